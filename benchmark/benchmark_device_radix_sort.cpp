@@ -53,7 +53,86 @@ std::vector<Key> generate_keys(size_t size)
     }
 }
 
-template<class Key>
+// Default sort, or the onesweep variant on the rocPRIM backend
+template<bool Onesweep>
+struct radix_sort
+{
+    template<class Key>
+    static hipError_t sort_keys(void * d_temporary_storage,
+                                size_t& temporary_storage_bytes,
+                                const Key * d_keys_input,
+                                Key * d_keys_output,
+                                size_t size,
+                                hipStream_t stream)
+    {
+        return hipcub::DeviceRadixSort::SortKeys(
+            d_temporary_storage, temporary_storage_bytes,
+            d_keys_input, d_keys_output, size,
+            0, sizeof(Key) * 8,
+            stream, false
+        );
+    }
+
+    template<class Key, class Value>
+    static hipError_t sort_pairs(void * d_temporary_storage,
+                                 size_t& temporary_storage_bytes,
+                                 const Key * d_keys_input,
+                                 Key * d_keys_output,
+                                 const Value * d_values_input,
+                                 Value * d_values_output,
+                                 size_t size,
+                                 hipStream_t stream)
+    {
+        return hipcub::DeviceRadixSort::SortPairs(
+            d_temporary_storage, temporary_storage_bytes,
+            d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+            0, sizeof(Key) * 8,
+            stream, false
+        );
+    }
+};
+
+#ifdef HIPCUB_ROCPRIM_API
+template<>
+struct radix_sort<true>
+{
+    template<class Key>
+    static hipError_t sort_keys(void * d_temporary_storage,
+                                size_t& temporary_storage_bytes,
+                                const Key * d_keys_input,
+                                Key * d_keys_output,
+                                size_t size,
+                                hipStream_t stream)
+    {
+        return hipcub::DeviceRadixSort::SortKeysOnesweep(
+            d_temporary_storage, temporary_storage_bytes,
+            d_keys_input, d_keys_output, size,
+            0, sizeof(Key) * 8,
+            stream, false
+        );
+    }
+
+    template<class Key, class Value>
+    static hipError_t sort_pairs(void * d_temporary_storage,
+                                 size_t& temporary_storage_bytes,
+                                 const Key * d_keys_input,
+                                 Key * d_keys_output,
+                                 const Value * d_values_input,
+                                 Value * d_values_output,
+                                 size_t size,
+                                 hipStream_t stream)
+    {
+        return hipcub::DeviceRadixSort::SortPairsOnesweep(
+            d_temporary_storage, temporary_storage_bytes,
+            d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+            0, sizeof(Key) * 8,
+            stream, false
+        );
+    }
+};
+#endif // HIPCUB_ROCPRIM_API
+
+template<class Key, bool Onesweep = false>
 void run_sort_keys_benchmark(benchmark::State& state,
                              hipStream_t stream,
                              size_t size,
@@ -76,11 +155,10 @@ void run_sort_keys_benchmark(benchmark::State& state,
     void * d_temporary_storage = nullptr;
     size_t temporary_storage_bytes = 0;
     HIP_CHECK(
-        hipcub::DeviceRadixSort::SortKeys(
+        radix_sort<Onesweep>::sort_keys(
             d_temporary_storage, temporary_storage_bytes,
             d_keys_input, d_keys_output, size,
-            0, sizeof(key_type) * 8 ,
-            stream, false
+            stream
         )
     );
 
@@ -91,11 +169,10 @@ void run_sort_keys_benchmark(benchmark::State& state,
     for(size_t i = 0; i < warmup_size; i++)
     {
         HIP_CHECK(
-            hipcub::DeviceRadixSort::SortKeys(
+            radix_sort<Onesweep>::sort_keys(
                 d_temporary_storage, temporary_storage_bytes,
                 d_keys_input, d_keys_output, size,
-                0, sizeof(key_type) * 8,
-                stream, false
+                stream
             )
         );
     }
@@ -108,11 +185,10 @@ void run_sort_keys_benchmark(benchmark::State& state,
         for(size_t i = 0; i < batch_size; i++)
         {
             HIP_CHECK(
-                hipcub::DeviceRadixSort::SortKeys(
+                radix_sort<Onesweep>::sort_keys(
                     d_temporary_storage, temporary_storage_bytes,
                     d_keys_input, d_keys_output, size,
-                    0, sizeof(key_type) * 8,
-                    stream, false
+                    stream
                 )
             );
         }
@@ -131,7 +207,7 @@ void run_sort_keys_benchmark(benchmark::State& state,
     HIP_CHECK(hipFree(d_keys_output));
 }
 
-template<class Key, class Value>
+template<class Key, class Value, bool Onesweep = false>
 void run_sort_pairs_benchmark(benchmark::State& state,
                               hipStream_t stream,
                               size_t size,
@@ -173,11 +249,201 @@ void run_sort_pairs_benchmark(benchmark::State& state,
     void * d_temporary_storage = nullptr;
     size_t temporary_storage_bytes = 0;
     HIP_CHECK(
-        hipcub::DeviceRadixSort::SortPairs(
+        radix_sort<Onesweep>::sort_pairs(
             d_temporary_storage, temporary_storage_bytes,
             d_keys_input, d_keys_output, d_values_input, d_values_output, size,
-            0, sizeof(key_type) * 8,
-            stream, false
+            stream
+        )
+    );
+
+    HIP_CHECK(hipMalloc(&d_temporary_storage, temporary_storage_bytes));
+    HIP_CHECK(hipDeviceSynchronize());
+
+    // Warm-up
+    for(size_t i = 0; i < warmup_size; i++)
+    {
+        HIP_CHECK(
+            radix_sort<Onesweep>::sort_pairs(
+                d_temporary_storage, temporary_storage_bytes,
+                d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                stream
+            )
+        );
+    }
+    HIP_CHECK(hipDeviceSynchronize());
+
+    for (auto _ : state)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for(size_t i = 0; i < batch_size; i++)
+        {
+            HIP_CHECK(
+                radix_sort<Onesweep>::sort_pairs(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                    stream
+                )
+            );
+        }
+        HIP_CHECK(hipDeviceSynchronize());
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed_seconds =
+            std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+        state.SetIterationTime(elapsed_seconds.count());
+    }
+    state.SetBytesProcessed(
+        state.iterations() * batch_size * size * (sizeof(key_type) + sizeof(value_type))
+    );
+    state.SetItemsProcessed(state.iterations() * batch_size * size);
+
+    HIP_CHECK(hipFree(d_temporary_storage));
+    HIP_CHECK(hipFree(d_keys_input));
+    HIP_CHECK(hipFree(d_keys_output));
+    HIP_CHECK(hipFree(d_values_input));
+    HIP_CHECK(hipFree(d_values_output));
+}
+
+
+#ifdef HIPCUB_ROCPRIM_API
+template<class Key, bool WriteKeys>
+void run_sort_indices_benchmark(benchmark::State& state,
+                                hipStream_t stream,
+                                size_t size,
+                                std::shared_ptr<std::vector<Key>> keys_input)
+{
+    using key_type = Key;
+    using index_type = unsigned int;
+
+    key_type * d_keys_input;
+    key_type * d_keys_output = nullptr;
+    HIP_CHECK(hipMalloc(&d_keys_input, size * sizeof(key_type)));
+    if(WriteKeys)
+    {
+        HIP_CHECK(hipMalloc(&d_keys_output, size * sizeof(key_type)));
+    }
+    HIP_CHECK(
+        hipMemcpy(
+            d_keys_input, keys_input->data(),
+            size * sizeof(key_type),
+            hipMemcpyHostToDevice
+        )
+    );
+
+    index_type * d_indices_output;
+    HIP_CHECK(hipMalloc(&d_indices_output, size * sizeof(index_type)));
+
+    void * d_temporary_storage = nullptr;
+    size_t temporary_storage_bytes = 0;
+    HIP_CHECK(
+        hipcub::DeviceRadixSort::SortIndices(
+            d_temporary_storage, temporary_storage_bytes,
+            d_keys_input, d_keys_output, d_indices_output, size,
+            0, sizeof(key_type) * 8, stream
+        )
+    );
+
+    HIP_CHECK(hipMalloc(&d_temporary_storage, temporary_storage_bytes));
+    HIP_CHECK(hipDeviceSynchronize());
+
+    // Warm-up
+    for(size_t i = 0; i < warmup_size; i++)
+    {
+        HIP_CHECK(
+            hipcub::DeviceRadixSort::SortIndices(
+                d_temporary_storage, temporary_storage_bytes,
+                d_keys_input, d_keys_output, d_indices_output, size,
+                0, sizeof(key_type) * 8, stream
+            )
+        );
+    }
+    HIP_CHECK(hipDeviceSynchronize());
+
+    for (auto _ : state)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for(size_t i = 0; i < batch_size; i++)
+        {
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortIndices(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys_input, d_keys_output, d_indices_output, size,
+                    0, sizeof(key_type) * 8, stream
+                )
+            );
+        }
+        HIP_CHECK(hipDeviceSynchronize());
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed_seconds =
+            std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+        state.SetIterationTime(elapsed_seconds.count());
+    }
+    state.SetBytesProcessed(
+        state.iterations() * batch_size * size * (sizeof(key_type) + sizeof(index_type))
+    );
+    state.SetItemsProcessed(state.iterations() * batch_size * size);
+
+    HIP_CHECK(hipFree(d_temporary_storage));
+    HIP_CHECK(hipFree(d_keys_input));
+    if(WriteKeys)
+    {
+        HIP_CHECK(hipFree(d_keys_output));
+    }
+    HIP_CHECK(hipFree(d_indices_output));
+}
+
+// Onesweep sort of pairs with or without check_presorted, over random, sorted and
+// reverse sorted keys: the cost of the check when it fails and its gain otherwise
+template<class Key, class Value, bool CheckPresorted>
+void run_sort_pairs_presorted_benchmark(benchmark::State& state,
+                                        hipStream_t stream,
+                                        size_t size,
+                                        std::shared_ptr<std::vector<Key>> keys_input)
+{
+    using key_type = Key;
+    using value_type = Value;
+
+    key_type * d_keys_input;
+    key_type * d_keys_output;
+    HIP_CHECK(hipMalloc(&d_keys_input, size * sizeof(key_type)));
+    HIP_CHECK(hipMalloc(&d_keys_output, size * sizeof(key_type)));
+    HIP_CHECK(
+        hipMemcpy(
+            d_keys_input, keys_input->data(),
+            size * sizeof(key_type),
+            hipMemcpyHostToDevice
+        )
+    );
+
+    std::vector<value_type> values_input(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        values_input[i] = value_type(i);
+    }
+
+    value_type * d_values_input;
+    value_type * d_values_output;
+    HIP_CHECK(hipMalloc(&d_values_input, size * sizeof(value_type)));
+    HIP_CHECK(hipMalloc(&d_values_output, size * sizeof(value_type)));
+    HIP_CHECK(
+        hipMemcpy(
+            d_values_input, values_input.data(),
+            size * sizeof(value_type),
+            hipMemcpyHostToDevice
+        )
+    );
+
+    void * d_temporary_storage = nullptr;
+    size_t temporary_storage_bytes = 0;
+    HIP_CHECK(
+        hipcub::DeviceRadixSort::SortPairsOnesweep(
+            d_temporary_storage, temporary_storage_bytes,
+            d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+            0, sizeof(key_type) * 8, stream, false,
+            false, CheckPresorted
         )
     );
 
@@ -188,11 +454,11 @@ void run_sort_pairs_benchmark(benchmark::State& state,
     for(size_t i = 0; i < warmup_size; i++)
     {
         HIP_CHECK(
-            hipcub::DeviceRadixSort::SortPairs(
+            hipcub::DeviceRadixSort::SortPairsOnesweep(
                 d_temporary_storage, temporary_storage_bytes,
                 d_keys_input, d_keys_output, d_values_input, d_values_output, size,
-                0, sizeof(key_type) * 8,
-                stream, false
+                0, sizeof(key_type) * 8, stream, false,
+                false, CheckPresorted
             )
         );
     }
@@ -205,11 +471,11 @@ void run_sort_pairs_benchmark(benchmark::State& state,
         for(size_t i = 0; i < batch_size; i++)
         {
             HIP_CHECK(
-                hipcub::DeviceRadixSort::SortPairs(
+                hipcub::DeviceRadixSort::SortPairsOnesweep(
                     d_temporary_storage, temporary_storage_bytes,
                     d_keys_input, d_keys_output, d_values_input, d_values_output, size,
-                    0, sizeof(key_type) * 8,
-                    stream, false
+                    0, sizeof(key_type) * 8, stream, false,
+                    false, CheckPresorted
                 )
             );
         }
@@ -232,6 +498,108 @@ void run_sort_pairs_benchmark(benchmark::State& state,
     HIP_CHECK(hipFree(d_values_output));
 }
 
+// In-place sort of pairs, to compare with sort_pairs_onesweep.  The keys and values
+// are copied back from the input before every sort, as sorted keys would be sorted
+// again otherwise, and the copies are part of the measured time.
+template<class Key, class Value>
+void run_sort_pairs_in_place_benchmark(benchmark::State& state,
+                                       hipStream_t stream,
+                                       size_t size,
+                                       std::shared_ptr<std::vector<Key>> keys_input)
+{
+    using key_type = Key;
+    using value_type = Value;
+
+    key_type * d_keys_input;
+    key_type * d_keys;
+    HIP_CHECK(hipMalloc(&d_keys_input, size * sizeof(key_type)));
+    HIP_CHECK(hipMalloc(&d_keys, size * sizeof(key_type)));
+    HIP_CHECK(
+        hipMemcpy(
+            d_keys_input, keys_input->data(),
+            size * sizeof(key_type),
+            hipMemcpyHostToDevice
+        )
+    );
+
+    std::vector<value_type> values_input(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        values_input[i] = value_type(i);
+    }
+
+    value_type * d_values_input;
+    value_type * d_values;
+    HIP_CHECK(hipMalloc(&d_values_input, size * sizeof(value_type)));
+    HIP_CHECK(hipMalloc(&d_values, size * sizeof(value_type)));
+    HIP_CHECK(
+        hipMemcpy(
+            d_values_input, values_input.data(),
+            size * sizeof(value_type),
+            hipMemcpyHostToDevice
+        )
+    );
+
+    void * d_temporary_storage = nullptr;
+    size_t temporary_storage_bytes = 0;
+    HIP_CHECK(
+        hipcub::DeviceRadixSort::SortPairsInPlace(
+            d_temporary_storage, temporary_storage_bytes,
+            d_keys, d_values, size,
+            0, sizeof(key_type) * 8, stream, false
+        )
+    );
+
+    HIP_CHECK(hipMalloc(&d_temporary_storage, temporary_storage_bytes));
+    HIP_CHECK(hipDeviceSynchronize());
+
+    auto sort = [&]()
+    {
+        HIP_CHECK(hipMemcpyAsync(d_keys, d_keys_input, size * sizeof(key_type), hipMemcpyDeviceToDevice, stream));
+        HIP_CHECK(hipMemcpyAsync(d_values, d_values_input, size * sizeof(value_type), hipMemcpyDeviceToDevice, stream));
+        HIP_CHECK(
+            hipcub::DeviceRadixSort::SortPairsInPlace(
+                d_temporary_storage, temporary_storage_bytes,
+                d_keys, d_values, size,
+                0, sizeof(key_type) * 8, stream, false
+            )
+        );
+    };
+
+    // Warm-up
+    for(size_t i = 0; i < warmup_size; i++)
+    {
+        sort();
+    }
+    HIP_CHECK(hipDeviceSynchronize());
+
+    for (auto _ : state)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for(size_t i = 0; i < batch_size; i++)
+        {
+            sort();
+        }
+        HIP_CHECK(hipDeviceSynchronize());
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed_seconds =
+            std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+        state.SetIterationTime(elapsed_seconds.count());
+    }
+    state.SetBytesProcessed(
+        state.iterations() * batch_size * size * (sizeof(key_type) + sizeof(value_type))
+    );
+    state.SetItemsProcessed(state.iterations() * batch_size * size);
+
+    HIP_CHECK(hipFree(d_temporary_storage));
+    HIP_CHECK(hipFree(d_keys_input));
+    HIP_CHECK(hipFree(d_keys));
+    HIP_CHECK(hipFree(d_values_input));
+    HIP_CHECK(hipFree(d_values));
+}
+#endif // HIPCUB_ROCPRIM_API
 
 #define CREATE_SORT_KEYS_BENCHMARK(Key) \
     { \
@@ -255,6 +623,70 @@ void run_sort_pairs_benchmark(benchmark::State& state,
         ); \
     }
 
+#define CREATE_SORT_KEYS_ONESWEEP_BENCHMARK(Key) \
+    { \
+        auto keys_input = std::make_shared<std::vector<Key>>(generate_keys<Key>(size)); \
+        benchmarks.push_back( \
+            benchmark::RegisterBenchmark( \
+                (std::string("sort_keys_onesweep") + "<" #Key ">").c_str(), \
+                [=](benchmark::State& state) { run_sort_keys_benchmark<Key, true>(state, stream, size, keys_input); } \
+            ) \
+        ); \
+    }
+
+#define CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(Key, Value) \
+    { \
+        auto keys_input = std::make_shared<std::vector<Key>>(generate_keys<Key>(size)); \
+        benchmarks.push_back( \
+            benchmark::RegisterBenchmark( \
+                (std::string("sort_pairs_onesweep") + "<" #Key ", " #Value">").c_str(), \
+                [=](benchmark::State& state) { run_sort_pairs_benchmark<Key, Value, true>(state, stream, size, keys_input); } \
+            ) \
+        ); \
+    }
+
+#define CREATE_SORT_INDICES_BENCHMARK(Key, WriteKeys) \
+    { \
+        auto keys_input = std::make_shared<std::vector<Key>>(generate_keys<Key>(size)); \
+        benchmarks.push_back( \
+            benchmark::RegisterBenchmark( \
+                (std::string(WriteKeys ? "sort_indices" : "sort_indices_discard_keys") + "<" #Key ">").c_str(), \
+                [=](benchmark::State& state) { run_sort_indices_benchmark<Key, WriteKeys>(state, stream, size, keys_input); } \
+            ) \
+        ); \
+    }
+
+// Order is one of random, sorted or reversed
+#define CREATE_SORT_PAIRS_PRESORTED_BENCHMARK(Key, Value, Order) \
+    { \
+        auto keys_input = std::make_shared<std::vector<Key>>(generate_keys<Key>(size)); \
+        if(std::string(#Order) != "random") std::sort(keys_input->begin(), keys_input->end()); \
+        if(std::string(#Order) == "reversed") std::reverse(keys_input->begin(), keys_input->end()); \
+        benchmarks.push_back( \
+            benchmark::RegisterBenchmark( \
+                (std::string("sort_pairs_onesweep") + "<" #Key ", " #Value ">/" #Order).c_str(), \
+                [=](benchmark::State& state) { run_sort_pairs_presorted_benchmark<Key, Value, false>(state, stream, size, keys_input); } \
+            ) \
+        ); \
+        benchmarks.push_back( \
+            benchmark::RegisterBenchmark( \
+                (std::string("sort_pairs_onesweep_check_presorted") + "<" #Key ", " #Value ">/" #Order).c_str(), \
+                [=](benchmark::State& state) { run_sort_pairs_presorted_benchmark<Key, Value, true>(state, stream, size, keys_input); } \
+            ) \
+        ); \
+    }
+
+#define CREATE_SORT_PAIRS_IN_PLACE_BENCHMARK(Key, Value) \
+    { \
+        auto keys_input = std::make_shared<std::vector<Key>>(generate_keys<Key>(size)); \
+        benchmarks.push_back( \
+            benchmark::RegisterBenchmark( \
+                (std::string("sort_pairs_in_place") + "<" #Key ", " #Value ">").c_str(), \
+                [=](benchmark::State& state) { run_sort_pairs_in_place_benchmark<Key, Value>(state, stream, size, keys_input); } \
+            ) \
+        ); \
+    }
+
 
 void add_sort_keys_benchmarks(std::vector<benchmark::internal::Benchmark*>& benchmarks,
                               hipStream_t stream,
@@ -288,6 +720,71 @@ void add_sort_pairs_benchmarks(std::vector<benchmark::internal::Benchmark*>& ben
     CREATE_SORT_PAIRS_BENCHMARK(uint8_t, uint8_t)
 }
 
+#ifdef HIPCUB_ROCPRIM_API
+void add_sort_keys_onesweep_benchmarks(std::vector<benchmark::internal::Benchmark*>& benchmarks,
+                                       hipStream_t stream,
+                                       size_t size)
+{
+    CREATE_SORT_KEYS_ONESWEEP_BENCHMARK(int)
+    CREATE_SORT_KEYS_ONESWEEP_BENCHMARK(long long)
+    CREATE_SORT_KEYS_ONESWEEP_BENCHMARK(int8_t)
+    CREATE_SORT_KEYS_ONESWEEP_BENCHMARK(uint8_t)
+    CREATE_SORT_KEYS_ONESWEEP_BENCHMARK(short)
+}
+
+void add_sort_pairs_onesweep_benchmarks(std::vector<benchmark::internal::Benchmark*>& benchmarks,
+                                        hipStream_t stream,
+                                        size_t size)
+{
+    using custom_float2 = benchmark_utils::custom_type<float, float>;
+    using custom_double2 = benchmark_utils::custom_type<double, double>;
+
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(int, float)
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(int, double)
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(int, custom_float2)
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(int, custom_double2)
+
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(long long, float)
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(long long, double)
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(long long, custom_float2)
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(long long, custom_double2)
+
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(int8_t, int8_t)
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(uint8_t, uint8_t)
+}
+
+void add_sort_indices_benchmarks(std::vector<benchmark::internal::Benchmark*>& benchmarks,
+                                 hipStream_t stream,
+                                 size_t size)
+{
+    // Argsort as sort_pairs_onesweep with an identity permutation for comparison
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(int, unsigned int)
+    CREATE_SORT_PAIRS_ONESWEEP_BENCHMARK(long long, unsigned int)
+
+    CREATE_SORT_INDICES_BENCHMARK(int, true)
+    CREATE_SORT_INDICES_BENCHMARK(int, false)
+    CREATE_SORT_INDICES_BENCHMARK(long long, true)
+    CREATE_SORT_INDICES_BENCHMARK(long long, false)
+}
+
+void add_sort_pairs_presorted_benchmarks(std::vector<benchmark::internal::Benchmark*>& benchmarks,
+                                         hipStream_t stream,
+                                         size_t size)
+{
+    CREATE_SORT_PAIRS_PRESORTED_BENCHMARK(long long, unsigned int, random)
+    CREATE_SORT_PAIRS_PRESORTED_BENCHMARK(long long, unsigned int, sorted)
+    CREATE_SORT_PAIRS_PRESORTED_BENCHMARK(long long, unsigned int, reversed)
+}
+
+void add_sort_pairs_in_place_benchmarks(std::vector<benchmark::internal::Benchmark*>& benchmarks,
+                                        hipStream_t stream,
+                                        size_t size)
+{
+    CREATE_SORT_PAIRS_IN_PLACE_BENCHMARK(int, float)
+    CREATE_SORT_PAIRS_IN_PLACE_BENCHMARK(long long, double)
+}
+#endif // HIPCUB_ROCPRIM_API
+
 int main(int argc, char *argv[])
 {
     cli::Parser parser(argc, argv);
@@ -312,6 +809,13 @@ int main(int argc, char *argv[])
     std::vector<benchmark::internal::Benchmark*> benchmarks;
     add_sort_keys_benchmarks(benchmarks, stream, size);
     add_sort_pairs_benchmarks(benchmarks, stream, size);
+#ifdef HIPCUB_ROCPRIM_API
+    add_sort_keys_onesweep_benchmarks(benchmarks, stream, size);
+    add_sort_pairs_onesweep_benchmarks(benchmarks, stream, size);
+    add_sort_indices_benchmarks(benchmarks, stream, size);
+    add_sort_pairs_presorted_benchmarks(benchmarks, stream, size);
+    add_sort_pairs_in_place_benchmarks(benchmarks, stream, size);
+#endif // HIPCUB_ROCPRIM_API
 
     // Use manual timing
     for(auto& b : benchmarks)
@@ -0,0 +1,619 @@
+// MIT License
+//
+// Copyright (c) 2021 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "common_benchmark_header.hpp"
+
+#include <numeric>
+
+// Matrix generators shared with the tests
+#include "../test/hipcub/experimental/sparse_matrix.hpp"
+
+// HIP API
+#include "hipcub/device/device_spmv.hpp"
+
+
+#ifndef DEFAULT_N
+const size_t DEFAULT_N = 1024 * 1024 * 16;
+#endif
+
+const unsigned int batch_size = 10;
+const unsigned int warmup_size = 5;
+
+// Sparsity pattern of a benchmarked matrix
+struct matrix_spec
+{
+    std::string kind;   // grid2d, grid3d, dense, wheel, uniform, powerlaw or market
+    int         param;  // width, row length, spokes or mean row length
+    int         rows;   // rows of the random and dense matrices
+    std::string path;   // Matrix Market file
+    bool        rcm;    // apply reverse Cuthill-McKee relabeling
+
+    std::string name() const
+    {
+        std::string name = kind == "market" ? path.substr(path.find_last_of("/\\") + 1)
+                                            : kind + "_" + std::to_string(param);
+        return rcm ? name + "/rcm" : name + "/natural";
+    }
+};
+
+// Random square matrix whose row lengths follow a uniform or a power-law
+// distribution with the given mean
+template<class T>
+void init_random(CooMatrix<T, int>& coo_matrix, const matrix_spec& spec)
+{
+    std::default_random_engine gen(spec.rows);
+    std::vector<int> row_lengths(spec.rows);
+    if(spec.kind == "uniform")
+    {
+        std::uniform_int_distribution<int> distribution(spec.param / 2, spec.param + spec.param / 2);
+        for(auto& length : row_lengths) length = distribution(gen);
+    }
+    else
+    {
+        // Pareto with shape 1.5 has mean 3 * x_min
+        std::uniform_real_distribution<double> distribution(0.0, 1.0);
+        const double x_min = spec.param / 3.0;
+        for(auto& length : row_lengths)
+        {
+            const double x = x_min / std::pow(1.0 - distribution(gen), 1.0 / 1.5);
+            length = int(std::min<double>(x, spec.rows));
+        }
+    }
+
+    coo_matrix.num_rows     = spec.rows;
+    coo_matrix.num_cols     = spec.rows;
+    coo_matrix.num_nonzeros = std::accumulate(row_lengths.begin(), row_lengths.end(), 0);
+    coo_matrix.coo_tuples   = new typename CooMatrix<T, int>::CooTuple[coo_matrix.num_nonzeros];
+
+    std::uniform_int_distribution<int> column_distribution(0, spec.rows - 1);
+    int nonzero = 0;
+    for(int row = 0; row < spec.rows; row++)
+    {
+        for(int i = 0; i < row_lengths[row]; i++)
+        {
+            coo_matrix.coo_tuples[nonzero++] =
+                typename CooMatrix<T, int>::CooTuple(row, column_distribution(gen), T(1));
+        }
+    }
+    std::sort(coo_matrix.coo_tuples, coo_matrix.coo_tuples + coo_matrix.num_nonzeros);
+}
+
+// Sparse matrix on the host, shared by the benchmarks of all formats
+template<class T>
+using csr_matrix_ptr = std::shared_ptr<CsrMatrix<T, int>>;
+
+template<class T>
+csr_matrix_ptr<T> generate_matrix(const matrix_spec& spec)
+{
+    CooMatrix<T, int> coo_matrix;
+    if(spec.kind == "grid2d")
+    {
+        coo_matrix.InitGrid2d(spec.param, false);
+    }
+    else if(spec.kind == "grid3d")
+    {
+        coo_matrix.InitGrid3d(spec.param, false);
+    }
+    else if(spec.kind == "wheel")
+    {
+        coo_matrix.InitWheel(spec.param);
+    }
+    else if(spec.kind == "dense")
+    {
+        coo_matrix.InitDense(spec.rows, spec.param);
+    }
+    else if(spec.kind == "market")
+    {
+        coo_matrix.InitMarket(spec.path);
+    }
+    else
+    {
+        init_random(coo_matrix, spec);
+    }
+
+    auto csr_matrix = std::make_shared<CsrMatrix<T, int>>();
+    csr_matrix->FromCoo(coo_matrix);
+    if(spec.rcm)
+    {
+        RcmRelabel(*csr_matrix);
+    }
+    return csr_matrix;
+}
+
+// Matrices are generated when first benchmarked and kept while consecutive
+// benchmarks (the formats of one matrix) use them
+template<class T>
+csr_matrix_ptr<T> get_matrix(const matrix_spec& spec)
+{
+    static std::string cached_name;
+    static csr_matrix_ptr<T> cached_matrix;
+    if(!cached_matrix || cached_name != spec.name())
+    {
+        cached_matrix.reset();
+        cached_matrix = generate_matrix<T>(spec);
+        cached_name = spec.name();
+    }
+    return cached_matrix;
+}
+
+// CSR arrays and dense vectors on the device
+template<class T>
+struct device_csr_matrix
+{
+    T *   d_values;
+    int * d_row_offsets;
+    int * d_column_indices;
+    T *   d_vector_x;
+    T *   d_vector_y;
+
+    explicit device_csr_matrix(const CsrMatrix<T, int>& matrix)
+    {
+        std::vector<T> vector_x(matrix.num_cols, T(1));
+
+        HIP_CHECK(hipMalloc(&d_values, matrix.num_nonzeros * sizeof(T)));
+        HIP_CHECK(hipMalloc(&d_row_offsets, (matrix.num_rows + 1) * sizeof(int)));
+        HIP_CHECK(hipMalloc(&d_column_indices, matrix.num_nonzeros * sizeof(int)));
+        HIP_CHECK(hipMalloc(&d_vector_x, matrix.num_cols * sizeof(T)));
+        HIP_CHECK(hipMalloc(&d_vector_y, matrix.num_rows * sizeof(T)));
+        HIP_CHECK(hipMemcpy(d_values, matrix.values, matrix.num_nonzeros * sizeof(T), hipMemcpyHostToDevice));
+        HIP_CHECK(hipMemcpy(d_row_offsets, matrix.row_offsets, (matrix.num_rows + 1) * sizeof(int), hipMemcpyHostToDevice));
+        HIP_CHECK(hipMemcpy(d_column_indices, matrix.column_indices, matrix.num_nonzeros * sizeof(int), hipMemcpyHostToDevice));
+        HIP_CHECK(hipMemcpy(d_vector_x, vector_x.data(), matrix.num_cols * sizeof(T), hipMemcpyHostToDevice));
+    }
+
+    ~device_csr_matrix()
+    {
+        HIP_CHECK(hipFree(d_values));
+        HIP_CHECK(hipFree(d_row_offsets));
+        HIP_CHECK(hipFree(d_column_indices));
+        HIP_CHECK(hipFree(d_vector_x));
+        HIP_CHECK(hipFree(d_vector_y));
+    }
+};
+
+// Minimum bytes moved by one CSR product: the matrix, x and y once each
+template<class T>
+size_t csr_bytes(const CsrMatrix<T, int>& matrix)
+{
+    return matrix.num_nonzeros * (sizeof(T) + sizeof(int))
+        + (matrix.num_rows + 1) * sizeof(int)
+        + matrix.num_cols * sizeof(T)
+        + matrix.num_rows * sizeof(T);
+}
+
+// Times batch_size calls of spmv per iteration and reports GFLOP/s and the
+// effective bandwidth for the given bytes moved per call
+template<class T, class Spmv>
+void run_timed(benchmark::State& state,
+               const CsrMatrix<T, int>& matrix,
+               size_t bytes_per_call,
+               Spmv spmv)
+{
+    // Warm-up
+    for(size_t i = 0; i < warmup_size; i++)
+    {
+        spmv();
+    }
+    HIP_CHECK(hipDeviceSynchronize());
+
+    double total_seconds = 0.0;
+    for (auto _ : state)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for(size_t i = 0; i < batch_size; i++)
+        {
+            spmv();
+        }
+        HIP_CHECK(hipDeviceSynchronize());
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed_seconds =
+            std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+        state.SetIterationTime(elapsed_seconds.count());
+        total_seconds += elapsed_seconds.count();
+    }
+    const double calls = double(state.iterations()) * batch_size;
+    state.SetBytesProcessed(state.iterations() * batch_size * bytes_per_call);
+    state.SetItemsProcessed(state.iterations() * batch_size * matrix.num_nonzeros);
+    state.counters["GFLOP/s"] = 2.0 * matrix.num_nonzeros * calls / total_seconds / 1e9;
+    state.counters["GB/s"] = bytes_per_call * calls / total_seconds / 1e9;
+    state.counters["rows"] = matrix.num_rows;
+    state.counters["nnz"] = matrix.num_nonzeros;
+}
+
+template<class T>
+void run_csr_benchmark(benchmark::State& state,
+                       hipStream_t stream,
+                       matrix_spec spec)
+{
+    csr_matrix_ptr<T> matrix = get_matrix<T>(spec);
+    device_csr_matrix<T> d_matrix(*matrix);
+
+    void * d_temporary_storage = nullptr;
+    size_t temporary_storage_bytes = 0;
+    HIP_CHECK(
+        hipcub::DeviceSpmv::CsrMV(
+            d_temporary_storage, temporary_storage_bytes,
+            d_matrix.d_values, d_matrix.d_row_offsets, d_matrix.d_column_indices,
+            d_matrix.d_vector_x, d_matrix.d_vector_y,
+            matrix->num_rows, matrix->num_cols, matrix->num_nonzeros,
+            stream, false
+        )
+    );
+
+    HIP_CHECK(hipMalloc(&d_temporary_storage, temporary_storage_bytes));
+    HIP_CHECK(hipDeviceSynchronize());
+
+    run_timed(state, *matrix, csr_bytes(*matrix), [&]
+    {
+        HIP_CHECK(
+            hipcub::DeviceSpmv::CsrMV(
+                d_temporary_storage, temporary_storage_bytes,
+                d_matrix.d_values, d_matrix.d_row_offsets, d_matrix.d_column_indices,
+                d_matrix.d_vector_x, d_matrix.d_vector_y,
+                matrix->num_rows, matrix->num_cols, matrix->num_nonzeros,
+                stream, false
+            )
+        );
+    });
+
+    HIP_CHECK(hipFree(d_temporary_storage));
+}
+
+#ifdef HIPCUB_ROCPRIM_API
+
+template<class T>
+void run_csr_plan_benchmark(benchmark::State& state,
+                            hipStream_t stream,
+                            matrix_spec spec)
+{
+    csr_matrix_ptr<T> matrix = get_matrix<T>(spec);
+    device_csr_matrix<T> d_matrix(*matrix);
+
+    hipcub::DeviceSpmv::Plan<T> plan;
+    void * d_temporary_storage = nullptr;
+    size_t temporary_storage_bytes = 0;
+    HIP_CHECK(
+        hipcub::DeviceSpmv::CsrMVPlan(
+            d_temporary_storage, temporary_storage_bytes, plan, d_matrix.d_row_offsets,
+            matrix->num_rows, matrix->num_cols, matrix->num_nonzeros,
+            stream, false
+        )
+    );
+
+    HIP_CHECK(hipMalloc(&d_temporary_storage, temporary_storage_bytes));
+    HIP_CHECK(
+        hipcub::DeviceSpmv::CsrMVPlan(
+            d_temporary_storage, temporary_storage_bytes, plan, d_matrix.d_row_offsets,
+            matrix->num_rows, matrix->num_cols, matrix->num_nonzeros,
+            stream, false
+        )
+    );
+    HIP_CHECK(hipDeviceSynchronize());
+
+    run_timed(state, *matrix, csr_bytes(*matrix), [&]
+    {
+        HIP_CHECK(
+            hipcub::DeviceSpmv::CsrMV(
+                plan, d_matrix.d_values, d_matrix.d_column_indices,
+                d_matrix.d_vector_x, d_matrix.d_vector_y,
+                T(1), T(0), stream, false
+            )
+        );
+    });
+
+    HIP_CHECK(hipFree(d_temporary_storage));
+}
+
+template<class T>
+void run_coo_benchmark(benchmark::State& state,
+                       hipStream_t stream,
+                       matrix_spec spec)
+{
+    csr_matrix_ptr<T> matrix = get_matrix<T>(spec);
+    device_csr_matrix<T> d_matrix(*matrix);
+
+    std::vector<int> row_indices(matrix->num_nonzeros);
+    for(int row = 0; row < matrix->num_rows; row++)
+    {
+        for(int i = matrix->row_offsets[row]; i < matrix->row_offsets[row + 1]; i++)
+        {
+            row_indices[i] = row;
+        }
+    }
+
+    int * d_row_indices;
+    HIP_CHECK(hipMalloc(&d_row_indices, matrix->num_nonzeros * sizeof(int)));
+    HIP_CHECK(
+        hipMemcpy(
+            d_row_indices, row_indices.data(),
+            matrix->num_nonzeros * sizeof(int),
+            hipMemcpyHostToDevice
+        )
+    );
+
+    void * d_temporary_storage = nullptr;
+    size_t temporary_storage_bytes = 0;
+    HIP_CHECK(
+        hipcub::DeviceSpmv::CooMV(
+            d_temporary_storage, temporary_storage_bytes,
+            d_matrix.d_values, d_row_indices, d_matrix.d_column_indices,
+            d_matrix.d_vector_x, d_matrix.d_vector_y,
+            matrix->num_rows, matrix->num_cols, matrix->num_nonzeros,
+            T(1), T(0), stream, false
+        )
+    );
+
+    HIP_CHECK(hipMalloc(&d_temporary_storage, temporary_storage_bytes));
+    HIP_CHECK(hipDeviceSynchronize());
+
+    const size_t coo_bytes = matrix->num_nonzeros * (sizeof(T) + 2 * sizeof(int))
+        + matrix->num_cols * sizeof(T)
+        + matrix->num_rows * sizeof(T);
+
+    run_timed(state, *matrix, coo_bytes, [&]
+    {
+        HIP_CHECK(
+            hipcub::DeviceSpmv::CooMV(
+                d_temporary_storage, temporary_storage_bytes,
+                d_matrix.d_values, d_row_indices, d_matrix.d_column_indices,
+                d_matrix.d_vector_x, d_matrix.d_vector_y,
+                matrix->num_rows, matrix->num_cols, matrix->num_nonzeros,
+                T(1), T(0), stream, false
+            )
+        );
+    });
+
+    HIP_CHECK(hipFree(d_temporary_storage));
+    HIP_CHECK(hipFree(d_row_indices));
+}
+
+template<class T>
+void run_sell_benchmark(benchmark::State& state,
+                        hipStream_t stream,
+                        matrix_spec spec,
+                        int slice_height,
+                        int sort_window)
+{
+    csr_matrix_ptr<T> matrix = get_matrix<T>(spec);
+    device_csr_matrix<T> d_matrix(*matrix);
+
+    const int num_slices = (matrix->num_rows + slice_height - 1) / slice_height;
+
+    int * d_row_permutation;
+    int * d_slice_offsets;
+    HIP_CHECK(hipMalloc(&d_row_permutation, matrix->num_rows * sizeof(int)));
+    HIP_CHECK(hipMalloc(&d_slice_offsets, (num_slices + 1) * sizeof(int)));
+
+    void * d_temporary_storage = nullptr;
+    size_t temporary_storage_bytes = 0;
+    HIP_CHECK(
+        hipcub::DeviceSpmv::CsrToSellPartition(
+            d_temporary_storage, temporary_storage_bytes,
+            d_matrix.d_row_offsets, matrix->num_rows, matrix->num_nonzeros,
+            slice_height, sort_window, d_row_permutation, d_slice_offsets,
+            stream, false
+        )
+    );
+
+    HIP_CHECK(hipMalloc(&d_temporary_storage, temporary_storage_bytes));
+    HIP_CHECK(
+        hipcub::DeviceSpmv::CsrToSellPartition(
+            d_temporary_storage, temporary_storage_bytes,
+            d_matrix.d_row_offsets, matrix->num_rows, matrix->num_nonzeros,
+            slice_height, sort_window, d_row_permutation, d_slice_offsets,
+            stream, false
+        )
+    );
+
+    int num_stored = 0;
+    HIP_CHECK(
+        hipMemcpy(
+            &num_stored, d_slice_offsets + num_slices,
+            sizeof(int),
+            hipMemcpyDeviceToHost
+        )
+    );
+
+    // SELL is not meant for skewed rows; skip when padding would dominate
+    if(size_t(num_stored) > 4 * size_t(matrix->num_nonzeros))
+    {
+        HIP_CHECK(hipFree(d_temporary_storage));
+        HIP_CHECK(hipFree(d_row_permutation));
+        HIP_CHECK(hipFree(d_slice_offsets));
+        state.SkipWithError("SELL padding exceeds 4x the nonzeros");
+        return;
+    }
+
+    T *   d_sell_values;
+    int * d_sell_column_indices;
+    HIP_CHECK(hipMalloc(&d_sell_values, num_stored * sizeof(T)));
+    HIP_CHECK(hipMalloc(&d_sell_column_indices, num_stored * sizeof(int)));
+    HIP_CHECK(
+        hipcub::DeviceSpmv::CsrToSell(
+            d_matrix.d_values, d_matrix.d_row_offsets, d_matrix.d_column_indices,
+            matrix->num_rows, slice_height, d_row_permutation, d_slice_offsets,
+            d_sell_values, d_sell_column_indices,
+            stream, false
+        )
+    );
+    HIP_CHECK(hipDeviceSynchronize());
+
+    state.counters["padding"] = double(num_stored) / matrix->num_nonzeros;
+
+    const size_t sell_bytes = size_t(num_stored) * (sizeof(T) + sizeof(int))
+        + (num_slices + 1) * sizeof(int)
+        + matrix->num_rows * sizeof(int)
+        + matrix->num_cols * sizeof(T)
+        + matrix->num_rows * sizeof(T);
+
+    run_timed(state, *matrix, sell_bytes, [&]
+    {
+        HIP_CHECK(
+            hipcub::DeviceSpmv::SellMV(
+                d_sell_values, d_sell_column_indices, d_slice_offsets, d_row_permutation,
+                d_matrix.d_vector_x, d_matrix.d_vector_y,
+                matrix->num_rows, slice_height,
+                T(1), T(0), stream, false
+            )
+        );
+    });
+
+    HIP_CHECK(hipFree(d_temporary_storage));
+    HIP_CHECK(hipFree(d_row_permutation));
+    HIP_CHECK(hipFree(d_slice_offsets));
+    HIP_CHECK(hipFree(d_sell_values));
+    HIP_CHECK(hipFree(d_sell_column_indices));
+}
+
+#endif // HIPCUB_ROCPRIM_API
+
+
+#define CREATE_SPMV_BENCHMARK(T, FORMAT) \
+    benchmarks.push_back( \
+        benchmark::RegisterBenchmark( \
+            (std::string("spmv_" #FORMAT "<" #T ">/") + spec.name()).c_str(), \
+            [=](benchmark::State& state) { run_##FORMAT##_benchmark<T>(state, stream, spec); } \
+        ) \
+    );
+
+#define CREATE_SPMV_SELL_BENCHMARK(T, C, SIGMA) \
+    benchmarks.push_back( \
+        benchmark::RegisterBenchmark( \
+            (std::string("spmv_sell_" #C "_" #SIGMA "<" #T ">/") + spec.name()).c_str(), \
+            [=](benchmark::State& state) { run_sell_benchmark<T>(state, stream, spec, C, SIGMA); } \
+        ) \
+    );
+
+#ifdef HIPCUB_ROCPRIM_API
+#define CREATE_SPMV_FORMAT_BENCHMARKS(T) \
+    for(const matrix_spec& spec : specs) \
+    { \
+        CREATE_SPMV_BENCHMARK(T, csr) \
+        CREATE_SPMV_BENCHMARK(T, csr_plan) \
+        CREATE_SPMV_BENCHMARK(T, coo) \
+        CREATE_SPMV_SELL_BENCHMARK(T, 64, 1) \
+        CREATE_SPMV_SELL_BENCHMARK(T, 64, 1024) \
+    }
+#else
+#define CREATE_SPMV_FORMAT_BENCHMARKS(T) \
+    for(const matrix_spec& spec : specs) \
+    { \
+        CREATE_SPMV_BENCHMARK(T, csr) \
+    }
+#endif
+
+// Shapes and row-length distributions of about size nonzeros each, every one
+// in natural and in RCM order
+std::vector<matrix_spec> get_matrix_specs(size_t size, const std::string& market_path)
+{
+    const int n = int(size);
+    std::vector<matrix_spec> specs;
+    if(!market_path.empty())
+    {
+        specs.push_back({ "market", 0, 0, market_path, false });
+    }
+    else
+    {
+        // Regular stencils
+        specs.push_back({ "grid2d", int(std::sqrt(n / 5.0)), 0, "", false });
+        specs.push_back({ "grid3d", int(std::cbrt(n / 7.0)), 0, "", false });
+        // Uniform rows, short to long
+        for(int row_length : { 8, 64, 512 })
+        {
+            specs.push_back({ "dense", row_length, n / row_length, "", false });
+        }
+        // Random columns, increasingly skewed row lengths
+        specs.push_back({ "uniform", 16, n / 16, "", false });
+        specs.push_back({ "powerlaw", 16, n / 16, "", false });
+        specs.push_back({ "wheel", n / 3, 0, "", false });
+    }
+
+    // Dense rows are left alone by RCM
+    const size_t natural_specs = specs.size();
+    for(size_t i = 0; i < natural_specs; i++)
+    {
+        if(specs[i].kind != "dense")
+        {
+            matrix_spec spec = specs[i];
+            spec.rcm = true;
+            specs.push_back(spec);
+        }
+    }
+    return specs;
+}
+
+void add_spmv_benchmarks(std::vector<benchmark::internal::Benchmark*>& benchmarks,
+                         hipStream_t stream,
+                         const std::vector<matrix_spec>& specs)
+{
+    CREATE_SPMV_FORMAT_BENCHMARKS(float)
+    CREATE_SPMV_FORMAT_BENCHMARKS(double)
+}
+
+int main(int argc, char *argv[])
+{
+    cli::Parser parser(argc, argv);
+    parser.set_optional<size_t>("size", "size", DEFAULT_N, "approximate number of nonzeros");
+    parser.set_optional<std::string>("mtx", "mtx", "", "Matrix Market file to benchmark instead of the generated matrices");
+    parser.set_optional<int>("trials", "trials", -1, "number of iterations");
+    parser.run_and_exit_if_error();
+
+    // Parse argv
+    benchmark::Initialize(&argc, argv);
+    const size_t size = parser.get<size_t>("size");
+    const std::string market_path = parser.get<std::string>("mtx");
+    const int trials = parser.get<int>("trials");
+
+    // HIP
+    hipStream_t stream = 0; // default
+    hipDeviceProp_t devProp;
+    int device_id = 0;
+    HIP_CHECK(hipGetDevice(&device_id));
+    HIP_CHECK(hipGetDeviceProperties(&devProp, device_id));
+    std::cout << "[HIP] Device name: " << devProp.name << std::endl;
+
+    // Add benchmarks
+    std::vector<benchmark::internal::Benchmark*> benchmarks;
+    add_spmv_benchmarks(benchmarks, stream, get_matrix_specs(size, market_path));
+
+    // Use manual timing
+    for(auto& b : benchmarks)
+    {
+        b->UseManualTime();
+        b->Unit(benchmark::kMillisecond);
+    }
+
+    // Force number of iterations
+    if(trials > 0)
+    {
+        for(auto& b : benchmarks)
+        {
+            b->Iterations(trials);
+        }
+    }
+
+    // Run benchmarks
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -42,6 +42,7 @@
 #include "../../../util_ptx.hpp"
 
 #include "../thread/thread_reduce.hpp"
+#include "../thread/thread_scan.hpp"
 #include "../block/block_scan.hpp"
 #include "../block/radix_rank_sort_operations.hpp"
 
@@ -479,7 +480,7 @@ private:
 
         RADIX_DIGITS                = 1 << RADIX_BITS,
 
-        LOG_WARP_THREADS            = Log2<ARCH>::VALUE,
+        LOG_WARP_THREADS            = Log2<HIPCUB_DEVICE_WARP_THREADS>::VALUE,
         WARP_THREADS                = 1 << LOG_WARP_THREADS,
         WARPS                       = (BLOCK_THREADS + WARP_THREADS - 1) / WARP_THREADS,
 
@@ -581,6 +582,21 @@ public:
         int             (&ranks)[KEYS_PER_THREAD],          ///< [out] For each key, the local rank within the tile
         int             current_bit,                        ///< [in] The least-significant bit position of the current digit to extract
         int             num_bits)                           ///< [in] The number of bits in the current digit
+    {
+        RankKeys(keys, ranks, DigitExtractor<UnsignedBits>(current_bit, num_bits));
+    }
+
+    /**
+     * \brief Rank keys by the digits that \p digit_extractor takes from them.
+     */
+    template <
+        typename        UnsignedBits,
+        int             KEYS_PER_THREAD,
+        typename        DigitExtractorT>
+    HIPCUB_DEVICE inline void RankKeys(
+        UnsignedBits    (&keys)[KEYS_PER_THREAD],           ///< [in] Keys for this tile
+        int             (&ranks)[KEYS_PER_THREAD],          ///< [out] For each key, the local rank within the tile
+        DigitExtractorT digit_extractor)                    ///< [in] Extracts the current digit of a key
     {
         // Initialize shared digit counters
 
@@ -594,19 +610,19 @@ public:
 
         volatile DigitCounterT  *digit_counters[KEYS_PER_THREAD];
         uint32_t                warp_id         = linear_tid >> LOG_WARP_THREADS;
-        uint32_t                lane_mask_lt    = LaneMaskLt();
+        uint64_t                lane_mask_lt    = LaneMaskLt();
 
         #pragma unroll
         for (int ITEM = 0; ITEM < KEYS_PER_THREAD; ++ITEM)
         {
             // My digit
-            uint32_t digit = BFE(keys[ITEM], current_bit, num_bits);
+            uint32_t digit = digit_extractor.Digit(keys[ITEM]);
 
             if (IS_DESCENDING)
                 digit = RADIX_DIGITS - digit - 1;
 
             // Mask of peers who have same digit as me
-            uint32_t peer_mask = rocprim::MatchAny<RADIX_BITS>(digit);
+            uint64_t peer_mask = MatchAny<RADIX_BITS>(digit);
 
             // Pointer to smem digit counter for this key
             digit_counters[ITEM] = &temp_storage.aliasable.warp_digit_counters[digit * PADDED_WARPS + warp_id];
@@ -618,10 +634,10 @@ public:
             WARP_SYNC(0xFFFFFFFF);
 
             // Number of peers having same digit as me
-            int32_t digit_count = __popc(peer_mask);
+            int32_t digit_count = __popcll(peer_mask);
 
             // Number of lower-ranked peers having same digit seen so far
-            int32_t peer_digit_prefix = __popc(peer_mask & lane_mask_lt);
+            int32_t peer_digit_prefix = __popcll(peer_mask & lane_mask_lt);
 
             if (peer_digit_prefix == 0)
             {
@@ -674,7 +690,23 @@ public:
         int             num_bits,                           ///< [in] The number of bits in the current digit
         int             (&exclusive_digit_prefix)[BINS_TRACKED_PER_THREAD])            ///< [out] The exclusive prefix sum for the digits [(threadIdx.x * BINS_TRACKED_PER_THREAD) ... (threadIdx.x * BINS_TRACKED_PER_THREAD) + BINS_TRACKED_PER_THREAD - 1]
     {
-        RankKeys(keys, ranks, current_bit, num_bits);
+        RankKeys(keys, ranks, DigitExtractor<UnsignedBits>(current_bit, num_bits), exclusive_digit_prefix);
+    }
+
+    /**
+     * \brief Rank keys by the digits that \p digit_extractor takes from them.  For the lower \p RADIX_DIGITS threads, digit counts for each digit are provided for the corresponding thread.
+     */
+    template <
+        typename        UnsignedBits,
+        int             KEYS_PER_THREAD,
+        typename        DigitExtractorT>
+    HIPCUB_DEVICE inline void RankKeys(
+        UnsignedBits    (&keys)[KEYS_PER_THREAD],           ///< [in] Keys for this tile
+        int             (&ranks)[KEYS_PER_THREAD],          ///< [out] For each key, the local rank within the tile (out parameter)
+        DigitExtractorT digit_extractor,                    ///< [in] Extracts the current digit of a key
+        int             (&exclusive_digit_prefix)[BINS_TRACKED_PER_THREAD])            ///< [out] The exclusive prefix sum for the digits [(threadIdx.x * BINS_TRACKED_PER_THREAD) ... (threadIdx.x * BINS_TRACKED_PER_THREAD) + BINS_TRACKED_PER_THREAD - 1]
+    {
+        RankKeys(keys, ranks, digit_extractor);
 
         // Get exclusive count for each digit
         #pragma unroll
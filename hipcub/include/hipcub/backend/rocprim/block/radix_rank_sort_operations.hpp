@@ -36,21 +36,186 @@
  #define HIPCUB_ROCPRIM_BLOCK_RADIX_RANK_SORT_OPERATIONS_HPP_
 
 #include <type_traits>
+#include <utility>
 
 #include "../../../config.hpp"
 
+#include "../util_type.hpp"
+
  #include <rocprim/config.hpp>
  #include <rocprim/type_traits.hpp>
  #include <rocprim/detail/various.hpp>
+ #include <rocprim/types/tuple.hpp>
 
 BEGIN_HIPCUB_NAMESPACE
 
-/** \brief Twiddling keys for radix sort. */
-template <bool IS_DESCENDING, typename KeyT>
+#ifndef DOXYGEN_SHOULD_SKIP_THIS    // Do not document
+namespace detail
+{
+
+/// Tuple of references to the fields of \p KeyT returned by \p DecomposerT
+template <typename KeyT, typename DecomposerT>
+using decomposed_key_t = decltype(std::declval<DecomposerT>()(std::declval<KeyT&>()));
+
+/// Number of bits of the fields of a decomposed key, from field \p I on
+template <typename TupleT, int I = 0, int N = ::rocprim::tuple_size<TupleT>::value>
+struct decomposed_key_bits
+{
+    typedef typename std::remove_reference<typename ::rocprim::tuple_element<I, TupleT>::type>::type FieldT;
+    static constexpr int VALUE = int(sizeof(FieldT) * 8) + decomposed_key_bits<TupleT, I + 1, N>::VALUE;
+};
+
+template <typename TupleT, int N>
+struct decomposed_key_bits<TupleT, N, N>
+{
+    static constexpr int VALUE = 0;
+};
+
+/// Applies \p op to the fields of a decomposed key, from the least significant
+/// (last) field to the most significant one, with the bit offset of each field
+template <int I>
+struct decomposed_key_walk
+{
+    template <typename TupleT, typename OpT>
+    static HIPCUB_HOST_DEVICE __forceinline__ void Apply(TupleT fields, OpT& op, int bit_offset = 0)
+    {
+        auto& field = ::rocprim::get<I - 1>(fields);
+        op(field, bit_offset);
+        decomposed_key_walk<I - 1>::Apply(fields, op, bit_offset + int(sizeof(field) * 8));
+    }
+};
+
+template <>
+struct decomposed_key_walk<0>
+{
+    template <typename TupleT, typename OpT>
+    static HIPCUB_HOST_DEVICE __forceinline__ void Apply(TupleT, OpT&, int = 0)
+    {
+    }
+};
+
+template <typename TupleT, typename OpT>
+HIPCUB_HOST_DEVICE __forceinline__ void for_each_decomposed_field(TupleT fields, OpT& op)
+{
+    decomposed_key_walk<::rocprim::tuple_size<TupleT>::value>::Apply(fields, op);
+}
+
+/// Twiddles each field of a decomposed key in place
+template <bool IS_DESCENDING, bool IS_IN>
+struct decomposed_twiddle_op
+{
+    template <typename FieldT>
+    HIPCUB_HOST_DEVICE __forceinline__ void operator()(FieldT& field, int)
+    {
+        typedef Traits<FieldT> TraitsT;
+        typedef typename TraitsT::UnsignedBits UnsignedBits;
+        UnsignedBits& bits = reinterpret_cast<UnsignedBits&>(field);
+        if (IS_IN)
+        {
+            bits = TraitsT::TwiddleIn(bits);
+            if (IS_DESCENDING) bits = ~bits;
+        }
+        else
+        {
+            if (IS_DESCENDING) bits = ~bits;
+            bits = TraitsT::TwiddleOut(bits);
+        }
+    }
+};
+
+/// Sets every bit of each field of a decomposed key
+struct decomposed_fill_op
+{
+    template <typename FieldT>
+    HIPCUB_HOST_DEVICE __forceinline__ void operator()(FieldT& field, int)
+    {
+        typedef typename Traits<FieldT>::UnsignedBits UnsignedBits;
+        reinterpret_cast<UnsignedBits&>(field) = ~UnsignedBits(0);
+    }
+};
+
+/// Gathers the bits [current_bit, current_bit + num_bits) of a decomposed key,
+/// which may span several fields
+struct decomposed_digit_op
+{
+    int current_bit, num_bits;
+    unsigned int digit;
+
+    template <typename FieldT>
+    HIPCUB_HOST_DEVICE __forceinline__ void operator()(FieldT& field, int bit_offset)
+    {
+        typedef typename Traits<FieldT>::UnsignedBits UnsignedBits;
+        constexpr int FIELD_BITS = int(sizeof(FieldT) * 8);
+        const int first = ::rocprim::max(current_bit, bit_offset);
+        const int last  = ::rocprim::min(current_bit + num_bits, bit_offset + FIELD_BITS);
+        if (first < last)
+        {
+            const UnsignedBits bits = reinterpret_cast<const UnsignedBits&>(field);
+            const unsigned int mask = (1u << (last - first)) - 1;
+            digit |= (static_cast<unsigned int>(bits >> (first - bit_offset)) & mask) << (first - current_bit);
+        }
+    }
+};
+
+} // end namespace detail
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * \brief Twiddling keys for radix sort.
+ *
+ * With a \p DecomposerT other than \p NullType, keys are records that the decomposer
+ * exposes as a <tt>::rocprim::tuple</tt> of references to arithmetic fields, most
+ * significant first.  Their bits are the key itself with every field twiddled in place.
+ */
+template <bool IS_DESCENDING, typename KeyT, typename DecomposerT = NullType>
 struct RadixSortTwiddle
+{
+    typedef KeyT UnsignedBits;
+    typedef detail::decomposed_key_t<KeyT, DecomposerT> FieldsT;
+
+    /// Number of bits of the fields of a key
+    static constexpr int KEY_BITS = detail::decomposed_key_bits<typename std::remove_reference<FieldsT>::type>::VALUE;
+
+    DecomposerT decomposer;
+
+    HIPCUB_HOST_DEVICE __forceinline__ RadixSortTwiddle(DecomposerT decomposer = DecomposerT())
+        : decomposer(decomposer)
+    {}
+
+    HIPCUB_HOST_DEVICE __forceinline__ UnsignedBits In(UnsignedBits key) const
+    {
+        detail::decomposed_twiddle_op<IS_DESCENDING, true> op;
+        detail::for_each_decomposed_field(decomposer(key), op);
+        return key;
+    }
+    HIPCUB_HOST_DEVICE __forceinline__ UnsignedBits Out(UnsignedBits key) const
+    {
+        detail::decomposed_twiddle_op<IS_DESCENDING, false> op;
+        detail::for_each_decomposed_field(decomposer(key), op);
+        return key;
+    }
+    /// Twiddled key that ranks after every other key
+    HIPCUB_HOST_DEVICE __forceinline__ UnsignedBits MaxBits() const
+    {
+        UnsignedBits key = UnsignedBits();
+        detail::decomposed_fill_op op;
+        detail::for_each_decomposed_field(decomposer(key), op);
+        return key;
+    }
+};
+
+template <bool IS_DESCENDING, typename KeyT>
+struct RadixSortTwiddle<IS_DESCENDING, KeyT, NullType>
 {
     typedef Traits<KeyT> TraitsT;
     typedef typename TraitsT::UnsignedBits UnsignedBits;
+
+    /// Number of bits of a key
+    static constexpr int KEY_BITS = int(sizeof(KeyT) * 8);
+
+    HIPCUB_HOST_DEVICE __forceinline__ RadixSortTwiddle(NullType = NullType())
+    {}
+
     static HIPCUB_HOST_DEVICE __forceinline__ UnsignedBits In(UnsignedBits key)
     {
         key = TraitsT::TwiddleIn(key);
@@ -67,15 +232,45 @@ struct RadixSortTwiddle
     {
         return Out(~UnsignedBits(0));
     }
+    /// Twiddled key that ranks after every other key
+    static HIPCUB_HOST_DEVICE __forceinline__ UnsignedBits MaxBits()
+    {
+        return ~UnsignedBits(0);
+    }
 };
 
-/** \brief Stateful abstraction to extract digits. */
-template <typename UnsignedBits>
+/**
+ * \brief Stateful abstraction to extract digits.
+ *
+ * With a \p DecomposerT other than \p NullType, digits are taken from the twiddled
+ * fields of a decomposed key as if the fields were concatenated, the first one
+ * most significant.
+ */
+template <typename UnsignedBits, typename DecomposerT = NullType>
 struct DigitExtractor
+{
+    int current_bit, num_bits;
+    DecomposerT decomposer;
+
+    HIPCUB_DEVICE __inline__ DigitExtractor() : current_bit(0), num_bits(0), decomposer() {}
+    HIPCUB_DEVICE __inline__ DigitExtractor(int current_bit, int num_bits, DecomposerT decomposer = DecomposerT())
+        : current_bit(current_bit), num_bits(num_bits), decomposer(decomposer)
+    { }
+
+    HIPCUB_DEVICE __inline__ int Digit(UnsignedBits key)
+    {
+        detail::decomposed_digit_op op = { current_bit, num_bits, 0u };
+        detail::for_each_decomposed_field(decomposer(key), op);
+        return int(op.digit);
+    }
+};
+
+template <typename UnsignedBits>
+struct DigitExtractor<UnsignedBits, NullType>
 {
     int current_bit, mask;
     HIPCUB_DEVICE __inline__ DigitExtractor() : current_bit(0), mask(0) {}
-    HIPCUB_DEVICE __inline__ DigitExtractor(int current_bit, int num_bits)
+    HIPCUB_DEVICE __inline__ DigitExtractor(int current_bit, int num_bits, NullType = NullType())
         : current_bit(current_bit), mask((1 << num_bits) - 1)
     { }
 
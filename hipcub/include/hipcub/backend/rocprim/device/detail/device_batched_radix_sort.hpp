@@ -0,0 +1,585 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_BATCHED_RADIX_SORT_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_BATCHED_RADIX_SORT_HPP_
+
+#include <limits>
+#include <type_traits>
+
+#include "../../../../config.hpp"
+
+#include "../../util_type.hpp"
+#include "../../block/block_load.hpp"
+#include "../../block/block_radix_sort.hpp"
+#include "../../block/block_store_func.hpp"
+#include "../../block/radix_rank_sort_operations.hpp"
+
+#include <rocprim/device/device_segmented_radix_sort.hpp>
+#include <rocprim/iterator/counting_iterator.hpp>
+#include <rocprim/iterator/transform_iterator.hpp>
+
+BEGIN_HIPCUB_NAMESPACE
+namespace detail
+{
+
+/// Longest segments sorted by a single block, in registers and shared memory
+constexpr int batched_radix_sort_max_segment_length = 4096;
+
+/**
+ * Tuning of the batched radix sort of segments of up to \p SEGMENT_LENGTH items.
+ *
+ * A block loads a whole segment, sorts it with BlockRadixSort and stores it, so
+ * that all segments are sorted by one launch.  Blocks are as small as allows a tile
+ * of no more than 16 items per thread, with as few padding items as possible.
+ */
+template <int SEGMENT_LENGTH>
+struct BatchedRadixSortPolicy
+{
+    static constexpr int BLOCK_THREADS      =
+        (SEGMENT_LENGTH <= 256) ? 64 : ((SEGMENT_LENGTH <= 512) ? 128 : 256);
+    static constexpr int ITEMS_PER_THREAD   =
+        (SEGMENT_LENGTH <= BLOCK_THREADS) ? 1 : ((SEGMENT_LENGTH + BLOCK_THREADS - 1) / BLOCK_THREADS);
+    static constexpr int TILE_ITEMS         = BLOCK_THREADS * ITEMS_PER_THREAD;
+
+    static_assert(SEGMENT_LENGTH <= batched_radix_sort_max_segment_length,
+                  "Longer segments are not sorted by a single block");
+};
+
+/// Loads the values of a segment, nothing for keys only
+template <typename BlockLoadT, typename ValueT, int ITEMS_PER_THREAD>
+HIPCUB_DEVICE __forceinline__ void BatchedRadixSortLoadValues(
+    Int2Type<false>                     /*keys_only*/,
+    typename BlockLoadT::TempStorage&   temp_storage,
+    const ValueT*                       d_values_in,
+    ValueT                              (&values)[ITEMS_PER_THREAD],
+    int                                 valid_items)
+{
+    BlockLoadT(temp_storage).Load(d_values_in, values, valid_items);
+}
+
+template <typename BlockLoadT, typename ValueT, int ITEMS_PER_THREAD>
+HIPCUB_DEVICE __forceinline__ void BatchedRadixSortLoadValues(
+    Int2Type<true>                      /*keys_only*/,
+    typename BlockLoadT::TempStorage&,
+    const ValueT*,
+    ValueT                              (&)[ITEMS_PER_THREAD],
+    int)
+{
+}
+
+/**
+ * Sorts segment \p blockIdx.x, of \p segment_length items from
+ * <tt>blockIdx.x * segment_stride</tt> on, with one block.
+ */
+template <
+    typename    Policy,
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceBatchedRadixSortKernel(
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    int             segment_length,
+    int             segment_stride,
+    int             begin_bit,
+    int             end_bit)
+{
+    constexpr int  BLOCK_THREADS    = Policy::BLOCK_THREADS;
+    constexpr int  ITEMS_PER_THREAD = Policy::ITEMS_PER_THREAD;
+    constexpr bool KEYS_ONLY        = std::is_same<ValueT, NullType>::value;
+
+    typedef RadixSortTwiddle<IS_DESCENDING, KeyT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+    typedef BlockLoad<KeyT, BLOCK_THREADS, ITEMS_PER_THREAD, BLOCK_LOAD_WARP_TRANSPOSE> BlockLoadKeysT;
+    typedef BlockLoad<typename std::conditional<KEYS_ONLY, KeyT, ValueT>::type,
+                      BLOCK_THREADS, ITEMS_PER_THREAD, BLOCK_LOAD_WARP_TRANSPOSE> BlockLoadValuesT;
+    typedef BlockRadixSort<KeyT, BLOCK_THREADS, ITEMS_PER_THREAD, ValueT> BlockRadixSortT;
+
+    struct _TempStorage
+    {
+        union
+        {
+            typename BlockLoadKeysT::TempStorage    load_keys;
+            typename BlockLoadValuesT::TempStorage  load_values;
+            typename BlockRadixSortT::TempStorage   sort;
+        } aliasable;
+    };
+
+    __shared__ Uninitialized<_TempStorage> temp_storage_raw;
+    _TempStorage& temp_storage = temp_storage_raw.Alias();
+
+    const size_t segment_offset = size_t(hipBlockIdx_x) * size_t(segment_stride);
+
+    // Padding sorts after every valid key, so the valid keys stay first and in order
+    KeyT oob_key;
+    reinterpret_cast<UnsignedBits&>(oob_key) = TwiddleT::DefaultKey();
+
+    KeyT   keys[ITEMS_PER_THREAD];
+    ValueT values[ITEMS_PER_THREAD];
+    BlockLoadKeysT(temp_storage.aliasable.load_keys).Load(
+        d_keys_in + segment_offset, keys, segment_length, oob_key);
+    if (!KEYS_ONLY)
+    {
+        ::rocprim::syncthreads();
+        BatchedRadixSortLoadValues<BlockLoadValuesT>(
+            Int2Type<KEYS_ONLY>(), temp_storage.aliasable.load_values, d_values_in + segment_offset, values, segment_length);
+    }
+    ::rocprim::syncthreads();
+
+    // Sorted to a striped arrangement, so that stores are coalesced
+    BlockRadixSortT block_sort(temp_storage.aliasable.sort);
+    if (IS_DESCENDING)
+    {
+        if (KEYS_ONLY) block_sort.SortDescendingBlockedToStriped(keys, begin_bit, end_bit);
+        else           block_sort.SortDescendingBlockedToStriped(keys, values, begin_bit, end_bit);
+    }
+    else
+    {
+        if (KEYS_ONLY) block_sort.SortBlockedToStriped(keys, begin_bit, end_bit);
+        else           block_sort.SortBlockedToStriped(keys, values, begin_bit, end_bit);
+    }
+
+    StoreDirectStriped<BLOCK_THREADS>(hipThreadIdx_x, d_keys_out + segment_offset, keys, segment_length);
+    if (!KEYS_ONLY)
+    {
+        StoreDirectStriped<BLOCK_THREADS>(hipThreadIdx_x, d_values_out + segment_offset, values, segment_length);
+    }
+}
+
+/// Offset of segment \p i, \p shift items after its beginning
+struct BatchedRadixSortOffsetOp
+{
+    unsigned int segment_stride;
+    unsigned int shift;
+
+    HIPCUB_HOST_DEVICE __forceinline__ unsigned int operator()(unsigned int i) const
+    {
+        return (i * segment_stride) + shift;
+    }
+};
+
+/// Sorts the segments with a block each, whatever their length
+template <
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    BeginOffsetIteratorT,
+    typename    EndOffsetIteratorT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t BatchedRadixSortSegmented(
+    void*                   d_temp_storage,
+    size_t&                 temp_storage_bytes,
+    const KeyT*             d_keys_in,
+    KeyT*                   d_keys_out,
+    const NullType*         ,
+    NullType*               ,
+    unsigned int            num_items,
+    unsigned int            num_segments,
+    BeginOffsetIteratorT    d_begin_offsets,
+    EndOffsetIteratorT      d_end_offsets,
+    int                     begin_bit,
+    int                     end_bit,
+    hipStream_t             stream,
+    bool                    debug_synchronous)
+{
+    return IS_DESCENDING
+        ? ::rocprim::segmented_radix_sort_keys_desc(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, num_items,
+            num_segments, d_begin_offsets, d_end_offsets,
+            begin_bit, end_bit,
+            stream, debug_synchronous)
+        : ::rocprim::segmented_radix_sort_keys(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, num_items,
+            num_segments, d_begin_offsets, d_end_offsets,
+            begin_bit, end_bit,
+            stream, debug_synchronous);
+}
+
+template <
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT,
+    typename    BeginOffsetIteratorT,
+    typename    EndOffsetIteratorT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t BatchedRadixSortSegmented(
+    void*                   d_temp_storage,
+    size_t&                 temp_storage_bytes,
+    const KeyT*             d_keys_in,
+    KeyT*                   d_keys_out,
+    const ValueT*           d_values_in,
+    ValueT*                 d_values_out,
+    unsigned int            num_items,
+    unsigned int            num_segments,
+    BeginOffsetIteratorT    d_begin_offsets,
+    EndOffsetIteratorT      d_end_offsets,
+    int                     begin_bit,
+    int                     end_bit,
+    hipStream_t             stream,
+    bool                    debug_synchronous)
+{
+    return IS_DESCENDING
+        ? ::rocprim::segmented_radix_sort_pairs_desc(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out, num_items,
+            num_segments, d_begin_offsets, d_end_offsets,
+            begin_bit, end_bit,
+            stream, debug_synchronous)
+        : ::rocprim::segmented_radix_sort_pairs(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out, num_items,
+            num_segments, d_begin_offsets, d_end_offsets,
+            begin_bit, end_bit,
+            stream, debug_synchronous);
+}
+
+/**
+ * Sorts segments of any length with the segmented radix sort, the offsets of the
+ * segments computed on the fly instead of read from arrays.
+ */
+template <
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t BatchedRadixSortLong(
+    void*           d_temp_storage,
+    size_t&         temp_storage_bytes,
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    int             num_segments,
+    int             segment_length,
+    int             segment_stride,
+    int             begin_bit,
+    int             end_bit,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    typedef ::rocprim::transform_iterator<
+        ::rocprim::counting_iterator<unsigned int>, BatchedRadixSortOffsetOp, unsigned int> OffsetIteratorT;
+
+    // The offsets of all segments must fit in 32 bits
+    const unsigned long long num_items = (num_segments == 0) ? 0ull :
+        (static_cast<unsigned long long>(num_segments - 1) * segment_stride) + segment_length;
+    if (num_items > static_cast<unsigned long long>(std::numeric_limits<unsigned int>::max()))
+    {
+        return hipErrorInvalidValue;
+    }
+
+    OffsetIteratorT d_begin_offsets(::rocprim::counting_iterator<unsigned int>(0),
+        BatchedRadixSortOffsetOp{ static_cast<unsigned int>(segment_stride), 0u });
+    OffsetIteratorT d_end_offsets(::rocprim::counting_iterator<unsigned int>(0),
+        BatchedRadixSortOffsetOp{ static_cast<unsigned int>(segment_stride), static_cast<unsigned int>(segment_length) });
+
+    return BatchedRadixSortSegmented<IS_DESCENDING>(
+        d_temp_storage, temp_storage_bytes,
+        d_keys_in, d_keys_out, d_values_in, d_values_out,
+        static_cast<unsigned int>(num_items), static_cast<unsigned int>(num_segments),
+        d_begin_offsets, d_end_offsets,
+        begin_bit, end_bit,
+        stream, debug_synchronous);
+}
+
+/**
+ * Sorts segments of up to <tt>Policy::TILE_ITEMS</tt> items with a block each, in a
+ * single launch.  No temporary storage is used.
+ */
+template <
+    typename    Policy,
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t BatchedRadixSortBlocks(
+    void*           d_temp_storage,
+    size_t&         temp_storage_bytes,
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    int             num_segments,
+    int             segment_length,
+    int             segment_stride,
+    int             begin_bit,
+    int             end_bit,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    // A single byte, so that the storage can be allocated
+    if (d_temp_storage == nullptr)
+    {
+        temp_storage_bytes = 1;
+        return hipSuccess;
+    }
+
+    if ((num_segments == 0) || (segment_length == 0))
+    {
+        return hipSuccess;
+    }
+
+    hipError_t error = hipSuccess;
+
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(DeviceBatchedRadixSortKernel<Policy, IS_DESCENDING, KeyT, ValueT>),
+        dim3(num_segments), dim3(Policy::BLOCK_THREADS), 0, stream,
+        d_keys_in, d_keys_out, d_values_in, d_values_out,
+        segment_length, segment_stride, begin_bit, end_bit);
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    return error;
+}
+
+/// Whether the segments are well formed and do not overlap
+inline bool BatchedRadixSortValid(
+    int num_segments,
+    int segment_length,
+    int segment_stride)
+{
+    return (num_segments >= 0) && (segment_length >= 0)
+        && ((num_segments <= 1) || (segment_stride >= segment_length));
+}
+
+/**
+ * Picks the block sort of the shortest compiled length, from \p LENGTH on and
+ * doubling, that the segments fit in, or the segmented radix sort past the longest.
+ */
+template <int LENGTH, bool IS_DESCENDING>
+struct BatchedRadixSortDispatch
+{
+    template <typename KeyT, typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t Sort(
+        void*           d_temp_storage,
+        size_t&         temp_storage_bytes,
+        const KeyT*     d_keys_in,
+        KeyT*           d_keys_out,
+        const ValueT*   d_values_in,
+        ValueT*         d_values_out,
+        int             num_segments,
+        int             segment_length,
+        int             segment_stride,
+        int             begin_bit,
+        int             end_bit,
+        hipStream_t     stream,
+        bool            debug_synchronous)
+    {
+        if (segment_length <= LENGTH)
+        {
+            return BatchedRadixSortBlocks<BatchedRadixSortPolicy<LENGTH>, IS_DESCENDING>(
+                d_temp_storage, temp_storage_bytes,
+                d_keys_in, d_keys_out, d_values_in, d_values_out,
+                num_segments, segment_length, segment_stride,
+                begin_bit, end_bit,
+                stream, debug_synchronous);
+        }
+        return BatchedRadixSortDispatch<LENGTH * 2, IS_DESCENDING>::Sort(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            num_segments, segment_length, segment_stride,
+            begin_bit, end_bit,
+            stream, debug_synchronous);
+    }
+};
+
+template <bool IS_DESCENDING>
+struct BatchedRadixSortDispatch<batched_radix_sort_max_segment_length * 2, IS_DESCENDING>
+{
+    template <typename KeyT, typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t Sort(
+        void*           d_temp_storage,
+        size_t&         temp_storage_bytes,
+        const KeyT*     d_keys_in,
+        KeyT*           d_keys_out,
+        const ValueT*   d_values_in,
+        ValueT*         d_values_out,
+        int             num_segments,
+        int             segment_length,
+        int             segment_stride,
+        int             begin_bit,
+        int             end_bit,
+        hipStream_t     stream,
+        bool            debug_synchronous)
+    {
+        return BatchedRadixSortLong<IS_DESCENDING>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            num_segments, segment_length, segment_stride,
+            begin_bit, end_bit,
+            stream, debug_synchronous);
+    }
+};
+
+/**
+ * Sorts \p num_segments segments of \p segment_length items, segment \p i from
+ * <tt>i * segment_stride</tt> on in the input and the output.  Items between
+ * segments are left untouched.
+ */
+template <
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t BatchedRadixSort(
+    void*           d_temp_storage,
+    size_t&         temp_storage_bytes,
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    int             num_segments,
+    int             segment_length,
+    int             segment_stride,
+    int             begin_bit,
+    int             end_bit,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    if (!BatchedRadixSortValid(num_segments, segment_length, segment_stride))
+    {
+        return hipErrorInvalidValue;
+    }
+
+    return BatchedRadixSortDispatch<128, IS_DESCENDING>::Sort(
+        d_temp_storage, temp_storage_bytes,
+        d_keys_in, d_keys_out, d_values_in, d_values_out,
+        num_segments, segment_length, segment_stride,
+        begin_bit, end_bit,
+        stream, debug_synchronous);
+}
+
+template <
+    int         SEGMENT_LENGTH,
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t BatchedRadixSortFixed(
+    std::true_type          /* fits_block */,
+    void*           d_temp_storage,
+    size_t&         temp_storage_bytes,
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    int             num_segments,
+    int             segment_stride,
+    int             begin_bit,
+    int             end_bit,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    return BatchedRadixSortBlocks<BatchedRadixSortPolicy<SEGMENT_LENGTH>, IS_DESCENDING>(
+        d_temp_storage, temp_storage_bytes,
+        d_keys_in, d_keys_out, d_values_in, d_values_out,
+        num_segments, SEGMENT_LENGTH, segment_stride,
+        begin_bit, end_bit,
+        stream, debug_synchronous);
+}
+
+template <
+    int         SEGMENT_LENGTH,
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t BatchedRadixSortFixed(
+    std::false_type         /* fits_block */,
+    void*           d_temp_storage,
+    size_t&         temp_storage_bytes,
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    int             num_segments,
+    int             segment_stride,
+    int             begin_bit,
+    int             end_bit,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    return BatchedRadixSortLong<IS_DESCENDING>(
+        d_temp_storage, temp_storage_bytes,
+        d_keys_in, d_keys_out, d_values_in, d_values_out,
+        num_segments, SEGMENT_LENGTH, segment_stride,
+        begin_bit, end_bit,
+        stream, debug_synchronous);
+}
+
+/**
+ * As BatchedRadixSort, for segments of \p SEGMENT_LENGTH items known at compile
+ * time: the block sort is tuned to that length, and no other one is compiled.
+ */
+template <
+    int         SEGMENT_LENGTH,
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t BatchedRadixSort(
+    void*           d_temp_storage,
+    size_t&         temp_storage_bytes,
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    int             num_segments,
+    int             segment_stride,
+    int             begin_bit,
+    int             end_bit,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    static_assert(SEGMENT_LENGTH > 0, "Segments must not be empty");
+
+    if (!BatchedRadixSortValid(num_segments, SEGMENT_LENGTH, segment_stride))
+    {
+        return hipErrorInvalidValue;
+    }
+
+    return BatchedRadixSortFixed<SEGMENT_LENGTH, IS_DESCENDING>(
+        std::integral_constant<bool, (SEGMENT_LENGTH <= batched_radix_sort_max_segment_length)>(),
+        d_temp_storage, temp_storage_bytes,
+        d_keys_in, d_keys_out, d_values_in, d_values_out,
+        num_segments, segment_stride,
+        begin_bit, end_bit,
+        stream, debug_synchronous);
+}
+
+} // end namespace detail
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_BATCHED_RADIX_SORT_HPP_
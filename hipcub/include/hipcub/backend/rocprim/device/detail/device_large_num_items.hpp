@@ -0,0 +1,613 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_LARGE_NUM_ITEMS_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_LARGE_NUM_ITEMS_HPP_
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "../../../../config.hpp"
+#include "../../../../util_temp_storage.hpp"
+
+#include <rocprim/device/device_reduce.hpp>
+#include <rocprim/device/device_scan.hpp>
+#include <rocprim/device/device_select.hpp>
+#include <rocprim/iterator/counting_iterator.hpp>
+#include <rocprim/iterator/transform_iterator.hpp>
+
+BEGIN_HIPCUB_NAMESPACE
+namespace detail
+{
+
+// Device-wide calls are forwarded to rocPRIM in a single call while num_items fits
+// in an int, as they have always been.  Larger inputs are processed in chunks of
+// this many items, which every rocPRIM algorithm handles with 32-bit offsets.
+constexpr size_t large_num_items_chunk = size_t(1) << 30;
+
+template<class NumItemsT>
+inline
+bool num_items_negative(NumItemsT num_items, std::true_type /* signed */)
+{
+    return num_items < NumItemsT(0);
+}
+
+template<class NumItemsT>
+inline
+bool num_items_negative(NumItemsT, std::false_type /* signed */)
+{
+    return false;
+}
+
+template<class NumItemsT>
+inline
+bool num_items_negative(NumItemsT num_items)
+{
+    static_assert(std::is_integral<NumItemsT>::value, "num_items must be of an integral type");
+    return num_items_negative(num_items, std::integral_constant<bool, std::is_signed<NumItemsT>::value>());
+}
+
+// Whether num_items is non-negative and representable as a Limit
+template<class Limit, class NumItemsT>
+inline
+bool num_items_fit(NumItemsT num_items)
+{
+    return !num_items_negative(num_items)
+        && static_cast<unsigned long long>(num_items)
+            <= static_cast<unsigned long long>(std::numeric_limits<Limit>::max());
+}
+
+// Whether every value of NumItemsT is representable as an int
+template<class NumItemsT>
+using num_items_int_range = std::integral_constant<
+    bool,
+    (sizeof(NumItemsT) < sizeof(int))
+        || ((sizeof(NumItemsT) == sizeof(int)) && std::is_signed<NumItemsT>::value)
+>;
+
+template<class NumItemsT, class SmallCall, class LargeCall>
+inline
+hipError_t dispatch_num_items(NumItemsT num_items,
+                              SmallCall small_call,
+                              LargeCall,
+                              std::true_type /* int range */)
+{
+    if(num_items_negative(num_items))
+    {
+        return hipErrorInvalidValue;
+    }
+    return small_call(static_cast<size_t>(num_items));
+}
+
+template<class NumItemsT, class SmallCall, class LargeCall>
+inline
+hipError_t dispatch_num_items(NumItemsT num_items,
+                              SmallCall small_call,
+                              LargeCall large_call,
+                              std::false_type /* int range */)
+{
+    if(num_items_fit<int>(num_items))
+    {
+        return small_call(static_cast<size_t>(num_items));
+    }
+    if(num_items_negative(num_items))
+    {
+        return hipErrorInvalidValue;
+    }
+    return large_call(static_cast<size_t>(num_items));
+}
+
+// Runs small_call(size) if num_items fits in an int and large_call(size) otherwise,
+// with size the number of items as a size_t.  The choice is made at compile time
+// for types that cannot exceed an int, so a generic large_call is then not even
+// instantiated.  Negative num_items return hipErrorInvalidValue.
+template<class NumItemsT, class SmallCall, class LargeCall>
+inline
+hipError_t dispatch_num_items(NumItemsT num_items,
+                              SmallCall small_call,
+                              LargeCall large_call)
+{
+    return dispatch_num_items(num_items, small_call, large_call, num_items_int_range<NumItemsT>());
+}
+
+// Lays out the buffers of plan in d_temp_storage, which need not be aligned.  With a
+// NULL d_temp_storage only stores the number of bytes required.
+inline
+hipError_t alias_temporaries(void * d_temp_storage,
+                             size_t& temp_storage_bytes,
+                             TempStoragePlan& plan)
+{
+    const size_t required_bytes = plan.ArenaBytes() + plan.alignment - 1;
+    if(d_temp_storage == nullptr)
+    {
+        temp_storage_bytes = required_bytes;
+        return hipSuccess;
+    }
+    if(temp_storage_bytes < required_bytes)
+    {
+        return hipErrorInvalidValue;
+    }
+    const uintptr_t aligned =
+        (reinterpret_cast<uintptr_t>(d_temp_storage) + plan.alignment - 1) & ~uintptr_t(plan.alignment - 1);
+    return plan.Bind(reinterpret_cast<void *>(aligned), plan.ArenaBytes());
+}
+
+/// Output iterator writing at an offset read from device memory when accessed
+template<class OutputIteratorT, class OffsetT>
+class device_offset_output_iterator
+{
+public:
+    using value_type = typename std::iterator_traits<OutputIteratorT>::value_type;
+    using reference = decltype(std::declval<OutputIteratorT&>()[0]);
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
+
+    HIPCUB_HOST_DEVICE inline
+    device_offset_output_iterator(OutputIteratorT output,
+                                  const OffsetT * d_offset,
+                                  difference_type index = 0)
+        : output_(output), d_offset_(d_offset), index_(index)
+    {
+    }
+
+    HIPCUB_HOST_DEVICE inline
+    reference operator*() const
+    {
+        return output_[*d_offset_ + index_];
+    }
+
+    HIPCUB_HOST_DEVICE inline
+    reference operator[](difference_type n) const
+    {
+        return output_[*d_offset_ + index_ + n];
+    }
+
+    HIPCUB_HOST_DEVICE inline
+    device_offset_output_iterator& operator++()
+    {
+        index_++;
+        return *this;
+    }
+
+    HIPCUB_HOST_DEVICE inline
+    device_offset_output_iterator operator++(int)
+    {
+        device_offset_output_iterator old = *this;
+        index_++;
+        return old;
+    }
+
+    HIPCUB_HOST_DEVICE inline
+    device_offset_output_iterator& operator+=(difference_type n)
+    {
+        index_ += n;
+        return *this;
+    }
+
+    HIPCUB_HOST_DEVICE inline
+    device_offset_output_iterator operator+(difference_type n) const
+    {
+        return device_offset_output_iterator(output_, d_offset_, index_ + n);
+    }
+
+    HIPCUB_HOST_DEVICE inline
+    device_offset_output_iterator operator-(difference_type n) const
+    {
+        return device_offset_output_iterator(output_, d_offset_, index_ - n);
+    }
+
+    HIPCUB_HOST_DEVICE inline
+    difference_type operator-(const device_offset_output_iterator& other) const
+    {
+        return index_ - other.index_;
+    }
+
+    HIPCUB_HOST_DEVICE inline
+    bool operator==(const device_offset_output_iterator& other) const
+    {
+        return index_ == other.index_;
+    }
+
+    HIPCUB_HOST_DEVICE inline
+    bool operator!=(const device_offset_output_iterator& other) const
+    {
+        return index_ != other.index_;
+    }
+
+private:
+    OutputIteratorT output_;
+    const OffsetT * d_offset_;
+    difference_type index_;
+};
+
+// Item i of a chunk of a scan, with the aggregate of all previous chunks folded into
+// the first item
+template<class InputIteratorT, class AccT, class ScanOpT>
+struct scan_carry_op
+{
+    InputIteratorT input;
+    const AccT * d_carry;
+    ScanOpT scan_op;
+
+    HIPCUB_HOST_DEVICE inline
+    AccT operator()(size_t i) const
+    {
+        return (i == 0) ? static_cast<AccT>(scan_op(*d_carry, static_cast<AccT>(input[0])))
+                        : static_cast<AccT>(input[i]);
+    }
+};
+
+// Whether item i of the input starts a run of equal items
+template<class InputIteratorT, class EqualityOpT>
+struct unique_flag_op
+{
+    InputIteratorT input;
+    EqualityOpT equality_op;
+
+    HIPCUB_HOST_DEVICE inline
+    bool operator()(size_t i) const
+    {
+        return (i == 0) || !equality_op(input[i - 1], input[i]);
+    }
+};
+
+/// Reduces num_items items in chunks: every chunk to a partial of type AccT, then the
+/// partials with init
+template<
+    class AccT,
+    class InputIteratorT,
+    class OutputIteratorT,
+    class InitT,
+    class ReduceOpT
+>
+inline
+hipError_t reduce_large(void * d_temp_storage,
+                        size_t& temp_storage_bytes,
+                        InputIteratorT d_in,
+                        OutputIteratorT d_out,
+                        size_t num_items,
+                        ReduceOpT reduce_op,
+                        InitT init,
+                        hipStream_t stream,
+                        bool debug_synchronous,
+                        size_t chunk_items = large_num_items_chunk)
+{
+    const size_t num_chunks = (num_items + chunk_items - 1) / chunk_items;
+
+    size_t chunk_bytes = 0;
+    size_t final_bytes = 0;
+    hipError_t error = ::rocprim::reduce(
+        nullptr, chunk_bytes, d_in, static_cast<AccT *>(nullptr),
+        std::min(num_items, chunk_items), reduce_op, stream, debug_synchronous
+    );
+    if(error != hipSuccess) return error;
+    error = ::rocprim::reduce(
+        nullptr, final_bytes, static_cast<AccT *>(nullptr), d_out, init,
+        num_chunks, reduce_op, stream, debug_synchronous
+    );
+    if(error != hipSuccess) return error;
+
+    TempStoragePlan plan;
+    TempStoragePlan::Buffer partials, storage;
+    plan.Reserve(partials, num_chunks * sizeof(AccT), 0);
+    plan.Reserve(storage, std::max(chunk_bytes, final_bytes), 0);
+    if((error = alias_temporaries(d_temp_storage, temp_storage_bytes, plan)) != hipSuccess
+        || d_temp_storage == nullptr)
+    {
+        return error;
+    }
+
+    AccT * d_partials = plan.Pointer<AccT>(partials);
+    for(size_t chunk = 0; chunk < num_chunks; chunk++)
+    {
+        const size_t begin = chunk * chunk_items;
+        size_t bytes = plan.Bytes(storage);
+        error = ::rocprim::reduce(
+            plan.Pointer(storage), bytes, d_in + begin, d_partials + chunk,
+            std::min(chunk_items, num_items - begin), reduce_op, stream, debug_synchronous
+        );
+        if(error != hipSuccess) return error;
+    }
+    size_t bytes = plan.Bytes(storage);
+    return ::rocprim::reduce(
+        plan.Pointer(storage), bytes, d_partials, d_out, init,
+        num_chunks, reduce_op, stream, debug_synchronous
+    );
+}
+
+/// Scans one chunk with the rocPRIM scan selected by the tag, so that only that scan
+/// is instantiated
+template<class InputIteratorT, class OutputIteratorT, class InitT, class ScanOpT>
+inline
+hipError_t scan_chunk_op(std::true_type /* exclusive */,
+                         void * storage,
+                         size_t& bytes,
+                         InputIteratorT input,
+                         OutputIteratorT output,
+                         InitT init,
+                         size_t size,
+                         ScanOpT scan_op,
+                         hipStream_t stream,
+                         bool debug_synchronous)
+{
+    return ::rocprim::exclusive_scan(
+        storage, bytes, input, output, init,
+        size, scan_op, stream, debug_synchronous);
+}
+
+template<class InputIteratorT, class OutputIteratorT, class InitT, class ScanOpT>
+inline
+hipError_t scan_chunk_op(std::false_type /* exclusive */,
+                         void * storage,
+                         size_t& bytes,
+                         InputIteratorT input,
+                         OutputIteratorT output,
+                         InitT,
+                         size_t size,
+                         ScanOpT scan_op,
+                         hipStream_t stream,
+                         bool debug_synchronous)
+{
+    return ::rocprim::inclusive_scan(
+        storage, bytes, input, output,
+        size, scan_op, stream, debug_synchronous);
+}
+
+/// Scans num_items items in chunks.  The aggregates of all chunks but the last are
+/// reduced and scanned first, then every chunk is scanned with the aggregate of the
+/// chunks before it folded into its first item.  Every call reads and writes the same
+/// positions, so the scan may be performed in place.
+template<
+    bool Exclusive,
+    class AccT,
+    class InputIteratorT,
+    class OutputIteratorT,
+    class InitT,
+    class ScanOpT
+>
+inline
+hipError_t scan_large(void * d_temp_storage,
+                      size_t& temp_storage_bytes,
+                      InputIteratorT d_in,
+                      OutputIteratorT d_out,
+                      size_t num_items,
+                      ScanOpT scan_op,
+                      InitT init,
+                      hipStream_t stream,
+                      bool debug_synchronous,
+                      size_t chunk_items = large_num_items_chunk)
+{
+    using carry_iterator = ::rocprim::transform_iterator<
+        ::rocprim::counting_iterator<size_t>, scan_carry_op<InputIteratorT, AccT, ScanOpT>, AccT
+    >;
+
+    const size_t num_chunks = (num_items + chunk_items - 1) / chunk_items;
+    const size_t max_chunk = std::min(num_items, chunk_items);
+
+    // Scans a chunk, as an exclusive scan of a chunk after the first starts with init
+    // instead of init combined with the carry, which is written by a single-item
+    // reduction afterwards
+    auto scan_chunk = [&](void * storage, size_t& bytes,
+                          auto input, OutputIteratorT output, size_t size)
+    {
+        return scan_chunk_op(
+            std::integral_constant<bool, Exclusive>(),
+            storage, bytes, input, output, init,
+            size, scan_op, stream, debug_synchronous);
+    };
+    auto carry_input = [&](size_t begin, const AccT * d_carry)
+    {
+        return carry_iterator(
+            ::rocprim::counting_iterator<size_t>(0),
+            scan_carry_op<InputIteratorT, AccT, ScanOpT>{ d_in + begin, d_carry, scan_op }
+        );
+    };
+
+    // Every call below runs with the same temporary storage
+    size_t storage_bytes = 0;
+    size_t bytes = 0;
+    hipError_t error = ::rocprim::reduce(
+        nullptr, bytes, d_in, static_cast<AccT *>(nullptr),
+        max_chunk, scan_op, stream, debug_synchronous
+    );
+    if(error != hipSuccess) return error;
+    storage_bytes = std::max(storage_bytes, bytes);
+
+    error = ::rocprim::inclusive_scan(
+        nullptr, bytes, static_cast<AccT *>(nullptr), static_cast<AccT *>(nullptr),
+        num_chunks, scan_op, stream, debug_synchronous
+    );
+    if(error != hipSuccess) return error;
+    storage_bytes = std::max(storage_bytes, bytes);
+
+    if((error = scan_chunk(nullptr, bytes, d_in, d_out, max_chunk)) != hipSuccess) return error;
+    storage_bytes = std::max(storage_bytes, bytes);
+
+    if((error = scan_chunk(nullptr, bytes, carry_input(0, nullptr), d_out, max_chunk)) != hipSuccess) return error;
+    storage_bytes = std::max(storage_bytes, bytes);
+
+    if(Exclusive)
+    {
+        error = ::rocprim::reduce(
+            nullptr, bytes, static_cast<const AccT *>(nullptr), d_out, init,
+            1, scan_op, stream, debug_synchronous
+        );
+        if(error != hipSuccess) return error;
+        storage_bytes = std::max(storage_bytes, bytes);
+    }
+
+    TempStoragePlan plan;
+    TempStoragePlan::Buffer partials, storage;
+    plan.Reserve(partials, num_chunks * sizeof(AccT), 0);
+    plan.Reserve(storage, storage_bytes, 0);
+    if((error = alias_temporaries(d_temp_storage, temp_storage_bytes, plan)) != hipSuccess
+        || d_temp_storage == nullptr)
+    {
+        return error;
+    }
+
+    // Aggregates of the chunks before the last, scanned in place.  They are computed
+    // before any output is written.
+    AccT * d_partials = plan.Pointer<AccT>(partials);
+    for(size_t chunk = 0; chunk + 1 < num_chunks; chunk++)
+    {
+        bytes = plan.Bytes(storage);
+        error = ::rocprim::reduce(
+            plan.Pointer(storage), bytes, d_in + chunk * chunk_items, d_partials + chunk,
+            chunk_items, scan_op, stream, debug_synchronous
+        );
+        if(error != hipSuccess) return error;
+    }
+    if(num_chunks > 1)
+    {
+        bytes = plan.Bytes(storage);
+        error = ::rocprim::inclusive_scan(
+            plan.Pointer(storage), bytes, d_partials, d_partials,
+            num_chunks - 1, scan_op, stream, debug_synchronous
+        );
+        if(error != hipSuccess) return error;
+    }
+
+    // The first chunk is an ordinary scan
+    bytes = plan.Bytes(storage);
+    if((error = scan_chunk(plan.Pointer(storage), bytes, d_in, d_out, max_chunk)) != hipSuccess) return error;
+
+    for(size_t chunk = 1; chunk < num_chunks; chunk++)
+    {
+        const size_t begin = chunk * chunk_items;
+        const AccT * d_carry = d_partials + chunk - 1;
+
+        bytes = plan.Bytes(storage);
+        error = scan_chunk(
+            plan.Pointer(storage), bytes, carry_input(begin, d_carry), d_out + begin,
+            std::min(chunk_items, num_items - begin)
+        );
+        if(error != hipSuccess) return error;
+
+        if(Exclusive)
+        {
+            bytes = plan.Bytes(storage);
+            error = ::rocprim::reduce(
+                plan.Pointer(storage), bytes, d_carry, d_out + begin, init,
+                1, scan_op, stream, debug_synchronous
+            );
+            if(error != hipSuccess) return error;
+        }
+    }
+    return hipSuccess;
+}
+
+/// Selects from num_items items in chunks.  The selected items of each chunk are written
+/// after those of the chunks before it, at an offset computed on the device, and the
+/// total count is written to d_num_selected_out with its own value type.
+///
+/// select(d_temp_storage, temp_storage_bytes, begin, d_out, d_count, num_items) runs
+/// the selection of the items [begin, begin + num_items).
+template<
+    class OutputIteratorT,
+    class NumSelectedIteratorT,
+    class SelectChunk
+>
+inline
+hipError_t select_large(void * d_temp_storage,
+                        size_t& temp_storage_bytes,
+                        OutputIteratorT d_out,
+                        NumSelectedIteratorT d_num_selected_out,
+                        size_t num_items,
+                        SelectChunk select,
+                        hipStream_t stream,
+                        bool debug_synchronous,
+                        size_t chunk_items = large_num_items_chunk)
+{
+    using offset_output_iterator = device_offset_output_iterator<OutputIteratorT, size_t>;
+
+    const size_t num_chunks = (num_items + chunk_items - 1) / chunk_items;
+
+    size_t select_bytes = 0;
+    size_t reduce_bytes = 0;
+    hipError_t error = select(
+        nullptr, select_bytes, size_t(0), offset_output_iterator(d_out, nullptr),
+        static_cast<size_t *>(nullptr), std::min(num_items, chunk_items)
+    );
+    if(error != hipSuccess) return error;
+    error = ::rocprim::reduce(
+        nullptr, reduce_bytes, static_cast<size_t *>(nullptr), d_num_selected_out, size_t(0),
+        num_chunks, ::rocprim::plus<size_t>(), stream, debug_synchronous
+    );
+    if(error != hipSuccess) return error;
+
+    TempStoragePlan plan;
+    TempStoragePlan::Buffer counts, offset, storage;
+    plan.Reserve(counts, num_chunks * sizeof(size_t), 0);
+    plan.Reserve(offset, sizeof(size_t), 0);
+    plan.Reserve(storage, std::max(select_bytes, reduce_bytes), 0);
+    if((error = alias_temporaries(d_temp_storage, temp_storage_bytes, plan)) != hipSuccess
+        || d_temp_storage == nullptr)
+    {
+        return error;
+    }
+
+    size_t * d_counts = plan.Pointer<size_t>(counts);
+    size_t * d_offset = plan.Pointer<size_t>(offset);
+    if((error = hipMemsetAsync(d_offset, 0, sizeof(size_t), stream)) != hipSuccess) return error;
+    for(size_t chunk = 0; chunk < num_chunks; chunk++)
+    {
+        size_t bytes = plan.Bytes(storage);
+        if(chunk > 0)
+        {
+            error = ::rocprim::reduce(
+                plan.Pointer(storage), bytes, d_counts, d_offset, size_t(0),
+                chunk, ::rocprim::plus<size_t>(), stream, debug_synchronous
+            );
+            if(error != hipSuccess) return error;
+            bytes = plan.Bytes(storage);
+        }
+
+        const size_t begin = chunk * chunk_items;
+        error = select(
+            plan.Pointer(storage), bytes, begin, offset_output_iterator(d_out, d_offset),
+            d_counts + chunk, std::min(chunk_items, num_items - begin)
+        );
+        if(error != hipSuccess) return error;
+    }
+
+    size_t bytes = plan.Bytes(storage);
+    return ::rocprim::reduce(
+        plan.Pointer(storage), bytes, d_counts, d_num_selected_out, size_t(0),
+        num_chunks, ::rocprim::plus<size_t>(), stream, debug_synchronous
+    );
+}
+
+} // end detail namespace
+
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_LARGE_NUM_ITEMS_HPP_
@@ -0,0 +1,644 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_MERGE_SORT_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_MERGE_SORT_HPP_
+
+#include <iterator>
+#include <type_traits>
+
+#include "../../../../config.hpp"
+
+#include "../../util_type.hpp"
+#include "../../thread/thread_search.hpp"
+
+#include <rocprim/detail/various.hpp>
+
+BEGIN_HIPCUB_NAMESPACE
+namespace detail
+{
+
+/**
+ * Tuning of the merge sort.
+ *
+ * Each block first sorts one tile in shared memory; tiles are then merged pairwise,
+ * doubling the length of the sorted runs at each pass.  A pass splits every pair of
+ * runs into tiles of output along merge-path diagonals, so that each block merges
+ * exactly one tile whatever the keys.
+ *
+ * A tile of keys and values is held in shared memory, so wide records, e.g. structs
+ * or string prefixes, get fewer items per thread, then fewer threads, to keep the
+ * tile within \p TILE_BYTES.  Only records over <tt>TILE_BYTES / 64</tt> bytes exceed it.
+ */
+template <typename KeyT, typename ValueT>
+struct MergeSortPolicy
+{
+    static constexpr int TILE_BYTES         = 32 * 1024;
+    static constexpr int ITEM_BYTES         =
+        int(sizeof(KeyT)) + (std::is_same<ValueT, NullType>::value ? 0 : int(sizeof(ValueT)));
+    static constexpr int TILE_RECORDS       = TILE_BYTES / ITEM_BYTES;
+    static constexpr int BLOCK_THREADS      =
+        (TILE_RECORDS >= 256) ? 256 : ((TILE_RECORDS >= 128) ? 128 : 64);
+    static constexpr int MAX_ITEMS_PER_THREAD = (ITEM_BYTES <= 8) ? 8 : 4;
+    static constexpr int ITEMS_PER_THREAD   =
+        (TILE_RECORDS / BLOCK_THREADS) > MAX_ITEMS_PER_THREAD ? MAX_ITEMS_PER_THREAD
+        : ((TILE_RECORDS / BLOCK_THREADS) < 1 ? 1 : (TILE_RECORDS / BLOCK_THREADS));
+    static constexpr int TILE_ITEMS         = BLOCK_THREADS * ITEMS_PER_THREAD;
+};
+
+/// Key and value types of merge sort iterators, NullType for keys only
+template <typename IteratorT>
+using merge_sort_value_t = typename std::iterator_traits<IteratorT>::value_type;
+
+/**
+ * Shared memory of a tile being sorted or merged
+ */
+template <typename Policy, typename KeyT, typename ValueT>
+struct MergeSortTileStorage
+{
+    static constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+
+    KeyT    keys[Policy::TILE_ITEMS];
+    ValueT  values[KEYS_ONLY ? 1 : Policy::TILE_ITEMS];
+};
+
+/**
+ * Merges \p ITEMS_PER_THREAD items of the runs <tt>[a, a_end)</tt> and <tt>[b, b_end)</tt>
+ * of \p keys_shared, taking the item of A first among equal items, and records where
+ * each merged key comes from in \p ranks.
+ */
+template <
+    int         ITEMS_PER_THREAD,
+    typename    KeyT,
+    typename    CompareOpT>
+HIPCUB_DEVICE __forceinline__ void MergeSortSerialMerge(
+    const KeyT* keys_shared,
+    int         a,
+    int         a_end,
+    int         b,
+    int         b_end,
+    KeyT        (&keys)[ITEMS_PER_THREAD],
+    int         (&ranks)[ITEMS_PER_THREAD],
+    CompareOpT  compare_op)
+{
+    #pragma unroll
+    for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+    {
+        if ((a < a_end) || (b < b_end))
+        {
+            const bool take_b = (b < b_end) && ((a >= a_end) || compare_op(keys_shared[b], keys_shared[a]));
+            ranks[ITEM] = take_b ? b++ : a++;
+            keys[ITEM]  = keys_shared[ranks[ITEM]];
+        }
+    }
+}
+
+/**
+ * Merges the sorted runs <tt>[0, a_len)</tt> and <tt>[a_len, a_len + b_len)</tt> of the
+ * tile in shared memory, each thread producing its \p ITEMS_PER_THREAD consecutive
+ * items of the merged run from the diagonal that starts them.
+ */
+template <
+    typename    Policy,
+    typename    KeyT,
+    typename    ValueT,
+    typename    CompareOpT>
+HIPCUB_DEVICE __forceinline__ void MergeSortMergeRuns(
+    MergeSortTileStorage<Policy, KeyT, ValueT>& storage,
+    int         run_begin,
+    int         a_len,
+    int         b_len,
+    int         diagonal,
+    KeyT        (&keys)[Policy::ITEMS_PER_THREAD],
+    ValueT      (&values)[Policy::ITEMS_PER_THREAD],
+    CompareOpT  compare_op)
+{
+    const KeyT* a_keys = storage.keys + run_begin;
+    const KeyT* b_keys = a_keys + a_len;
+
+    diagonal = ::rocprim::min(diagonal, a_len + b_len);
+    struct
+    {
+        int x;
+        int y;
+    } coordinate;
+    MergePathSearch(diagonal, a_keys, b_keys, a_len, b_len, coordinate, compare_op);
+
+    int ranks[Policy::ITEMS_PER_THREAD];
+    MergeSortSerialMerge(
+        storage.keys,
+        run_begin + coordinate.x, run_begin + a_len,
+        run_begin + a_len + coordinate.y, run_begin + a_len + b_len,
+        keys, ranks, compare_op);
+
+    if (!MergeSortTileStorage<Policy, KeyT, ValueT>::KEYS_ONLY)
+    {
+        #pragma unroll
+        for (int ITEM = 0; ITEM < Policy::ITEMS_PER_THREAD; ++ITEM)
+        {
+            if (diagonal + ITEM < a_len + b_len)
+            {
+                values[ITEM] = storage.values[ranks[ITEM]];
+            }
+        }
+    }
+}
+
+/// Loads the first \p num_items items of a tile to shared memory
+template <
+    typename    Policy,
+    typename    KeyT,
+    typename    ValueT,
+    typename    KeyIteratorT,
+    typename    ValueIteratorT>
+HIPCUB_DEVICE __forceinline__ void MergeSortLoadToShared(
+    MergeSortTileStorage<Policy, KeyT, ValueT>& storage,
+    int             shared_offset,
+    KeyIteratorT    d_keys,
+    ValueIteratorT  d_values,
+    int             num_items)
+{
+    for (int i = hipThreadIdx_x; i < num_items; i += Policy::BLOCK_THREADS)
+    {
+        storage.keys[shared_offset + i] = d_keys[i];
+        if (!MergeSortTileStorage<Policy, KeyT, ValueT>::KEYS_ONLY)
+        {
+            storage.values[shared_offset + i] = d_values[i];
+        }
+    }
+}
+
+/// Stores the first \p num_items items of a tile held in blocked arrangement
+template <
+    typename    Policy,
+    typename    KeyT,
+    typename    ValueT,
+    typename    KeyIteratorT,
+    typename    ValueIteratorT>
+HIPCUB_DEVICE __forceinline__ void MergeSortStoreBlocked(
+    MergeSortTileStorage<Policy, KeyT, ValueT>& storage,
+    const KeyT      (&keys)[Policy::ITEMS_PER_THREAD],
+    const ValueT    (&values)[Policy::ITEMS_PER_THREAD],
+    KeyIteratorT    d_keys,
+    ValueIteratorT  d_values,
+    int             num_items)
+{
+    constexpr bool KEYS_ONLY = MergeSortTileStorage<Policy, KeyT, ValueT>::KEYS_ONLY;
+
+    // Through shared memory, so that stores are coalesced
+    ::rocprim::syncthreads();
+    #pragma unroll
+    for (int ITEM = 0; ITEM < Policy::ITEMS_PER_THREAD; ++ITEM)
+    {
+        const int i = (hipThreadIdx_x * Policy::ITEMS_PER_THREAD) + ITEM;
+        if (i < num_items)
+        {
+            storage.keys[i] = keys[ITEM];
+            if (!KEYS_ONLY)
+            {
+                storage.values[i] = values[ITEM];
+            }
+        }
+    }
+    ::rocprim::syncthreads();
+
+    for (int i = hipThreadIdx_x; i < num_items; i += Policy::BLOCK_THREADS)
+    {
+        d_keys[i] = storage.keys[i];
+        if (!KEYS_ONLY)
+        {
+            d_values[i] = storage.values[i];
+        }
+    }
+}
+
+/**
+ * Odd-even transposition sort of the first \p num_valid items of a thread, which
+ * only swaps neighbours that are out of order and so keeps equal items in place.
+ */
+template <
+    int         ITEMS_PER_THREAD,
+    typename    KeyT,
+    typename    ValueT,
+    typename    CompareOpT>
+HIPCUB_DEVICE __forceinline__ void MergeSortThreadSort(
+    KeyT        (&keys)[ITEMS_PER_THREAD],
+    ValueT      (&values)[ITEMS_PER_THREAD],
+    int         num_valid,
+    CompareOpT  compare_op)
+{
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+
+    #pragma unroll
+    for (int STEP = 0; STEP < ITEMS_PER_THREAD; ++STEP)
+    {
+        #pragma unroll
+        for (int ITEM = STEP & 1; ITEM + 1 < ITEMS_PER_THREAD; ITEM += 2)
+        {
+            if ((ITEM + 1 < num_valid) && compare_op(keys[ITEM + 1], keys[ITEM]))
+            {
+                KeyT key = keys[ITEM];
+                keys[ITEM] = keys[ITEM + 1];
+                keys[ITEM + 1] = key;
+                if (!KEYS_ONLY)
+                {
+                    ValueT value = values[ITEM];
+                    values[ITEM] = values[ITEM + 1];
+                    values[ITEM + 1] = value;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Sorts the first \p num_valid items of a tile, stably, from the input to the output
+ * by the whole block.
+ */
+template <
+    typename    Policy,
+    typename    KeyT,
+    typename    ValueT,
+    typename    KeyInputIteratorT,
+    typename    ValueInputIteratorT,
+    typename    KeyIteratorT,
+    typename    ValueIteratorT,
+    typename    CompareOpT>
+HIPCUB_DEVICE __forceinline__ void MergeSortTile(
+    MergeSortTileStorage<Policy, KeyT, ValueT>& storage,
+    KeyInputIteratorT   d_keys_in,
+    ValueInputIteratorT d_values_in,
+    KeyIteratorT        d_keys_out,
+    ValueIteratorT      d_values_out,
+    int                 num_valid,
+    CompareOpT          compare_op)
+{
+    typedef MergeSortTileStorage<Policy, KeyT, ValueT> StorageT;
+
+    constexpr int ITEMS_PER_THREAD = Policy::ITEMS_PER_THREAD;
+
+    const int thread_offset = hipThreadIdx_x * ITEMS_PER_THREAD;
+
+    MergeSortLoadToShared(storage, 0, d_keys_in, d_values_in, num_valid);
+    ::rocprim::syncthreads();
+
+    KeyT   keys[ITEMS_PER_THREAD];
+    ValueT values[ITEMS_PER_THREAD];
+    #pragma unroll
+    for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+    {
+        if (thread_offset + ITEM < num_valid)
+        {
+            keys[ITEM] = storage.keys[thread_offset + ITEM];
+            if (!StorageT::KEYS_ONLY)
+            {
+                values[ITEM] = storage.values[thread_offset + ITEM];
+            }
+        }
+    }
+
+    const int thread_valid = ::rocprim::max(0, ::rocprim::min(ITEMS_PER_THREAD, num_valid - thread_offset));
+    MergeSortThreadSort(keys, values, thread_valid, compare_op);
+
+    // Merge the runs of the threads pairwise until the tile is one run
+    for (int run_items = ITEMS_PER_THREAD; run_items < Policy::TILE_ITEMS; run_items *= 2)
+    {
+        ::rocprim::syncthreads();
+        #pragma unroll
+        for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+        {
+            if (thread_offset + ITEM < num_valid)
+            {
+                storage.keys[thread_offset + ITEM] = keys[ITEM];
+                if (!StorageT::KEYS_ONLY)
+                {
+                    storage.values[thread_offset + ITEM] = values[ITEM];
+                }
+            }
+        }
+        ::rocprim::syncthreads();
+
+        const int run_begin = (thread_offset / (2 * run_items)) * (2 * run_items);
+        const int a_len     = ::rocprim::max(0, ::rocprim::min(run_items, num_valid - run_begin));
+        const int b_len     = ::rocprim::max(0, ::rocprim::min(run_items, num_valid - run_begin - run_items));
+        MergeSortMergeRuns(storage, run_begin, a_len, b_len, thread_offset - run_begin, keys, values, compare_op);
+    }
+
+    MergeSortStoreBlocked(storage, keys, values, d_keys_out, d_values_out, num_valid);
+}
+
+/**
+ * Sorts each tile of the input, stably, into the output.
+ */
+template <
+    typename    Policy,
+    typename    KeyInputIteratorT,
+    typename    ValueInputIteratorT,
+    typename    KeyIteratorT,
+    typename    ValueIteratorT,
+    typename    OffsetT,
+    typename    CompareOpT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceMergeSortBlockSortKernel(
+    KeyInputIteratorT   d_keys_in,
+    ValueInputIteratorT d_values_in,
+    KeyIteratorT        d_keys_out,
+    ValueIteratorT      d_values_out,
+    OffsetT             num_items,
+    CompareOpT          compare_op)
+{
+    typedef merge_sort_value_t<KeyIteratorT> KeyT;
+    typedef merge_sort_value_t<ValueIteratorT> ValueT;
+    typedef MergeSortTileStorage<Policy, KeyT, ValueT> StorageT;
+
+    __shared__ Uninitialized<StorageT> temp_storage_raw;
+    StorageT& storage = temp_storage_raw.Alias();
+
+    const size_t tile_offset = size_t(hipBlockIdx_x) * Policy::TILE_ITEMS;
+    const int    num_valid   = int(::rocprim::min(size_t(Policy::TILE_ITEMS), size_t(num_items) - tile_offset));
+
+    MergeSortTile<Policy, KeyT, ValueT>(
+        storage,
+        d_keys_in + tile_offset, d_values_in + tile_offset,
+        d_keys_out + tile_offset, d_values_out + tile_offset,
+        num_valid, compare_op);
+}
+
+/**
+ * Finds where each tile of output of a merge pass starts in the first of the two
+ * runs it is merged from.  Runs and diagonals are computed in size_t, as twice the
+ * run length of the last pass may not fit in OffsetT.
+ */
+template <
+    typename    Policy,
+    typename    KeyIteratorT,
+    typename    OffsetT,
+    typename    CompareOpT>
+static __global__ void
+DeviceMergeSortPartitionKernel(
+    KeyIteratorT    d_keys,
+    OffsetT         num_items,
+    OffsetT         num_partitions,
+    OffsetT*        d_partitions,   ///< [out] Offset of the first item of A of each tile, and of the end
+    size_t          run_items,
+    CompareOpT      compare_op)
+{
+    const size_t partition = (size_t(hipBlockIdx_x) * hipBlockDim_x) + hipThreadIdx_x;
+    if (partition >= size_t(num_partitions))
+    {
+        return;
+    }
+
+    const size_t items     = size_t(num_items);
+    const size_t diagonal  = ::rocprim::min(partition * Policy::TILE_ITEMS, items);
+    const size_t run_begin = (diagonal / (2 * run_items)) * (2 * run_items);
+    const size_t a_len     = ::rocprim::min(run_items, items - run_begin);
+    const size_t b_len     = ::rocprim::min(run_items, items - run_begin - a_len);
+
+    struct
+    {
+        size_t x;
+        size_t y;
+    } coordinate;
+    MergePathSearch(diagonal - run_begin, d_keys + run_begin, d_keys + run_begin + a_len,
+                    a_len, b_len, coordinate, compare_op);
+    d_partitions[partition] = OffsetT(run_begin + coordinate.x);
+}
+
+/**
+ * Merges one tile of output of a merge pass from the two runs it comes from.
+ */
+template <
+    typename    Policy,
+    typename    KeyInputIteratorT,
+    typename    ValueInputIteratorT,
+    typename    KeyIteratorT,
+    typename    ValueIteratorT,
+    typename    OffsetT,
+    typename    CompareOpT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceMergeSortMergeKernel(
+    KeyInputIteratorT   d_keys_in,
+    ValueInputIteratorT d_values_in,
+    KeyIteratorT        d_keys_out,
+    ValueIteratorT      d_values_out,
+    OffsetT             num_items,
+    const OffsetT*      d_partitions,
+    size_t              run_items,
+    CompareOpT          compare_op)
+{
+    typedef merge_sort_value_t<KeyIteratorT> KeyT;
+    typedef merge_sort_value_t<ValueIteratorT> ValueT;
+    typedef MergeSortTileStorage<Policy, KeyT, ValueT> StorageT;
+
+    constexpr int ITEMS_PER_THREAD = Policy::ITEMS_PER_THREAD;
+
+    __shared__ Uninitialized<StorageT> temp_storage_raw;
+    StorageT& storage = temp_storage_raw.Alias();
+
+    const size_t items       = size_t(num_items);
+    const size_t tile_offset = size_t(hipBlockIdx_x) * Policy::TILE_ITEMS;
+    const size_t tile_end    = ::rocprim::min(tile_offset + Policy::TILE_ITEMS, items);
+    const size_t run_begin   = (tile_offset / (2 * run_items)) * (2 * run_items);
+    const size_t a_len       = ::rocprim::min(run_items, items - run_begin);
+    const size_t b_begin     = run_begin + a_len;
+
+    // Tiles never straddle two pairs of runs: the last tile of a pair ends with both runs
+    const size_t a_first = size_t(d_partitions[hipBlockIdx_x]);
+    const size_t a_last  = ((tile_end < items) && (tile_end < run_begin + (2 * run_items)))
+        ? size_t(d_partitions[hipBlockIdx_x + 1])
+        : b_begin;
+    const size_t b_first = b_begin + ((tile_offset - run_begin) - (a_first - run_begin));
+    const size_t b_last  = b_begin + ((tile_end - run_begin) - (a_last - run_begin));
+
+    const int tile_a_len = int(a_last - a_first);
+    const int tile_b_len = int(b_last - b_first);
+    MergeSortLoadToShared(storage, 0, d_keys_in + a_first, d_values_in + a_first, tile_a_len);
+    MergeSortLoadToShared(storage, tile_a_len, d_keys_in + b_first, d_values_in + b_first, tile_b_len);
+    ::rocprim::syncthreads();
+
+    KeyT   keys[ITEMS_PER_THREAD];
+    ValueT values[ITEMS_PER_THREAD];
+    MergeSortMergeRuns(storage, 0, tile_a_len, tile_b_len, int(hipThreadIdx_x) * ITEMS_PER_THREAD,
+                       keys, values, compare_op);
+
+    MergeSortStoreBlocked(storage, keys, values, d_keys_out + tile_offset, d_values_out + tile_offset,
+                          tile_a_len + tile_b_len);
+}
+
+/**
+ * Stable merge sort of \p num_items keys (and values) by \p compare_op, from the input
+ * iterators to the output ones, which may be the same.  Runs are merged back and forth
+ * between the output and temporary storage, starting from whichever of the two makes
+ * the last pass end in the output.
+ */
+template <
+    typename    KeyInputIteratorT,
+    typename    ValueInputIteratorT,
+    typename    KeyIteratorT,
+    typename    ValueIteratorT,
+    typename    OffsetT,
+    typename    CompareOpT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t MergeSort(
+    void*                   d_temp_storage,
+    size_t&                 temp_storage_bytes,
+    KeyInputIteratorT       d_keys_in,
+    ValueInputIteratorT     d_values_in,
+    KeyIteratorT            d_keys_out,
+    ValueIteratorT          d_values_out,
+    OffsetT                 num_items,
+    CompareOpT              compare_op,
+    hipStream_t             stream,
+    bool                    debug_synchronous)
+{
+    typedef merge_sort_value_t<KeyIteratorT> KeyT;
+    typedef merge_sort_value_t<ValueIteratorT> ValueT;
+    typedef MergeSortPolicy<KeyT, ValueT> Policy;
+
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+    constexpr unsigned int PARTITION_BLOCK_THREADS = 256;
+
+    // Counted in size_t: doubling the run length may overflow OffsetT
+    const size_t num_tiles = DivideAndRoundUp(size_t(num_items), size_t(Policy::TILE_ITEMS));
+    int num_passes = 0;
+    for (size_t runs = 1; runs < num_tiles; runs *= 2)
+    {
+        ++num_passes;
+    }
+
+    const size_t partitions_bytes = (num_passes == 0) ? 0 :
+        ::rocprim::detail::align_size(sizeof(OffsetT) * (num_tiles + 1));
+    const size_t keys_bytes = (num_passes == 0) ? 0 :
+        ::rocprim::detail::align_size(sizeof(KeyT) * size_t(num_items));
+    const size_t values_bytes = ((num_passes == 0) || KEYS_ONLY) ? 0 :
+        ::rocprim::detail::align_size(sizeof(ValueT) * size_t(num_items));
+    // Never report 0 bytes, which some allocators refuse
+    const size_t required_bytes =
+        ::rocprim::max(partitions_bytes + keys_bytes + values_bytes, size_t(1));
+
+    if (d_temp_storage == nullptr)
+    {
+        temp_storage_bytes = required_bytes;
+        return hipSuccess;
+    }
+
+    if (temp_storage_bytes < required_bytes)
+    {
+        return hipErrorInvalidValue;
+    }
+
+    if (num_items == 0)
+    {
+        return hipSuccess;
+    }
+
+    char* d_temp = static_cast<char*>(d_temp_storage);
+    OffsetT* d_partitions = reinterpret_cast<OffsetT*>(d_temp);
+    KeyT*    d_keys_tmp   = reinterpret_cast<KeyT*>(d_temp + partitions_bytes);
+    ValueT*  d_values_tmp = reinterpret_cast<ValueT*>(d_temp + partitions_bytes + keys_bytes);
+
+    hipError_t error = hipSuccess;
+
+    // With an odd number of passes, tiles are sorted to the temporary storage
+    bool in_output = (num_passes % 2) == 0;
+    if (in_output)
+    {
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceMergeSortBlockSortKernel<
+                Policy, KeyInputIteratorT, ValueInputIteratorT, KeyIteratorT, ValueIteratorT, OffsetT, CompareOpT>),
+            dim3(static_cast<unsigned int>(num_tiles)), dim3(Policy::BLOCK_THREADS), 0, stream,
+            d_keys_in, d_values_in, d_keys_out, d_values_out, num_items, compare_op);
+    }
+    else
+    {
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceMergeSortBlockSortKernel<
+                Policy, KeyInputIteratorT, ValueInputIteratorT, KeyT*, ValueT*, OffsetT, CompareOpT>),
+            dim3(static_cast<unsigned int>(num_tiles)), dim3(Policy::BLOCK_THREADS), 0, stream,
+            d_keys_in, d_values_in, d_keys_tmp, d_values_tmp, num_items, compare_op);
+    }
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    const OffsetT num_partitions = OffsetT(num_tiles + 1);
+    const unsigned int partition_grid_size = static_cast<unsigned int>(
+        DivideAndRoundUp(num_tiles + 1, size_t(PARTITION_BLOCK_THREADS)));
+
+    for (int pass = 0; pass < num_passes; ++pass)
+    {
+        const size_t run_items = size_t(Policy::TILE_ITEMS) << pass;
+
+        if (in_output)
+        {
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(DeviceMergeSortPartitionKernel<Policy, KeyIteratorT, OffsetT, CompareOpT>),
+                dim3(partition_grid_size), dim3(PARTITION_BLOCK_THREADS), 0, stream,
+                d_keys_out, num_items, num_partitions, d_partitions, run_items, compare_op);
+        }
+        else
+        {
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(DeviceMergeSortPartitionKernel<Policy, KeyT*, OffsetT, CompareOpT>),
+                dim3(partition_grid_size), dim3(PARTITION_BLOCK_THREADS), 0, stream,
+                d_keys_tmp, num_items, num_partitions, d_partitions, run_items, compare_op);
+        }
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        if (in_output)
+        {
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(DeviceMergeSortMergeKernel<
+                    Policy, KeyIteratorT, ValueIteratorT, KeyT*, ValueT*, OffsetT, CompareOpT>),
+                dim3(static_cast<unsigned int>(num_tiles)), dim3(Policy::BLOCK_THREADS), 0, stream,
+                d_keys_out, d_values_out, d_keys_tmp, d_values_tmp,
+                num_items, d_partitions, run_items, compare_op);
+        }
+        else
+        {
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(DeviceMergeSortMergeKernel<
+                    Policy, KeyT*, ValueT*, KeyIteratorT, ValueIteratorT, OffsetT, CompareOpT>),
+                dim3(static_cast<unsigned int>(num_tiles)), dim3(Policy::BLOCK_THREADS), 0, stream,
+                d_keys_tmp, d_values_tmp, d_keys_out, d_values_out,
+                num_items, d_partitions, run_items, compare_op);
+        }
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        in_output = !in_output;
+    }
+
+    return error;
+}
+
+} // end namespace detail
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_MERGE_SORT_HPP_
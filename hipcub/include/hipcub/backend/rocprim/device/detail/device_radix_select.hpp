@@ -0,0 +1,614 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_RADIX_SELECT_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_RADIX_SELECT_HPP_
+
+#include <type_traits>
+
+#include "../../../../config.hpp"
+
+#include "../../util_type.hpp"
+#include "../../block/block_scan.hpp"
+#include "../../block/radix_rank_sort_operations.hpp"
+#include "device_radix_sort_onesweep.hpp"
+
+#include <rocprim/detail/various.hpp>
+
+BEGIN_HIPCUB_NAMESPACE
+namespace detail
+{
+
+/**
+ * Tuning of the radix select.
+ *
+ * Radix select finds the k-th smallest twiddled key one digit at a time, from the
+ * most significant digit down.  Each pass counts the digits of the keys that match
+ * the digits decided so far, then picks the digit whose bucket holds the k-th key.
+ * Refining stops as soon as that bucket is taken whole, so most selections end
+ * well before the last digit.  At the first pass whose bucket fits in a buffer of
+ * 1 / CANDIDATE_DIVISOR of the keys, the keys of the bucket are copied there and
+ * the later passes read only those.
+ */
+template <typename KeyT>
+struct RadixSelectPolicy
+{
+    static constexpr int RADIX_BITS         = 8;
+    static constexpr int RADIX_DIGITS       = 1 << RADIX_BITS;
+    static constexpr int BLOCK_THREADS      = 256;
+    static constexpr int ITEMS_PER_THREAD   = 8;
+    static constexpr int TILE_ITEMS         = BLOCK_THREADS * ITEMS_PER_THREAD;
+    static constexpr int KEY_BITS           = int(sizeof(KeyT) * 8);
+    static constexpr int MAX_PASSES         = (KEY_BITS + RADIX_BITS - 1) / RADIX_BITS;
+    static constexpr int CANDIDATE_DIVISOR  = 16;
+
+    static_assert(BLOCK_THREADS == RADIX_DIGITS, "The digit is chosen by one thread per digit");
+};
+
+/**
+ * Progress of a radix select, kept in device memory between passes.
+ */
+template <typename UnsignedBits>
+struct RadixSelectState
+{
+    UnsignedBits    prefix;         // Twiddled bits of the k-th key decided so far
+    int             prefix_bit;     // Lowest decided bit, the key size before the first pass
+    unsigned int    k_remaining;    // Rank (from 1) of the k-th key among the keys that match prefix
+    int             done;           // Whether the bucket of the k-th key needs no more refining
+    unsigned int    less_count;     // Keys below the bucket gathered so far
+    unsigned int    equal_count;    // Keys in the bucket gathered so far
+    int             compacted;      // 0: passes read the input, 1: the bucket is being copied to the candidates, 2: copied
+    unsigned int    num_candidates; // Keys of the bucket copied to the candidates
+};
+
+/**
+ * Bits of \p key from \p bit on, or 0 if \p bit is past the key
+ */
+template <typename UnsignedBits>
+HIPCUB_DEVICE __forceinline__ UnsignedBits RadixSelectHighBits(UnsignedBits key, int bit)
+{
+    return (bit >= int(sizeof(UnsignedBits) * 8)) ? UnsignedBits(0) : UnsignedBits(key >> bit);
+}
+
+template <typename UnsignedBits>
+static __global__ void
+DeviceRadixSelectInitKernel(
+    RadixSelectState<UnsignedBits>* d_state,
+    unsigned int                    k)
+{
+    d_state->prefix         = UnsignedBits(0);
+    d_state->prefix_bit     = int(sizeof(UnsignedBits) * 8);
+    d_state->k_remaining    = k;
+    d_state->done           = 0;
+    d_state->less_count     = 0;
+    d_state->equal_count    = 0;
+    d_state->compacted      = 0;
+    d_state->num_candidates = 0;
+}
+
+/**
+ * Counts the digits of the keys that match the digits decided so far, reading the
+ * candidates instead of the input once they are copied.
+ */
+template <
+    typename    Policy,
+    bool        SELECT_MAX,
+    typename    KeyT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSelectHistogramKernel(
+    const KeyT*     d_keys,
+    unsigned int    num_items,
+    const typename Traits<KeyT>::UnsignedBits* d_candidates, ///< Twiddled keys of the bucket
+    const RadixSelectState<typename Traits<KeyT>::UnsignedBits>* d_state,
+    unsigned int*   d_bins,         ///< [out] Digit counts of this pass (zeroed beforehand)
+    int             current_bit,
+    int             num_bits)
+{
+    typedef RadixSortTwiddle<SELECT_MAX, KeyT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+
+    __shared__ unsigned int bins[Policy::RADIX_DIGITS];
+
+    if (d_state->done)
+    {
+        return;
+    }
+
+    for (int bin = hipThreadIdx_x; bin < Policy::RADIX_DIGITS; bin += Policy::BLOCK_THREADS)
+    {
+        bins[bin] = 0;
+    }
+    ::rocprim::syncthreads();
+
+    const UnsignedBits prefix     = RadixSelectHighBits(d_state->prefix, d_state->prefix_bit);
+    const int          prefix_bit = d_state->prefix_bit;
+    const bool         compacted  = d_state->compacted != 0;
+    const unsigned int num_keys   = compacted ? d_state->num_candidates : num_items;
+    DigitExtractor<UnsignedBits> digit_extractor(current_bit, num_bits);
+
+    const UnsignedBits* d_bits = reinterpret_cast<const UnsignedBits*>(d_keys);
+    for (size_t i = (size_t(hipBlockIdx_x) * Policy::BLOCK_THREADS) + hipThreadIdx_x;
+         i < num_keys;
+         i += size_t(hipGridDim_x) * Policy::BLOCK_THREADS)
+    {
+        const UnsignedBits key = compacted ? d_candidates[i] : TwiddleT::In(d_bits[i]);
+        if (RadixSelectHighBits(key, prefix_bit) == prefix)
+        {
+            atomicAdd(&bins[digit_extractor.Digit(key)], 1u);
+        }
+    }
+    ::rocprim::syncthreads();
+
+    for (int bin = hipThreadIdx_x; bin < Policy::RADIX_DIGITS; bin += Policy::BLOCK_THREADS)
+    {
+        if (bins[bin] != 0)
+        {
+            atomicAdd(&d_bins[bin], bins[bin]);
+        }
+    }
+}
+
+/**
+ * Picks the digit whose bucket holds the k-th key.  One block, one thread per digit.
+ * Selecting the k smallest keys is done once the bucket is taken whole; finding the
+ * k-th key only once it is the only key left in the bucket.  Refining a bucket that
+ * fits in the candidates starts with copying it there.
+ */
+template <
+    typename    Policy,
+    bool        FIND_NTH,
+    typename    UnsignedBits>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSelectChooseKernel(
+    RadixSelectState<UnsignedBits>* d_state,
+    const unsigned int*             d_bins,
+    int                             current_bit,
+    unsigned int                    candidate_capacity)
+{
+    typedef BlockScan<unsigned int, Policy::BLOCK_THREADS> BlockScanT;
+
+    __shared__ typename BlockScanT::TempStorage temp_storage;
+
+    if (d_state->done)
+    {
+        return;
+    }
+
+    const unsigned int digit = hipThreadIdx_x;
+    const unsigned int k     = d_state->k_remaining;
+    const unsigned int count = d_bins[digit];
+    unsigned int below;
+    BlockScanT(temp_storage).ExclusiveSum(count, below);
+
+    if ((below < k) && (k <= below + count))
+    {
+        const unsigned int k_remaining = k - below;
+        d_state->prefix      |= UnsignedBits(digit) << current_bit;
+        d_state->prefix_bit   = current_bit;
+        d_state->k_remaining  = k_remaining;
+        d_state->done         = FIND_NTH ? (count == 1) : (count == k_remaining);
+
+        const int compacted = d_state->compacted;
+        d_state->compacted  = (compacted != 0) ? 2
+            : ((!d_state->done && (count <= candidate_capacity)) ? 1 : 0);
+    }
+}
+
+/**
+ * Copies the twiddled keys of the bucket of the k-th key to the candidates, in the
+ * pass whose bucket first fits there.  Blocks claim their place with one atomic per tile.
+ */
+template <
+    typename    Policy,
+    bool        SELECT_MAX,
+    typename    KeyT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSelectCompactKernel(
+    const KeyT*     d_keys,
+    unsigned int    num_items,
+    typename Traits<KeyT>::UnsignedBits* d_candidates,
+    RadixSelectState<typename Traits<KeyT>::UnsignedBits>* d_state)
+{
+    typedef RadixSortTwiddle<SELECT_MAX, KeyT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+    typedef BlockScan<unsigned int, Policy::BLOCK_THREADS> BlockScanT;
+
+    __shared__ typename BlockScanT::TempStorage temp_storage;
+    __shared__ unsigned int candidate_base;
+
+    if (d_state->compacted != 1)
+    {
+        return;
+    }
+
+    const unsigned int linear_tid = hipThreadIdx_x;
+    const UnsignedBits prefix     = RadixSelectHighBits(d_state->prefix, d_state->prefix_bit);
+    const int          prefix_bit = d_state->prefix_bit;
+    const size_t       num_tiles  = DivideAndRoundUp(size_t(num_items), size_t(Policy::TILE_ITEMS));
+
+    const UnsignedBits* d_bits = reinterpret_cast<const UnsignedBits*>(d_keys);
+    for (size_t tile = hipBlockIdx_x; tile < num_tiles; tile += hipGridDim_x)
+    {
+        const size_t tile_offset = tile * Policy::TILE_ITEMS;
+
+        UnsignedBits keys[Policy::ITEMS_PER_THREAD];
+        bool         selected[Policy::ITEMS_PER_THREAD];
+        unsigned int selected_count = 0;
+
+        #pragma unroll
+        for (int ITEM = 0; ITEM < Policy::ITEMS_PER_THREAD; ++ITEM)
+        {
+            const size_t i = tile_offset + (ITEM * Policy::BLOCK_THREADS) + linear_tid;
+            selected[ITEM] = false;
+            if (i < num_items)
+            {
+                keys[ITEM]     = TwiddleT::In(d_bits[i]);
+                selected[ITEM] = RadixSelectHighBits(keys[ITEM], prefix_bit) == prefix;
+                selected_count += selected[ITEM] ? 1 : 0;
+            }
+        }
+
+        unsigned int selected_offset, selected_aggregate;
+        BlockScanT(temp_storage).ExclusiveSum(selected_count, selected_offset, selected_aggregate);
+
+        if (linear_tid == 0)
+        {
+            candidate_base = (selected_aggregate != 0)
+                ? atomicAdd(&d_state->num_candidates, selected_aggregate) : 0;
+        }
+        ::rocprim::syncthreads();
+
+        unsigned int position = candidate_base + selected_offset;
+        #pragma unroll
+        for (int ITEM = 0; ITEM < Policy::ITEMS_PER_THREAD; ++ITEM)
+        {
+            if (selected[ITEM])
+            {
+                d_candidates[position++] = keys[ITEM];
+            }
+        }
+        ::rocprim::syncthreads();
+    }
+}
+
+/**
+ * Writes the keys below the bucket of the k-th key and the first keys of the bucket
+ * that complete the k smallest keys.  Blocks claim their place in the output with
+ * one atomic per block and per kind of key.
+ */
+template <
+    typename    Policy,
+    bool        SELECT_MAX,
+    typename    KeyT,
+    typename    ValueT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSelectGatherKernel(
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    unsigned int    num_items,
+    unsigned int    k,
+    RadixSelectState<typename Traits<KeyT>::UnsignedBits>* d_state)
+{
+    typedef RadixSortTwiddle<SELECT_MAX, KeyT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+    typedef BlockScan<unsigned int, Policy::BLOCK_THREADS> BlockScanT;
+
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+
+    __shared__ typename BlockScanT::TempStorage temp_storage;
+    __shared__ unsigned int less_base;
+    __shared__ unsigned int equal_base;
+
+    const unsigned int linear_tid  = hipThreadIdx_x;
+    const size_t       tile_offset = size_t(hipBlockIdx_x) * Policy::TILE_ITEMS;
+
+    const UnsignedBits prefix      = RadixSelectHighBits(d_state->prefix, d_state->prefix_bit);
+    const int          prefix_bit  = d_state->prefix_bit;
+    const unsigned int k_remaining = d_state->k_remaining;
+    const unsigned int less_total  = k - k_remaining;
+
+    const UnsignedBits* d_bits_in = reinterpret_cast<const UnsignedBits*>(d_keys_in);
+    UnsignedBits keys[Policy::ITEMS_PER_THREAD];
+    int          kinds[Policy::ITEMS_PER_THREAD];   // 0: not selected, 1: below the bucket, 2: in the bucket
+    unsigned int less_count  = 0;
+    unsigned int equal_count = 0;
+
+    #pragma unroll
+    for (int ITEM = 0; ITEM < Policy::ITEMS_PER_THREAD; ++ITEM)
+    {
+        const size_t i = tile_offset + (ITEM * Policy::BLOCK_THREADS) + linear_tid;
+        kinds[ITEM] = 0;
+        if (i < num_items)
+        {
+            keys[ITEM] = TwiddleT::In(d_bits_in[i]);
+            const UnsignedBits high = RadixSelectHighBits(keys[ITEM], prefix_bit);
+            kinds[ITEM] = (high < prefix) ? 1 : ((high == prefix) ? 2 : 0);
+            less_count  += (kinds[ITEM] == 1) ? 1 : 0;
+            equal_count += (kinds[ITEM] == 2) ? 1 : 0;
+        }
+    }
+
+    unsigned int less_offset, less_aggregate;
+    BlockScanT(temp_storage).ExclusiveSum(less_count, less_offset, less_aggregate);
+    ::rocprim::syncthreads();
+    unsigned int equal_offset, equal_aggregate;
+    BlockScanT(temp_storage).ExclusiveSum(equal_count, equal_offset, equal_aggregate);
+
+    if (linear_tid == 0)
+    {
+        less_base  = (less_aggregate != 0) ? atomicAdd(&d_state->less_count, less_aggregate) : 0;
+        equal_base = (equal_aggregate != 0) ? atomicAdd(&d_state->equal_count, equal_aggregate) : 0;
+    }
+    ::rocprim::syncthreads();
+
+    unsigned int less_position  = less_base + less_offset;
+    unsigned int equal_position = equal_base + equal_offset;
+
+    #pragma unroll
+    for (int ITEM = 0; ITEM < Policy::ITEMS_PER_THREAD; ++ITEM)
+    {
+        unsigned int position = k;
+        if (kinds[ITEM] == 1)
+        {
+            position = less_position++;
+        }
+        else if (kinds[ITEM] == 2)
+        {
+            position = (equal_position < k_remaining) ? (less_total + equal_position) : k;
+            ++equal_position;
+        }
+
+        if (position < k)
+        {
+            const size_t i = tile_offset + (ITEM * Policy::BLOCK_THREADS) + linear_tid;
+            reinterpret_cast<UnsignedBits*>(d_keys_out)[position] = TwiddleT::Out(keys[ITEM]);
+            if (!KEYS_ONLY)
+            {
+                d_values_out[position] = d_values_in[i];
+            }
+        }
+    }
+}
+
+/**
+ * Writes the key in the bucket of the k-th key, once that key is the only one left
+ * in the bucket or the bucket spans a single key value.
+ */
+template <
+    typename    Policy,
+    bool        SELECT_MAX,
+    typename    KeyT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSelectNthKernel(
+    const KeyT*     d_keys_in,
+    KeyT*           d_nth_out,
+    unsigned int    num_items,
+    const typename Traits<KeyT>::UnsignedBits* d_candidates,
+    const RadixSelectState<typename Traits<KeyT>::UnsignedBits>* d_state)
+{
+    typedef RadixSortTwiddle<SELECT_MAX, KeyT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+
+    const UnsignedBits prefix     = RadixSelectHighBits(d_state->prefix, d_state->prefix_bit);
+    const int          prefix_bit = d_state->prefix_bit;
+    const bool         compacted  = d_state->compacted != 0;
+    const unsigned int num_keys   = compacted ? d_state->num_candidates : num_items;
+
+    const UnsignedBits* d_bits = reinterpret_cast<const UnsignedBits*>(d_keys_in);
+    for (size_t i = (size_t(hipBlockIdx_x) * Policy::BLOCK_THREADS) + hipThreadIdx_x;
+         i < num_keys;
+         i += size_t(hipGridDim_x) * Policy::BLOCK_THREADS)
+    {
+        const UnsignedBits key = compacted ? d_candidates[i] : TwiddleT::In(d_bits[i]);
+        if (RadixSelectHighBits(key, prefix_bit) == prefix)
+        {
+            // Every key left in the bucket is the same
+            *reinterpret_cast<UnsignedBits*>(d_nth_out) = TwiddleT::Out(key);
+        }
+    }
+}
+
+/**
+ * Selects the \p k smallest keys of \p d_keys_in (the largest with \p SELECT_MAX)
+ * and their values.  The selected keys are written to \p d_keys_out in no particular
+ * order, or sorted with \p sort_output.  With \p FIND_NTH, only the k-th key itself
+ * is written, to \p d_keys_out[0].
+ */
+template <
+    bool        SELECT_MAX,
+    bool        FIND_NTH,
+    typename    KeyT,
+    typename    ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t RadixSelect(
+    void*                   d_temp_storage,
+    size_t&                 temp_storage_bytes,
+    const KeyT*             d_keys_in,
+    KeyT*                   d_keys_out,
+    const ValueT*           d_values_in,
+    ValueT*                 d_values_out,
+    unsigned int            num_items,
+    unsigned int            k,
+    bool                    sort_output,
+    hipStream_t             stream,
+    bool                    debug_synchronous)
+{
+    typedef RadixSelectPolicy<KeyT> Policy;
+    typedef typename Traits<KeyT>::UnsignedBits UnsignedBits;
+    typedef RadixSelectState<UnsignedBits> StateT;
+
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+
+    if (k > num_items)
+    {
+        return hipErrorInvalidValue;
+    }
+
+    sort_output = sort_output && !FIND_NTH;
+
+    const size_t state_bytes =
+        ::rocprim::detail::align_size(sizeof(StateT));
+    const size_t bins_bytes =
+        ::rocprim::detail::align_size(sizeof(unsigned int) * Policy::RADIX_DIGITS);
+    const unsigned int candidate_capacity = num_items / Policy::CANDIDATE_DIVISOR;
+    const size_t candidates_bytes =
+        ::rocprim::detail::align_size(sizeof(UnsignedBits) * candidate_capacity);
+    const size_t staged_keys_bytes = !sort_output ? 0 :
+        ::rocprim::detail::align_size(sizeof(KeyT) * k);
+    const size_t staged_values_bytes = (!sort_output || KEYS_ONLY) ? 0 :
+        ::rocprim::detail::align_size(sizeof(ValueT) * k);
+
+    // The k selected keys are gathered to the temporary storage and sorted from there
+    DoubleBuffer<KeyT>   d_sorted_keys(nullptr, d_keys_out);
+    DoubleBuffer<ValueT> d_sorted_values(nullptr, d_values_out);
+    size_t sort_bytes = 0;
+    hipError_t error = hipSuccess;
+    if (sort_output && HipcubDebug(error = RadixSortOnesweep<SELECT_MAX>(
+        nullptr, sort_bytes, d_sorted_keys, d_sorted_values, false, k,
+        0, int(sizeof(KeyT) * 8), stream, debug_synchronous))) return error;
+
+    const size_t required_bytes =
+        state_bytes + bins_bytes + candidates_bytes + staged_keys_bytes + staged_values_bytes + sort_bytes;
+
+    if (d_temp_storage == nullptr)
+    {
+        temp_storage_bytes = required_bytes;
+        return hipSuccess;
+    }
+
+    if (temp_storage_bytes < required_bytes)
+    {
+        return hipErrorInvalidValue;
+    }
+
+    if (k == 0)
+    {
+        return hipSuccess;
+    }
+
+    char* d_temp = static_cast<char*>(d_temp_storage);
+    StateT*         d_state         = reinterpret_cast<StateT*>(d_temp);
+    unsigned int*   d_bins          = reinterpret_cast<unsigned int*>(d_temp + state_bytes);
+    d_temp += state_bytes + bins_bytes;
+    UnsignedBits*   d_candidates    = reinterpret_cast<UnsignedBits*>(d_temp);
+    KeyT*           d_staged_keys   = reinterpret_cast<KeyT*>(d_temp + candidates_bytes);
+    ValueT*         d_staged_values = reinterpret_cast<ValueT*>(d_temp + candidates_bytes + staged_keys_bytes);
+    void*           d_sort_storage  = d_temp + candidates_bytes + staged_keys_bytes + staged_values_bytes;
+
+    int device_id = 0;
+    int compute_units = 0;
+    if (HipcubDebug(error = hipGetDevice(&device_id))) return error;
+    if (HipcubDebug(error = hipDeviceGetAttribute(&compute_units, hipDeviceAttributeMultiprocessorCount, device_id))) return error;
+
+    const size_t num_tiles = DivideAndRoundUp(size_t(num_items), size_t(Policy::TILE_ITEMS));
+    const unsigned int histogram_grid_size = static_cast<unsigned int>(
+        ::rocprim::min(num_tiles, size_t(compute_units) * 4));
+
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(DeviceRadixSelectInitKernel<UnsignedBits>),
+        dim3(1), dim3(1), 0, stream,
+        d_state, k);
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    // Passes after the bucket is isolated return at once, and so does the copy to the
+    // candidates in every pass but the one that fills them, which spares waiting for
+    // the state on the host
+    for (int pass = 0; pass < Policy::MAX_PASSES; ++pass)
+    {
+        const int end_bit     = Policy::KEY_BITS - (pass * Policy::RADIX_BITS);
+        const int current_bit = ::rocprim::max(0, end_bit - int(Policy::RADIX_BITS));
+        const int num_bits    = end_bit - current_bit;
+        const bool last_pass  = (pass + 1 == Policy::MAX_PASSES);
+
+        if (HipcubDebug(error = hipMemsetAsync(d_bins, 0, bins_bytes, stream))) return error;
+
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceRadixSelectHistogramKernel<Policy, SELECT_MAX, KeyT>),
+            dim3(histogram_grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+            d_keys_in, num_items, d_candidates, d_state, d_bins, current_bit, num_bits);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceRadixSelectChooseKernel<Policy, FIND_NTH, UnsignedBits>),
+            dim3(1), dim3(Policy::BLOCK_THREADS), 0, stream,
+            d_state, d_bins, current_bit, last_pass ? 0u : candidate_capacity);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        // No pass refines after the last one
+        if (!last_pass && (candidate_capacity != 0))
+        {
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(DeviceRadixSelectCompactKernel<Policy, SELECT_MAX, KeyT>),
+                dim3(histogram_grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+                d_keys_in, num_items, d_candidates, d_state);
+            if (HipcubDebug(error = hipPeekAtLastError())) return error;
+            if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+        }
+    }
+
+    if (FIND_NTH)
+    {
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceRadixSelectNthKernel<Policy, SELECT_MAX, KeyT>),
+            dim3(histogram_grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+            d_keys_in, d_keys_out, num_items, d_candidates, d_state);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+        return error;
+    }
+
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(DeviceRadixSelectGatherKernel<Policy, SELECT_MAX, KeyT, ValueT>),
+        dim3(static_cast<unsigned int>(num_tiles)), dim3(Policy::BLOCK_THREADS), 0, stream,
+        d_keys_in, sort_output ? d_staged_keys : d_keys_out,
+        d_values_in, sort_output ? d_staged_values : d_values_out,
+        num_items, k, d_state);
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    if (sort_output)
+    {
+        d_sorted_keys   = DoubleBuffer<KeyT>(d_staged_keys, d_keys_out);
+        d_sorted_values = DoubleBuffer<ValueT>(d_staged_values, d_values_out);
+        if (HipcubDebug(error = RadixSortOnesweep<SELECT_MAX>(
+            d_sort_storage, sort_bytes, d_sorted_keys, d_sorted_values, false, k,
+            0, int(sizeof(KeyT) * 8), stream, debug_synchronous))) return error;
+    }
+
+    return error;
+}
+
+} // end namespace detail
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_RADIX_SELECT_HPP_
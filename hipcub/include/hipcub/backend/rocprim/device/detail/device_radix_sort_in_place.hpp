@@ -0,0 +1,816 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_RADIX_SORT_IN_PLACE_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_RADIX_SORT_IN_PLACE_HPP_
+
+#include <type_traits>
+
+#include "../../../../config.hpp"
+
+#include "../../util_type.hpp"
+#include "../../block/block_load.hpp"
+#include "../../block/block_radix_sort.hpp"
+#include "../../block/block_scan.hpp"
+#include "../../block/block_store_func.hpp"
+#include "../../block/radix_rank_sort_operations.hpp"
+
+#include "device_batched_radix_sort.hpp"
+
+#include <rocprim/detail/various.hpp>
+
+BEGIN_HIPCUB_NAMESPACE
+namespace detail
+{
+
+/**
+ * Tuning of the in-place MSD radix sort.
+ *
+ * Segments of keys are partitioned by their most significant digit that is left,
+ * in rounds of a tile of keys per block: the tile is taken out of the places not
+ * yet read, then each key is swapped into the next place of its digit until a key
+ * lands on a place that was already read (American flag sort).  Segments that fit
+ * a tile are sorted by BlockRadixSort in shared memory.  The largest segments are
+ * partitioned by the whole device, smaller ones by a block each.
+ */
+template <typename KeyT, typename ValueT>
+struct RadixSortInPlacePolicy
+{
+    static constexpr int RADIX_BITS             = 8;
+    static constexpr int RADIX_DIGITS           = 1 << RADIX_BITS;
+    static constexpr int BLOCK_THREADS          = 256;
+    static constexpr int ITEM_BYTES             = (sizeof(KeyT) > sizeof(ValueT)) ? sizeof(KeyT) : sizeof(ValueT);
+    static constexpr int ITEMS_PER_THREAD       =
+        (32 / ITEM_BYTES) > 8 ? 8 : ((32 / ITEM_BYTES) < 1 ? 1 : (32 / ITEM_BYTES));
+    static constexpr int TILE_ITEMS             = BLOCK_THREADS * ITEMS_PER_THREAD;
+    static constexpr int MAX_PASSES             = (int(sizeof(KeyT) * 8) + RADIX_BITS - 1) / RADIX_BITS;
+    /// Largest segments partitioned by a single block
+    static constexpr unsigned int BLOCK_SEGMENT_ITEMS = 1u << 18;
+    /// Segments a block may have left to sort: at most RADIX_DIGITS - 1 more per digit
+    static constexpr int STACK_SEGMENTS         = MAX_PASSES * RADIX_DIGITS;
+    /// Blocks per compute unit partitioning a segment with the whole device
+    static constexpr int BLOCKS_PER_CU          = 2;
+
+    static_assert(BLOCK_THREADS >= RADIX_DIGITS, "Every digit needs a thread of its own");
+};
+
+/// Keys in [begin, end) that share their digits above \p pass
+struct RadixSortInPlaceSegment
+{
+    size_t          begin;
+    size_t          end;
+    int             pass;
+};
+
+/**
+ * Unread places of a digit: once they are all read, \p write goes past \p read.
+ * Places are 64-bit for the grid and 32-bit, relative to their segment, for a block.
+ */
+template <typename OffsetT>
+HIPCUB_DEVICE __forceinline__ OffsetT RadixSortInPlaceUnread(
+    OffsetT         write,
+    OffsetT         read)
+{
+    return (write < read) ? read - write : 0;
+}
+
+/**
+ * Digit whose unread places hold unread key \p item, given the exclusive sum
+ * \p offsets of the numbers of unread places of the digits.
+ */
+template <typename Policy, typename OffsetT>
+HIPCUB_DEVICE __forceinline__ int RadixSortInPlaceFindDigit(
+    const OffsetT*      offsets,
+    unsigned int        item)
+{
+    int digit = 0;
+    for (int step = Policy::RADIX_DIGITS / 2; step > 0; step /= 2)
+    {
+        if (offsets[digit + step] <= item)
+        {
+            digit += step;
+        }
+    }
+    return digit;
+}
+
+/**
+ * Takes unread keys [\p first, \p first + TILE_ITEMS) of a segment, with \p taken
+ * keys taken altogether, from the end of the unread places of their digits.  The
+ * unread places of digit \p d are [write[d], read[d]), and \p offsets the
+ * exclusive sum of their numbers.
+ */
+template <typename Policy, typename UnsignedBits, typename ValueT, typename OffsetT>
+HIPCUB_DEVICE __forceinline__ void RadixSortInPlaceTake(
+    const UnsignedBits* d_bits,
+    const ValueT*       d_values,
+    const OffsetT*      read,
+    const OffsetT*      offsets,
+    unsigned int        first,
+    unsigned int        taken,
+    UnsignedBits        (&keys)[Policy::ITEMS_PER_THREAD],
+    ValueT              (&values)[Policy::ITEMS_PER_THREAD])
+{
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+
+    #pragma unroll
+    for (int item = 0; item < Policy::ITEMS_PER_THREAD; ++item)
+    {
+        const unsigned int index = first + (item * Policy::BLOCK_THREADS) + hipThreadIdx_x;
+        if (index < taken)
+        {
+            const int digit = RadixSortInPlaceFindDigit<Policy>(offsets, index);
+            const OffsetT place = read[digit] - 1 - (index - offsets[digit]);
+            keys[item] = d_bits[place];
+            if (!KEYS_ONLY)
+            {
+                values[item] = d_values[place];
+            }
+        }
+    }
+}
+
+/**
+ * Puts \p key at the next place of its digit, claimed from \p write.  A place below
+ * \p read of its digit still holds an unread key, which is taken out and put at
+ * the next place of its own digit, and so on until a key lands on a place that was
+ * already read.  Every place is claimed by one thread only, and there are as many
+ * places of a digit as keys of that digit, so claims never run out.
+ */
+template <typename Policy, bool IS_DESCENDING, typename KeyT, typename ValueT, typename OffsetT>
+HIPCUB_DEVICE __forceinline__ void RadixSortInPlaceScatter(
+    typename RadixSortTwiddle<IS_DESCENDING, KeyT>::UnsignedBits*   d_bits,
+    ValueT*                                                         d_values,
+    OffsetT*                                                        write,
+    const OffsetT*                                                  read,
+    typename RadixSortTwiddle<IS_DESCENDING, KeyT>::UnsignedBits    key,
+    ValueT                                                          value,
+    DigitExtractor<typename RadixSortTwiddle<IS_DESCENDING, KeyT>::UnsignedBits>& digit_extractor)
+{
+    typedef RadixSortTwiddle<IS_DESCENDING, KeyT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+
+    while (true)
+    {
+        const int digit = digit_extractor.Digit(TwiddleT::In(key));
+        const OffsetT place = atomicAdd(&write[digit], OffsetT(1));
+        if (place >= read[digit])
+        {
+            d_bits[place] = key;
+            if (!KEYS_ONLY)
+            {
+                d_values[place] = value;
+            }
+            return;
+        }
+
+        const UnsignedBits next_key = d_bits[place];
+        d_bits[place] = key;
+        key = next_key;
+        if (!KEYS_ONLY)
+        {
+            const ValueT next_value = d_values[place];
+            d_values[place] = value;
+            value = next_value;
+        }
+    }
+}
+
+/**
+ * Counts the digits of segment [\p begin, \p end) with the whole grid.
+ */
+template <typename Policy, bool IS_DESCENDING, typename KeyT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSortInPlaceHistogramKernel(
+    const KeyT*             d_keys,
+    unsigned long long*     d_bins,     ///< [out] Digit counts (zeroed beforehand)
+    size_t                  begin,
+    size_t                  end,
+    int                     current_bit,
+    int                     num_bits)
+{
+    typedef RadixSortTwiddle<IS_DESCENDING, KeyT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+
+    // A block may count more than 2^32 keys of a digit on small devices
+    __shared__ unsigned long long bins[Policy::RADIX_DIGITS];
+
+    for (int bin = hipThreadIdx_x; bin < Policy::RADIX_DIGITS; bin += Policy::BLOCK_THREADS)
+    {
+        bins[bin] = 0;
+    }
+    ::rocprim::syncthreads();
+
+    const UnsignedBits* d_bits = reinterpret_cast<const UnsignedBits*>(d_keys);
+    DigitExtractor<UnsignedBits> digit_extractor(current_bit, num_bits);
+    for (size_t i = begin + (size_t(hipBlockIdx_x) * Policy::BLOCK_THREADS) + hipThreadIdx_x;
+         i < end;
+         i += size_t(hipGridDim_x) * Policy::BLOCK_THREADS)
+    {
+        atomicAdd(&bins[digit_extractor.Digit(TwiddleT::In(d_bits[i]))], 1ull);
+    }
+    ::rocprim::syncthreads();
+
+    for (int bin = hipThreadIdx_x; bin < Policy::RADIX_DIGITS; bin += Policy::BLOCK_THREADS)
+    {
+        if (bins[bin] != 0)
+        {
+            atomicAdd(&d_bins[bin], bins[bin]);
+        }
+    }
+}
+
+/**
+ * Turns the digit counts of segment [\p begin, end) into the places of each digit
+ * and lists the segments of the next digit, one per digit.
+ */
+template <typename Policy>
+static __global__ __launch_bounds__(Policy::RADIX_DIGITS) void
+DeviceRadixSortInPlaceScanKernel(
+    const unsigned long long*   d_bins,
+    unsigned long long*         d_write,        ///< [out] First place of each digit
+    unsigned long long*         d_read,         ///< [out] End of the places of each digit
+    RadixSortInPlaceSegment*    d_segments,     ///< [out] Segment of each digit
+    size_t                      begin,
+    int                         pass)
+{
+    typedef BlockScan<unsigned long long, Policy::RADIX_DIGITS> BlockScanT;
+
+    __shared__ typename BlockScanT::TempStorage temp_storage;
+
+    const unsigned long long count = d_bins[hipThreadIdx_x];
+    unsigned long long offset;
+    BlockScanT(temp_storage).ExclusiveSum(count, offset);
+
+    const RadixSortInPlaceSegment segment = { begin + offset, begin + offset + count, pass - 1 };
+    d_write[hipThreadIdx_x]     = segment.begin;
+    d_read[hipThreadIdx_x]      = segment.end;
+    d_segments[hipThreadIdx_x]  = segment;
+}
+
+/**
+ * Takes a tile of unread keys per block into \p d_key_buffer and \p d_value_buffer,
+ * and leaves the unread places that are left in \p d_read_out.
+ */
+template <typename Policy, bool IS_DESCENDING, typename KeyT, typename ValueT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSortInPlaceReadKernel(
+    const KeyT*                 d_keys,
+    const ValueT*               d_values,
+    const unsigned long long*   d_write,
+    const unsigned long long*   d_read,
+    unsigned long long*         d_read_out,
+    unsigned int*               d_taken,        ///< [out] Keys taken by the grid
+    KeyT*                       d_key_buffer,   ///< [out] \p TILE_ITEMS per block
+    ValueT*                     d_value_buffer) ///< [out] \p TILE_ITEMS per block
+{
+    constexpr int  BLOCK_THREADS    = Policy::BLOCK_THREADS;
+    constexpr int  ITEMS_PER_THREAD = Policy::ITEMS_PER_THREAD;
+    constexpr int  RADIX_DIGITS     = Policy::RADIX_DIGITS;
+    constexpr bool KEYS_ONLY        = std::is_same<ValueT, NullType>::value;
+
+    typedef typename RadixSortTwiddle<IS_DESCENDING, KeyT>::UnsignedBits UnsignedBits;
+    typedef BlockScan<unsigned long long, BLOCK_THREADS> BlockScanT;
+
+    __shared__ typename BlockScanT::TempStorage scan_storage;
+    __shared__ unsigned long long read[RADIX_DIGITS];
+    __shared__ unsigned long long offsets[RADIX_DIGITS];
+
+    const unsigned int linear_tid = hipThreadIdx_x;
+
+    const unsigned long long unread =
+        (linear_tid < RADIX_DIGITS) ? RadixSortInPlaceUnread(d_write[linear_tid], d_read[linear_tid]) : 0;
+    unsigned long long offset, total;
+    BlockScanT(scan_storage).ExclusiveSum(unread, offset, total);
+    if (linear_tid < RADIX_DIGITS)
+    {
+        read[linear_tid]    = d_read[linear_tid];
+        offsets[linear_tid] = offset;
+    }
+    ::rocprim::syncthreads();
+
+    const unsigned int taken = static_cast<unsigned int>(
+        ::rocprim::min(total, (unsigned long long)hipGridDim_x * Policy::TILE_ITEMS));
+    if ((hipBlockIdx_x == 0) && (linear_tid < RADIX_DIGITS))
+    {
+        d_read_out[linear_tid] = read[linear_tid] - ((taken > offset) ? ::rocprim::min(taken - offset, unread) : 0);
+        if (linear_tid == 0)
+        {
+            *d_taken = taken;
+        }
+    }
+
+    const unsigned int first = hipBlockIdx_x * Policy::TILE_ITEMS;
+    UnsignedBits keys[ITEMS_PER_THREAD];
+    ValueT       values[ITEMS_PER_THREAD];
+    RadixSortInPlaceTake<Policy>(
+        reinterpret_cast<const UnsignedBits*>(d_keys), d_values, read, offsets, first, taken, keys, values);
+
+    UnsignedBits* d_bits_buffer = reinterpret_cast<UnsignedBits*>(d_key_buffer);
+    #pragma unroll
+    for (int item = 0; item < ITEMS_PER_THREAD; ++item)
+    {
+        const unsigned int index = first + (item * BLOCK_THREADS) + linear_tid;
+        if (index < taken)
+        {
+            d_bits_buffer[index] = keys[item];
+            if (!KEYS_ONLY)
+            {
+                d_value_buffer[index] = values[item];
+            }
+        }
+    }
+}
+
+/**
+ * Swaps the keys taken by DeviceRadixSortInPlaceReadKernel into the places of their
+ * digits.
+ */
+template <typename Policy, bool IS_DESCENDING, typename KeyT, typename ValueT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSortInPlaceWriteKernel(
+    KeyT*                       d_keys,
+    ValueT*                     d_values,
+    unsigned long long*         d_write,
+    const unsigned long long*   d_read,
+    const unsigned int*         d_taken,
+    const KeyT*                 d_key_buffer,
+    const ValueT*               d_value_buffer,
+    int                         current_bit,
+    int                         num_bits)
+{
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+
+    typedef typename RadixSortTwiddle<IS_DESCENDING, KeyT>::UnsignedBits UnsignedBits;
+
+    const unsigned int taken = *d_taken;
+    const UnsignedBits* d_bits_buffer = reinterpret_cast<const UnsignedBits*>(d_key_buffer);
+    DigitExtractor<UnsignedBits> digit_extractor(current_bit, num_bits);
+
+    #pragma unroll
+    for (int item = 0; item < Policy::ITEMS_PER_THREAD; ++item)
+    {
+        const unsigned int index =
+            (hipBlockIdx_x * Policy::TILE_ITEMS) + (item * Policy::BLOCK_THREADS) + hipThreadIdx_x;
+        if (index < taken)
+        {
+            RadixSortInPlaceScatter<Policy, IS_DESCENDING, KeyT>(
+                reinterpret_cast<UnsignedBits*>(d_keys), d_values, d_write, d_read,
+                d_bits_buffer[index], KEYS_ONLY ? ValueT() : d_value_buffer[index],
+                digit_extractor);
+        }
+    }
+}
+
+/**
+ * Sorts segment \p blockIdx.x of \p d_segments, or \p root if \p d_segments is
+ * \p NULL, with one block.  Segments of a tile are sorted by BlockRadixSort over
+ * the digits they have left; longer ones are partitioned by their next digit with
+ * the places of the digits in shared memory, and their parts put on a stack of the
+ * block in \p d_stacks, depth first.  Segments that are too long for a block are
+ * left to the grid.  A block counts places from the beginning of its segment, which
+ * fit 32 bits, wherever the segment is in the keys.
+ */
+template <typename Policy, bool IS_DESCENDING, typename KeyT, typename ValueT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSortInPlaceBlockKernel(
+    KeyT*                           d_keys,
+    ValueT*                         d_values,
+    const RadixSortInPlaceSegment*  d_segments,
+    RadixSortInPlaceSegment         root,
+    RadixSortInPlaceSegment*        d_stacks,   ///< [in] \p STACK_SEGMENTS per block
+    int                             begin_bit,
+    int                             end_bit)
+{
+    constexpr int  BLOCK_THREADS    = Policy::BLOCK_THREADS;
+    constexpr int  ITEMS_PER_THREAD = Policy::ITEMS_PER_THREAD;
+    constexpr int  TILE_ITEMS       = Policy::TILE_ITEMS;
+    constexpr int  RADIX_DIGITS     = Policy::RADIX_DIGITS;
+    constexpr bool KEYS_ONLY        = std::is_same<ValueT, NullType>::value;
+
+    typedef RadixSortTwiddle<IS_DESCENDING, KeyT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+    typedef BlockLoad<KeyT, BLOCK_THREADS, ITEMS_PER_THREAD, BLOCK_LOAD_WARP_TRANSPOSE> BlockLoadKeysT;
+    typedef BlockLoad<typename std::conditional<KEYS_ONLY, KeyT, ValueT>::type,
+                      BLOCK_THREADS, ITEMS_PER_THREAD, BLOCK_LOAD_WARP_TRANSPOSE> BlockLoadValuesT;
+    typedef BlockRadixSort<KeyT, BLOCK_THREADS, ITEMS_PER_THREAD, ValueT> BlockRadixSortT;
+    typedef BlockScan<unsigned int, BLOCK_THREADS> BlockScanT;
+
+    struct _TempStorage
+    {
+        union
+        {
+            typename BlockLoadKeysT::TempStorage    load_keys;
+            typename BlockLoadValuesT::TempStorage  load_values;
+            typename BlockRadixSortT::TempStorage   sort;
+            typename BlockScanT::TempStorage        scan;
+        } aliasable;
+
+        unsigned int    bins[RADIX_DIGITS];
+        unsigned int    write[RADIX_DIGITS];
+        unsigned int    read[RADIX_DIGITS];
+        unsigned int    offsets[RADIX_DIGITS];
+        int             stack_size;
+        bool            single_digit;
+    };
+
+    __shared__ Uninitialized<_TempStorage> temp_storage_raw;
+    _TempStorage& temp_storage = temp_storage_raw.Alias();
+
+    const unsigned int linear_tid = hipThreadIdx_x;
+
+    const RadixSortInPlaceSegment first = (d_segments != nullptr) ? d_segments[hipBlockIdx_x] : root;
+    if ((first.end - first.begin) <= 1 || (first.end - first.begin) > Policy::BLOCK_SEGMENT_ITEMS)
+    {
+        return;
+    }
+
+    RadixSortInPlaceSegment* d_stack = d_stacks + (size_t(hipBlockIdx_x) * Policy::STACK_SEGMENTS);
+    if (linear_tid == 0)
+    {
+        d_stack[0] = first;
+        temp_storage.stack_size = 1;
+    }
+    ::rocprim::syncthreads();
+
+    while (temp_storage.stack_size > 0)
+    {
+        const RadixSortInPlaceSegment segment = d_stack[temp_storage.stack_size - 1];
+        ::rocprim::syncthreads();
+        if (linear_tid == 0)
+        {
+            --temp_storage.stack_size;
+            temp_storage.single_digit = false;
+        }
+
+        const unsigned int size        = static_cast<unsigned int>(segment.end - segment.begin);
+        const int          current_bit = begin_bit + (segment.pass * Policy::RADIX_BITS);
+        const int          num_bits    = ::rocprim::min(int(Policy::RADIX_BITS), end_bit - current_bit);
+
+        KeyT*         d_segment_keys   = d_keys + segment.begin;
+        ValueT*       d_segment_values = d_values + segment.begin;
+        UnsignedBits* d_bits           = reinterpret_cast<UnsignedBits*>(d_segment_keys);
+
+        if (size <= TILE_ITEMS)
+        {
+            // The digits above this one are the same for every key of the segment
+            KeyT oob_key;
+            reinterpret_cast<UnsignedBits&>(oob_key) = TwiddleT::DefaultKey();
+
+            KeyT   keys[ITEMS_PER_THREAD];
+            ValueT values[ITEMS_PER_THREAD];
+            BlockLoadKeysT(temp_storage.aliasable.load_keys).Load(
+                d_segment_keys, keys, int(size), oob_key);
+            if (!KEYS_ONLY)
+            {
+                ::rocprim::syncthreads();
+                BatchedRadixSortLoadValues<BlockLoadValuesT>(
+                    Int2Type<KEYS_ONLY>(), temp_storage.aliasable.load_values, d_segment_values, values, int(size));
+            }
+            ::rocprim::syncthreads();
+
+            BlockRadixSortT block_sort(temp_storage.aliasable.sort);
+            if (IS_DESCENDING)
+            {
+                if (KEYS_ONLY) block_sort.SortDescendingBlockedToStriped(keys, begin_bit, current_bit + num_bits);
+                else           block_sort.SortDescendingBlockedToStriped(keys, values, begin_bit, current_bit + num_bits);
+            }
+            else
+            {
+                if (KEYS_ONLY) block_sort.SortBlockedToStriped(keys, begin_bit, current_bit + num_bits);
+                else           block_sort.SortBlockedToStriped(keys, values, begin_bit, current_bit + num_bits);
+            }
+
+            StoreDirectStriped<BLOCK_THREADS>(linear_tid, d_segment_keys, keys, int(size));
+            if (!KEYS_ONLY)
+            {
+                StoreDirectStriped<BLOCK_THREADS>(linear_tid, d_segment_values, values, int(size));
+            }
+            ::rocprim::syncthreads();
+            continue;
+        }
+
+        // Digit counts, then places of each digit
+        if (linear_tid < RADIX_DIGITS)
+        {
+            temp_storage.bins[linear_tid] = 0;
+        }
+        ::rocprim::syncthreads();
+
+        DigitExtractor<UnsignedBits> digit_extractor(current_bit, num_bits);
+        for (unsigned int i = linear_tid; i < size; i += BLOCK_THREADS)
+        {
+            atomicAdd(&temp_storage.bins[digit_extractor.Digit(TwiddleT::In(d_bits[i]))], 1u);
+        }
+        ::rocprim::syncthreads();
+
+        const unsigned int count = (linear_tid < RADIX_DIGITS) ? temp_storage.bins[linear_tid] : 0;
+        unsigned int offset;
+        BlockScanT(temp_storage.aliasable.scan).ExclusiveSum(count, offset);
+        if (linear_tid < RADIX_DIGITS)
+        {
+            temp_storage.write[linear_tid] = offset;
+            temp_storage.read[linear_tid]  = offset + count;
+            if (count == size)
+            {
+                temp_storage.single_digit = true;
+            }
+        }
+        ::rocprim::syncthreads();
+
+        // Keys that all have the same digit stay where they are
+        while (!temp_storage.single_digit)
+        {
+            const unsigned int unread =
+                (linear_tid < RADIX_DIGITS) ? RadixSortInPlaceUnread(temp_storage.write[linear_tid], temp_storage.read[linear_tid]) : 0;
+            unsigned int unread_offset, total;
+            BlockScanT(temp_storage.aliasable.scan).ExclusiveSum(unread, unread_offset, total);
+            if (linear_tid < RADIX_DIGITS)
+            {
+                temp_storage.offsets[linear_tid] = unread_offset;
+            }
+            ::rocprim::syncthreads();
+
+            if (total == 0)
+            {
+                break;
+            }
+
+            const unsigned int taken = ::rocprim::min(total, unsigned(TILE_ITEMS));
+            UnsignedBits keys[ITEMS_PER_THREAD];
+            ValueT       values[ITEMS_PER_THREAD];
+            RadixSortInPlaceTake<Policy>(
+                d_bits, d_segment_values, temp_storage.read, temp_storage.offsets, 0, taken, keys, values);
+            ::rocprim::syncthreads();
+
+            if (linear_tid < RADIX_DIGITS)
+            {
+                temp_storage.read[linear_tid] -=
+                    (taken > unread_offset) ? ::rocprim::min(taken - unread_offset, unread) : 0;
+            }
+            ::rocprim::syncthreads();
+
+            #pragma unroll
+            for (int item = 0; item < ITEMS_PER_THREAD; ++item)
+            {
+                if ((item * BLOCK_THREADS) + linear_tid < taken)
+                {
+                    RadixSortInPlaceScatter<Policy, IS_DESCENDING, KeyT>(
+                        d_bits, d_segment_values, temp_storage.write, temp_storage.read,
+                        keys[item], values[item], digit_extractor);
+                }
+            }
+            ::rocprim::syncthreads();
+        }
+
+        // Parts with digits left go on the stack
+        if ((linear_tid < RADIX_DIGITS) && (segment.pass > 0) && (count > 1))
+        {
+            const RadixSortInPlaceSegment part = { segment.begin + offset, segment.begin + offset + count, segment.pass - 1 };
+            d_stack[atomicAdd(&temp_storage.stack_size, 1)] = part;
+        }
+        ::rocprim::syncthreads();
+    }
+}
+
+/**
+ * Sorts \p d_keys and \p d_values between \p begin_bit and \p end_bit in place.
+ * The temporary storage holds the places of the digits, the stacks of the blocks
+ * and a tile of keys per block of the grid, \p O((RADIX_DIGITS + TILE_ITEMS) *
+ * blocks), whatever \p num_items.  The sort is not stable.
+ *
+ * The keys, and parts longer than a block partitions, are split by the whole grid
+ * one after the other, the host waiting for the digit counts of each to know which
+ * parts are long again.  Keys taken out by a read kernel are only swapped in by the
+ * next write kernel, so that no place is written before its key has been read.  The
+ * other parts are then sorted by a block each.  The grid counts places in 64 bits,
+ * so \p num_items may exceed 2^32 - 1.
+ */
+template <bool IS_DESCENDING, typename KeyT, typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t RadixSortInPlace(
+    void*           d_temp_storage,
+    size_t&         temp_storage_bytes,
+    KeyT*           d_keys,
+    ValueT*         d_values,
+    size_t          num_items,
+    int             begin_bit,
+    int             end_bit,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    typedef RadixSortInPlacePolicy<KeyT, ValueT> Policy;
+
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+
+    hipError_t error = hipSuccess;
+
+    int device_id = 0;
+    int compute_units = 0;
+    if (HipcubDebug(error = hipGetDevice(&device_id))) return error;
+    if (HipcubDebug(error = hipDeviceGetAttribute(&compute_units, hipDeviceAttributeMultiprocessorCount, device_id))) return error;
+    const unsigned int max_grid_size = static_cast<unsigned int>(::rocprim::max(compute_units, 1) * Policy::BLOCKS_PER_CU);
+
+    const size_t bins_bytes =
+        ::rocprim::detail::align_size(sizeof(unsigned long long) * Policy::RADIX_DIGITS);
+    const size_t taken_bytes =
+        ::rocprim::detail::align_size(sizeof(unsigned int));
+    const size_t segments_bytes =
+        ::rocprim::detail::align_size(sizeof(RadixSortInPlaceSegment) * Policy::RADIX_DIGITS);
+    const size_t stacks_bytes =
+        ::rocprim::detail::align_size(sizeof(RadixSortInPlaceSegment) * Policy::RADIX_DIGITS * Policy::STACK_SEGMENTS);
+    const size_t key_buffer_bytes =
+        ::rocprim::detail::align_size(sizeof(KeyT) * max_grid_size * Policy::TILE_ITEMS);
+    const size_t value_buffer_bytes = KEYS_ONLY ? 0 :
+        ::rocprim::detail::align_size(sizeof(ValueT) * max_grid_size * Policy::TILE_ITEMS);
+    const size_t required_bytes =
+        (4 * bins_bytes) + taken_bytes + segments_bytes + stacks_bytes + key_buffer_bytes + value_buffer_bytes;
+
+    if (d_temp_storage == nullptr)
+    {
+        temp_storage_bytes = required_bytes;
+        return hipSuccess;
+    }
+
+    if (temp_storage_bytes < required_bytes)
+    {
+        return hipErrorInvalidValue;
+    }
+
+    if ((begin_bit < 0) || (end_bit > int(sizeof(KeyT) * 8)))
+    {
+        return hipErrorInvalidValue;
+    }
+
+    if ((num_items <= 1) || (end_bit <= begin_bit))
+    {
+        return hipSuccess;
+    }
+
+    char* d_temp = static_cast<char*>(d_temp_storage);
+    unsigned long long* d_bins      = reinterpret_cast<unsigned long long*>(d_temp);
+    unsigned long long* d_write     = reinterpret_cast<unsigned long long*>(d_temp + bins_bytes);
+    unsigned long long* d_read[2]   = {
+        reinterpret_cast<unsigned long long*>(d_temp + (2 * bins_bytes)),
+        reinterpret_cast<unsigned long long*>(d_temp + (3 * bins_bytes))
+    };
+    d_temp += 4 * bins_bytes;
+    unsigned int*               d_taken         = reinterpret_cast<unsigned int*>(d_temp);
+    RadixSortInPlaceSegment*    d_segments      = reinterpret_cast<RadixSortInPlaceSegment*>(d_temp + taken_bytes);
+    RadixSortInPlaceSegment*    d_stacks        = reinterpret_cast<RadixSortInPlaceSegment*>(d_temp + taken_bytes + segments_bytes);
+    d_temp += taken_bytes + segments_bytes + stacks_bytes;
+    KeyT*                       d_key_buffer    = reinterpret_cast<KeyT*>(d_temp);
+    ValueT*                     d_value_buffer  = KEYS_ONLY ? nullptr : reinterpret_cast<ValueT*>(d_temp + key_buffer_bytes);
+
+    const int num_passes = DivideAndRoundUp(end_bit - begin_bit, int(Policy::RADIX_BITS));
+    const RadixSortInPlaceSegment root = { 0, num_items, num_passes - 1 };
+
+    // Segments split by the grid, depth first: the keys, parts too long for a block
+    // and parts that are all the keys of their segment.  Each leaves at most
+    // RADIX_DIGITS - 1 more per digit on the stack.
+    RadixSortInPlaceSegment stack[Policy::STACK_SEGMENTS];
+    int stack_size = 0;
+    stack[stack_size++] = root;
+
+    while (stack_size > 0)
+    {
+        const RadixSortInPlaceSegment segment = stack[--stack_size];
+        const size_t       size        = segment.end - segment.begin;
+        const int          current_bit = begin_bit + (segment.pass * Policy::RADIX_BITS);
+        const int          num_bits    = ::rocprim::min(int(Policy::RADIX_BITS), end_bit - current_bit);
+        const unsigned int grid_size   = static_cast<unsigned int>(
+            ::rocprim::min(DivideAndRoundUp(size, size_t(Policy::TILE_ITEMS)), size_t(max_grid_size)));
+
+        // A segment that fits a block is left to one
+        if (size <= Policy::BLOCK_SEGMENT_ITEMS)
+        {
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(DeviceRadixSortInPlaceBlockKernel<Policy, IS_DESCENDING, KeyT, ValueT>),
+                dim3(1), dim3(Policy::BLOCK_THREADS), 0, stream,
+                d_keys, d_values, nullptr, segment, d_stacks, begin_bit, end_bit);
+            if (HipcubDebug(error = hipPeekAtLastError())) return error;
+            if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+            continue;
+        }
+
+        if (HipcubDebug(error = hipMemsetAsync(d_bins, 0, bins_bytes, stream))) return error;
+
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceRadixSortInPlaceHistogramKernel<Policy, IS_DESCENDING, KeyT>),
+            dim3(grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+            d_keys, d_bins, segment.begin, segment.end, current_bit, num_bits);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceRadixSortInPlaceScanKernel<Policy>),
+            dim3(1), dim3(Policy::RADIX_DIGITS), 0, stream,
+            d_bins, d_write, d_read[0], d_segments, segment.begin, segment.pass);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        // The host needs the counts to tell the long parts
+        unsigned long long counts[Policy::RADIX_DIGITS];
+        if (HipcubDebug(error = hipMemcpyAsync(counts, d_bins, sizeof(counts), hipMemcpyDeviceToHost, stream))) return error;
+        if (HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        // Keys that all have the same digit, e.g. the upper bytes of timestamps, stay
+        // where they are and go on to the next digit
+        bool single_digit = false;
+        for (int digit = 0; digit < Policy::RADIX_DIGITS; ++digit)
+        {
+            single_digit = single_digit || (counts[digit] == size);
+        }
+
+        if (single_digit)
+        {
+            if (segment.pass > 0)
+            {
+                const RadixSortInPlaceSegment part = { segment.begin, segment.end, segment.pass - 1 };
+                stack[stack_size++] = part;
+            }
+            continue;
+        }
+
+        // Every round takes at least a tile per block out of the unread places
+        const size_t num_rounds = DivideAndRoundUp(size, size_t(grid_size) * Policy::TILE_ITEMS);
+        for (size_t round = 0; round < num_rounds; ++round)
+        {
+            unsigned long long* d_read_in  = d_read[round % 2];
+            unsigned long long* d_read_out = d_read[(round + 1) % 2];
+
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(DeviceRadixSortInPlaceReadKernel<Policy, IS_DESCENDING, KeyT, ValueT>),
+                dim3(grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+                d_keys, d_values, d_write, d_read_in, d_read_out, d_taken, d_key_buffer, d_value_buffer);
+            if (HipcubDebug(error = hipPeekAtLastError())) return error;
+            if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(DeviceRadixSortInPlaceWriteKernel<Policy, IS_DESCENDING, KeyT, ValueT>),
+                dim3(grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+                d_keys, d_values, d_write, d_read_out, d_taken, d_key_buffer, d_value_buffer,
+                current_bit, num_bits);
+            if (HipcubDebug(error = hipPeekAtLastError())) return error;
+            if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+        }
+
+        if (segment.pass == 0)
+        {
+            continue;
+        }
+
+        // Parts that fit a block are sorted by a block each, stream ordered before the
+        // next long segment overwrites d_segments
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceRadixSortInPlaceBlockKernel<Policy, IS_DESCENDING, KeyT, ValueT>),
+            dim3(Policy::RADIX_DIGITS), dim3(Policy::BLOCK_THREADS), 0, stream,
+            d_keys, d_values, d_segments, root, d_stacks, begin_bit, end_bit);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        size_t offset = segment.begin;
+        for (int digit = 0; digit < Policy::RADIX_DIGITS; ++digit)
+        {
+            if (counts[digit] > Policy::BLOCK_SEGMENT_ITEMS)
+            {
+                const RadixSortInPlaceSegment part = { offset, offset + counts[digit], segment.pass - 1 };
+                stack[stack_size++] = part;
+            }
+            offset += counts[digit];
+        }
+    }
+
+    return error;
+}
+
+} // end namespace detail
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_RADIX_SORT_IN_PLACE_HPP_
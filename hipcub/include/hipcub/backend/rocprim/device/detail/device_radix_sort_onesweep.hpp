@@ -0,0 +1,889 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_RADIX_SORT_ONESWEEP_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_RADIX_SORT_ONESWEEP_HPP_
+
+#include <type_traits>
+
+#include "../../../../config.hpp"
+
+#include "../../util_ptx.hpp"
+#include "../../util_type.hpp"
+#include "../../block/block_adjacent_difference.hpp"
+#include "../../block/block_radix_rank.hpp"
+#include "../../block/block_scan.hpp"
+#include "../../block/radix_rank_sort_operations.hpp"
+
+#include <rocprim/detail/various.hpp>
+
+BEGIN_HIPCUB_NAMESPACE
+namespace detail
+{
+
+/**
+ * Tuning of the onesweep radix sort.
+ *
+ * Each pass ranks a tile of keys with BlockRadixRankMatch and scatters it straight
+ * to its place in the output, so a pass reads and writes the keys once instead of
+ * the upsweep, scan and downsweep of the classic LSD sort.
+ */
+template <typename KeyT, typename ValueT, typename DecomposerT = NullType>
+struct RadixSortOnesweepPolicy
+{
+    static constexpr int RADIX_BITS         = 8;
+    static constexpr int RADIX_DIGITS       = 1 << RADIX_BITS;
+    static constexpr int BLOCK_THREADS      = 256;
+    static constexpr int ITEM_BYTES         = (sizeof(KeyT) > sizeof(ValueT)) ? sizeof(KeyT) : sizeof(ValueT);
+    static constexpr int ITEMS_PER_THREAD   =
+        (64 / ITEM_BYTES) > 16 ? 16 : ((64 / ITEM_BYTES) < 1 ? 1 : (64 / ITEM_BYTES));
+    static constexpr int TILE_ITEMS         = BLOCK_THREADS * ITEMS_PER_THREAD;
+    static constexpr int MAX_PASSES         =
+        (RadixSortTwiddle<false, KeyT, DecomposerT>::KEY_BITS + RADIX_BITS - 1) / RADIX_BITS;
+
+    static_assert(BLOCK_THREADS >= RADIX_DIGITS, "Every digit needs a thread of its own");
+};
+
+/**
+ * Status of a digit of a tile in the decoupled look-back.  The two most significant
+ * bits tell whether the tile has published nothing yet, the count of the digit in
+ * the tile alone, or the count in the tile and all tiles before it.
+ */
+typedef unsigned long long RadixSortLookbackT;
+
+constexpr RadixSortLookbackT radix_sort_lookback_aggregate  = RadixSortLookbackT(1) << 62;
+constexpr RadixSortLookbackT radix_sort_lookback_prefix     = RadixSortLookbackT(2) << 62;
+constexpr RadixSortLookbackT radix_sort_lookback_flags      = RadixSortLookbackT(3) << 62;
+
+/**
+ * Order of the input as found by the histogram kernel.  Each pair of adjacent keys
+ * sets one flag, so input with neither flag set is in order and input with only
+ * \p radix_sort_order_not_sorted set is in strictly reverse order.
+ */
+constexpr unsigned int radix_sort_order_not_sorted      = 1;    ///< A key sorts before the key preceding it
+constexpr unsigned int radix_sort_order_not_reversed    = 2;    ///< A key does not sort strictly before the key preceding it
+
+/// Whether the sort of input of order \p order is a copy or a reversal of the input
+HIPCUB_HOST_DEVICE __forceinline__ bool RadixSortOrderPresorted(unsigned int order)
+{
+    return ((order & radix_sort_order_not_sorted) == 0)
+        || ((order & radix_sort_order_not_reversed) == 0);
+}
+
+/**
+ * Order flag of a key and the key preceding it, twiddled, comparing their digits
+ * between \p begin_bit and \p end_bit from the most significant one.
+ */
+template <typename Policy, typename UnsignedBits, typename DecomposerT>
+struct RadixSortOrderOp
+{
+    int         begin_bit;
+    int         end_bit;
+    DecomposerT decomposer;
+
+    HIPCUB_DEVICE __forceinline__ unsigned int operator()(const UnsignedBits& previous, const UnsignedBits& key) const
+    {
+        const int num_passes = DivideAndRoundUp(end_bit - begin_bit, Policy::RADIX_BITS);
+        for (int pass = num_passes - 1; pass >= 0; --pass)
+        {
+            const int current_bit = begin_bit + (pass * Policy::RADIX_BITS);
+            const int num_bits    = ::rocprim::min(int(Policy::RADIX_BITS), end_bit - current_bit);
+            DigitExtractor<UnsignedBits, DecomposerT> digit_extractor(current_bit, num_bits, decomposer);
+            const int previous_digit = digit_extractor.Digit(previous);
+            const int digit          = digit_extractor.Digit(key);
+            if (previous_digit != digit)
+            {
+                return (previous_digit < digit) ? radix_sort_order_not_reversed : radix_sort_order_not_sorted;
+            }
+        }
+        // Equal keys would not stay in order if reversed
+        return radix_sort_order_not_reversed;
+    }
+};
+
+/**
+ * Counts the digits of all passes in one read of the keys.  Unless \p d_order is
+ * \p NULL, the same read compares adjacent keys to find whether they are already
+ * in order or in reverse order.
+ */
+template <
+    typename    Policy,
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    DecomposerT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSortHistogramKernel(
+    const KeyT*     d_keys,
+    unsigned int*   d_bins,         ///< [out] Digit counts, \p RADIX_DIGITS per pass
+    unsigned int*   d_order,        ///< [out] Order flags of the keys (zeroed beforehand), or \p NULL not to check the order
+    unsigned int    num_items,
+    int             begin_bit,
+    int             end_bit,
+    DecomposerT     decomposer)
+{
+    typedef RadixSortTwiddle<IS_DESCENDING, KeyT, DecomposerT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+
+    typedef BlockAdjacentDifference<UnsignedBits, Policy::BLOCK_THREADS> BlockAdjacentDifferenceT;
+    typedef RadixSortOrderOp<Policy, UnsignedBits, DecomposerT> OrderOpT;
+
+    const TwiddleT twiddle(decomposer);
+
+    constexpr int BINS = Policy::MAX_PASSES * Policy::RADIX_DIGITS;
+
+    __shared__ unsigned int bins[BINS];
+    __shared__ typename BlockAdjacentDifferenceT::TempStorage adjacent_storage;
+    __shared__ unsigned int block_order;
+
+    const int  num_passes  = DivideAndRoundUp(end_bit - begin_bit, Policy::RADIX_BITS);
+    const bool check_order = (d_order != nullptr);
+    const OrderOpT order_op = { begin_bit, end_bit, decomposer };
+
+    for (int bin = hipThreadIdx_x; bin < BINS; bin += Policy::BLOCK_THREADS)
+    {
+        bins[bin] = 0;
+    }
+    if (hipThreadIdx_x == 0)
+    {
+        block_order = 0;
+    }
+    ::rocprim::syncthreads();
+
+    // Blocks step over the keys a block-wide run at a time, so that the whole block
+    // compares each run with BlockAdjacentDifference
+    const UnsignedBits* d_bits = reinterpret_cast<const UnsignedBits*>(d_keys);
+    unsigned int order = 0;
+    for (size_t run_offset = size_t(hipBlockIdx_x) * Policy::BLOCK_THREADS;
+         run_offset < num_items;
+         run_offset += size_t(hipGridDim_x) * Policy::BLOCK_THREADS)
+    {
+        const size_t i     = run_offset + hipThreadIdx_x;
+        const bool   valid = (i < num_items);
+        UnsignedBits keys[1] = { twiddle.In(d_bits[valid ? i : (num_items - 1)]) };
+
+        if (valid)
+        {
+            for (int pass = 0; pass < num_passes; ++pass)
+            {
+                const int current_bit = begin_bit + (pass * Policy::RADIX_BITS);
+                const int num_bits    = ::rocprim::min(int(Policy::RADIX_BITS), end_bit - current_bit);
+                DigitExtractor<UnsignedBits, DecomposerT> digit_extractor(current_bit, num_bits, decomposer);
+                atomicAdd(&bins[(pass * Policy::RADIX_DIGITS) + digit_extractor.Digit(keys[0])], 1u);
+            }
+        }
+
+        if (check_order)
+        {
+            // The first key of the run follows the last key of the run before it
+            const UnsignedBits predecessor = twiddle.In(d_bits[(run_offset == 0) ? 0 : (run_offset - 1)]);
+            unsigned int flags[1];
+            BlockAdjacentDifferenceT(adjacent_storage).FlagHeads(flags, keys, order_op, predecessor);
+            if (valid && (i != 0))
+            {
+                order |= flags[0];
+            }
+            ::rocprim::syncthreads();
+        }
+    }
+    if (order != 0)
+    {
+        atomicOr(&block_order, order);
+    }
+    ::rocprim::syncthreads();
+
+    for (int bin = hipThreadIdx_x; bin < num_passes * Policy::RADIX_DIGITS; bin += Policy::BLOCK_THREADS)
+    {
+        if (bins[bin] != 0)
+        {
+            atomicAdd(&d_bins[bin], bins[bin]);
+        }
+    }
+    if (check_order && (hipThreadIdx_x == 0) && (block_order != 0))
+    {
+        atomicOr(d_order, block_order);
+    }
+}
+
+/**
+ * Turns the digit counts of each pass into the offset of each digit in the output.
+ * One block per pass.  A pass whose digit is the same in every key would leave the
+ * keys where they are; if \p d_constant_passes is not \p NULL, such passes are
+ * flagged in it.
+ */
+template <typename Policy>
+static __global__ __launch_bounds__(Policy::RADIX_DIGITS) void
+DeviceRadixSortExclusiveSumKernel(
+    unsigned int*   d_bins,
+    unsigned int*   d_constant_passes,  ///< [out] Set to 1 for passes with a single digit (zeroed beforehand)
+    unsigned int    num_items)
+{
+    typedef BlockScan<unsigned int, Policy::RADIX_DIGITS> BlockScanT;
+
+    __shared__ typename BlockScanT::TempStorage temp_storage;
+
+    unsigned int* d_pass_bins = d_bins + (hipBlockIdx_x * Policy::RADIX_DIGITS);
+    unsigned int count = d_pass_bins[hipThreadIdx_x];
+    if ((d_constant_passes != nullptr) && (count == num_items))
+    {
+        d_constant_passes[hipBlockIdx_x] = 1;
+    }
+    BlockScanT(temp_storage).ExclusiveSum(count, count);
+    d_pass_bins[hipThreadIdx_x] = count;
+}
+
+/**
+ * Index \p i as a value, for sorts that generate the values 0, 1, ... on the fly
+ */
+template <typename ValueT>
+HIPCUB_DEVICE __forceinline__ ValueT RadixSortIndex(size_t i)
+{
+    return static_cast<ValueT>(i);
+}
+
+template <>
+HIPCUB_DEVICE __forceinline__ NullType RadixSortIndex<NullType>(size_t)
+{
+    return NullType();
+}
+
+/**
+ * Writes the indices 0, 1, ... to \p d_values_out.
+ */
+template <typename Policy, typename ValueT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSortIndicesKernel(
+    ValueT*         d_values_out,
+    unsigned int    num_items)
+{
+    for (size_t i = (size_t(hipBlockIdx_x) * Policy::BLOCK_THREADS) + hipThreadIdx_x;
+         i < num_items;
+         i += size_t(hipGridDim_x) * Policy::BLOCK_THREADS)
+    {
+        d_values_out[i] = RadixSortIndex<ValueT>(i);
+    }
+}
+
+/**
+ * Zeroes the look-back and the tile counter of a pass, in place of a memset when the
+ * order of the keys is checked: nothing is written for keys the histogram kernel
+ * found to be presorted, whose passes return at once.
+ */
+template <typename Policy>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSortLookbackInitKernel(
+    unsigned int*           d_words,    ///< [out] Look-back followed by the tile counter
+    size_t                  num_words,
+    const unsigned int*     d_order)    ///< [in] Order flags of the keys
+{
+    if (RadixSortOrderPresorted(*d_order))
+    {
+        return;
+    }
+
+    for (size_t i = (size_t(hipBlockIdx_x) * Policy::BLOCK_THREADS) + hipThreadIdx_x;
+         i < num_words;
+         i += size_t(hipGridDim_x) * Policy::BLOCK_THREADS)
+    {
+        d_words[i] = 0;
+    }
+}
+
+/**
+ * Writes the sorted keys and values of input that the histogram kernel found to be
+ * in order, as a copy, or in strictly reverse order, as a reversal, and does nothing
+ * otherwise.  In place, only reversed input is touched.  A \p NULL \p d_keys_out
+ * discards the keys and a \p NULL \p d_values_in stands for the indices of the keys.
+ */
+template <typename Policy, typename KeyT, typename ValueT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSortPresortedKernel(
+    const KeyT*             d_keys_in,
+    KeyT*                   d_keys_out,
+    const ValueT*           d_values_in,
+    ValueT*                 d_values_out,
+    unsigned int            num_items,
+    bool                    in_place,
+    const unsigned int*     d_order)
+{
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+
+    const unsigned int order = *d_order;
+    if (!RadixSortOrderPresorted(order))
+    {
+        return;
+    }
+    const bool reversed = (order & radix_sort_order_not_sorted) != 0;
+
+    const size_t step = size_t(hipGridDim_x) * Policy::BLOCK_THREADS;
+    if (in_place)
+    {
+        if (!reversed)
+        {
+            return;
+        }
+        for (size_t i = (size_t(hipBlockIdx_x) * Policy::BLOCK_THREADS) + hipThreadIdx_x; i < (num_items / 2); i += step)
+        {
+            const size_t j = num_items - 1 - i;
+            const KeyT key = d_keys_out[i];
+            d_keys_out[i] = d_keys_out[j];
+            d_keys_out[j] = key;
+            if (!KEYS_ONLY)
+            {
+                const ValueT value = d_values_out[i];
+                d_values_out[i] = d_values_out[j];
+                d_values_out[j] = value;
+            }
+        }
+        return;
+    }
+
+    for (size_t i = (size_t(hipBlockIdx_x) * Policy::BLOCK_THREADS) + hipThreadIdx_x; i < num_items; i += step)
+    {
+        const size_t source = reversed ? (num_items - 1 - i) : i;
+        if (d_keys_out != nullptr)
+        {
+            d_keys_out[i] = d_keys_in[source];
+        }
+        if (!KEYS_ONLY)
+        {
+            d_values_out[i] = (d_values_in != nullptr) ? d_values_in[source] : RadixSortIndex<ValueT>(source);
+        }
+    }
+}
+
+/**
+ * Sorts the keys and values by one digit.  Tiles are taken in order from
+ * \p d_tile_counter; each tile ranks its keys, looks back across the tiles before
+ * it for the count of each digit and scatters to the output.  A \p NULL
+ * \p d_keys_out discards the sorted keys and a \p NULL \p d_values_in stands for
+ * the indices of the keys.  Input that is already in order or in reverse order,
+ * per the non-\p NULL \p d_order, is left to the presorted kernel.
+ */
+template <
+    typename    Policy,
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT,
+    typename    DecomposerT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceRadixSortOnesweepKernel(
+    const KeyT*             d_keys_in,
+    KeyT*                   d_keys_out,         ///< [out] Sorted keys, or \p NULL to discard them
+    const ValueT*           d_values_in,        ///< [in] Values, or \p NULL for the indices of the keys
+    ValueT*                 d_values_out,
+    unsigned int            num_items,
+    const unsigned int*     d_bins,             ///< [in] Offset of each digit of this pass in the output
+    RadixSortLookbackT*     d_lookback,         ///< [in] Zeroed look-back, \p RADIX_DIGITS per tile
+    unsigned int*           d_tile_counter,     ///< [in] Zeroed tile counter
+    const unsigned int*     d_order,            ///< [in] Order flags of the keys, or \p NULL if not checked
+    int                     current_bit,
+    int                     num_bits,
+    DecomposerT             decomposer)
+{
+    typedef RadixSortTwiddle<IS_DESCENDING, KeyT, DecomposerT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+    typedef BlockRadixRankMatch<Policy::BLOCK_THREADS, Policy::RADIX_BITS, false> BlockRadixRankT;
+
+    constexpr int  BLOCK_THREADS    = Policy::BLOCK_THREADS;
+    constexpr int  ITEMS_PER_THREAD = Policy::ITEMS_PER_THREAD;
+    constexpr int  TILE_ITEMS       = Policy::TILE_ITEMS;
+    constexpr int  RADIX_DIGITS     = Policy::RADIX_DIGITS;
+    constexpr int  WARP_THREADS     = HIPCUB_DEVICE_WARP_THREADS;
+    constexpr int  WARP_ITEMS       = WARP_THREADS * ITEMS_PER_THREAD;
+    constexpr bool KEYS_ONLY        = std::is_same<ValueT, NullType>::value;
+
+    static_assert(BLOCK_THREADS % WARP_THREADS == 0, "Blocks must be made of whole warps");
+
+    struct _TempStorage
+    {
+        union
+        {
+            typename BlockRadixRankT::TempStorage   rank;
+            UnsignedBits                            keys[TILE_ITEMS];
+            ValueT                                  values[TILE_ITEMS];
+        } aliasable;
+
+        unsigned int    digit_prefix[RADIX_DIGITS + 1];
+        unsigned int    digit_offset[RADIX_DIGITS];
+        unsigned int    tile_id;
+    };
+
+    __shared__ Uninitialized<_TempStorage> temp_storage_raw;
+    _TempStorage& temp_storage = temp_storage_raw.Alias();
+
+    if ((d_order != nullptr) && RadixSortOrderPresorted(*d_order))
+    {
+        return;
+    }
+
+    const unsigned int linear_tid = hipThreadIdx_x;
+    const TwiddleT twiddle(decomposer);
+    DigitExtractor<UnsignedBits, DecomposerT> digit_extractor(current_bit, num_bits, decomposer);
+
+    if (linear_tid == 0)
+    {
+        temp_storage.tile_id = atomicAdd(d_tile_counter, 1u);
+    }
+    ::rocprim::syncthreads();
+
+    const unsigned int tile_id     = temp_storage.tile_id;
+    const size_t       tile_offset = size_t(tile_id) * TILE_ITEMS;
+    const int          valid_items = int(::rocprim::min(size_t(TILE_ITEMS), num_items - tile_offset));
+
+    // Keys are loaded warp-striped: BlockRadixRankMatch ranks equal digits in warp,
+    // item, lane order, which is then the order of the keys in the input
+    const int warp_offset = (linear_tid / WARP_THREADS) * WARP_ITEMS;
+    const int lane        = linear_tid % WARP_THREADS;
+
+    const UnsignedBits* d_bits_in = reinterpret_cast<const UnsignedBits*>(d_keys_in);
+    UnsignedBits keys[ITEMS_PER_THREAD];
+
+    #pragma unroll
+    for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+    {
+        const int item = warp_offset + (ITEM * WARP_THREADS) + lane;
+        // Padding ranks after every valid key
+        keys[ITEM] = (item < valid_items)
+            ? twiddle.In(d_bits_in[tile_offset + item])
+            : twiddle.MaxBits();
+    }
+
+    int ranks[ITEMS_PER_THREAD];
+    int exclusive_digit_prefix[BlockRadixRankT::BINS_TRACKED_PER_THREAD];
+    BlockRadixRankT(temp_storage.aliasable.rank).RankKeys(
+        keys, ranks, digit_extractor, exclusive_digit_prefix);
+
+    if (linear_tid < RADIX_DIGITS)
+    {
+        temp_storage.digit_prefix[linear_tid] = exclusive_digit_prefix[0];
+    }
+    if (linear_tid == 0)
+    {
+        temp_storage.digit_prefix[RADIX_DIGITS] = TILE_ITEMS;
+    }
+    ::rocprim::syncthreads();
+
+    // Decoupled look-back of the count of each digit in the tiles before this one
+    if (linear_tid < RADIX_DIGITS)
+    {
+        const unsigned int digit = linear_tid;
+        const unsigned int count =
+            ::rocprim::min(temp_storage.digit_prefix[digit + 1], static_cast<unsigned int>(valid_items))
+            - ::rocprim::min(temp_storage.digit_prefix[digit], static_cast<unsigned int>(valid_items));
+
+        RadixSortLookbackT* d_tile_lookback = d_lookback + (size_t(tile_id) * RADIX_DIGITS);
+        unsigned int exclusive = 0;
+        if (tile_id == 0)
+        {
+            atomicExch(&d_tile_lookback[digit], radix_sort_lookback_prefix | count);
+        }
+        else
+        {
+            atomicExch(&d_tile_lookback[digit], radix_sort_lookback_aggregate | count);
+
+            for (RadixSortLookbackT* d_predecessor = d_tile_lookback - RADIX_DIGITS; ; d_predecessor -= RADIX_DIGITS)
+            {
+                RadixSortLookbackT status;
+                do
+                {
+                    status = atomicAdd(&d_predecessor[digit], RadixSortLookbackT(0));
+                } while ((status & radix_sort_lookback_flags) == 0);
+
+                exclusive += static_cast<unsigned int>(status & ~radix_sort_lookback_flags);
+                if ((status & radix_sort_lookback_flags) == radix_sort_lookback_prefix)
+                {
+                    break;
+                }
+            }
+
+            atomicExch(&d_tile_lookback[digit], radix_sort_lookback_prefix | (exclusive + count));
+        }
+
+        temp_storage.digit_offset[digit] = d_bins[digit] + exclusive - temp_storage.digit_prefix[digit];
+    }
+    ::rocprim::syncthreads();
+
+    // Scatter through shared memory so that consecutive threads write consecutive
+    // items of the same digit
+    #pragma unroll
+    for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+    {
+        temp_storage.aliasable.keys[ranks[ITEM]] = keys[ITEM];
+    }
+    ::rocprim::syncthreads();
+
+    UnsignedBits* d_bits_out = reinterpret_cast<UnsignedBits*>(d_keys_out);
+    unsigned int  positions[ITEMS_PER_THREAD];
+
+    #pragma unroll
+    for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+    {
+        const int item = (ITEM * BLOCK_THREADS) + linear_tid;
+        if (item < valid_items)
+        {
+            const UnsignedBits key = temp_storage.aliasable.keys[item];
+            positions[ITEM] = temp_storage.digit_offset[digit_extractor.Digit(key)] + item;
+            if (d_bits_out != nullptr)
+            {
+                d_bits_out[positions[ITEM]] = twiddle.Out(key);
+            }
+        }
+    }
+
+    if (!KEYS_ONLY)
+    {
+        ValueT values[ITEMS_PER_THREAD];
+
+        #pragma unroll
+        for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+        {
+            const int item = warp_offset + (ITEM * WARP_THREADS) + lane;
+            if (item < valid_items)
+            {
+                values[ITEM] = (d_values_in != nullptr)
+                    ? d_values_in[tile_offset + item]
+                    : RadixSortIndex<ValueT>(tile_offset + item);
+            }
+        }
+        ::rocprim::syncthreads();
+
+        #pragma unroll
+        for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+        {
+            const int item = warp_offset + (ITEM * WARP_THREADS) + lane;
+            if (item < valid_items)
+            {
+                temp_storage.aliasable.values[ranks[ITEM]] = values[ITEM];
+            }
+        }
+        ::rocprim::syncthreads();
+
+        #pragma unroll
+        for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+        {
+            const int item = (ITEM * BLOCK_THREADS) + linear_tid;
+            if (item < valid_items)
+            {
+                d_values_out[positions[ITEM]] = temp_storage.aliasable.values[item];
+            }
+        }
+    }
+}
+
+/**
+ * Sorts \p d_keys and \p d_values between \p begin_bit and \p end_bit with the
+ * onesweep kernels.  Sorted data ends up in the current buffers of \p d_keys and
+ * \p d_values.  Unless \p is_overwrite_okay, the current buffers are left untouched,
+ * the alternate buffers receive the result and \p d_temp_storage provides the
+ * buffers the passes alternate between.  With \p narrow_bit_range, passes over
+ * digits that are the same in every key are skipped; this synchronizes \p stream
+ * once the histograms are known.  With \p check_presorted, the histogram kernel
+ * also finds whether the keys are already in order or in strictly reverse order;
+ * such input is copied or reversed to the output in one more kernel and the passes
+ * return at once, without zeroing their look-back and without the host waiting for
+ * the check.  With \p narrow_bit_range as well, the host learns the check along with
+ * the histograms and launches no pass for such input.
+ *
+ * Unless \p is_overwrite_okay, a \p NULL current values buffer stands for the
+ * indices 0, 1, ... of the keys, which are then generated by the first pass, and a
+ * \p NULL alternate keys buffer discards the sorted keys.
+ */
+template <
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT,
+    typename    DecomposerT = NullType>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t RadixSortOnesweep(
+    void*                   d_temp_storage,
+    size_t&                 temp_storage_bytes,
+    DoubleBuffer<KeyT>&     d_keys,
+    DoubleBuffer<ValueT>&   d_values,
+    bool                    is_overwrite_okay,
+    unsigned int            num_items,
+    int                     begin_bit,
+    int                     end_bit,
+    hipStream_t             stream,
+    bool                    debug_synchronous,
+    DecomposerT             decomposer = DecomposerT(),
+    bool                    narrow_bit_range = false,
+    bool                    check_presorted = false)
+{
+    typedef RadixSortOnesweepPolicy<KeyT, ValueT, DecomposerT> Policy;
+
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+
+    const bool discard_keys = !is_overwrite_okay && (d_keys.Alternate() == nullptr);
+    const bool index_values = !is_overwrite_okay && !KEYS_ONLY && (d_values.Current() == nullptr);
+
+    const int num_passes = (end_bit > begin_bit)
+        ? DivideAndRoundUp(end_bit - begin_bit, int(Policy::RADIX_BITS))
+        : 0;
+    const size_t num_tiles = DivideAndRoundUp(size_t(num_items), size_t(Policy::TILE_ITEMS));
+
+    const size_t lookback_bytes =
+        ::rocprim::detail::align_size(sizeof(RadixSortLookbackT) * num_tiles * Policy::RADIX_DIGITS);
+    const size_t counter_bytes =
+        ::rocprim::detail::align_size(sizeof(unsigned int));
+    const size_t bins_bytes =
+        ::rocprim::detail::align_size(sizeof(unsigned int) * Policy::MAX_PASSES * Policy::RADIX_DIGITS);
+    const size_t order_bytes = !check_presorted ? 0 :
+        ::rocprim::detail::align_size(sizeof(unsigned int));
+    const size_t constant_passes_bytes = !narrow_bit_range ? 0 :
+        ::rocprim::detail::align_size(sizeof(unsigned int) * Policy::MAX_PASSES);
+    // Discarded keys still need a second buffer to alternate with
+    const size_t keys_bytes = is_overwrite_okay ? 0 :
+        ::rocprim::detail::align_size(sizeof(KeyT) * num_items) * (discard_keys ? 2 : 1);
+    const size_t values_bytes = (is_overwrite_okay || KEYS_ONLY) ? 0 :
+        ::rocprim::detail::align_size(sizeof(ValueT) * num_items);
+    const size_t required_bytes =
+        lookback_bytes + counter_bytes + bins_bytes + order_bytes + constant_passes_bytes + keys_bytes + values_bytes;
+
+    if (d_temp_storage == nullptr)
+    {
+        temp_storage_bytes = required_bytes;
+        return hipSuccess;
+    }
+
+    if (temp_storage_bytes < required_bytes)
+    {
+        return hipErrorInvalidValue;
+    }
+
+    if ((begin_bit < 0) || (end_bit > RadixSortTwiddle<IS_DESCENDING, KeyT, DecomposerT>::KEY_BITS))
+    {
+        return hipErrorInvalidValue;
+    }
+
+    char* d_temp = static_cast<char*>(d_temp_storage);
+    RadixSortLookbackT* d_lookback      = reinterpret_cast<RadixSortLookbackT*>(d_temp);
+    unsigned int*       d_tile_counter  = reinterpret_cast<unsigned int*>(d_temp + lookback_bytes);
+    unsigned int*       d_bins          = reinterpret_cast<unsigned int*>(d_temp + lookback_bytes + counter_bytes);
+    unsigned int*       d_order         = !check_presorted ? nullptr :
+        reinterpret_cast<unsigned int*>(d_temp + lookback_bytes + counter_bytes + bins_bytes);
+    unsigned int*       d_constant_passes = !narrow_bit_range ? nullptr :
+        reinterpret_cast<unsigned int*>(d_temp + lookback_bytes + counter_bytes + bins_bytes + order_bytes);
+    char*               d_buffers       =
+        d_temp + lookback_bytes + counter_bytes + bins_bytes + order_bytes + constant_passes_bytes;
+    KeyT*               d_keys_tmp      = reinterpret_cast<KeyT*>(d_buffers);
+    ValueT*             d_values_tmp    = reinterpret_cast<ValueT*>(d_buffers + keys_bytes);
+    KeyT*               d_keys_scratch  = !discard_keys ? d_keys.Alternate() :
+        reinterpret_cast<KeyT*>(d_buffers + (keys_bytes / 2));
+
+    hipError_t error = hipSuccess;
+
+    // Without passes to run, the output is a copy of the input
+    auto copy_through = [&]() -> hipError_t
+    {
+        if (!is_overwrite_okay && (num_items != 0))
+        {
+            if (!discard_keys && HipcubDebug(error = hipMemcpyAsync(d_keys.Alternate(), d_keys.Current(),
+                sizeof(KeyT) * num_items, hipMemcpyDeviceToDevice, stream))) return error;
+            if (index_values)
+            {
+                const unsigned int grid_size = static_cast<unsigned int>(
+                    ::rocprim::min(num_tiles, size_t(1024)));
+                hipLaunchKernelGGL(
+                    HIP_KERNEL_NAME(DeviceRadixSortIndicesKernel<Policy, ValueT>),
+                    dim3(grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+                    d_values.Alternate(), num_items);
+                if (HipcubDebug(error = hipPeekAtLastError())) return error;
+                if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+            }
+            else if (!KEYS_ONLY && HipcubDebug(error = hipMemcpyAsync(d_values.Alternate(), d_values.Current(),
+                sizeof(ValueT) * num_items, hipMemcpyDeviceToDevice, stream))) return error;
+        }
+        if (!is_overwrite_okay)
+        {
+            d_keys.selector ^= 1;
+            d_values.selector ^= 1;
+        }
+        return error;
+    };
+
+    if ((num_items == 0) || (num_passes == 0))
+    {
+        return copy_through();
+    }
+
+    // Histogram of every pass in one read of the keys
+    int device_id = 0;
+    int compute_units = 0;
+    if (HipcubDebug(error = hipGetDevice(&device_id))) return error;
+    if (HipcubDebug(error = hipDeviceGetAttribute(&compute_units, hipDeviceAttributeMultiprocessorCount, device_id))) return error;
+
+    const unsigned int histogram_grid_size = static_cast<unsigned int>(
+        ::rocprim::min(num_tiles, size_t(compute_units) * 4));
+
+    // The order flags follow the bins and are zeroed with them
+    if (HipcubDebug(error = hipMemsetAsync(d_bins, 0, bins_bytes + order_bytes, stream))) return error;
+
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(DeviceRadixSortHistogramKernel<Policy, IS_DESCENDING, KeyT, DecomposerT>),
+        dim3(histogram_grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+        d_keys.Current(), d_bins, d_order, num_items, begin_bit, end_bit, decomposer);
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    if (narrow_bit_range
+        && HipcubDebug(error = hipMemsetAsync(d_constant_passes, 0, constant_passes_bytes, stream))) return error;
+
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(DeviceRadixSortExclusiveSumKernel<Policy>),
+        dim3(num_passes), dim3(Policy::RADIX_DIGITS), 0, stream,
+        d_bins, d_constant_passes, num_items);
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    // Passes to run.  When narrowing the bit range, the host waits for the histograms
+    // and drops the passes whose digit is the same in every key, so that only digits
+    // with varying bits are sorted.  The order flags come along, and no pass is
+    // launched for presorted keys.
+    int passes[Policy::MAX_PASSES];
+    int num_sorting_passes = 0;
+    bool presorted = false;
+    if (narrow_bit_range)
+    {
+        unsigned int constant_passes[Policy::MAX_PASSES];
+        unsigned int order = 0;
+        if (HipcubDebug(error = hipMemcpyAsync(constant_passes, d_constant_passes,
+            sizeof(unsigned int) * num_passes, hipMemcpyDeviceToHost, stream))) return error;
+        if (check_presorted && HipcubDebug(error = hipMemcpyAsync(&order, d_order,
+            sizeof(unsigned int), hipMemcpyDeviceToHost, stream))) return error;
+        if (HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+        presorted = check_presorted && RadixSortOrderPresorted(order);
+
+        for (int pass = 0; pass < num_passes; ++pass)
+        {
+            if (constant_passes[pass] == 0)
+            {
+                passes[num_sorting_passes++] = pass;
+            }
+        }
+
+        if (num_sorting_passes == 0)
+        {
+            return copy_through();
+        }
+    }
+    else
+    {
+        for (int pass = 0; pass < num_passes; ++pass)
+        {
+            passes[num_sorting_passes++] = pass;
+        }
+    }
+
+    // Presorted input goes straight to where the last pass would leave it.  Whether
+    // it is presorted is only known on the device, so the passes are still launched
+    // and return at once, and their look-back is zeroed by a kernel that does the same.
+    if (check_presorted)
+    {
+        const bool in_place = is_overwrite_okay && ((num_sorting_passes % 2) == 0);
+        const unsigned int grid_size = static_cast<unsigned int>(
+            ::rocprim::min(num_tiles, size_t(1024)));
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceRadixSortPresortedKernel<Policy, KeyT, ValueT>),
+            dim3(grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+            d_keys.Current(), in_place ? d_keys.Current() : d_keys.Alternate(),
+            d_values.Current(), in_place ? d_values.Current() : d_values.Alternate(),
+            num_items, in_place, d_order);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+    }
+
+    // Without overwriting, passes alternate between the temporary buffers and the
+    // output so that the last one writes the output.  Discarded keys alternate with
+    // a second temporary buffer instead and the last pass does not write them.
+    KeyT*   d_keys_in       = d_keys.Current();
+    ValueT* d_values_in     = d_values.Current();
+    KeyT*   d_keys_out      = d_keys.Alternate();
+    ValueT* d_values_out    = d_values.Alternate();
+
+    for (int i = 0; (i < num_sorting_passes) && !presorted; ++i)
+    {
+        const int pass = passes[i];
+
+        KeyT*   d_keys_dst      = d_keys_out;
+        ValueT* d_values_dst    = d_values_out;
+        if (!is_overwrite_okay)
+        {
+            const bool to_output = ((num_sorting_passes - 1 - i) % 2) == 0;
+            const bool is_last   = (i == (num_sorting_passes - 1));
+            d_keys_dst      = to_output ? (is_last ? d_keys.Alternate() : d_keys_scratch) : d_keys_tmp;
+            d_values_dst    = to_output ? d_values.Alternate() : d_values_tmp;
+        }
+
+        const int current_bit = begin_bit + (pass * Policy::RADIX_BITS);
+        const int num_bits    = ::rocprim::min(int(Policy::RADIX_BITS), end_bit - current_bit);
+
+        // The look-back and the tile counter are contiguous and zeroed together
+        if (check_presorted)
+        {
+            const size_t num_words = (lookback_bytes + counter_bytes) / sizeof(unsigned int);
+            const unsigned int init_grid_size = static_cast<unsigned int>(::rocprim::min(
+                DivideAndRoundUp(num_words, size_t(Policy::BLOCK_THREADS)), size_t(compute_units) * 4));
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(DeviceRadixSortLookbackInitKernel<Policy>),
+                dim3(init_grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+                reinterpret_cast<unsigned int*>(d_lookback), num_words, d_order);
+            if (HipcubDebug(error = hipPeekAtLastError())) return error;
+            if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+        }
+        else if (HipcubDebug(error = hipMemsetAsync(d_lookback, 0, lookback_bytes + counter_bytes, stream))) return error;
+
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceRadixSortOnesweepKernel<Policy, IS_DESCENDING, KeyT, ValueT, DecomposerT>),
+            dim3(static_cast<unsigned int>(num_tiles)), dim3(Policy::BLOCK_THREADS), 0, stream,
+            d_keys_in, d_keys_dst, d_values_in, d_values_dst,
+            num_items, d_bins + (pass * Policy::RADIX_DIGITS), d_lookback, d_tile_counter, d_order,
+            current_bit, num_bits, decomposer);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        if (is_overwrite_okay)
+        {
+            d_keys_out      = d_keys_in;
+            d_values_out    = d_values_in;
+        }
+        d_keys_in       = d_keys_dst;
+        d_values_in     = d_values_dst;
+    }
+
+    if (!is_overwrite_okay || ((num_sorting_passes % 2) == 1))
+    {
+        d_keys.selector ^= 1;
+        d_values.selector ^= 1;
+    }
+
+    return error;
+}
+
+} // end namespace detail
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_RADIX_SORT_ONESWEEP_HPP_
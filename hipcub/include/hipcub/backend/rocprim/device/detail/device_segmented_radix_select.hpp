@@ -0,0 +1,549 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_SEGMENTED_RADIX_SELECT_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_SEGMENTED_RADIX_SELECT_HPP_
+
+#include <type_traits>
+
+#include "../../../../config.hpp"
+
+#include "../../util_type.hpp"
+#include "../../util_ptx.hpp"
+#include "../../block/radix_rank_sort_operations.hpp"
+#include "device_radix_select.hpp"
+
+#include <rocprim/detail/various.hpp>
+
+BEGIN_HIPCUB_NAMESPACE
+namespace detail
+{
+
+/**
+ * Tuning of the segmented radix select.
+ *
+ * A warp selects from each segment that fits in its registers, several warps to a
+ * block so that short segments do not leave most of a block idle.  The warps hand
+ * longer segments over to a list that blocks then share, each block selecting from
+ * one segment at a time.
+ *
+ * \p WARP_THREADS is the wavefront size of the device code only, 64 when the host
+ * code is compiled, so the warp kernel has a fixed block size and the host derives
+ * the warps of a block from the wavefront size of the device it launches on.
+ */
+template <typename KeyT>
+struct SegmentedRadixSelectPolicy
+{
+    static constexpr int RADIX_BITS             = 8;
+    static constexpr int RADIX_DIGITS           = 1 << RADIX_BITS;
+    static constexpr int WARP_THREADS           = HIPCUB_DEVICE_WARP_THREADS;
+    static constexpr int WARP_BLOCK_THREADS     = 256;
+    static constexpr int WARP_ITEMS_PER_THREAD  = 16;
+    static constexpr int WARP_TILE_ITEMS        = WARP_THREADS * WARP_ITEMS_PER_THREAD;
+    static constexpr int BLOCK_THREADS          = 256;
+    static constexpr int BLOCK_ITEMS_PER_THREAD = 8;
+    static constexpr int KEY_BITS               = int(sizeof(KeyT) * 8);
+    static constexpr int MAX_PASSES             = (KEY_BITS + RADIX_BITS - 1) / RADIX_BITS;
+};
+
+/**
+ * Radix select of the \p k smallest twiddled keys of one segment by a group of
+ * \p GROUP_THREADS threads, either a warp or a whole block.  A segment of up to
+ * <tt>GROUP_THREADS * ITEMS_PER_THREAD</tt> keys is loaded once and kept in registers
+ * between passes; a longer one is read again at each pass.
+ */
+template <
+    int         GROUP_THREADS,
+    int         ITEMS_PER_THREAD,
+    bool        SELECT_MAX,
+    typename    KeyT,
+    typename    ValueT>
+class SegmentRadixSelect
+{
+    typedef RadixSortTwiddle<SELECT_MAX, KeyT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+
+    static constexpr int  RADIX_BITS      = 8;
+    static constexpr int  RADIX_DIGITS    = 1 << RADIX_BITS;
+    static constexpr int  BINS_PER_THREAD = RADIX_DIGITS / GROUP_THREADS;
+    static constexpr int  TILE_ITEMS      = GROUP_THREADS * ITEMS_PER_THREAD;
+    static constexpr int  KEY_BITS        = int(sizeof(KeyT) * 8);
+    static constexpr bool IS_WARP         = GROUP_THREADS <= HIPCUB_DEVICE_WARP_THREADS;
+    static constexpr bool KEYS_ONLY       = std::is_same<ValueT, NullType>::value;
+
+    static_assert(RADIX_DIGITS % GROUP_THREADS == 0, "Every thread chooses among the same number of digits");
+
+public:
+    struct TempStorage
+    {
+        unsigned int    bins[RADIX_DIGITS];
+        unsigned int    scan[GROUP_THREADS];
+        UnsignedBits    prefix;         // Twiddled bits of the k-th key decided so far
+        int             prefix_bit;     // Lowest decided bit, the key size before the first pass
+        unsigned int    k_remaining;    // Rank (from 1) of the k-th key among the keys that match prefix
+        int             done;           // Whether the bucket of the k-th key is taken whole
+        unsigned int    less_count;     // Keys below the bucket gathered so far
+        unsigned int    equal_count;    // Keys in the bucket gathered so far
+    };
+
+private:
+    TempStorage&        storage;
+    const unsigned int  linear_tid;
+
+    HIPCUB_DEVICE __forceinline__ void Sync()
+    {
+        if (IS_WARP)
+        {
+            WARP_SYNC(0xFFFFFFFF);
+        }
+        else
+        {
+            ::rocprim::syncthreads();
+        }
+    }
+
+    HIPCUB_DEVICE __forceinline__ unsigned int ExclusiveSum(unsigned int value)
+    {
+        storage.scan[linear_tid] = value;
+        Sync();
+        for (int offset = 1; offset < GROUP_THREADS; offset <<= 1)
+        {
+            const unsigned int addend = (int(linear_tid) >= offset) ? storage.scan[linear_tid - offset] : 0;
+            Sync();
+            storage.scan[linear_tid] += addend;
+            Sync();
+        }
+        return storage.scan[linear_tid] - value;
+    }
+
+    /// Counts the digits of the keys that match the digits decided so far and picks
+    /// the digit whose bucket holds the k-th key
+    template <typename OffsetT>
+    HIPCUB_DEVICE __forceinline__ void Refine(
+        const UnsignedBits  (&keys)[ITEMS_PER_THREAD],
+        bool                resident,
+        const UnsignedBits* d_bits_in,
+        OffsetT             segment_begin,
+        OffsetT             segment_end,
+        int                 current_bit,
+        int                 num_bits)
+    {
+        const UnsignedBits prefix      = RadixSelectHighBits(storage.prefix, storage.prefix_bit);
+        const int          prefix_bit  = storage.prefix_bit;
+        const unsigned int k_remaining = storage.k_remaining;
+        DigitExtractor<UnsignedBits> digit_extractor(current_bit, num_bits);
+
+        #pragma unroll
+        for (int BIN = 0; BIN < BINS_PER_THREAD; ++BIN)
+        {
+            storage.bins[(linear_tid * BINS_PER_THREAD) + BIN] = 0;
+        }
+        Sync();
+
+        if (resident)
+        {
+            #pragma unroll
+            for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+            {
+                const OffsetT i = segment_begin + OffsetT((ITEM * GROUP_THREADS) + linear_tid);
+                if ((i < segment_end) && (RadixSelectHighBits(keys[ITEM], prefix_bit) == prefix))
+                {
+                    atomicAdd(&storage.bins[digit_extractor.Digit(keys[ITEM])], 1u);
+                }
+            }
+        }
+        else
+        {
+            for (OffsetT i = segment_begin + OffsetT(linear_tid); i < segment_end; i += GROUP_THREADS)
+            {
+                const UnsignedBits key = TwiddleT::In(d_bits_in[i]);
+                if (RadixSelectHighBits(key, prefix_bit) == prefix)
+                {
+                    atomicAdd(&storage.bins[digit_extractor.Digit(key)], 1u);
+                }
+            }
+        }
+        Sync();
+
+        unsigned int counts[BINS_PER_THREAD];
+        unsigned int thread_count = 0;
+        #pragma unroll
+        for (int BIN = 0; BIN < BINS_PER_THREAD; ++BIN)
+        {
+            counts[BIN] = storage.bins[(linear_tid * BINS_PER_THREAD) + BIN];
+            thread_count += counts[BIN];
+        }
+        unsigned int below = ExclusiveSum(thread_count);
+
+        #pragma unroll
+        for (int BIN = 0; BIN < BINS_PER_THREAD; ++BIN)
+        {
+            if ((below < k_remaining) && (k_remaining <= below + counts[BIN]))
+            {
+                const unsigned int digit = (linear_tid * BINS_PER_THREAD) + BIN;
+                storage.prefix      |= UnsignedBits(digit) << current_bit;
+                storage.prefix_bit   = current_bit;
+                storage.k_remaining  = k_remaining - below;
+                storage.done         = (counts[BIN] == k_remaining - below);
+            }
+            below += counts[BIN];
+        }
+        Sync();
+    }
+
+    /// Writes a key below the bucket of the k-th key or one of the first keys of the
+    /// bucket that complete the k smallest keys
+    HIPCUB_DEVICE __forceinline__ void Gather(
+        UnsignedBits        key,
+        const ValueT*       d_values_in,
+        size_t              i,
+        UnsignedBits*       d_bits_out,
+        ValueT*             d_values_out,
+        UnsignedBits        prefix,
+        int                 prefix_bit,
+        unsigned int        k_remaining,
+        unsigned int        k)
+    {
+        const UnsignedBits high = RadixSelectHighBits(key, prefix_bit);
+        unsigned int position = k;
+        if (high < prefix)
+        {
+            position = atomicAdd(&storage.less_count, 1u);
+        }
+        else if (high == prefix)
+        {
+            const unsigned int equal_position = atomicAdd(&storage.equal_count, 1u);
+            position = (equal_position < k_remaining) ? (k - k_remaining + equal_position) : k;
+        }
+
+        if (position < k)
+        {
+            d_bits_out[position] = TwiddleT::Out(key);
+            if (!KEYS_ONLY)
+            {
+                d_values_out[position] = d_values_in[i];
+            }
+        }
+    }
+
+public:
+    HIPCUB_DEVICE __forceinline__ SegmentRadixSelect(TempStorage& storage, unsigned int linear_tid)
+        : storage(storage), linear_tid(linear_tid)
+    {}
+
+    /**
+     * Writes the \p k selected keys of <tt>[segment_begin, segment_end)</tt> and their
+     * values, in no particular order, to the first \p k places of the outputs, or the
+     * whole segment if it has no more than \p k keys.
+     */
+    template <typename OffsetT>
+    HIPCUB_DEVICE __forceinline__ void Select(
+        const KeyT*     d_keys_in,
+        KeyT*           d_keys_out,
+        const ValueT*   d_values_in,
+        ValueT*         d_values_out,
+        OffsetT         segment_begin,
+        OffsetT         segment_end,
+        unsigned int    k)
+    {
+        const UnsignedBits* d_bits_in  = reinterpret_cast<const UnsignedBits*>(d_keys_in);
+        UnsignedBits*       d_bits_out = reinterpret_cast<UnsignedBits*>(d_keys_out);
+
+        const size_t segment_size = (segment_begin < segment_end) ? size_t(segment_end - segment_begin) : 0;
+        if (segment_size <= k)
+        {
+            // Every key is selected
+            for (OffsetT i = segment_begin + OffsetT(linear_tid); i < segment_end; i += GROUP_THREADS)
+            {
+                d_bits_out[i - segment_begin] = d_bits_in[i];
+                if (!KEYS_ONLY)
+                {
+                    d_values_out[i - segment_begin] = d_values_in[i];
+                }
+            }
+            return;
+        }
+
+        const bool resident = segment_size <= TILE_ITEMS;
+        UnsignedBits keys[ITEMS_PER_THREAD];
+        if (resident)
+        {
+            #pragma unroll
+            for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+            {
+                const OffsetT i = segment_begin + OffsetT((ITEM * GROUP_THREADS) + linear_tid);
+                keys[ITEM] = (i < segment_end) ? TwiddleT::In(d_bits_in[i]) : UnsignedBits(0);
+            }
+        }
+
+        if (linear_tid == 0)
+        {
+            storage.prefix      = UnsignedBits(0);
+            storage.prefix_bit  = KEY_BITS;
+            storage.k_remaining = k;
+            storage.done        = 0;
+            storage.less_count  = 0;
+            storage.equal_count = 0;
+        }
+        Sync();
+
+        for (int end_bit = KEY_BITS; (end_bit > 0) && !storage.done; end_bit -= RADIX_BITS)
+        {
+            const int current_bit = ::rocprim::max(0, end_bit - RADIX_BITS);
+            Refine(keys, resident, d_bits_in, segment_begin, segment_end, current_bit, end_bit - current_bit);
+        }
+
+        const UnsignedBits prefix      = RadixSelectHighBits(storage.prefix, storage.prefix_bit);
+        const int          prefix_bit  = storage.prefix_bit;
+        const unsigned int k_remaining = storage.k_remaining;
+
+        if (resident)
+        {
+            #pragma unroll
+            for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+            {
+                const OffsetT i = segment_begin + OffsetT((ITEM * GROUP_THREADS) + linear_tid);
+                if (i < segment_end)
+                {
+                    Gather(keys[ITEM], d_values_in, size_t(i), d_bits_out, d_values_out,
+                           prefix, prefix_bit, k_remaining, k);
+                }
+            }
+        }
+        else
+        {
+            for (OffsetT i = segment_begin + OffsetT(linear_tid); i < segment_end; i += GROUP_THREADS)
+            {
+                Gather(TwiddleT::In(d_bits_in[i]), d_values_in, size_t(i), d_bits_out, d_values_out,
+                       prefix, prefix_bit, k_remaining, k);
+            }
+        }
+        Sync();
+    }
+};
+
+/// Values output of a segment, nothing for keys only
+template <typename ValueT>
+HIPCUB_DEVICE __forceinline__ ValueT* SegmentValuesOut(ValueT* d_values_out, size_t offset)
+{
+    return d_values_out + offset;
+}
+
+HIPCUB_DEVICE __forceinline__ NullType* SegmentValuesOut(NullType* d_values_out, size_t)
+{
+    return d_values_out;
+}
+
+/**
+ * Selects from the segments that fit in the registers of a warp, one segment per
+ * warp, and lists the other segments for DeviceSegmentedRadixSelectBlockKernel.
+ */
+template <
+    typename    Policy,
+    bool        SELECT_MAX,
+    typename    KeyT,
+    typename    ValueT,
+    typename    OffsetIteratorT>
+static __global__ __launch_bounds__(Policy::WARP_BLOCK_THREADS) void
+DeviceSegmentedRadixSelectWarpKernel(
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    unsigned int    num_segments,
+    OffsetIteratorT d_begin_offsets,
+    OffsetIteratorT d_end_offsets,
+    unsigned int    k,
+    unsigned int*   d_large_segments,       ///< [out] Segments left to the blocks
+    unsigned int*   d_num_large_segments)   ///< [in,out] Number of such segments (zeroed beforehand)
+{
+    typedef SegmentRadixSelect<Policy::WARP_THREADS, Policy::WARP_ITEMS_PER_THREAD, SELECT_MAX, KeyT, ValueT> WarpSelectT;
+    typedef typename std::iterator_traits<OffsetIteratorT>::value_type OffsetT;
+
+    constexpr int WARPS_PER_BLOCK = Policy::WARP_BLOCK_THREADS / Policy::WARP_THREADS;
+
+    __shared__ typename WarpSelectT::TempStorage temp_storage[WARPS_PER_BLOCK];
+
+    const unsigned int warp_id = hipThreadIdx_x / Policy::WARP_THREADS;
+    const unsigned int lane_id = hipThreadIdx_x % Policy::WARP_THREADS;
+    const unsigned int segment = (hipBlockIdx_x * WARPS_PER_BLOCK) + warp_id;
+    if (segment >= num_segments)
+    {
+        return;
+    }
+
+    const OffsetT segment_begin = d_begin_offsets[segment];
+    const OffsetT segment_end   = d_end_offsets[segment];
+    const size_t  segment_size  = (segment_begin < segment_end) ? size_t(segment_end - segment_begin) : 0;
+    if ((segment_size > k) && (segment_size > Policy::WARP_TILE_ITEMS))
+    {
+        if (lane_id == 0)
+        {
+            d_large_segments[atomicAdd(d_num_large_segments, 1u)] = segment;
+        }
+        return;
+    }
+
+    const size_t output_offset = size_t(segment) * k;
+    WarpSelectT(temp_storage[warp_id], lane_id).Select(
+        d_keys_in, d_keys_out + output_offset,
+        d_values_in, SegmentValuesOut(d_values_out, output_offset),
+        segment_begin, segment_end, k);
+}
+
+/**
+ * Selects from the segments listed by DeviceSegmentedRadixSelectWarpKernel, one
+ * segment per block at a time.
+ */
+template <
+    typename    Policy,
+    bool        SELECT_MAX,
+    typename    KeyT,
+    typename    ValueT,
+    typename    OffsetIteratorT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+DeviceSegmentedRadixSelectBlockKernel(
+    const KeyT*         d_keys_in,
+    KeyT*               d_keys_out,
+    const ValueT*       d_values_in,
+    ValueT*             d_values_out,
+    OffsetIteratorT     d_begin_offsets,
+    OffsetIteratorT     d_end_offsets,
+    unsigned int        k,
+    const unsigned int* d_large_segments,
+    const unsigned int* d_num_large_segments)
+{
+    typedef SegmentRadixSelect<Policy::BLOCK_THREADS, Policy::BLOCK_ITEMS_PER_THREAD, SELECT_MAX, KeyT, ValueT> BlockSelectT;
+    typedef typename std::iterator_traits<OffsetIteratorT>::value_type OffsetT;
+
+    __shared__ typename BlockSelectT::TempStorage temp_storage;
+
+    const unsigned int num_large_segments = *d_num_large_segments;
+    for (unsigned int i = hipBlockIdx_x; i < num_large_segments; i += hipGridDim_x)
+    {
+        const unsigned int segment = d_large_segments[i];
+        const size_t output_offset = size_t(segment) * k;
+        BlockSelectT(temp_storage, hipThreadIdx_x).Select(
+            d_keys_in, d_keys_out + output_offset,
+            d_values_in, SegmentValuesOut(d_values_out, output_offset),
+            OffsetT(d_begin_offsets[segment]), OffsetT(d_end_offsets[segment]), k);
+    }
+}
+
+/**
+ * Selects the \p k smallest keys (the largest with \p SELECT_MAX) of every segment
+ * and their values.  The keys selected from segment \p i are written, in no particular
+ * order, from <tt>d_keys_out[i * k]</tt> on; a segment with fewer than \p k keys is
+ * copied whole and leaves the rest of its \p k places untouched.
+ */
+template <
+    bool        SELECT_MAX,
+    typename    KeyT,
+    typename    ValueT,
+    typename    OffsetIteratorT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t SegmentedRadixSelect(
+    void*                   d_temp_storage,
+    size_t&                 temp_storage_bytes,
+    const KeyT*             d_keys_in,
+    KeyT*                   d_keys_out,
+    const ValueT*           d_values_in,
+    ValueT*                 d_values_out,
+    unsigned int            num_segments,
+    OffsetIteratorT         d_begin_offsets,
+    OffsetIteratorT         d_end_offsets,
+    unsigned int            k,
+    hipStream_t             stream,
+    bool                    debug_synchronous)
+{
+    typedef SegmentedRadixSelectPolicy<KeyT> Policy;
+
+    const size_t count_bytes =
+        ::rocprim::detail::align_size(sizeof(unsigned int));
+    const size_t large_segments_bytes =
+        ::rocprim::detail::align_size(sizeof(unsigned int) * num_segments);
+    const size_t required_bytes = count_bytes + large_segments_bytes;
+
+    if (d_temp_storage == nullptr)
+    {
+        temp_storage_bytes = required_bytes;
+        return hipSuccess;
+    }
+
+    if (temp_storage_bytes < required_bytes)
+    {
+        return hipErrorInvalidValue;
+    }
+
+    if ((num_segments == 0) || (k == 0))
+    {
+        return hipSuccess;
+    }
+
+    char* d_temp = static_cast<char*>(d_temp_storage);
+    unsigned int* d_num_large_segments = reinterpret_cast<unsigned int*>(d_temp);
+    unsigned int* d_large_segments     = reinterpret_cast<unsigned int*>(d_temp + count_bytes);
+
+    hipError_t error = hipSuccess;
+    int device_id = 0;
+    int compute_units = 0;
+    if (HipcubDebug(error = hipGetDevice(&device_id))) return error;
+    if (HipcubDebug(error = hipDeviceGetAttribute(&compute_units, hipDeviceAttributeMultiprocessorCount, device_id))) return error;
+
+    // The warps of a block depend on the wavefront size of the device
+    const unsigned int warps_per_block = unsigned(Policy::WARP_BLOCK_THREADS) / HIPCUB_HOST_WARP_THREADS;
+    const unsigned int warp_grid_size  = DivideAndRoundUp(num_segments, warps_per_block);
+    const unsigned int block_grid_size = ::rocprim::min(num_segments, unsigned(compute_units) * 4);
+
+    if (HipcubDebug(error = hipMemsetAsync(d_num_large_segments, 0, sizeof(unsigned int), stream))) return error;
+
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(DeviceSegmentedRadixSelectWarpKernel<Policy, SELECT_MAX, KeyT, ValueT, OffsetIteratorT>),
+        dim3(warp_grid_size), dim3(Policy::WARP_BLOCK_THREADS), 0, stream,
+        d_keys_in, d_keys_out, d_values_in, d_values_out,
+        num_segments, d_begin_offsets, d_end_offsets, k,
+        d_large_segments, d_num_large_segments);
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(DeviceSegmentedRadixSelectBlockKernel<Policy, SELECT_MAX, KeyT, ValueT, OffsetIteratorT>),
+        dim3(block_grid_size), dim3(Policy::BLOCK_THREADS), 0, stream,
+        d_keys_in, d_keys_out, d_values_in, d_values_out,
+        d_begin_offsets, d_end_offsets, k,
+        d_large_segments, d_num_large_segments);
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    return error;
+}
+
+} // end namespace detail
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_SEGMENTED_RADIX_SELECT_HPP_
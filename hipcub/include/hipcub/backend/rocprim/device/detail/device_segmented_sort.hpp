@@ -0,0 +1,488 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_SEGMENTED_SORT_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_SEGMENTED_SORT_HPP_
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "../../../../config.hpp"
+
+#include "../../util_type.hpp"
+#include "../../block/radix_rank_sort_operations.hpp"
+#include "device_merge_sort.hpp"
+#include "device_radix_sort_onesweep.hpp"
+
+#include <rocprim/detail/various.hpp>
+#include <rocprim/device/device_segmented_radix_sort.hpp>
+
+BEGIN_HIPCUB_NAMESPACE
+namespace detail
+{
+
+/**
+ * Tuning of the segmented sort.
+ *
+ * Segments are sorted by one of three paths according to their size.  A thread sorts
+ * each segment of up to \p SMALL_SEGMENT_ITEMS items in its registers, and lists the
+ * other segments as it goes.  A block sorts each listed segment that fits in one merge
+ * sort tile.  Longer segments are sorted with a block each by the rocPRIM segmented
+ * radix sort, over a list of bounds padded with empty segments to the most there can
+ * be, so the host never waits for their number.  Only when there are fewer segments
+ * than compute units, which a block each would leave mostly idle, are the long ones
+ * sorted one after the other by the device-wide onesweep radix sort.
+ */
+template <typename KeyT, typename ValueT>
+struct SegmentedSortPolicy
+{
+    static constexpr int SMALL_BLOCK_THREADS    = 256;
+    static constexpr int SMALL_SEGMENT_ITEMS    = 16;
+    typedef MergeSortPolicy<KeyT, ValueT> MediumPolicy;
+    static constexpr int MEDIUM_SEGMENT_ITEMS   = MediumPolicy::TILE_ITEMS;
+    static constexpr int KEY_BITS               = int(sizeof(KeyT) * 8);
+};
+
+/**
+ * Orders keys as DeviceRadixSort does, by their twiddled bits
+ */
+template <bool IS_DESCENDING, typename KeyT>
+struct SegmentedSortCompareOp
+{
+    typedef RadixSortTwiddle<IS_DESCENDING, KeyT> TwiddleT;
+    typedef typename TwiddleT::UnsignedBits UnsignedBits;
+
+    HIPCUB_DEVICE __forceinline__ bool operator()(const KeyT& lhs, const KeyT& rhs) const
+    {
+        return TwiddleT::In(reinterpret_cast<const UnsignedBits&>(lhs))
+            < TwiddleT::In(reinterpret_cast<const UnsignedBits&>(rhs));
+    }
+};
+
+/// Values of a segment, nothing for keys only
+template <typename ValueT>
+HIPCUB_HOST_DEVICE __forceinline__ ValueT* SegmentedSortValues(ValueT* d_values, size_t offset)
+{
+    return d_values + offset;
+}
+
+HIPCUB_HOST_DEVICE __forceinline__ NullType* SegmentedSortValues(NullType* d_values, size_t)
+{
+    return d_values;
+}
+
+HIPCUB_HOST_DEVICE __forceinline__ const NullType* SegmentedSortValues(const NullType* d_values, size_t)
+{
+    return d_values;
+}
+
+/**
+ * Sorts each small segment in the registers of a thread, and lists the medium
+ * segments for DeviceSegmentedSortMediumKernel and the bounds of the large ones
+ * for the host.
+ */
+template <
+    typename    Policy,
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT,
+    typename    OffsetIteratorT>
+static __global__ __launch_bounds__(Policy::SMALL_BLOCK_THREADS) void
+DeviceSegmentedSortSmallKernel(
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    unsigned int    num_segments,
+    OffsetIteratorT d_begin_offsets,
+    OffsetIteratorT d_end_offsets,
+    unsigned int*   d_medium_segments,  ///< [out] Segments left to the blocks
+    typename std::iterator_traits<OffsetIteratorT>::value_type* d_large_begin_offsets, ///< [out] Bounds of the segments left to the device (zeroed beforehand)
+    typename std::iterator_traits<OffsetIteratorT>::value_type* d_large_end_offsets,
+    unsigned int*   d_num_segments)     ///< [in,out] Number of medium and large segments (zeroed beforehand)
+{
+    typedef typename std::iterator_traits<OffsetIteratorT>::value_type OffsetT;
+
+    constexpr bool KEYS_ONLY = std::is_same<ValueT, NullType>::value;
+    constexpr int  ITEMS     = Policy::SMALL_SEGMENT_ITEMS;
+
+    const unsigned int segment = (hipBlockIdx_x * Policy::SMALL_BLOCK_THREADS) + hipThreadIdx_x;
+    if (segment >= num_segments)
+    {
+        return;
+    }
+
+    const OffsetT segment_begin = d_begin_offsets[segment];
+    const OffsetT segment_end   = d_end_offsets[segment];
+    const size_t  segment_size  = (segment_begin < segment_end) ? size_t(segment_end - segment_begin) : 0;
+    if (segment_size > Policy::MEDIUM_SEGMENT_ITEMS)
+    {
+        const unsigned int i = atomicAdd(&d_num_segments[1], 1u);
+        d_large_begin_offsets[i] = segment_begin;
+        d_large_end_offsets[i]   = segment_end;
+        return;
+    }
+    if (segment_size > ITEMS)
+    {
+        d_medium_segments[atomicAdd(&d_num_segments[0], 1u)] = segment;
+        return;
+    }
+
+    const int num_valid = int(segment_size);
+    KeyT   keys[ITEMS];
+    ValueT values[ITEMS];
+    #pragma unroll
+    for (int ITEM = 0; ITEM < ITEMS; ++ITEM)
+    {
+        if (ITEM < num_valid)
+        {
+            keys[ITEM] = d_keys_in[segment_begin + ITEM];
+            if (!KEYS_ONLY)
+            {
+                values[ITEM] = d_values_in[segment_begin + ITEM];
+            }
+        }
+    }
+
+    MergeSortThreadSort(keys, values, num_valid, SegmentedSortCompareOp<IS_DESCENDING, KeyT>());
+
+    #pragma unroll
+    for (int ITEM = 0; ITEM < ITEMS; ++ITEM)
+    {
+        if (ITEM < num_valid)
+        {
+            d_keys_out[segment_begin + ITEM] = keys[ITEM];
+            if (!KEYS_ONLY)
+            {
+                d_values_out[segment_begin + ITEM] = values[ITEM];
+            }
+        }
+    }
+}
+
+/**
+ * Sorts the segments listed by DeviceSegmentedSortSmallKernel, one segment per block
+ * at a time.
+ */
+template <
+    typename    Policy,
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT,
+    typename    OffsetIteratorT>
+static __global__ __launch_bounds__(Policy::MediumPolicy::BLOCK_THREADS) void
+DeviceSegmentedSortMediumKernel(
+    const KeyT*         d_keys_in,
+    KeyT*               d_keys_out,
+    const ValueT*       d_values_in,
+    ValueT*             d_values_out,
+    OffsetIteratorT     d_begin_offsets,
+    OffsetIteratorT     d_end_offsets,
+    const unsigned int* d_medium_segments,
+    const unsigned int* d_num_segments)
+{
+    typedef typename Policy::MediumPolicy MediumPolicy;
+    typedef MergeSortTileStorage<MediumPolicy, KeyT, ValueT> StorageT;
+    typedef typename std::iterator_traits<OffsetIteratorT>::value_type OffsetT;
+
+    __shared__ Uninitialized<StorageT> temp_storage_raw;
+    StorageT& storage = temp_storage_raw.Alias();
+
+    const unsigned int num_medium_segments = d_num_segments[0];
+    for (unsigned int i = hipBlockIdx_x; i < num_medium_segments; i += hipGridDim_x)
+    {
+        const unsigned int segment = d_medium_segments[i];
+        const OffsetT segment_begin = d_begin_offsets[segment];
+        const OffsetT segment_end   = d_end_offsets[segment];
+
+        MergeSortTile<MediumPolicy, KeyT, ValueT>(
+            storage,
+            d_keys_in + segment_begin, SegmentedSortValues(d_values_in, size_t(segment_begin)),
+            d_keys_out + segment_begin, SegmentedSortValues(d_values_out, size_t(segment_begin)),
+            int(segment_end - segment_begin), SegmentedSortCompareOp<IS_DESCENDING, KeyT>());
+        ::rocprim::syncthreads();
+    }
+}
+
+/// Sorts the large segments with a block each
+template <
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    OffsetT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t SegmentedSortLarge(
+    void*           d_temp_storage,
+    size_t&         temp_storage_bytes,
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const NullType* ,
+    NullType*       ,
+    unsigned int    num_items,
+    unsigned int    num_segments,
+    const OffsetT*  d_begin_offsets,
+    const OffsetT*  d_end_offsets,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    return IS_DESCENDING
+        ? ::rocprim::segmented_radix_sort_keys_desc(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, num_items,
+            num_segments, d_begin_offsets, d_end_offsets,
+            0, int(sizeof(KeyT) * 8),
+            stream, debug_synchronous)
+        : ::rocprim::segmented_radix_sort_keys(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, num_items,
+            num_segments, d_begin_offsets, d_end_offsets,
+            0, int(sizeof(KeyT) * 8),
+            stream, debug_synchronous);
+}
+
+template <
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT,
+    typename    OffsetT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t SegmentedSortLarge(
+    void*           d_temp_storage,
+    size_t&         temp_storage_bytes,
+    const KeyT*     d_keys_in,
+    KeyT*           d_keys_out,
+    const ValueT*   d_values_in,
+    ValueT*         d_values_out,
+    unsigned int    num_items,
+    unsigned int    num_segments,
+    const OffsetT*  d_begin_offsets,
+    const OffsetT*  d_end_offsets,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    return IS_DESCENDING
+        ? ::rocprim::segmented_radix_sort_pairs_desc(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out, num_items,
+            num_segments, d_begin_offsets, d_end_offsets,
+            0, int(sizeof(KeyT) * 8),
+            stream, debug_synchronous)
+        : ::rocprim::segmented_radix_sort_pairs(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out, num_items,
+            num_segments, d_begin_offsets, d_end_offsets,
+            0, int(sizeof(KeyT) * 8),
+            stream, debug_synchronous);
+}
+
+/**
+ * Sorts, stably, every segment of the input into the same place of the output, in
+ * the order of DeviceRadixSort.  Items outside of all segments are left untouched
+ * in the output.
+ *
+ * The call synchronizes \p stream only when there are fewer segments than compute
+ * units and some of them may be large: the host then waits for the small kernel to
+ * know how many large segments there are and where, to sort each of them with the
+ * whole device.
+ */
+template <
+    bool        IS_DESCENDING,
+    typename    KeyT,
+    typename    ValueT,
+    typename    OffsetIteratorT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t SegmentedSort(
+    void*                   d_temp_storage,
+    size_t&                 temp_storage_bytes,
+    const KeyT*             d_keys_in,
+    KeyT*                   d_keys_out,
+    const ValueT*           d_values_in,
+    ValueT*                 d_values_out,
+    unsigned int            num_items,
+    unsigned int            num_segments,
+    OffsetIteratorT         d_begin_offsets,
+    OffsetIteratorT         d_end_offsets,
+    hipStream_t             stream,
+    bool                    debug_synchronous)
+{
+    typedef SegmentedSortPolicy<KeyT, ValueT> Policy;
+    typedef typename Policy::MediumPolicy MediumPolicy;
+    typedef typename std::iterator_traits<OffsetIteratorT>::value_type OffsetT;
+
+    // Segments may overlap nowhere, so only so many of them can be medium or large
+    const unsigned int max_medium_segments =
+        ::rocprim::min(num_segments, num_items / unsigned(Policy::SMALL_SEGMENT_ITEMS + 1));
+    const unsigned int max_large_segments =
+        ::rocprim::min(num_segments, num_items / unsigned(Policy::MEDIUM_SEGMENT_ITEMS + 1));
+
+    hipError_t error = hipSuccess;
+
+    int device_id = 0;
+    int compute_units = 0;
+    if (HipcubDebug(error = hipGetDevice(&device_id))) return error;
+    if (HipcubDebug(error = hipDeviceGetAttribute(&compute_units, hipDeviceAttributeMultiprocessorCount, device_id))) return error;
+
+    // Fewer segments than compute units: the large ones are sorted by the device one at
+    // a time, which needs their bounds on the host
+    const bool device_sorts = (max_large_segments > 0) && (num_segments < unsigned(compute_units));
+
+    DoubleBuffer<KeyT>   d_keys(const_cast<KeyT*>(d_keys_in), d_keys_out);
+    DoubleBuffer<ValueT> d_values(const_cast<ValueT*>(d_values_in), d_values_out);
+
+    size_t device_sort_bytes = 0;
+    size_t block_sort_bytes  = 0;
+    if (device_sorts)
+    {
+        if (HipcubDebug(error = RadixSortOnesweep<IS_DESCENDING>(
+            nullptr, device_sort_bytes,
+            d_keys, d_values, false, num_items,
+            0, Policy::KEY_BITS,
+            stream, debug_synchronous))) return error;
+    }
+    else if (max_large_segments > 0)
+    {
+        if (HipcubDebug(error = SegmentedSortLarge<IS_DESCENDING>(
+            nullptr, block_sort_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out, num_items,
+            max_large_segments, static_cast<const OffsetT*>(nullptr), static_cast<const OffsetT*>(nullptr),
+            stream, debug_synchronous))) return error;
+    }
+
+    const size_t count_bytes =
+        ::rocprim::detail::align_size(sizeof(unsigned int) * 2);
+    const size_t medium_segments_bytes =
+        ::rocprim::detail::align_size(sizeof(unsigned int) * max_medium_segments);
+    const size_t large_offsets_bytes =
+        ::rocprim::detail::align_size(sizeof(OffsetT) * max_large_segments);
+    const size_t sort_bytes =
+        ::rocprim::detail::align_size(::rocprim::max(device_sort_bytes, block_sort_bytes));
+    const size_t required_bytes =
+        count_bytes + medium_segments_bytes + (2 * large_offsets_bytes) + sort_bytes;
+
+    if (d_temp_storage == nullptr)
+    {
+        temp_storage_bytes = required_bytes;
+        return hipSuccess;
+    }
+
+    if (temp_storage_bytes < required_bytes)
+    {
+        return hipErrorInvalidValue;
+    }
+
+    if (num_segments == 0)
+    {
+        return hipSuccess;
+    }
+
+    char* d_temp = static_cast<char*>(d_temp_storage);
+    unsigned int* d_num_segments        = reinterpret_cast<unsigned int*>(d_temp);
+    unsigned int* d_medium_segments     = reinterpret_cast<unsigned int*>(d_temp + count_bytes);
+    OffsetT*      d_large_begin_offsets = reinterpret_cast<OffsetT*>(d_temp + count_bytes + medium_segments_bytes);
+    OffsetT*      d_large_end_offsets   = reinterpret_cast<OffsetT*>(d_temp + count_bytes + medium_segments_bytes + large_offsets_bytes);
+    void*         d_sort_temp           = d_temp + count_bytes + medium_segments_bytes + (2 * large_offsets_bytes);
+
+    if (HipcubDebug(error = hipMemsetAsync(d_num_segments, 0, sizeof(unsigned int) * 2, stream))) return error;
+    // Bounds the small kernel does not fill are left as empty segments
+    if (max_large_segments > 0 && HipcubDebug(error = hipMemsetAsync(
+        d_large_begin_offsets, 0, 2 * large_offsets_bytes, stream))) return error;
+
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(DeviceSegmentedSortSmallKernel<Policy, IS_DESCENDING, KeyT, ValueT, OffsetIteratorT>),
+        dim3(DivideAndRoundUp(num_segments, unsigned(Policy::SMALL_BLOCK_THREADS))), dim3(Policy::SMALL_BLOCK_THREADS), 0, stream,
+        d_keys_in, d_keys_out, d_values_in, d_values_out,
+        num_segments, d_begin_offsets, d_end_offsets,
+        d_medium_segments, d_large_begin_offsets, d_large_end_offsets, d_num_segments);
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    if (max_medium_segments > 0)
+    {
+        const unsigned int medium_grid_size = ::rocprim::min(max_medium_segments, unsigned(compute_units) * 4);
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(DeviceSegmentedSortMediumKernel<Policy, IS_DESCENDING, KeyT, ValueT, OffsetIteratorT>),
+            dim3(medium_grid_size), dim3(MediumPolicy::BLOCK_THREADS), 0, stream,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            d_begin_offsets, d_end_offsets,
+            d_medium_segments, d_num_segments);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+    }
+
+    if (max_large_segments == 0)
+    {
+        return error;
+    }
+
+    if (!device_sorts)
+    {
+        // Empty segments past the large ones return at once
+        return SegmentedSortLarge<IS_DESCENDING>(
+            d_sort_temp, block_sort_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out, num_items,
+            max_large_segments, d_large_begin_offsets, d_large_end_offsets,
+            stream, debug_synchronous);
+    }
+
+    // The bounds of the large segments come along with their number
+    unsigned int num_segments_host[2];
+    std::unique_ptr<OffsetT[]> large_begin_offsets(new OffsetT[max_large_segments]);
+    std::unique_ptr<OffsetT[]> large_end_offsets(new OffsetT[max_large_segments]);
+    if (HipcubDebug(error = hipMemcpyAsync(num_segments_host, d_num_segments,
+        sizeof(unsigned int) * 2, hipMemcpyDeviceToHost, stream))) return error;
+    if (HipcubDebug(error = hipMemcpyAsync(large_begin_offsets.get(), d_large_begin_offsets,
+        sizeof(OffsetT) * max_large_segments, hipMemcpyDeviceToHost, stream))) return error;
+    if (HipcubDebug(error = hipMemcpyAsync(large_end_offsets.get(), d_large_end_offsets,
+        sizeof(OffsetT) * max_large_segments, hipMemcpyDeviceToHost, stream))) return error;
+    if (HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    const unsigned int num_large_segments = num_segments_host[1];
+
+    for (unsigned int i = 0; i < num_large_segments; ++i)
+    {
+        const size_t segment_begin = size_t(large_begin_offsets[i]);
+        DoubleBuffer<KeyT> d_segment_keys(
+            const_cast<KeyT*>(d_keys_in) + segment_begin, d_keys_out + segment_begin);
+        DoubleBuffer<ValueT> d_segment_values(
+            const_cast<ValueT*>(SegmentedSortValues(d_values_in, segment_begin)),
+            SegmentedSortValues(d_values_out, segment_begin));
+        if (HipcubDebug(error = RadixSortOnesweep<IS_DESCENDING>(
+            d_sort_temp, device_sort_bytes,
+            d_segment_keys, d_segment_values, false,
+            static_cast<unsigned int>(large_end_offsets[i] - large_begin_offsets[i]),
+            0, Policy::KEY_BITS,
+            stream, debug_synchronous))) return error;
+    }
+
+    return error;
+}
+
+} // end namespace detail
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DETAIL_DEVICE_SEGMENTED_SORT_HPP_
@@ -0,0 +1,193 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DEVICE_MERGE_SORT_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DEVICE_MERGE_SORT_HPP_
+
+#include "../../../config.hpp"
+
+#include "../util_type.hpp"
+#include "detail/device_large_num_items.hpp"
+#include "detail/device_merge_sort.hpp"
+
+BEGIN_HIPCUB_NAMESPACE
+
+/**
+ * \brief DeviceMergeSort sorts a sequence by any strict weak ordering.
+ *
+ * \par Overview
+ * Keys only need \p compare_op, a binary predicate that returns whether its first
+ * argument orders before its second one, so that keys which cannot be twiddled into
+ * radix digits (records, strings, custom orderings) can still be sorted.  Each tile
+ * is sorted in shared memory, then sorted runs are merged pairwise along merge-path
+ * diagonals (see MergePathSearch) until one run is left.
+ *
+ * \par
+ * - The sort is stable: equal keys keep their relative order.
+ * - Key and value iterators must be random access; the in-place variants read and
+ *   write through \p d_keys and \p d_items.
+ * - Temporary storage holds a copy of the keys and values.
+ */
+struct DeviceMergeSort
+{
+    template<typename KeyIteratorT, typename ValueIteratorT, typename OffsetT, typename CompareOpT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairs(void * d_temp_storage,
+                         size_t& temp_storage_bytes,
+                         KeyIteratorT d_keys,
+                         ValueIteratorT d_items,
+                         OffsetT num_items,
+                         CompareOpT compare_op,
+                         hipStream_t stream = 0,
+                         bool debug_synchronous = false)
+    {
+        if(detail::num_items_negative(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::MergeSort(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_items, d_keys, d_items,
+            num_items, compare_op,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyInputIteratorT, typename ValueInputIteratorT, typename KeyIteratorT, typename ValueIteratorT, typename OffsetT, typename CompareOpT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsCopy(void * d_temp_storage,
+                             size_t& temp_storage_bytes,
+                             KeyInputIteratorT d_input_keys,
+                             ValueInputIteratorT d_input_items,
+                             KeyIteratorT d_output_keys,
+                             ValueIteratorT d_output_items,
+                             OffsetT num_items,
+                             CompareOpT compare_op,
+                             hipStream_t stream = 0,
+                             bool debug_synchronous = false)
+    {
+        if(detail::num_items_negative(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::MergeSort(
+            d_temp_storage, temp_storage_bytes,
+            d_input_keys, d_input_items, d_output_keys, d_output_items,
+            num_items, compare_op,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyIteratorT, typename OffsetT, typename CompareOpT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeys(void * d_temp_storage,
+                        size_t& temp_storage_bytes,
+                        KeyIteratorT d_keys,
+                        OffsetT num_items,
+                        CompareOpT compare_op,
+                        hipStream_t stream = 0,
+                        bool debug_synchronous = false)
+    {
+        if(detail::num_items_negative(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::MergeSort(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, static_cast<NullType *>(nullptr), d_keys, static_cast<NullType *>(nullptr),
+            num_items, compare_op,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyInputIteratorT, typename KeyIteratorT, typename OffsetT, typename CompareOpT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysCopy(void * d_temp_storage,
+                            size_t& temp_storage_bytes,
+                            KeyInputIteratorT d_input_keys,
+                            KeyIteratorT d_output_keys,
+                            OffsetT num_items,
+                            CompareOpT compare_op,
+                            hipStream_t stream = 0,
+                            bool debug_synchronous = false)
+    {
+        if(detail::num_items_negative(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::MergeSort(
+            d_temp_storage, temp_storage_bytes,
+            d_input_keys, static_cast<NullType *>(nullptr), d_output_keys, static_cast<NullType *>(nullptr),
+            num_items, compare_op,
+            stream, debug_synchronous
+        );
+    }
+
+    // SortPairs is stable already
+    template<typename KeyIteratorT, typename ValueIteratorT, typename OffsetT, typename CompareOpT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t StableSortPairs(void * d_temp_storage,
+                               size_t& temp_storage_bytes,
+                               KeyIteratorT d_keys,
+                               ValueIteratorT d_items,
+                               OffsetT num_items,
+                               CompareOpT compare_op,
+                               hipStream_t stream = 0,
+                               bool debug_synchronous = false)
+    {
+        return SortPairs(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_items,
+            num_items, compare_op,
+            stream, debug_synchronous
+        );
+    }
+
+    // SortKeys is stable already
+    template<typename KeyIteratorT, typename OffsetT, typename CompareOpT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t StableSortKeys(void * d_temp_storage,
+                              size_t& temp_storage_bytes,
+                              KeyIteratorT d_keys,
+                              OffsetT num_items,
+                              CompareOpT compare_op,
+                              hipStream_t stream = 0,
+                              bool debug_synchronous = false)
+    {
+        return SortKeys(
+            d_temp_storage, temp_storage_bytes,
+            d_keys,
+            num_items, compare_op,
+            stream, debug_synchronous
+        );
+    }
+};
+
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DEVICE_MERGE_SORT_HPP_
@@ -33,14 +33,19 @@
 #include "../../../config.hpp"
 
 #include "../util_type.hpp"
+#include "detail/device_large_num_items.hpp"
+#include "detail/device_radix_sort_in_place.hpp"
+#include "detail/device_radix_sort_onesweep.hpp"
 
 #include <rocprim/device/device_radix_sort.hpp>
 
+#include <type_traits>
+
 BEGIN_HIPCUB_NAMESPACE
 
 struct DeviceRadixSort
 {
-    template<typename KeyT, typename ValueT>
+    template<typename KeyT, typename ValueT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortPairs(void * d_temp_storage,
                          size_t& temp_storage_bytes,
@@ -48,37 +53,45 @@ struct DeviceRadixSort
                          KeyT * d_keys_out,
                          const ValueT * d_values_in,
                          ValueT * d_values_out,
-                         int num_items,
+                         NumItemsT num_items,
                          int begin_bit = 0,
                          int end_bit = sizeof(KeyT) * 8,
                          hipStream_t stream = 0,
                          bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         return ::rocprim::radix_sort_pairs(
             d_temp_storage, temp_storage_bytes,
-            d_keys_in, d_keys_out, d_values_in, d_values_out, num_items,
+            d_keys_in, d_keys_out, d_values_in, d_values_out, static_cast<unsigned int>(num_items),
             begin_bit, end_bit,
             stream, debug_synchronous
         );
     }
 
-    template<typename KeyT, typename ValueT>
+    template<typename KeyT, typename ValueT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortPairs(void * d_temp_storage,
                          size_t& temp_storage_bytes,
                          DoubleBuffer<KeyT>& d_keys,
                          DoubleBuffer<ValueT>& d_values,
-                         int num_items,
+                         NumItemsT num_items,
                          int begin_bit = 0,
                          int end_bit = sizeof(KeyT) * 8,
                          hipStream_t stream = 0,
                          bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         ::rocprim::double_buffer<KeyT> d_keys_db = detail::to_double_buffer(d_keys);
         ::rocprim::double_buffer<ValueT> d_values_db = detail::to_double_buffer(d_values);
         hipError_t error = ::rocprim::radix_sort_pairs(
             d_temp_storage, temp_storage_bytes,
-            d_keys_db, d_values_db, num_items,
+            d_keys_db, d_values_db, static_cast<unsigned int>(num_items),
             begin_bit, end_bit,
             stream, debug_synchronous
         );
@@ -87,7 +100,7 @@ struct DeviceRadixSort
         return error;
     }
 
-    template<typename KeyT, typename ValueT>
+    template<typename KeyT, typename ValueT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortPairsDescending(void * d_temp_storage,
                                    size_t& temp_storage_bytes,
@@ -95,37 +108,45 @@ struct DeviceRadixSort
                                    KeyT * d_keys_out,
                                    const ValueT * d_values_in,
                                    ValueT * d_values_out,
-                                   int num_items,
+                                   NumItemsT num_items,
                                    int begin_bit = 0,
                                    int end_bit = sizeof(KeyT) * 8,
                                    hipStream_t stream = 0,
                                    bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         return ::rocprim::radix_sort_pairs_desc(
             d_temp_storage, temp_storage_bytes,
-            d_keys_in, d_keys_out, d_values_in, d_values_out, num_items,
+            d_keys_in, d_keys_out, d_values_in, d_values_out, static_cast<unsigned int>(num_items),
             begin_bit, end_bit,
             stream, debug_synchronous
         );
     }
 
-    template<typename KeyT, typename ValueT>
+    template<typename KeyT, typename ValueT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortPairsDescending(void * d_temp_storage,
                                    size_t& temp_storage_bytes,
                                    DoubleBuffer<KeyT>& d_keys,
                                    DoubleBuffer<ValueT>& d_values,
-                                   int num_items,
+                                   NumItemsT num_items,
                                    int begin_bit = 0,
                                    int end_bit = sizeof(KeyT) * 8,
                                    hipStream_t stream = 0,
                                    bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         ::rocprim::double_buffer<KeyT> d_keys_db = detail::to_double_buffer(d_keys);
         ::rocprim::double_buffer<ValueT> d_values_db = detail::to_double_buffer(d_values);
         hipError_t error = ::rocprim::radix_sort_pairs_desc(
             d_temp_storage, temp_storage_bytes,
-            d_keys_db, d_values_db, num_items,
+            d_keys_db, d_values_db, static_cast<unsigned int>(num_items),
             begin_bit, end_bit,
             stream, debug_synchronous
         );
@@ -134,41 +155,49 @@ struct DeviceRadixSort
         return error;
     }
 
-    template<typename KeyT>
+    template<typename KeyT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortKeys(void * d_temp_storage,
                         size_t& temp_storage_bytes,
                         const KeyT * d_keys_in,
                         KeyT * d_keys_out,
-                        int num_items,
+                        NumItemsT num_items,
                         int begin_bit = 0,
                         int end_bit = sizeof(KeyT) * 8,
                         hipStream_t stream = 0,
                         bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         return ::rocprim::radix_sort_keys(
             d_temp_storage, temp_storage_bytes,
-            d_keys_in, d_keys_out, num_items,
+            d_keys_in, d_keys_out, static_cast<unsigned int>(num_items),
             begin_bit, end_bit,
             stream, debug_synchronous
         );
     }
 
-    template<typename KeyT>
+    template<typename KeyT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortKeys(void * d_temp_storage,
                         size_t& temp_storage_bytes,
                         DoubleBuffer<KeyT>& d_keys,
-                        int num_items,
+                        NumItemsT num_items,
                         int begin_bit = 0,
                         int end_bit = sizeof(KeyT) * 8,
                         hipStream_t stream = 0,
                         bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         ::rocprim::double_buffer<KeyT> d_keys_db = detail::to_double_buffer(d_keys);
         hipError_t error = ::rocprim::radix_sort_keys(
             d_temp_storage, temp_storage_bytes,
-            d_keys_db, num_items,
+            d_keys_db, static_cast<unsigned int>(num_items),
             begin_bit, end_bit,
             stream, debug_synchronous
         );
@@ -176,47 +205,721 @@ struct DeviceRadixSort
         return error;
     }
 
-    template<typename KeyT>
+    template<typename KeyT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortKeysDescending(void * d_temp_storage,
                                   size_t& temp_storage_bytes,
                                   const KeyT * d_keys_in,
                                   KeyT * d_keys_out,
-                                  int num_items,
+                                  NumItemsT num_items,
                                   int begin_bit = 0,
                                   int end_bit = sizeof(KeyT) * 8,
                                   hipStream_t stream = 0,
                                   bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         return ::rocprim::radix_sort_keys_desc(
             d_temp_storage, temp_storage_bytes,
-            d_keys_in, d_keys_out, num_items,
+            d_keys_in, d_keys_out, static_cast<unsigned int>(num_items),
             begin_bit, end_bit,
             stream, debug_synchronous
         );
     }
 
-    template<typename KeyT>
+    template<typename KeyT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortKeysDescending(void * d_temp_storage,
                                   size_t& temp_storage_bytes,
                                   DoubleBuffer<KeyT>& d_keys,
-                                  int num_items,
+                                  NumItemsT num_items,
                                   int begin_bit = 0,
                                   int end_bit = sizeof(KeyT) * 8,
                                   hipStream_t stream = 0,
                                   bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         ::rocprim::double_buffer<KeyT> d_keys_db = detail::to_double_buffer(d_keys);
         hipError_t error = ::rocprim::radix_sort_keys_desc(
             d_temp_storage, temp_storage_bytes,
-            d_keys_db, num_items,
+            d_keys_db, static_cast<unsigned int>(num_items),
             begin_bit, end_bit,
             stream, debug_synchronous
         );
         detail::update_double_buffer(d_keys, d_keys_db);
         return error;
     }
+
+    // Onesweep variants: the same sorts with one kernel per digit, in which tiles rank
+    // their keys with BlockRadixRankMatch and find their output offsets by decoupled
+    // look-back.  Opt-in while the default sorts stay with rocPRIM.
+    //
+    // With narrow_bit_range, the histograms that the onesweep sort computes first are
+    // used to skip the passes over digits that are the same in every key, e.g. the
+    // upper bytes of 64-bit timestamps that span a few years.  This waits for the
+    // histograms on the host, so the call synchronizes stream.
+    //
+    // With check_presorted, the read of the keys that builds the histograms also
+    // compares adjacent keys.  Keys already in order are then copied to the output,
+    // keys in strictly reverse order are reversed, and the digit passes return at
+    // once; other keys are sorted as usual.  The check is decided on the device and
+    // costs no extra read of the keys nor a wait on the host, so it can stay on for
+    // inputs that often arrive sorted, e.g. streams of events by timestamp.
+
+    template<typename KeyT, typename ValueT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsOnesweep(void * d_temp_storage,
+                                 size_t& temp_storage_bytes,
+                                 const KeyT * d_keys_in,
+                                 KeyT * d_keys_out,
+                                 const ValueT * d_values_in,
+                                 ValueT * d_values_out,
+                                 NumItemsT num_items,
+                                 int begin_bit = 0,
+                                 int end_bit = sizeof(KeyT) * 8,
+                                 hipStream_t stream = 0,
+                                 bool debug_synchronous = false,
+                                 bool narrow_bit_range = false,
+                                 bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<KeyT> d_keys(const_cast<KeyT *>(d_keys_in), d_keys_out);
+        DoubleBuffer<ValueT> d_values(const_cast<ValueT *>(d_values_in), d_values_out);
+        return detail::RadixSortOnesweep<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, false, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            NullType(), narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsOnesweep(void * d_temp_storage,
+                                 size_t& temp_storage_bytes,
+                                 DoubleBuffer<KeyT>& d_keys,
+                                 DoubleBuffer<ValueT>& d_values,
+                                 NumItemsT num_items,
+                                 int begin_bit = 0,
+                                 int end_bit = sizeof(KeyT) * 8,
+                                 hipStream_t stream = 0,
+                                 bool debug_synchronous = false,
+                                 bool narrow_bit_range = false,
+                                 bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSortOnesweep<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, true, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            NullType(), narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsDescendingOnesweep(void * d_temp_storage,
+                                           size_t& temp_storage_bytes,
+                                           const KeyT * d_keys_in,
+                                           KeyT * d_keys_out,
+                                           const ValueT * d_values_in,
+                                           ValueT * d_values_out,
+                                           NumItemsT num_items,
+                                           int begin_bit = 0,
+                                           int end_bit = sizeof(KeyT) * 8,
+                                           hipStream_t stream = 0,
+                                           bool debug_synchronous = false,
+                                           bool narrow_bit_range = false,
+                                           bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<KeyT> d_keys(const_cast<KeyT *>(d_keys_in), d_keys_out);
+        DoubleBuffer<ValueT> d_values(const_cast<ValueT *>(d_values_in), d_values_out);
+        return detail::RadixSortOnesweep<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, false, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            NullType(), narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsDescendingOnesweep(void * d_temp_storage,
+                                           size_t& temp_storage_bytes,
+                                           DoubleBuffer<KeyT>& d_keys,
+                                           DoubleBuffer<ValueT>& d_values,
+                                           NumItemsT num_items,
+                                           int begin_bit = 0,
+                                           int end_bit = sizeof(KeyT) * 8,
+                                           hipStream_t stream = 0,
+                                           bool debug_synchronous = false,
+                                           bool narrow_bit_range = false,
+                                           bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSortOnesweep<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, true, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            NullType(), narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysOnesweep(void * d_temp_storage,
+                                size_t& temp_storage_bytes,
+                                const KeyT * d_keys_in,
+                                KeyT * d_keys_out,
+                                NumItemsT num_items,
+                                int begin_bit = 0,
+                                int end_bit = sizeof(KeyT) * 8,
+                                hipStream_t stream = 0,
+                                bool debug_synchronous = false,
+                                bool narrow_bit_range = false,
+                                bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<KeyT> d_keys(const_cast<KeyT *>(d_keys_in), d_keys_out);
+        DoubleBuffer<NullType> d_values;
+        return detail::RadixSortOnesweep<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, false, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            NullType(), narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysOnesweep(void * d_temp_storage,
+                                size_t& temp_storage_bytes,
+                                DoubleBuffer<KeyT>& d_keys,
+                                NumItemsT num_items,
+                                int begin_bit = 0,
+                                int end_bit = sizeof(KeyT) * 8,
+                                hipStream_t stream = 0,
+                                bool debug_synchronous = false,
+                                bool narrow_bit_range = false,
+                                bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<NullType> d_values;
+        return detail::RadixSortOnesweep<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, true, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            NullType(), narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysDescendingOnesweep(void * d_temp_storage,
+                                          size_t& temp_storage_bytes,
+                                          const KeyT * d_keys_in,
+                                          KeyT * d_keys_out,
+                                          NumItemsT num_items,
+                                          int begin_bit = 0,
+                                          int end_bit = sizeof(KeyT) * 8,
+                                          hipStream_t stream = 0,
+                                          bool debug_synchronous = false,
+                                          bool narrow_bit_range = false,
+                                          bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<KeyT> d_keys(const_cast<KeyT *>(d_keys_in), d_keys_out);
+        DoubleBuffer<NullType> d_values;
+        return detail::RadixSortOnesweep<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, false, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            NullType(), narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysDescendingOnesweep(void * d_temp_storage,
+                                          size_t& temp_storage_bytes,
+                                          DoubleBuffer<KeyT>& d_keys,
+                                          NumItemsT num_items,
+                                          int begin_bit = 0,
+                                          int end_bit = sizeof(KeyT) * 8,
+                                          hipStream_t stream = 0,
+                                          bool debug_synchronous = false,
+                                          bool narrow_bit_range = false,
+                                          bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<NullType> d_values;
+        return detail::RadixSortOnesweep<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, true, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            NullType(), narrow_bit_range, check_presorted
+        );
+    }
+
+    // Index variants (argsort): d_indices_out receives the permutation that sorts the
+    // keys, i.e. the index in d_keys_in of each sorted key.  The indices are generated
+    // by the first pass instead of being read from an array, and d_keys_out may be
+    // NULL to skip writing the sorted keys.  Sorted with the onesweep kernels, and
+    // narrow_bit_range and check_presorted are as for the onesweep variants.
+
+    template<typename KeyT, typename IndexT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortIndices(void * d_temp_storage,
+                           size_t& temp_storage_bytes,
+                           const KeyT * d_keys_in,
+                           KeyT * d_keys_out,
+                           IndexT * d_indices_out,
+                           NumItemsT num_items,
+                           int begin_bit = 0,
+                           int end_bit = sizeof(KeyT) * 8,
+                           hipStream_t stream = 0,
+                           bool debug_synchronous = false,
+                           bool narrow_bit_range = false,
+                           bool check_presorted = false)
+    {
+        static_assert(std::is_integral<IndexT>::value, "Indices must be integers");
+        if(!detail::num_items_fit<unsigned int>(num_items)
+           || ((num_items > 0) && !detail::num_items_fit<IndexT>(num_items - 1)))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<KeyT> d_keys(const_cast<KeyT *>(d_keys_in), d_keys_out);
+        DoubleBuffer<IndexT> d_indices(nullptr, d_indices_out);
+        return detail::RadixSortOnesweep<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_indices, false, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            NullType(), narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename IndexT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortIndicesDescending(void * d_temp_storage,
+                                     size_t& temp_storage_bytes,
+                                     const KeyT * d_keys_in,
+                                     KeyT * d_keys_out,
+                                     IndexT * d_indices_out,
+                                     NumItemsT num_items,
+                                     int begin_bit = 0,
+                                     int end_bit = sizeof(KeyT) * 8,
+                                     hipStream_t stream = 0,
+                                     bool debug_synchronous = false,
+                                     bool narrow_bit_range = false,
+                                     bool check_presorted = false)
+    {
+        static_assert(std::is_integral<IndexT>::value, "Indices must be integers");
+        if(!detail::num_items_fit<unsigned int>(num_items)
+           || ((num_items > 0) && !detail::num_items_fit<IndexT>(num_items - 1)))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<KeyT> d_keys(const_cast<KeyT *>(d_keys_in), d_keys_out);
+        DoubleBuffer<IndexT> d_indices(nullptr, d_indices_out);
+        return detail::RadixSortOnesweep<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_indices, false, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            NullType(), narrow_bit_range, check_presorted
+        );
+    }
+
+    // In-place variants: d_keys (and d_values) are sorted where they are, most
+    // significant digit first, so that no second buffer of num_items is needed.
+    // temp_storage_bytes depends on the device but not on num_items.  The sort is
+    // not stable: keys that compare equal between begin_bit and end_bit may be
+    // reordered.  num_items may be of any integral type and exceed 2^32 - 1.
+
+    template<typename KeyT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysInPlace(void * d_temp_storage,
+                               size_t& temp_storage_bytes,
+                               KeyT * d_keys,
+                               NumItemsT num_items,
+                               int begin_bit = 0,
+                               int end_bit = sizeof(KeyT) * 8,
+                               hipStream_t stream = 0,
+                               bool debug_synchronous = false)
+    {
+        if(detail::num_items_negative(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSortInPlace<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, static_cast<NullType *>(nullptr), static_cast<size_t>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysDescendingInPlace(void * d_temp_storage,
+                                         size_t& temp_storage_bytes,
+                                         KeyT * d_keys,
+                                         NumItemsT num_items,
+                                         int begin_bit = 0,
+                                         int end_bit = sizeof(KeyT) * 8,
+                                         hipStream_t stream = 0,
+                                         bool debug_synchronous = false)
+    {
+        if(detail::num_items_negative(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSortInPlace<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, static_cast<NullType *>(nullptr), static_cast<size_t>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsInPlace(void * d_temp_storage,
+                                size_t& temp_storage_bytes,
+                                KeyT * d_keys,
+                                ValueT * d_values,
+                                NumItemsT num_items,
+                                int begin_bit = 0,
+                                int end_bit = sizeof(KeyT) * 8,
+                                hipStream_t stream = 0,
+                                bool debug_synchronous = false)
+    {
+        if(detail::num_items_negative(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSortInPlace<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, static_cast<size_t>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsDescendingInPlace(void * d_temp_storage,
+                                          size_t& temp_storage_bytes,
+                                          KeyT * d_keys,
+                                          ValueT * d_values,
+                                          NumItemsT num_items,
+                                          int begin_bit = 0,
+                                          int end_bit = sizeof(KeyT) * 8,
+                                          hipStream_t stream = 0,
+                                          bool debug_synchronous = false)
+    {
+        if(detail::num_items_negative(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSortInPlace<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, static_cast<size_t>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    // Decomposer variants: keys are records that decomposer exposes as a
+    // ::rocprim::tuple of references to their arithmetic fields, most significant
+    // first, e.g. [] __host__ __device__ (custom_t& k) { return ::rocprim::tuple<int&, float&>(k.a, k.b); }.
+    // The fields are sorted as if concatenated, and bits are numbered from the least
+    // significant bit of the last field up to KEY_BITS, the total width of the fields.
+    // Decomposer's operator() must be const.  Sorted with the onesweep kernels, and
+    // narrow_bit_range and check_presorted are as for the onesweep variants.
+
+    template<typename KeyT, typename ValueT, typename NumItemsT, typename DecomposerT>
+    HIPCUB_RUNTIME_FUNCTION static
+    typename std::enable_if<!std::is_convertible<DecomposerT, int>::value, hipError_t>::type
+    SortPairs(void * d_temp_storage,
+              size_t& temp_storage_bytes,
+              const KeyT * d_keys_in,
+              KeyT * d_keys_out,
+              const ValueT * d_values_in,
+              ValueT * d_values_out,
+              NumItemsT num_items,
+              DecomposerT decomposer,
+              int begin_bit = 0,
+              int end_bit = RadixSortTwiddle<false, KeyT, DecomposerT>::KEY_BITS,
+              hipStream_t stream = 0,
+              bool debug_synchronous = false,
+              bool narrow_bit_range = false,
+              bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<KeyT> d_keys(const_cast<KeyT *>(d_keys_in), d_keys_out);
+        DoubleBuffer<ValueT> d_values(const_cast<ValueT *>(d_values_in), d_values_out);
+        return detail::RadixSortOnesweep<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, false, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            decomposer, narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename NumItemsT, typename DecomposerT>
+    HIPCUB_RUNTIME_FUNCTION static
+    typename std::enable_if<!std::is_convertible<DecomposerT, int>::value, hipError_t>::type
+    SortPairs(void * d_temp_storage,
+              size_t& temp_storage_bytes,
+              DoubleBuffer<KeyT>& d_keys,
+              DoubleBuffer<ValueT>& d_values,
+              NumItemsT num_items,
+              DecomposerT decomposer,
+              int begin_bit = 0,
+              int end_bit = RadixSortTwiddle<false, KeyT, DecomposerT>::KEY_BITS,
+              hipStream_t stream = 0,
+              bool debug_synchronous = false,
+              bool narrow_bit_range = false,
+              bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSortOnesweep<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, true, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            decomposer, narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename NumItemsT, typename DecomposerT>
+    HIPCUB_RUNTIME_FUNCTION static
+    typename std::enable_if<!std::is_convertible<DecomposerT, int>::value, hipError_t>::type
+    SortPairsDescending(void * d_temp_storage,
+                        size_t& temp_storage_bytes,
+                        const KeyT * d_keys_in,
+                        KeyT * d_keys_out,
+                        const ValueT * d_values_in,
+                        ValueT * d_values_out,
+                        NumItemsT num_items,
+                        DecomposerT decomposer,
+                        int begin_bit = 0,
+                        int end_bit = RadixSortTwiddle<false, KeyT, DecomposerT>::KEY_BITS,
+                        hipStream_t stream = 0,
+                        bool debug_synchronous = false,
+                        bool narrow_bit_range = false,
+                        bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<KeyT> d_keys(const_cast<KeyT *>(d_keys_in), d_keys_out);
+        DoubleBuffer<ValueT> d_values(const_cast<ValueT *>(d_values_in), d_values_out);
+        return detail::RadixSortOnesweep<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, false, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            decomposer, narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename NumItemsT, typename DecomposerT>
+    HIPCUB_RUNTIME_FUNCTION static
+    typename std::enable_if<!std::is_convertible<DecomposerT, int>::value, hipError_t>::type
+    SortPairsDescending(void * d_temp_storage,
+                        size_t& temp_storage_bytes,
+                        DoubleBuffer<KeyT>& d_keys,
+                        DoubleBuffer<ValueT>& d_values,
+                        NumItemsT num_items,
+                        DecomposerT decomposer,
+                        int begin_bit = 0,
+                        int end_bit = RadixSortTwiddle<false, KeyT, DecomposerT>::KEY_BITS,
+                        hipStream_t stream = 0,
+                        bool debug_synchronous = false,
+                        bool narrow_bit_range = false,
+                        bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSortOnesweep<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, true, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            decomposer, narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename NumItemsT, typename DecomposerT>
+    HIPCUB_RUNTIME_FUNCTION static
+    typename std::enable_if<!std::is_convertible<DecomposerT, int>::value, hipError_t>::type
+    SortKeys(void * d_temp_storage,
+             size_t& temp_storage_bytes,
+             const KeyT * d_keys_in,
+             KeyT * d_keys_out,
+             NumItemsT num_items,
+             DecomposerT decomposer,
+             int begin_bit = 0,
+             int end_bit = RadixSortTwiddle<false, KeyT, DecomposerT>::KEY_BITS,
+             hipStream_t stream = 0,
+             bool debug_synchronous = false,
+             bool narrow_bit_range = false,
+             bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<KeyT> d_keys(const_cast<KeyT *>(d_keys_in), d_keys_out);
+        DoubleBuffer<NullType> d_values;
+        return detail::RadixSortOnesweep<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, false, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            decomposer, narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename NumItemsT, typename DecomposerT>
+    HIPCUB_RUNTIME_FUNCTION static
+    typename std::enable_if<!std::is_convertible<DecomposerT, int>::value, hipError_t>::type
+    SortKeys(void * d_temp_storage,
+             size_t& temp_storage_bytes,
+             DoubleBuffer<KeyT>& d_keys,
+             NumItemsT num_items,
+             DecomposerT decomposer,
+             int begin_bit = 0,
+             int end_bit = RadixSortTwiddle<false, KeyT, DecomposerT>::KEY_BITS,
+             hipStream_t stream = 0,
+             bool debug_synchronous = false,
+             bool narrow_bit_range = false,
+             bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<NullType> d_values;
+        return detail::RadixSortOnesweep<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, true, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            decomposer, narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename NumItemsT, typename DecomposerT>
+    HIPCUB_RUNTIME_FUNCTION static
+    typename std::enable_if<!std::is_convertible<DecomposerT, int>::value, hipError_t>::type
+    SortKeysDescending(void * d_temp_storage,
+                       size_t& temp_storage_bytes,
+                       const KeyT * d_keys_in,
+                       KeyT * d_keys_out,
+                       NumItemsT num_items,
+                       DecomposerT decomposer,
+                       int begin_bit = 0,
+                       int end_bit = RadixSortTwiddle<false, KeyT, DecomposerT>::KEY_BITS,
+                       hipStream_t stream = 0,
+                       bool debug_synchronous = false,
+                       bool narrow_bit_range = false,
+                       bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<KeyT> d_keys(const_cast<KeyT *>(d_keys_in), d_keys_out);
+        DoubleBuffer<NullType> d_values;
+        return detail::RadixSortOnesweep<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, false, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            decomposer, narrow_bit_range, check_presorted
+        );
+    }
+
+    template<typename KeyT, typename NumItemsT, typename DecomposerT>
+    HIPCUB_RUNTIME_FUNCTION static
+    typename std::enable_if<!std::is_convertible<DecomposerT, int>::value, hipError_t>::type
+    SortKeysDescending(void * d_temp_storage,
+                       size_t& temp_storage_bytes,
+                       DoubleBuffer<KeyT>& d_keys,
+                       NumItemsT num_items,
+                       DecomposerT decomposer,
+                       int begin_bit = 0,
+                       int end_bit = RadixSortTwiddle<false, KeyT, DecomposerT>::KEY_BITS,
+                       hipStream_t stream = 0,
+                       bool debug_synchronous = false,
+                       bool narrow_bit_range = false,
+                       bool check_presorted = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        DoubleBuffer<NullType> d_values;
+        return detail::RadixSortOnesweep<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys, d_values, true, static_cast<unsigned int>(num_items),
+            begin_bit, end_bit,
+            stream, debug_synchronous,
+            decomposer, narrow_bit_range, check_presorted
+        );
+    }
 };
 
 END_HIPCUB_NAMESPACE
@@ -38,6 +38,7 @@
 #include "../../../config.hpp"
 #include "../iterator/arg_index_input_iterator.hpp"
 #include "../thread/thread_operators.hpp"
+#include "detail/device_large_num_items.hpp"
 
 #include <rocprim/device/device_reduce.hpp>
 #include <rocprim/device/device_reduce_by_key.hpp>
@@ -87,37 +88,57 @@ public:
         typename InputIteratorT,
         typename OutputIteratorT,
         typename ReduceOpT,
-        typename T
+        typename T,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t Reduce(void *d_temp_storage,
                       size_t &temp_storage_bytes,
                       InputIteratorT d_in,
                       OutputIteratorT d_out,
-                      int num_items,
+                      NumItemsT num_items,
                       ReduceOpT reduction_op,
                       T init,
                       hipStream_t stream = 0,
                       bool debug_synchronous = false)
     {
-        return ::rocprim::reduce(
-            d_temp_storage, temp_storage_bytes,
-            d_in, d_out, init, num_items,
-            ::hipcub::detail::convert_result_type<InputIteratorT, OutputIteratorT>(reduction_op),
-            stream, debug_synchronous
+        auto reduce_op = ::hipcub::detail::convert_result_type<InputIteratorT, OutputIteratorT>(reduction_op);
+        using result_type = typename decltype(reduce_op)::result_type;
+        return detail::dispatch_num_items(
+            num_items,
+            [&](size_t size)
+            {
+                return ::rocprim::reduce(
+                    d_temp_storage, temp_storage_bytes,
+                    d_in, d_out, init, size,
+                    reduce_op,
+                    stream, debug_synchronous
+                );
+            },
+            // More than 2^31 - 1 items: reduce in chunks
+            [&](auto size)
+            {
+                return detail::reduce_large<result_type>(
+                    d_temp_storage, temp_storage_bytes,
+                    d_in, d_out, size,
+                    reduce_op, init,
+                    stream, debug_synchronous
+                );
+            }
         );
     }
 
     template <
         typename InputIteratorT,
-        typename OutputIteratorT
+        typename OutputIteratorT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t Sum(void *d_temp_storage,
                    size_t &temp_storage_bytes,
                    InputIteratorT d_in,
                    OutputIteratorT d_out,
-                   int num_items,
+                   NumItemsT num_items,
                    hipStream_t stream = 0,
                    bool debug_synchronous = false)
     {
@@ -131,14 +152,15 @@ public:
 
     template <
         typename InputIteratorT,
-        typename OutputIteratorT
+        typename OutputIteratorT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t Min(void *d_temp_storage,
                    size_t &temp_storage_bytes,
                    InputIteratorT d_in,
                    OutputIteratorT d_out,
-                   int num_items,
+                   NumItemsT num_items,
                    hipStream_t stream = 0,
                    bool debug_synchronous = false)
     {
@@ -152,30 +174,37 @@ public:
 
     template <
         typename InputIteratorT,
-        typename OutputIteratorT
+        typename OutputIteratorT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t ArgMin(void *d_temp_storage,
                       size_t &temp_storage_bytes,
                       InputIteratorT d_in,
                       OutputIteratorT d_out,
-                      int num_items,
+                      NumItemsT num_items,
                       hipStream_t stream = 0,
                       bool debug_synchronous = false)
     {
-        using OffsetT = int;
         using T = typename std::iterator_traits<InputIteratorT>::value_type;
         using O = typename std::iterator_traits<OutputIteratorT>::value_type;
         using OutputTupleT =
             typename std::conditional<
                 std::is_same<O, void>::value,
-                KeyValuePair<OffsetT, T>,
+                KeyValuePair<int, T>,
                 O
             >::type;
 
+        // Indices have the key type of the output, e.g. KeyValuePair<int64_t, T> for more than 2^31 - 1 items
+        using OffsetT = typename OutputTupleT::Key;
         using OutputValueT = typename OutputTupleT::Value;
         using IteratorT = ArgIndexInputIterator<InputIteratorT, OffsetT, OutputValueT>;
 
+        if(!detail::num_items_fit<OffsetT>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+
         IteratorT d_indexed_in(d_in);
         OutputTupleT init(1, detail::get_max_value<T>());
 
@@ -188,14 +217,15 @@ public:
 
     template <
         typename InputIteratorT,
-        typename OutputIteratorT
+        typename OutputIteratorT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t Max(void *d_temp_storage,
                    size_t &temp_storage_bytes,
                    InputIteratorT d_in,
                    OutputIteratorT d_out,
-                   int num_items,
+                   NumItemsT num_items,
                    hipStream_t stream = 0,
                    bool debug_synchronous = false)
     {
@@ -209,30 +239,37 @@ public:
 
     template <
         typename InputIteratorT,
-        typename OutputIteratorT
+        typename OutputIteratorT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t ArgMax(void *d_temp_storage,
                       size_t &temp_storage_bytes,
                       InputIteratorT d_in,
                       OutputIteratorT d_out,
-                      int num_items,
+                      NumItemsT num_items,
                       hipStream_t stream = 0,
                       bool debug_synchronous = false)
     {
-        using OffsetT = int;
         using T = typename std::iterator_traits<InputIteratorT>::value_type;
         using O = typename std::iterator_traits<OutputIteratorT>::value_type;
         using OutputTupleT =
             typename std::conditional<
                 std::is_same<O, void>::value,
-                KeyValuePair<OffsetT, T>,
+                KeyValuePair<int, T>,
                 O
             >::type;
 
+        // Indices have the key type of the output, e.g. KeyValuePair<int64_t, T> for more than 2^31 - 1 items
+        using OffsetT = typename OutputTupleT::Key;
         using OutputValueT = typename OutputTupleT::Value;
         using IteratorT = ArgIndexInputIterator<InputIteratorT, OffsetT, OutputValueT>;
 
+        if(!detail::num_items_fit<OffsetT>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+
         IteratorT d_indexed_in(d_in);
         OutputTupleT init(1, detail::get_lowest_value<T>());
 
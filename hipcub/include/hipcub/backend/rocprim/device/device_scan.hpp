@@ -34,6 +34,7 @@
 #include "../../../config.hpp"
 
 #include "../thread/thread_operators.hpp"
+#include "detail/device_large_num_items.hpp"
 
 #include <rocprim/device/device_scan.hpp>
 BEGIN_HIPCUB_NAMESPACE
@@ -43,14 +44,15 @@ class DeviceScan
 public:
     template <
         typename InputIteratorT,
-        typename OutputIteratorT
+        typename OutputIteratorT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t InclusiveSum(void *d_temp_storage,
                             size_t &temp_storage_bytes,
                             InputIteratorT d_in,
                             OutputIteratorT d_out,
-                            int num_items,
+                            NumItemsT num_items,
                             hipStream_t stream = 0,
                             bool debug_synchronous = false)
     {
@@ -64,7 +66,8 @@ public:
     template <
         typename InputIteratorT,
         typename OutputIteratorT,
-        typename ScanOpT
+        typename ScanOpT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t InclusiveScan(void *d_temp_storage,
@@ -72,28 +75,47 @@ public:
                              InputIteratorT d_in,
                              OutputIteratorT d_out,
                              ScanOpT scan_op,
-                             int num_items,
+                             NumItemsT num_items,
                              hipStream_t stream = 0,
                              bool debug_synchronous = false)
     {
-        return ::rocprim::inclusive_scan(
-            d_temp_storage, temp_storage_bytes,
-            d_in, d_out, num_items,
-            ::hipcub::detail::convert_result_type<InputIteratorT, OutputIteratorT>(scan_op),
-            stream, debug_synchronous
+        auto op = ::hipcub::detail::convert_result_type<InputIteratorT, OutputIteratorT>(scan_op);
+        using result_type = typename decltype(op)::result_type;
+        return detail::dispatch_num_items(
+            num_items,
+            [&](size_t size)
+            {
+                return ::rocprim::inclusive_scan(
+                    d_temp_storage, temp_storage_bytes,
+                    d_in, d_out, size,
+                    op,
+                    stream, debug_synchronous
+                );
+            },
+            // More than 2^31 - 1 items: scan in chunks
+            [&](auto size)
+            {
+                return detail::scan_large<false, result_type>(
+                    d_temp_storage, temp_storage_bytes,
+                    d_in, d_out, size,
+                    op, result_type(),
+                    stream, debug_synchronous
+                );
+            }
         );
     }
 
     template <
         typename InputIteratorT,
-        typename OutputIteratorT
+        typename OutputIteratorT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t ExclusiveSum(void *d_temp_storage,
                             size_t &temp_storage_bytes,
                             InputIteratorT d_in,
                             OutputIteratorT d_out,
-                            int num_items,
+                            NumItemsT num_items,
                             hipStream_t stream = 0,
                             bool debug_synchronous = false)
     {
@@ -109,7 +131,8 @@ public:
         typename InputIteratorT,
         typename OutputIteratorT,
         typename ScanOpT,
-        typename InitValueT
+        typename InitValueT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t ExclusiveScan(void *d_temp_storage,
@@ -118,15 +141,33 @@ public:
                              OutputIteratorT d_out,
                              ScanOpT scan_op,
                              InitValueT init_value,
-                             int num_items,
+                             NumItemsT num_items,
                              hipStream_t stream = 0,
                              bool debug_synchronous = false)
     {
-        return ::rocprim::exclusive_scan(
-            d_temp_storage, temp_storage_bytes,
-            d_in, d_out, init_value, num_items,
-            ::hipcub::detail::convert_result_type<InputIteratorT, OutputIteratorT>(scan_op),
-            stream, debug_synchronous
+        auto op = ::hipcub::detail::convert_result_type<InputIteratorT, OutputIteratorT>(scan_op);
+        using result_type = typename decltype(op)::result_type;
+        return detail::dispatch_num_items(
+            num_items,
+            [&](size_t size)
+            {
+                return ::rocprim::exclusive_scan(
+                    d_temp_storage, temp_storage_bytes,
+                    d_in, d_out, init_value, size,
+                    op,
+                    stream, debug_synchronous
+                );
+            },
+            // More than 2^31 - 1 items: scan in chunks
+            [&](auto size)
+            {
+                return detail::scan_large<true, result_type>(
+                    d_temp_storage, temp_storage_bytes,
+                    d_in, d_out, size,
+                    op, init_value,
+                    stream, debug_synchronous
+                );
+            }
         );
     }
 };
@@ -33,6 +33,8 @@
 #include "../../../config.hpp"
 
 #include "../util_type.hpp"
+#include "detail/device_batched_radix_sort.hpp"
+#include "detail/device_large_num_items.hpp"
 
 #include <rocprim/device/device_segmented_radix_sort.hpp>
 
@@ -40,7 +42,7 @@ BEGIN_HIPCUB_NAMESPACE
 
 struct DeviceSegmentedRadixSort
 {
-    template<typename KeyT, typename ValueT, typename OffsetIteratorT>
+    template<typename KeyT, typename ValueT, typename OffsetIteratorT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortPairs(void * d_temp_storage,
                          size_t& temp_storage_bytes,
@@ -48,7 +50,7 @@ struct DeviceSegmentedRadixSort
                          KeyT * d_keys_out,
                          const ValueT * d_values_in,
                          ValueT * d_values_out,
-                         int num_items,
+                         NumItemsT num_items,
                          int num_segments,
                          OffsetIteratorT d_begin_offsets,
                          OffsetIteratorT d_end_offsets,
@@ -57,22 +59,26 @@ struct DeviceSegmentedRadixSort
                          hipStream_t stream = 0,
                          bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         return ::rocprim::segmented_radix_sort_pairs(
             d_temp_storage, temp_storage_bytes,
-            d_keys_in, d_keys_out, d_values_in, d_values_out, num_items,
+            d_keys_in, d_keys_out, d_values_in, d_values_out, static_cast<unsigned int>(num_items),
             num_segments, d_begin_offsets, d_end_offsets,
             begin_bit, end_bit,
             stream, debug_synchronous
         );
     }
 
-    template<typename KeyT, typename ValueT, typename OffsetIteratorT>
+    template<typename KeyT, typename ValueT, typename OffsetIteratorT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortPairs(void * d_temp_storage,
                          size_t& temp_storage_bytes,
                          DoubleBuffer<KeyT>& d_keys,
                          DoubleBuffer<ValueT>& d_values,
-                         int num_items,
+                         NumItemsT num_items,
                          int num_segments,
                          OffsetIteratorT d_begin_offsets,
                          OffsetIteratorT d_end_offsets,
@@ -81,11 +87,15 @@ struct DeviceSegmentedRadixSort
                          hipStream_t stream = 0,
                          bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         ::rocprim::double_buffer<KeyT> d_keys_db = detail::to_double_buffer(d_keys);
         ::rocprim::double_buffer<ValueT> d_values_db = detail::to_double_buffer(d_values);
         hipError_t error = ::rocprim::segmented_radix_sort_pairs(
             d_temp_storage, temp_storage_bytes,
-            d_keys_db, d_values_db, num_items,
+            d_keys_db, d_values_db, static_cast<unsigned int>(num_items),
             num_segments, d_begin_offsets, d_end_offsets,
             begin_bit, end_bit,
             stream, debug_synchronous
@@ -95,7 +105,7 @@ struct DeviceSegmentedRadixSort
         return error;
     }
 
-    template<typename KeyT, typename ValueT, typename OffsetIteratorT>
+    template<typename KeyT, typename ValueT, typename OffsetIteratorT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortPairsDescending(void * d_temp_storage,
                                    size_t& temp_storage_bytes,
@@ -103,7 +113,7 @@ struct DeviceSegmentedRadixSort
                                    KeyT * d_keys_out,
                                    const ValueT * d_values_in,
                                    ValueT * d_values_out,
-                                   int num_items,
+                                   NumItemsT num_items,
                                    int num_segments,
                                    OffsetIteratorT d_begin_offsets,
                                    OffsetIteratorT d_end_offsets,
@@ -112,22 +122,26 @@ struct DeviceSegmentedRadixSort
                                    hipStream_t stream = 0,
                                    bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         return ::rocprim::segmented_radix_sort_pairs_desc(
             d_temp_storage, temp_storage_bytes,
-            d_keys_in, d_keys_out, d_values_in, d_values_out, num_items,
+            d_keys_in, d_keys_out, d_values_in, d_values_out, static_cast<unsigned int>(num_items),
             num_segments, d_begin_offsets, d_end_offsets,
             begin_bit, end_bit,
             stream, debug_synchronous
         );
     }
 
-    template<typename KeyT, typename ValueT, typename OffsetIteratorT>
+    template<typename KeyT, typename ValueT, typename OffsetIteratorT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortPairsDescending(void * d_temp_storage,
                                    size_t& temp_storage_bytes,
                                    DoubleBuffer<KeyT>& d_keys,
                                    DoubleBuffer<ValueT>& d_values,
-                                   int num_items,
+                                   NumItemsT num_items,
                                    int num_segments,
                                    OffsetIteratorT d_begin_offsets,
                                    OffsetIteratorT d_end_offsets,
@@ -136,11 +150,15 @@ struct DeviceSegmentedRadixSort
                                    hipStream_t stream = 0,
                                    bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         ::rocprim::double_buffer<KeyT> d_keys_db = detail::to_double_buffer(d_keys);
         ::rocprim::double_buffer<ValueT> d_values_db = detail::to_double_buffer(d_values);
         hipError_t error = ::rocprim::segmented_radix_sort_pairs_desc(
             d_temp_storage, temp_storage_bytes,
-            d_keys_db, d_values_db, num_items,
+            d_keys_db, d_values_db, static_cast<unsigned int>(num_items),
             num_segments, d_begin_offsets, d_end_offsets,
             begin_bit, end_bit,
             stream, debug_synchronous
@@ -150,13 +168,13 @@ struct DeviceSegmentedRadixSort
         return error;
     }
 
-    template<typename KeyT, typename OffsetIteratorT>
+    template<typename KeyT, typename OffsetIteratorT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortKeys(void * d_temp_storage,
                         size_t& temp_storage_bytes,
                         const KeyT * d_keys_in,
                         KeyT * d_keys_out,
-                        int num_items,
+                        NumItemsT num_items,
                         int num_segments,
                         OffsetIteratorT d_begin_offsets,
                         OffsetIteratorT d_end_offsets,
@@ -165,21 +183,25 @@ struct DeviceSegmentedRadixSort
                         hipStream_t stream = 0,
                         bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         return ::rocprim::segmented_radix_sort_keys(
             d_temp_storage, temp_storage_bytes,
-            d_keys_in, d_keys_out, num_items,
+            d_keys_in, d_keys_out, static_cast<unsigned int>(num_items),
             num_segments, d_begin_offsets, d_end_offsets,
             begin_bit, end_bit,
             stream, debug_synchronous
         );
     }
 
-    template<typename KeyT, typename OffsetIteratorT>
+    template<typename KeyT, typename OffsetIteratorT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortKeys(void * d_temp_storage,
                         size_t& temp_storage_bytes,
                         DoubleBuffer<KeyT>& d_keys,
-                        int num_items,
+                        NumItemsT num_items,
                         int num_segments,
                         OffsetIteratorT d_begin_offsets,
                         OffsetIteratorT d_end_offsets,
@@ -188,10 +210,14 @@ struct DeviceSegmentedRadixSort
                         hipStream_t stream = 0,
                         bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         ::rocprim::double_buffer<KeyT> d_keys_db = detail::to_double_buffer(d_keys);
         hipError_t error = ::rocprim::segmented_radix_sort_keys(
             d_temp_storage, temp_storage_bytes,
-            d_keys_db, num_items,
+            d_keys_db, static_cast<unsigned int>(num_items),
             num_segments, d_begin_offsets, d_end_offsets,
             begin_bit, end_bit,
             stream, debug_synchronous
@@ -200,13 +226,13 @@ struct DeviceSegmentedRadixSort
         return error;
     }
 
-    template<typename KeyT, typename OffsetIteratorT>
+    template<typename KeyT, typename OffsetIteratorT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortKeysDescending(void * d_temp_storage,
                                   size_t& temp_storage_bytes,
                                   const KeyT * d_keys_in,
                                   KeyT * d_keys_out,
-                                  int num_items,
+                                  NumItemsT num_items,
                                   int num_segments,
                                   OffsetIteratorT d_begin_offsets,
                                   OffsetIteratorT d_end_offsets,
@@ -215,21 +241,25 @@ struct DeviceSegmentedRadixSort
                                   hipStream_t stream = 0,
                                   bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         return ::rocprim::segmented_radix_sort_keys_desc(
             d_temp_storage, temp_storage_bytes,
-            d_keys_in, d_keys_out, num_items,
+            d_keys_in, d_keys_out, static_cast<unsigned int>(num_items),
             num_segments, d_begin_offsets, d_end_offsets,
             begin_bit, end_bit,
             stream, debug_synchronous
         );
     }
 
-    template<typename KeyT, typename OffsetIteratorT>
+    template<typename KeyT, typename OffsetIteratorT, typename NumItemsT>
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t SortKeysDescending(void * d_temp_storage,
                                   size_t& temp_storage_bytes,
                                   DoubleBuffer<KeyT>& d_keys,
-                                  int num_items,
+                                  NumItemsT num_items,
                                   int num_segments,
                                   OffsetIteratorT d_begin_offsets,
                                   OffsetIteratorT d_end_offsets,
@@ -238,10 +268,14 @@ struct DeviceSegmentedRadixSort
                                   hipStream_t stream = 0,
                                   bool debug_synchronous = false)
     {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
         ::rocprim::double_buffer<KeyT> d_keys_db = detail::to_double_buffer(d_keys);
         hipError_t error = ::rocprim::segmented_radix_sort_keys_desc(
             d_temp_storage, temp_storage_bytes,
-            d_keys_db, num_items,
+            d_keys_db, static_cast<unsigned int>(num_items),
             num_segments, d_begin_offsets, d_end_offsets,
             begin_bit, end_bit,
             stream, debug_synchronous
@@ -249,6 +283,205 @@ struct DeviceSegmentedRadixSort
         detail::update_double_buffer(d_keys, d_keys_db);
         return error;
     }
+
+    // Batched variants: num_segments segments of segment_length items each,
+    // segment i from d_keys_in[i * segment_stride] on (likewise for the other
+    // arrays), e.g. the rows of a [num_segments, segment_stride] array.  No offset
+    // arrays are needed, and items between segments are left untouched.
+    //
+    // Segments of up to 4096 items are sorted by a BlockRadixSort each, in
+    // registers and shared memory, with a single launch.  Given as the template
+    // parameter SEGMENT_LENGTH, the length is known at compile time, and only the
+    // block sort tuned to it is compiled; given at run time, the block sort of the
+    // next power of two is used.  Longer segments are sorted as by SortPairs.
+
+    template<typename KeyT, typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsBatched(void * d_temp_storage,
+                                size_t& temp_storage_bytes,
+                                const KeyT * d_keys_in,
+                                KeyT * d_keys_out,
+                                const ValueT * d_values_in,
+                                ValueT * d_values_out,
+                                int num_segments,
+                                int segment_length,
+                                int segment_stride,
+                                int begin_bit = 0,
+                                int end_bit = sizeof(KeyT) * 8,
+                                hipStream_t stream = 0,
+                                bool debug_synchronous = false)
+    {
+        return detail::BatchedRadixSort<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            num_segments, segment_length, segment_stride,
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsDescendingBatched(void * d_temp_storage,
+                                          size_t& temp_storage_bytes,
+                                          const KeyT * d_keys_in,
+                                          KeyT * d_keys_out,
+                                          const ValueT * d_values_in,
+                                          ValueT * d_values_out,
+                                          int num_segments,
+                                          int segment_length,
+                                          int segment_stride,
+                                          int begin_bit = 0,
+                                          int end_bit = sizeof(KeyT) * 8,
+                                          hipStream_t stream = 0,
+                                          bool debug_synchronous = false)
+    {
+        return detail::BatchedRadixSort<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            num_segments, segment_length, segment_stride,
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysBatched(void * d_temp_storage,
+                               size_t& temp_storage_bytes,
+                               const KeyT * d_keys_in,
+                               KeyT * d_keys_out,
+                               int num_segments,
+                               int segment_length,
+                               int segment_stride,
+                               int begin_bit = 0,
+                               int end_bit = sizeof(KeyT) * 8,
+                               hipStream_t stream = 0,
+                               bool debug_synchronous = false)
+    {
+        return detail::BatchedRadixSort<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            num_segments, segment_length, segment_stride,
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysDescendingBatched(void * d_temp_storage,
+                                         size_t& temp_storage_bytes,
+                                         const KeyT * d_keys_in,
+                                         KeyT * d_keys_out,
+                                         int num_segments,
+                                         int segment_length,
+                                         int segment_stride,
+                                         int begin_bit = 0,
+                                         int end_bit = sizeof(KeyT) * 8,
+                                         hipStream_t stream = 0,
+                                         bool debug_synchronous = false)
+    {
+        return detail::BatchedRadixSort<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            num_segments, segment_length, segment_stride,
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    template<int SEGMENT_LENGTH, typename KeyT, typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsBatched(void * d_temp_storage,
+                                size_t& temp_storage_bytes,
+                                const KeyT * d_keys_in,
+                                KeyT * d_keys_out,
+                                const ValueT * d_values_in,
+                                ValueT * d_values_out,
+                                int num_segments,
+                                int segment_stride,
+                                int begin_bit = 0,
+                                int end_bit = sizeof(KeyT) * 8,
+                                hipStream_t stream = 0,
+                                bool debug_synchronous = false)
+    {
+        return detail::BatchedRadixSort<SEGMENT_LENGTH, false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            num_segments, segment_stride,
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    template<int SEGMENT_LENGTH, typename KeyT, typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsDescendingBatched(void * d_temp_storage,
+                                          size_t& temp_storage_bytes,
+                                          const KeyT * d_keys_in,
+                                          KeyT * d_keys_out,
+                                          const ValueT * d_values_in,
+                                          ValueT * d_values_out,
+                                          int num_segments,
+                                          int segment_stride,
+                                          int begin_bit = 0,
+                                          int end_bit = sizeof(KeyT) * 8,
+                                          hipStream_t stream = 0,
+                                          bool debug_synchronous = false)
+    {
+        return detail::BatchedRadixSort<SEGMENT_LENGTH, true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            num_segments, segment_stride,
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    template<int SEGMENT_LENGTH, typename KeyT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysBatched(void * d_temp_storage,
+                               size_t& temp_storage_bytes,
+                               const KeyT * d_keys_in,
+                               KeyT * d_keys_out,
+                               int num_segments,
+                               int segment_stride,
+                               int begin_bit = 0,
+                               int end_bit = sizeof(KeyT) * 8,
+                               hipStream_t stream = 0,
+                               bool debug_synchronous = false)
+    {
+        return detail::BatchedRadixSort<SEGMENT_LENGTH, false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            num_segments, segment_stride,
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
+
+    template<int SEGMENT_LENGTH, typename KeyT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysDescendingBatched(void * d_temp_storage,
+                                         size_t& temp_storage_bytes,
+                                         const KeyT * d_keys_in,
+                                         KeyT * d_keys_out,
+                                         int num_segments,
+                                         int segment_stride,
+                                         int begin_bit = 0,
+                                         int end_bit = sizeof(KeyT) * 8,
+                                         hipStream_t stream = 0,
+                                         bool debug_synchronous = false)
+    {
+        return detail::BatchedRadixSort<SEGMENT_LENGTH, true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            num_segments, segment_stride,
+            begin_bit, end_bit,
+            stream, debug_synchronous
+        );
+    }
 };
 
 END_HIPCUB_NAMESPACE
@@ -0,0 +1,268 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DEVICE_SEGMENTED_SORT_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DEVICE_SEGMENTED_SORT_HPP_
+
+#include "../../../config.hpp"
+
+#include "../util_type.hpp"
+
+#include "detail/device_segmented_sort.hpp"
+
+BEGIN_HIPCUB_NAMESPACE
+
+/**
+ * \brief DeviceSegmentedSort sorts every segment of a sequence, with segments of
+ * very different sizes in mind.
+ *
+ * \par Overview
+ * DeviceSegmentedRadixSort sorts each segment with a block, which leaves most of
+ * the device idle when segments are tiny, and a lone huge segment to a single block.
+ * DeviceSegmentedSort first splits segments by size: a thread sorts each segment of
+ * a few items, a block each segment that fits in one tile, and a block each the
+ * longer ones, with the segmented radix sort.  With fewer segments than compute
+ * units, the longer ones are sorted one at a time by the device-wide radix sort
+ * instead.  Each class is sorted by a launch of its own.
+ *
+ * \par
+ * - Segments are given as by DeviceSegmentedRadixSort, and keys are ordered as by
+ *   DeviceRadixSort over all their bits.
+ * - The sort is stable; the Stable variants are provided for compatibility.
+ * - Items of the output outside of all segments are left untouched.
+ * - The host does not wait for the device, except with fewer segments than compute
+ *   units and more than a tile of items: segments longer than a tile are then sorted
+ *   one after the other by the device-wide radix sort, and the call synchronizes
+ *   \p stream to learn where they are.
+ */
+struct DeviceSegmentedSort
+{
+    template<typename KeyT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeys(void * d_temp_storage,
+                        size_t& temp_storage_bytes,
+                        const KeyT * d_keys_in,
+                        KeyT * d_keys_out,
+                        int num_items,
+                        int num_segments,
+                        OffsetIteratorT d_begin_offsets,
+                        OffsetIteratorT d_end_offsets,
+                        hipStream_t stream = 0,
+                        bool debug_synchronous = false)
+    {
+        if(num_items < 0 || num_segments < 0)
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::SegmentedSort<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            static_cast<unsigned int>(num_items), static_cast<unsigned int>(num_segments),
+            d_begin_offsets, d_end_offsets,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortKeysDescending(void * d_temp_storage,
+                                  size_t& temp_storage_bytes,
+                                  const KeyT * d_keys_in,
+                                  KeyT * d_keys_out,
+                                  int num_items,
+                                  int num_segments,
+                                  OffsetIteratorT d_begin_offsets,
+                                  OffsetIteratorT d_end_offsets,
+                                  hipStream_t stream = 0,
+                                  bool debug_synchronous = false)
+    {
+        if(num_items < 0 || num_segments < 0)
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::SegmentedSort<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            static_cast<unsigned int>(num_items), static_cast<unsigned int>(num_segments),
+            d_begin_offsets, d_end_offsets,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairs(void * d_temp_storage,
+                         size_t& temp_storage_bytes,
+                         const KeyT * d_keys_in,
+                         KeyT * d_keys_out,
+                         const ValueT * d_values_in,
+                         ValueT * d_values_out,
+                         int num_items,
+                         int num_segments,
+                         OffsetIteratorT d_begin_offsets,
+                         OffsetIteratorT d_end_offsets,
+                         hipStream_t stream = 0,
+                         bool debug_synchronous = false)
+    {
+        if(num_items < 0 || num_segments < 0)
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::SegmentedSort<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            static_cast<unsigned int>(num_items), static_cast<unsigned int>(num_segments),
+            d_begin_offsets, d_end_offsets,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t SortPairsDescending(void * d_temp_storage,
+                                   size_t& temp_storage_bytes,
+                                   const KeyT * d_keys_in,
+                                   KeyT * d_keys_out,
+                                   const ValueT * d_values_in,
+                                   ValueT * d_values_out,
+                                   int num_items,
+                                   int num_segments,
+                                   OffsetIteratorT d_begin_offsets,
+                                   OffsetIteratorT d_end_offsets,
+                                   hipStream_t stream = 0,
+                                   bool debug_synchronous = false)
+    {
+        if(num_items < 0 || num_segments < 0)
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::SegmentedSort<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            static_cast<unsigned int>(num_items), static_cast<unsigned int>(num_segments),
+            d_begin_offsets, d_end_offsets,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t StableSortKeys(void * d_temp_storage,
+                              size_t& temp_storage_bytes,
+                              const KeyT * d_keys_in,
+                              KeyT * d_keys_out,
+                              int num_items,
+                              int num_segments,
+                              OffsetIteratorT d_begin_offsets,
+                              OffsetIteratorT d_end_offsets,
+                              hipStream_t stream = 0,
+                              bool debug_synchronous = false)
+    {
+        // SortKeys is stable already
+        return SortKeys(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out,
+            num_items, num_segments, d_begin_offsets, d_end_offsets,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t StableSortKeysDescending(void * d_temp_storage,
+                                        size_t& temp_storage_bytes,
+                                        const KeyT * d_keys_in,
+                                        KeyT * d_keys_out,
+                                        int num_items,
+                                        int num_segments,
+                                        OffsetIteratorT d_begin_offsets,
+                                        OffsetIteratorT d_end_offsets,
+                                        hipStream_t stream = 0,
+                                        bool debug_synchronous = false)
+    {
+        // SortKeysDescending is stable already
+        return SortKeysDescending(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out,
+            num_items, num_segments, d_begin_offsets, d_end_offsets,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t StableSortPairs(void * d_temp_storage,
+                               size_t& temp_storage_bytes,
+                               const KeyT * d_keys_in,
+                               KeyT * d_keys_out,
+                               const ValueT * d_values_in,
+                               ValueT * d_values_out,
+                               int num_items,
+                               int num_segments,
+                               OffsetIteratorT d_begin_offsets,
+                               OffsetIteratorT d_end_offsets,
+                               hipStream_t stream = 0,
+                               bool debug_synchronous = false)
+    {
+        // SortPairs is stable already
+        return SortPairs(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            num_items, num_segments, d_begin_offsets, d_end_offsets,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t StableSortPairsDescending(void * d_temp_storage,
+                                         size_t& temp_storage_bytes,
+                                         const KeyT * d_keys_in,
+                                         KeyT * d_keys_out,
+                                         const ValueT * d_values_in,
+                                         ValueT * d_values_out,
+                                         int num_items,
+                                         int num_segments,
+                                         OffsetIteratorT d_begin_offsets,
+                                         OffsetIteratorT d_end_offsets,
+                                         hipStream_t stream = 0,
+                                         bool debug_synchronous = false)
+    {
+        // SortPairsDescending is stable already
+        return SortPairsDescending(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            num_items, num_segments, d_begin_offsets, d_end_offsets,
+            stream, debug_synchronous
+        );
+    }
+};
+
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DEVICE_SEGMENTED_SORT_HPP_
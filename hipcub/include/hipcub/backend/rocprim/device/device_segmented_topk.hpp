@@ -0,0 +1,174 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DEVICE_SEGMENTED_TOPK_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DEVICE_SEGMENTED_TOPK_HPP_
+
+#include "../../../config.hpp"
+
+#include "../util_type.hpp"
+
+#include "detail/device_segmented_radix_select.hpp"
+
+BEGIN_HIPCUB_NAMESPACE
+
+/**
+ * \brief DeviceSegmentedTopK selects the k largest or smallest keys of every segment
+ * of a sequence by radix select.
+ *
+ * \par Overview
+ * Segments are selected from in place of being sorted: a warp handles each segment
+ * that fits in its registers, and blocks share the longer segments.  Only the
+ * selected keys (and values) are written, those of segment \p i from
+ * <tt>d_keys_out[i * k]</tt> on, in no particular order.  Among keys equal to the
+ * k-th key of a segment, which ones are selected is unspecified.
+ *
+ * \par
+ * - Segments are given as by DeviceSegmentedRadixSort; \p num_items is not used.
+ * - A segment with no more than \p k keys is copied whole, leaving the rest of its
+ *   \p k places in the outputs untouched.
+ * - Keys are arithmetic types, compared as by DeviceRadixSort.
+ */
+struct DeviceSegmentedTopK
+{
+    template<typename KeyT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t MaxKeys(void * d_temp_storage,
+                       size_t& temp_storage_bytes,
+                       const KeyT * d_keys_in,
+                       KeyT * d_keys_out,
+                       int num_items,
+                       int num_segments,
+                       OffsetIteratorT d_begin_offsets,
+                       OffsetIteratorT d_end_offsets,
+                       unsigned int k,
+                       hipStream_t stream = 0,
+                       bool debug_synchronous = false)
+    {
+        (void) num_items;
+        if(num_segments < 0)
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::SegmentedRadixSelect<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            static_cast<unsigned int>(num_segments), d_begin_offsets, d_end_offsets, k,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t MinKeys(void * d_temp_storage,
+                       size_t& temp_storage_bytes,
+                       const KeyT * d_keys_in,
+                       KeyT * d_keys_out,
+                       int num_items,
+                       int num_segments,
+                       OffsetIteratorT d_begin_offsets,
+                       OffsetIteratorT d_end_offsets,
+                       unsigned int k,
+                       hipStream_t stream = 0,
+                       bool debug_synchronous = false)
+    {
+        (void) num_items;
+        if(num_segments < 0)
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::SegmentedRadixSelect<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            static_cast<unsigned int>(num_segments), d_begin_offsets, d_end_offsets, k,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t MaxPairs(void * d_temp_storage,
+                        size_t& temp_storage_bytes,
+                        const KeyT * d_keys_in,
+                        KeyT * d_keys_out,
+                        const ValueT * d_values_in,
+                        ValueT * d_values_out,
+                        int num_items,
+                        int num_segments,
+                        OffsetIteratorT d_begin_offsets,
+                        OffsetIteratorT d_end_offsets,
+                        unsigned int k,
+                        hipStream_t stream = 0,
+                        bool debug_synchronous = false)
+    {
+        (void) num_items;
+        if(num_segments < 0)
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::SegmentedRadixSelect<true>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            static_cast<unsigned int>(num_segments), d_begin_offsets, d_end_offsets, k,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename OffsetIteratorT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t MinPairs(void * d_temp_storage,
+                        size_t& temp_storage_bytes,
+                        const KeyT * d_keys_in,
+                        KeyT * d_keys_out,
+                        const ValueT * d_values_in,
+                        ValueT * d_values_out,
+                        int num_items,
+                        int num_segments,
+                        OffsetIteratorT d_begin_offsets,
+                        OffsetIteratorT d_end_offsets,
+                        unsigned int k,
+                        hipStream_t stream = 0,
+                        bool debug_synchronous = false)
+    {
+        (void) num_items;
+        if(num_segments < 0)
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::SegmentedRadixSelect<false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            static_cast<unsigned int>(num_segments), d_begin_offsets, d_end_offsets, k,
+            stream, debug_synchronous
+        );
+    }
+};
+
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DEVICE_SEGMENTED_TOPK_HPP_
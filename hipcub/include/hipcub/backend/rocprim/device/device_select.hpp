@@ -33,8 +33,12 @@
 #include "../../../config.hpp"
 
 #include "../thread/thread_operators.hpp"
+#include "detail/device_large_num_items.hpp"
+#include "detail/device_radix_select.hpp"
 
 #include <rocprim/device/device_select.hpp>
+#include <rocprim/iterator/counting_iterator.hpp>
+#include <rocprim/iterator/transform_iterator.hpp>
 
 BEGIN_HIPCUB_NAMESPACE
 
@@ -45,7 +49,8 @@ public:
         typename InputIteratorT,
         typename FlagIterator,
         typename OutputIteratorT,
-        typename NumSelectedIteratorT
+        typename NumSelectedIteratorT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t Flagged(void *d_temp_storage,
@@ -54,14 +59,37 @@ public:
                        FlagIterator d_flags,
                        OutputIteratorT d_out,
                        NumSelectedIteratorT d_num_selected_out,
-                       int num_items,
+                       NumItemsT num_items,
                        hipStream_t stream = 0,
                        bool debug_synchronous = false)
     {
-        return ::rocprim::select(
-            d_temp_storage, temp_storage_bytes,
-            d_in, d_flags, d_out, d_num_selected_out, num_items,
-            stream, debug_synchronous
+        return detail::dispatch_num_items(
+            num_items,
+            [&](size_t size)
+            {
+                return ::rocprim::select(
+                    d_temp_storage, temp_storage_bytes,
+                    d_in, d_flags, d_out, d_num_selected_out, size,
+                    stream, debug_synchronous
+                );
+            },
+            // More than 2^31 - 1 items: select in chunks
+            [&](auto num_items_large)
+            {
+                return detail::select_large(
+                    d_temp_storage, temp_storage_bytes,
+                    d_out, d_num_selected_out, num_items_large,
+                    [&](void * storage, size_t& bytes, size_t begin, auto output, size_t * d_count, size_t size)
+                    {
+                        return ::rocprim::select(
+                            storage, bytes,
+                            d_in + begin, d_flags + begin, output, d_count, size,
+                            stream, debug_synchronous
+                        );
+                    },
+                    stream, debug_synchronous
+                );
+            }
         );
     }
 
@@ -69,7 +97,8 @@ public:
         typename InputIteratorT,
         typename OutputIteratorT,
         typename NumSelectedIteratorT,
-        typename SelectOp
+        typename SelectOp,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t If(void *d_temp_storage,
@@ -77,22 +106,46 @@ public:
                   InputIteratorT d_in,
                   OutputIteratorT d_out,
                   NumSelectedIteratorT d_num_selected_out,
-                  int num_items,
+                  NumItemsT num_items,
                   SelectOp select_op,
                   hipStream_t stream = 0,
                   bool debug_synchronous = false)
     {
-        return ::rocprim::select(
-            d_temp_storage, temp_storage_bytes,
-            d_in, d_out, d_num_selected_out, num_items, select_op,
-            stream, debug_synchronous
+        return detail::dispatch_num_items(
+            num_items,
+            [&](size_t size)
+            {
+                return ::rocprim::select(
+                    d_temp_storage, temp_storage_bytes,
+                    d_in, d_out, d_num_selected_out, size, select_op,
+                    stream, debug_synchronous
+                );
+            },
+            // More than 2^31 - 1 items: select in chunks
+            [&](auto num_items_large)
+            {
+                return detail::select_large(
+                    d_temp_storage, temp_storage_bytes,
+                    d_out, d_num_selected_out, num_items_large,
+                    [&](void * storage, size_t& bytes, size_t begin, auto output, size_t * d_count, size_t size)
+                    {
+                        return ::rocprim::select(
+                            storage, bytes,
+                            d_in + begin, output, d_count, size, select_op,
+                            stream, debug_synchronous
+                        );
+                    },
+                    stream, debug_synchronous
+                );
+            }
         );
     }
 
     template <
         typename InputIteratorT,
         typename OutputIteratorT,
-        typename NumSelectedIteratorT
+        typename NumSelectedIteratorT,
+        typename NumItemsT
     >
     HIPCUB_RUNTIME_FUNCTION static
     hipError_t Unique(void *d_temp_storage,
@@ -100,13 +153,76 @@ public:
                       InputIteratorT d_in,
                       OutputIteratorT d_out,
                       NumSelectedIteratorT d_num_selected_out,
-                      int num_items,
+                      NumItemsT num_items,
                       hipStream_t stream = 0,
                       bool debug_synchronous = false)
     {
-        return ::rocprim::unique(
+        using flag_op = detail::unique_flag_op<InputIteratorT, hipcub::Equality>;
+        using flag_iterator =
+            ::rocprim::transform_iterator<::rocprim::counting_iterator<size_t>, flag_op, bool>;
+        return detail::dispatch_num_items(
+            num_items,
+            [&](size_t size)
+            {
+                return ::rocprim::unique(
+                    d_temp_storage, temp_storage_bytes,
+                    d_in, d_out, d_num_selected_out, size, hipcub::Equality(),
+                    stream, debug_synchronous
+                );
+            },
+            // More than 2^31 - 1 items: select the first item of every run in chunks, the
+            // flag of the first item of a chunk comparing it with the last of the previous one
+            [&](auto num_items_large)
+            {
+                return detail::select_large(
+                    d_temp_storage, temp_storage_bytes,
+                    d_out, d_num_selected_out, num_items_large,
+                    [&](void * storage, size_t& bytes, size_t begin, auto output, size_t * d_count, size_t size)
+                    {
+                        return ::rocprim::select(
+                            storage, bytes,
+                            d_in + begin,
+                            flag_iterator(::rocprim::counting_iterator<size_t>(begin), flag_op{ d_in, hipcub::Equality() }),
+                            output, d_count, size,
+                            stream, debug_synchronous
+                        );
+                    },
+                    stream, debug_synchronous
+                );
+            }
+        );
+    }
+
+    // Writes to d_out[0] the key that would be at position nth if the keys were
+    // sorted, as std::nth_element, by radix select (see DeviceTopK).  Keys are
+    // arithmetic types compared as by DeviceRadixSort and nth must be less than
+    // num_items, which must fit in an unsigned int.  nth and num_items may be of
+    // different integral types.
+    template <
+        typename KeyT,
+        typename NthT,
+        typename NumItemsT
+    >
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t NthElement(void *d_temp_storage,
+                          size_t &temp_storage_bytes,
+                          const KeyT *d_in,
+                          KeyT *d_out,
+                          NthT nth,
+                          NumItemsT num_items,
+                          hipStream_t stream = 0,
+                          bool debug_synchronous = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items)
+           || detail::num_items_negative(nth)
+           || !(static_cast<unsigned long long>(nth) < static_cast<unsigned long long>(num_items)))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSelect<false, true>(
             d_temp_storage, temp_storage_bytes,
-            d_in, d_out, d_num_selected_out, num_items, hipcub::Equality(),
+            d_in, d_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            static_cast<unsigned int>(num_items), static_cast<unsigned int>(nth) + 1, false,
             stream, debug_synchronous
         );
     }
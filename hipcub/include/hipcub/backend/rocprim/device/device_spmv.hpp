@@ -32,10 +32,40 @@
 
 #include "../../../config.hpp"
 
+#include "../util_ptx.hpp"
+#include "../util_type.hpp"
+#include "../block/block_reduce.hpp"
+#include "../block/block_scan.hpp"
+#include "../warp/warp_reduce.hpp"
+#include "../iterator/counting_input_iterator.hpp"
 #include "../iterator/tex_ref_input_iterator.hpp"
+#include "../thread/thread_search.hpp"
+#include "device_scan.hpp"
+#include "device_segmented_radix_sort.hpp"
+
+#include <rocprim/detail/various.hpp>
+#include <rocprim/functional.hpp>
+
+#include <cmath>
+#include <limits>
 
 BEGIN_HIPCUB_NAMESPACE
 
+/// SpMV kernel variants that a DeviceSpmv::Plan can select
+enum SpmvAlgorithm
+{
+    SPMV_MERGE_PATH,    ///< Nonzeros and row ends are split evenly across thread blocks
+    SPMV_SCALAR,        ///< One thread per row, for short rows of similar length
+    SPMV_VECTOR         ///< A group of lanes of a wavefront per row, for long rows of similar length
+};
+
+/// Storage order of the dense operands of DeviceSpmv::CsrMM
+enum DenseLayout
+{
+    DENSE_ROW_MAJOR,    ///< Element (i, j) is at i * ld + j
+    DENSE_COLUMN_MAJOR  ///< Element (i, j) is at i + j * ld
+};
+
 class DeviceSpmv
 {
 
@@ -60,92 +90,1851 @@ struct SpmvParams
     ::hipcub::TexRefInputIterator<ValueT, 66778899, OffsetT>  t_vector_x;
 };
 
-static constexpr uint32_t CsrMVKernel_MaxThreads = 256;
+/// Row-length statistics of a CSR matrix, computed on the device by CsrMVPlan
+struct RowStats
+{
+    int             min_row_length;         ///< Length of the shortest row
+    int             max_row_length;         ///< Length of the longest row
+    int             empty_rows;             ///< Number of rows without nonzeros
+    double          row_length_mean;        ///< Mean row length
+    double          row_length_std_dev;     ///< Standard deviation of the row lengths
+    double          row_length_skewness;    ///< Skewness of the row lengths
+};
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS    // Do not document
+
+/// Merge-path coordinate: \p x indexes rows, \p y indexes nonzeros
+template <typename OffsetT>
+struct SpmvCoordinate
+{
+    OffsetT x;
+    OffsetT y;
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * \brief Reusable analysis of the sparsity structure of a CSR matrix.
+ *
+ * A plan is created once per sparsity structure with CsrMVPlan() and can then be
+ * passed to CsrMV() any number of times, with different values, vectors and
+ * scaling factors.  Every such call is a single kernel launch.
+ *
+ * CsrMVPlan() selects the kernel variant from the row-length statistics:
+ * matrices with short, uniform rows use SPMV_SCALAR, matrices with longer,
+ * uniform rows use SPMV_VECTOR, and skewed matrices use SPMV_MERGE_PATH.  The
+ * choice can be overridden by changing \p algorithm (and \p vector_threads)
+ * before calling CsrMV().
+ *
+ * The plan refers to the \p d_row_offsets array and to the temporary storage
+ * passed to CsrMVPlan(); both must stay alive and unmodified while the plan is
+ * in use.  A plan must not be used by multiple streams concurrently.
+ */
+template <typename ValueT>
+struct Plan
+{
+    int*                            d_row_offsets;          ///< Row offsets the plan was created for
+    int                             num_rows;               ///< Number of rows of matrix <b>A</b>.
+    int                             num_cols;               ///< Number of columns of matrix <b>A</b>.
+    int                             num_nonzeros;           ///< Number of nonzero elements of matrix <b>A</b>.
+    SpmvAlgorithm                   algorithm;              ///< Kernel variant used by CsrMV()
+    int                             vector_threads;         ///< Lanes per row of SPMV_VECTOR: 4, 8, 16 or 32
+    RowStats                        row_stats;              ///< Row-length statistics (host copy)
+
+    int                             num_merge_tiles;        ///< Number of merge-path tiles
+    SpmvCoordinate<int>*            d_tile_coordinates;     ///< Start coordinate of every merge-path tile
+    KeyValuePair<int, ValueT>*      d_tile_carry_pairs;     ///< Carry-out of every merge-path tile
+    unsigned int*                   d_tile_counter;         ///< Completed-tile counter, zero between launches
+};
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS    // Do not document
 
+/// Tuning parameters for the merge-path SpMV kernel
 template <typename ValueT>
+struct SpmvMergePathPolicy
+{
+    static constexpr int BLOCK_THREADS      = 256;
+    static constexpr int ITEMS_PER_THREAD   = (sizeof(ValueT) > 4) ? 5 : 7;
+    static constexpr int TILE_ITEMS         = BLOCK_THREADS * ITEMS_PER_THREAD;
+};
+
+/// Reduce-by-key operator used to combine per-thread row partials
+struct SpmvReduceByKeyOp
+{
+    template <typename KeyValuePairT>
+    HIPCUB_HOST_DEVICE inline
+    KeyValuePairT operator()(const KeyValuePairT &first, const KeyValuePairT &second) const
+    {
+        KeyValuePairT retval = second;
+        if (first.key == second.key)
+        {
+            retval.value = first.value + second.value;
+        }
+        return retval;
+    }
+};
+
+static constexpr uint32_t SpmvSearchKernel_BlockThreads = 256;
+
+/**
+ * Splits the merge path of (row end-offsets, nonzero indices) into tiles of
+ * \p tile_items consecutive merge items and records the starting coordinate of
+ * every tile (plus the end coordinate of the last one).
+ */
+template <typename OffsetT>
 static __global__ void
-CsrMVKernel(SpmvParams<ValueT, int> spmv_params)
+SpmvSearchKernel(
+    int                         num_merge_tiles,
+    int                         tile_items,
+    SpmvCoordinate<OffsetT>*    d_tile_coordinates,
+    const OffsetT*              d_row_end_offsets,
+    OffsetT                     num_rows,
+    OffsetT                     num_nonzeros)
+{
+    const int tile_idx = (hipBlockIdx_x * hipBlockDim_x) + hipThreadIdx_x;
+    if (tile_idx < num_merge_tiles + 1)
+    {
+        const OffsetT diagonal = ::rocprim::min<OffsetT>(
+            OffsetT(tile_items) * tile_idx, num_rows + num_nonzeros);
+
+        CountingInputIterator<OffsetT> nonzero_indices(0);
+        SpmvCoordinate<OffsetT> tile_coordinate;
+        MergePathSearch(
+            diagonal, d_row_end_offsets, nonzero_indices,
+            num_rows, num_nonzeros, tile_coordinate);
+
+        d_tile_coordinates[tile_idx] = tile_coordinate;
+    }
+}
+
+/**
+ * Consumes one merge tile per block.  Every thread walks ITEMS_PER_THREAD steps
+ * of the merge path, accumulating nonzeros until it crosses a row end.  Rows
+ * that end inside the tile are written to \p d_vector_y; the partial sum of the
+ * row left open at the end of the tile is emitted as the tile's carry-out.
+ *
+ * The last block to finish adds every carry-out into the row it left open, so
+ * no separate fix-up launch is needed.  It also resets \p d_tile_counter.
+ */
+template <
+    typename Policy,
+    bool     HAS_BETA,
+    typename ValueT,
+    typename OffsetT>
+static __global__ __launch_bounds__(Policy::BLOCK_THREADS) void
+SpmvMergePathKernel(
+    SpmvParams<ValueT, OffsetT>             spmv_params,
+    const SpmvCoordinate<OffsetT>*          d_tile_coordinates,
+    KeyValuePair<OffsetT, ValueT>*          d_tile_carry_pairs,
+    unsigned int*                           d_tile_counter,
+    int                                     num_merge_tiles)
 {
-    __shared__ ValueT partial;
+    constexpr int BLOCK_THREADS    = Policy::BLOCK_THREADS;
+    constexpr int ITEMS_PER_THREAD = Policy::ITEMS_PER_THREAD;
+    constexpr int TILE_ITEMS       = Policy::TILE_ITEMS;
+
+    using CoordinateT   = SpmvCoordinate<OffsetT>;
+    using KeyValuePairT = KeyValuePair<OffsetT, ValueT>;
+    using BlockScanT    = BlockScan<KeyValuePairT, BLOCK_THREADS, BLOCK_SCAN_WARP_SCANS>;
+
+    union MergeItem
+    {
+        OffsetT row_end_offset;
+        ValueT  nonzero;
+    };
+
+    union TempStorage
+    {
+        // Row end-offsets of the tile, later reused for the row totals
+        MergeItem                           merge_items[TILE_ITEMS + ITEMS_PER_THREAD + 1];
+        typename BlockScanT::TempStorage    scan;
+    };
 
-    const int32_t row_id = hipBlockIdx_x;
+    __shared__ TempStorage temp_storage;
+    __shared__ bool        is_last_tile;
 
-    if(hipThreadIdx_x == 0)
+    const int tile_idx = hipBlockIdx_x;
+    if (tile_idx >= num_merge_tiles)
     {
-        partial = spmv_params.beta * spmv_params.d_vector_y[row_id];
+        return;
     }
-    __syncthreads();
 
-    int32_t row_offset = (row_id == 0) ? (0) : (spmv_params.d_row_end_offsets[row_id - 1]);
-    for(uint32_t thread_offset = 0; thread_offset < spmv_params.num_cols / hipBlockDim_x; thread_offset++)
+    const CoordinateT tile_start_coord  = d_tile_coordinates[tile_idx];
+    const CoordinateT tile_end_coord    = d_tile_coordinates[tile_idx + 1];
+    const OffsetT     tile_num_rows     = tile_end_coord.x - tile_start_coord.x;
+    const OffsetT     tile_num_nonzeros = tile_end_coord.y - tile_start_coord.y;
+
+    // Gather the row end-offsets of the tile (clamped past the last row)
+    OffsetT* s_tile_row_end_offsets = &temp_storage.merge_items[0].row_end_offset;
+    for (int item = hipThreadIdx_x; item < tile_num_rows + ITEMS_PER_THREAD; item += BLOCK_THREADS)
     {
-        int32_t offset = row_offset + thread_offset * hipBlockDim_x + hipThreadIdx_x;
+        const OffsetT row = ::rocprim::min<OffsetT>(
+            tile_start_coord.x + item, spmv_params.num_rows - 1);
+        s_tile_row_end_offsets[item] = spmv_params.d_row_end_offsets[row];
+    }
+
+    ::rocprim::syncthreads();
 
-        if(offset < spmv_params.d_row_end_offsets[row_id])
+    // Search for the thread's starting coordinate within the merge tile
+    CountingInputIterator<OffsetT> tile_nonzero_indices(tile_start_coord.y);
+    CoordinateT thread_start_coord;
+    MergePathSearch(
+        OffsetT(hipThreadIdx_x * ITEMS_PER_THREAD),
+        s_tile_row_end_offsets,
+        tile_nonzero_indices,
+        tile_num_rows,
+        tile_num_nonzeros,
+        thread_start_coord);
+
+    // Walk the thread's merge path segment.  Row ends are keyed by their
+    // tile-local row; accumulation steps are keyed by tile_num_rows.
+    CoordinateT   thread_current_coord = thread_start_coord;
+    KeyValuePairT scan_segment[ITEMS_PER_THREAD];
+    ValueT        running_total = ValueT(0);
+
+    #pragma unroll
+    for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+    {
+        const OffsetT row_end_offset = s_tile_row_end_offsets[thread_current_coord.x];
+        if (tile_nonzero_indices[thread_current_coord.y] < row_end_offset)
+        {
+            // Move down (accumulate)
+            const OffsetT nonzero_idx = tile_start_coord.y + thread_current_coord.y;
+            running_total += spmv_params.d_values[nonzero_idx]
+                * spmv_params.d_vector_x[spmv_params.d_column_indices[nonzero_idx]];
+            scan_segment[ITEM].key   = tile_num_rows;
+            scan_segment[ITEM].value = running_total;
+            ++thread_current_coord.y;
+        }
+        else
         {
-            ValueT t_value =
-                spmv_params.alpha *
-                spmv_params.d_values[offset] *
-                spmv_params.d_vector_x[spmv_params.d_column_indices[offset]];
+            // Move right (row end)
+            scan_segment[ITEM].key   = thread_current_coord.x;
+            scan_segment[ITEM].value = running_total;
+            running_total = ValueT(0);
+            ++thread_current_coord.x;
+        }
+    }
+
+    ::rocprim::syncthreads();
+
+    // Block-wide reduce-value-by-row of the partials left open by each thread
+    KeyValuePairT scan_item;
+    scan_item.key   = thread_current_coord.x;
+    scan_item.value = running_total;
+
+    KeyValuePairT scan_initial;
+    scan_initial.key   = OffsetT(-1);
+    scan_initial.value = ValueT(0);
+
+    KeyValuePairT tile_carry;
+    BlockScanT(temp_storage.scan).ExclusiveScan(
+        scan_item, scan_item, scan_initial, SpmvReduceByKeyOp(), tile_carry);
 
-            atomicAdd(&partial, t_value);
+    if (hipThreadIdx_x == 0)
+    {
+        scan_item.key   = thread_start_coord.x;
+        scan_item.value = ValueT(0);
+    }
+
+    if (tile_num_rows > 0)
+    {
+        ::rocprim::syncthreads();
+
+        // The first row end of every thread closes the row carried in from
+        // the preceding threads of the tile
+        ValueT* s_partials = &temp_storage.merge_items[0].nonzero;
+        ValueT  prefix     = scan_item.value;
+
+        #pragma unroll
+        for (int ITEM = 0; ITEM < ITEMS_PER_THREAD; ++ITEM)
+        {
+            if (scan_segment[ITEM].key < tile_num_rows)
+            {
+                s_partials[scan_segment[ITEM].key] = scan_segment[ITEM].value + prefix;
+                prefix = ValueT(0);
+            }
+        }
 
-            __syncthreads();
+        ::rocprim::syncthreads();
 
-            if(hipThreadIdx_x == 0)
+        for (int item = hipThreadIdx_x; item < tile_num_rows; item += BLOCK_THREADS)
+        {
+            const OffsetT row = tile_start_coord.x + item;
+            ValueT total = spmv_params.alpha * s_partials[item];
+            if (HAS_BETA)
             {
-                spmv_params.d_vector_y[row_id] = partial;
+                total += spmv_params.beta * spmv_params.d_vector_y[row];
             }
+            spmv_params.d_vector_y[row] = total;
         }
     }
-}
 
-template <typename ValueT>
-    HIPCUB_RUNTIME_FUNCTION
-    static hipError_t CsrMV(
-        void*               d_temp_storage,                     ///< [in] %Device-accessible allocation of temporary storage.  When NULL, the required allocation size is written to \p temp_storage_bytes and no work is done.
-        size_t&             temp_storage_bytes,                 ///< [in,out] Reference to size in bytes of \p d_temp_storage allocation
-        ValueT*             d_values,                           ///< [in] Pointer to the array of \p num_nonzeros values of the corresponding nonzero elements of matrix <b>A</b>.
-        int*                d_row_offsets,                      ///< [in] Pointer to the array of \p m + 1 offsets demarcating the start of every row in \p d_column_indices and \p d_values (with the final entry being equal to \p num_nonzeros)
-        int*                d_column_indices,                   ///< [in] Pointer to the array of \p num_nonzeros column-indices of the corresponding nonzero elements of matrix <b>A</b>.  (Indices are zero-valued.)
-        ValueT*             d_vector_x,                         ///< [in] Pointer to the array of \p num_cols values corresponding to the dense input vector <em>x</em>
-        ValueT*             d_vector_y,                         ///< [out] Pointer to the array of \p num_rows values corresponding to the dense output vector <em>y</em>
-        int                 num_rows,                           ///< [in] number of rows of matrix <b>A</b>.
-        int                 num_cols,                           ///< [in] number of columns of matrix <b>A</b>.
-        int                 num_nonzeros,                       ///< [in] number of nonzero elements of matrix <b>A</b>.
-        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
-        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    // A single tile closes every row itself
+    if (num_merge_tiles == 1)
     {
-        SpmvParams<ValueT, int> spmv_params;
-        spmv_params.d_values             = d_values;
-        spmv_params.d_row_end_offsets    = d_row_offsets + 1;
-        spmv_params.d_column_indices     = d_column_indices;
-        spmv_params.d_vector_x           = d_vector_x;
-        spmv_params.d_vector_y           = d_vector_y;
-        spmv_params.num_rows             = num_rows;
-        spmv_params.num_cols             = num_cols;
-        spmv_params.num_nonzeros         = num_nonzeros;
-        spmv_params.alpha                = 1.0;
-        spmv_params.beta                 = 0.0;
+        return;
+    }
+
+    // Publish the rows of this tile before announcing its carry-out
+    __threadfence();
+    ::rocprim::syncthreads();
+
+    if (hipThreadIdx_x == 0)
+    {
+        tile_carry.key  += tile_start_coord.x;
+        tile_carry.value = spmv_params.alpha * tile_carry.value;
+        d_tile_carry_pairs[tile_idx] = tile_carry;
 
-        hipError_t status;
-        if(d_temp_storage == nullptr)
+        __threadfence();
+        const unsigned int ticket = atomicAdd(d_tile_counter, 1u);
+        is_last_tile = (ticket == static_cast<unsigned int>(num_merge_tiles - 1));
+    }
+
+    ::rocprim::syncthreads();
+
+    if (is_last_tile)
+    {
+        // Every other tile has finished: fix up the rows split across tiles
+        __threadfence();
+        for (int tile = hipThreadIdx_x; tile < num_merge_tiles; tile += BLOCK_THREADS)
         {
-            temp_storage_bytes = 0;
-            return hipError_t(0);
+            const KeyValuePairT carry = d_tile_carry_pairs[tile];
+            if (carry.key < spmv_params.num_rows)
+            {
+                atomicAdd(&spmv_params.d_vector_y[carry.key], carry.value);
+            }
         }
-        else
+
+        if (hipThreadIdx_x == 0)
         {
-            size_t block_size = min(num_cols, DeviceSpmv::CsrMVKernel_MaxThreads);
-            size_t grid_size = num_rows;
-            CsrMVKernel<<<grid_size, block_size, 0, stream>>>(spmv_params);
-            status = hipPeekAtLastError();
+            *d_tile_counter = 0;
         }
-        return status;
     }
+}
+
+static constexpr uint32_t SpmvRowStatsKernel_BlockThreads = 256;
+
+/// Device-side accumulator of RowStats
+struct SpmvRowStatsAccumulator
+{
+    int     min_row_length;
+    int     max_row_length;
+    int     empty_rows;
+    double  sum_squared_deviations;
+    double  sum_cubed_deviations;
 };
 
-END_HIPCUB_NAMESPACE
+/**
+ * Accumulates the extrema and the second and third central moments of the
+ * row lengths.  The mean is known on the host from num_nonzeros / num_rows.
+ */
+template <typename OffsetT>
+static __global__ __launch_bounds__(SpmvRowStatsKernel_BlockThreads) void
+SpmvRowStatsKernel(
+    const OffsetT*              d_row_offsets,
+    OffsetT                     num_rows,
+    double                      row_length_mean,
+    SpmvRowStatsAccumulator*    d_accumulator)
+{
+    using BlockReduceIntT    = BlockReduce<int, SpmvRowStatsKernel_BlockThreads>;
+    using BlockReduceDoubleT = BlockReduce<double, SpmvRowStatsKernel_BlockThreads>;
+
+    __shared__ union
+    {
+        typename BlockReduceIntT::TempStorage       reduce_int;
+        typename BlockReduceDoubleT::TempStorage    reduce_double;
+    } temp_storage;
+
+    int    min_row_length = std::numeric_limits<int>::max();
+    int    max_row_length = 0;
+    int    empty_rows     = 0;
+    double squared        = 0.0;
+    double cubed          = 0.0;
+
+    for (OffsetT row = (hipBlockIdx_x * hipBlockDim_x) + hipThreadIdx_x;
+         row < num_rows;
+         row += hipGridDim_x * hipBlockDim_x)
+    {
+        const int    row_length = static_cast<int>(d_row_offsets[row + 1] - d_row_offsets[row]);
+        const double deviation  = row_length - row_length_mean;
+        min_row_length = ::rocprim::min(min_row_length, row_length);
+        max_row_length = ::rocprim::max(max_row_length, row_length);
+        empty_rows    += (row_length == 0) ? 1 : 0;
+        squared       += deviation * deviation;
+        cubed         += deviation * deviation * deviation;
+    }
+
+    min_row_length = BlockReduceIntT(temp_storage.reduce_int).Reduce(min_row_length, Min());
+    ::rocprim::syncthreads();
+    max_row_length = BlockReduceIntT(temp_storage.reduce_int).Reduce(max_row_length, Max());
+    ::rocprim::syncthreads();
+    empty_rows = BlockReduceIntT(temp_storage.reduce_int).Sum(empty_rows);
+    ::rocprim::syncthreads();
+    squared = BlockReduceDoubleT(temp_storage.reduce_double).Sum(squared);
+    ::rocprim::syncthreads();
+    cubed = BlockReduceDoubleT(temp_storage.reduce_double).Sum(cubed);
+
+    if (hipThreadIdx_x == 0)
+    {
+        atomicMin(&d_accumulator->min_row_length, min_row_length);
+        atomicMax(&d_accumulator->max_row_length, max_row_length);
+        atomicAdd(&d_accumulator->empty_rows, empty_rows);
+        atomicAdd(&d_accumulator->sum_squared_deviations, squared);
+        atomicAdd(&d_accumulator->sum_cubed_deviations, cubed);
+    }
+}
+
+static constexpr uint32_t SpmvRowKernel_BlockThreads = 256;
+
+/// Widest lane group of the vector kernel; valid on wave32 and wave64 devices
+static constexpr int SpmvVectorKernel_MaxThreads = 32;
+
+/// Rows at most this long (and of similar length) use the scalar kernel
+static constexpr int SpmvScalarKernel_MaxRowLength = 16;
+
+/**
+ * Computes one row per thread.
+ */
+template <
+    bool     HAS_BETA,
+    typename ValueT,
+    typename OffsetT>
+static __global__ __launch_bounds__(SpmvRowKernel_BlockThreads) void
+SpmvScalarKernel(
+    SpmvParams<ValueT, OffsetT> spmv_params,
+    const OffsetT*              d_row_offsets)
+{
+    const OffsetT row = (hipBlockIdx_x * SpmvRowKernel_BlockThreads) + hipThreadIdx_x;
+    if (row >= spmv_params.num_rows)
+    {
+        return;
+    }
+
+    const OffsetT row_start = d_row_offsets[row];
+    const OffsetT row_end   = d_row_offsets[row + 1];
+
+    ValueT partial = ValueT(0);
+    for (OffsetT nonzero_idx = row_start; nonzero_idx < row_end; ++nonzero_idx)
+    {
+        partial += spmv_params.d_values[nonzero_idx]
+            * spmv_params.d_vector_x[spmv_params.d_column_indices[nonzero_idx]];
+    }
+
+    ValueT total = spmv_params.alpha * partial;
+    if (HAS_BETA)
+    {
+        total += spmv_params.beta * spmv_params.d_vector_y[row];
+    }
+    spmv_params.d_vector_y[row] = total;
+}
+
+/**
+ * Computes one row per group of \p VECTOR_THREADS consecutive lanes.  The lanes
+ * of a group read consecutive nonzeros of the row, so loads are coalesced.
+ */
+template <
+    int      VECTOR_THREADS,
+    bool     HAS_BETA,
+    typename ValueT,
+    typename OffsetT>
+static __global__ __launch_bounds__(SpmvRowKernel_BlockThreads) void
+SpmvVectorKernel(
+    SpmvParams<ValueT, OffsetT> spmv_params,
+    const OffsetT*              d_row_offsets)
+{
+    constexpr int ROWS_PER_BLOCK = SpmvRowKernel_BlockThreads / VECTOR_THREADS;
+
+    using WarpReduceT = WarpReduce<ValueT, VECTOR_THREADS>;
+
+    __shared__ typename WarpReduceT::TempStorage temp_storage[ROWS_PER_BLOCK];
+
+    const int     group = hipThreadIdx_x / VECTOR_THREADS;
+    const int     lane  = hipThreadIdx_x % VECTOR_THREADS;
+    const OffsetT row   = (hipBlockIdx_x * ROWS_PER_BLOCK) + group;
+
+    // Lanes of rows past the end stay to take part in the reduction
+    ValueT partial = ValueT(0);
+    if (row < spmv_params.num_rows)
+    {
+        const OffsetT row_start = d_row_offsets[row];
+        const OffsetT row_end   = d_row_offsets[row + 1];
+        for (OffsetT nonzero_idx = row_start + lane; nonzero_idx < row_end; nonzero_idx += VECTOR_THREADS)
+        {
+            partial += spmv_params.d_values[nonzero_idx]
+                * spmv_params.d_vector_x[spmv_params.d_column_indices[nonzero_idx]];
+        }
+    }
+
+    partial = WarpReduceT(temp_storage[group]).Sum(partial);
+
+    if ((lane == 0) && (row < spmv_params.num_rows))
+    {
+        ValueT total = spmv_params.alpha * partial;
+        if (HAS_BETA)
+        {
+            total += spmv_params.beta * spmv_params.d_vector_y[row];
+        }
+        spmv_params.d_vector_y[row] = total;
+    }
+}
+
+/**
+ * Picks the kernel variant of \p plan from its row-length statistics.
+ *
+ * Row-per-thread and row-per-group kernels are only balanced when rows have
+ * similar lengths; a coefficient of variation above one or a row much longer
+ * than the mean sends the matrix to the merge-path kernel.
+ */
+template <typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static void SelectAlgorithm(Plan<ValueT>& plan)
+{
+    const RowStats& stats = plan.row_stats;
+
+    plan.algorithm      = SPMV_MERGE_PATH;
+    plan.vector_threads = 4;
+    while ((plan.vector_threads < SpmvVectorKernel_MaxThreads)
+        && (plan.vector_threads < stats.row_length_mean))
+    {
+        plan.vector_threads *= 2;
+    }
+
+    const bool skewed =
+        (stats.row_length_std_dev > stats.row_length_mean)
+        || (stats.max_row_length > 8 * (std::ceil(stats.row_length_mean) + 1));
+
+    if ((plan.num_rows == 0) || skewed)
+    {
+        return;
+    }
+
+    plan.algorithm = (stats.max_row_length <= SpmvScalarKernel_MaxRowLength)
+        ? SPMV_SCALAR
+        : SPMV_VECTOR;
+}
+
+/**
+ * Lays out the merge-path partition of \p plan in \p d_temp_storage and
+ * launches the search for the tile coordinates.
+ */
+template <typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t PartitionMergePath(
+    void*               d_temp_storage,
+    size_t&             temp_storage_bytes,
+    Plan<ValueT>&       plan,
+    hipStream_t         stream,
+    bool                debug_synchronous)
+{
+    using Policy        = SpmvMergePathPolicy<ValueT>;
+    using CoordinateT   = SpmvCoordinate<int>;
+    using KeyValuePairT = KeyValuePair<int, ValueT>;
+
+    const int num_merge_items = plan.num_rows + plan.num_nonzeros;
+    plan.num_merge_tiles = DivideAndRoundUp(num_merge_items, int(Policy::TILE_ITEMS));
+
+    const size_t counter_bytes =
+        ::rocprim::detail::align_size(sizeof(unsigned int));
+    const size_t coordinates_bytes =
+        ::rocprim::detail::align_size(sizeof(CoordinateT) * (plan.num_merge_tiles + 1));
+    const size_t carry_pairs_bytes =
+        ::rocprim::detail::align_size(sizeof(KeyValuePairT) * plan.num_merge_tiles);
+    const size_t required_bytes = counter_bytes + coordinates_bytes + carry_pairs_bytes;
+
+    if (d_temp_storage == nullptr)
+    {
+        temp_storage_bytes = required_bytes;
+        return hipSuccess;
+    }
+
+    if (temp_storage_bytes < required_bytes)
+    {
+        return hipErrorInvalidValue;
+    }
+
+    char* d_temp = static_cast<char*>(d_temp_storage);
+    plan.d_tile_counter     = reinterpret_cast<unsigned int*>(d_temp);
+    plan.d_tile_coordinates = reinterpret_cast<CoordinateT*>(d_temp + counter_bytes);
+    plan.d_tile_carry_pairs = reinterpret_cast<KeyValuePairT*>(d_temp + counter_bytes + coordinates_bytes);
+
+    if (plan.num_rows == 0)
+    {
+        return hipSuccess;
+    }
+
+    hipError_t error = hipSuccess;
+    if (HipcubDebug(error = hipMemsetAsync(plan.d_tile_counter, 0, sizeof(unsigned int), stream))) return error;
+
+    const unsigned int search_grid_size = DivideAndRoundUp(
+        static_cast<unsigned int>(plan.num_merge_tiles + 1), SpmvSearchKernel_BlockThreads);
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(SpmvSearchKernel<int>),
+        dim3(search_grid_size), dim3(SpmvSearchKernel_BlockThreads), 0, stream,
+        plan.num_merge_tiles, int(Policy::TILE_ITEMS), plan.d_tile_coordinates,
+        plan.d_row_offsets + 1, plan.num_rows, plan.num_nonzeros);
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    return error;
+}
+
+/**
+ * Computes the row-length statistics of \p plan.  Synchronizes \p stream.
+ */
+template <typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t ComputeRowStats(
+    void*               d_temp_storage,
+    size_t&             temp_storage_bytes,
+    Plan<ValueT>&       plan,
+    hipStream_t         stream,
+    bool                debug_synchronous)
+{
+    const size_t required_bytes =
+        ::rocprim::detail::align_size(sizeof(SpmvRowStatsAccumulator));
+
+    if (d_temp_storage == nullptr)
+    {
+        temp_storage_bytes = required_bytes;
+        return hipSuccess;
+    }
+
+    if (temp_storage_bytes < required_bytes)
+    {
+        return hipErrorInvalidValue;
+    }
+
+    RowStats& stats = plan.row_stats;
+    stats.min_row_length      = 0;
+    stats.max_row_length      = 0;
+    stats.empty_rows          = 0;
+    stats.row_length_mean     = 0.0;
+    stats.row_length_std_dev  = 0.0;
+    stats.row_length_skewness = 0.0;
+
+    if (plan.num_rows == 0)
+    {
+        return hipSuccess;
+    }
+
+    stats.row_length_mean = double(plan.num_nonzeros) / plan.num_rows;
+
+    SpmvRowStatsAccumulator accumulator;
+    accumulator.min_row_length         = std::numeric_limits<int>::max();
+    accumulator.max_row_length         = 0;
+    accumulator.empty_rows             = 0;
+    accumulator.sum_squared_deviations = 0.0;
+    accumulator.sum_cubed_deviations   = 0.0;
+
+    SpmvRowStatsAccumulator* d_accumulator = static_cast<SpmvRowStatsAccumulator*>(d_temp_storage);
+
+    hipError_t error = hipSuccess;
+    if (HipcubDebug(error = hipMemcpyAsync(d_accumulator, &accumulator, sizeof(accumulator), hipMemcpyHostToDevice, stream))) return error;
+
+    const unsigned int grid_size = ::rocprim::min(
+        DivideAndRoundUp(static_cast<unsigned int>(plan.num_rows), SpmvRowStatsKernel_BlockThreads),
+        1024u);
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(SpmvRowStatsKernel<int>),
+        dim3(grid_size), dim3(SpmvRowStatsKernel_BlockThreads), 0, stream,
+        plan.d_row_offsets, plan.num_rows, stats.row_length_mean, d_accumulator);
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    if (HipcubDebug(error = hipMemcpyAsync(&accumulator, d_accumulator, sizeof(accumulator), hipMemcpyDeviceToHost, stream))) return error;
+    if (HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    stats.min_row_length     = accumulator.min_row_length;
+    stats.max_row_length     = accumulator.max_row_length;
+    stats.empty_rows         = accumulator.empty_rows;
+    stats.row_length_std_dev = std::sqrt(accumulator.sum_squared_deviations / plan.num_rows);
+    if (stats.row_length_std_dev > 0.0)
+    {
+        stats.row_length_skewness = (accumulator.sum_cubed_deviations / plan.num_rows)
+            / (stats.row_length_std_dev * stats.row_length_std_dev * stats.row_length_std_dev);
+    }
+
+    return error;
+}
+
+/**
+ * Launches the merge-path kernel of \p plan
+ */
+template <bool HAS_BETA, typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t DispatchMergePath(
+    const Plan<ValueT>&         plan,
+    SpmvParams<ValueT, int>&    spmv_params,
+    hipStream_t                 stream,
+    bool                        debug_synchronous)
+{
+    using Policy = SpmvMergePathPolicy<ValueT>;
+
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(SpmvMergePathKernel<Policy, HAS_BETA, ValueT, int>),
+        dim3(plan.num_merge_tiles), dim3(Policy::BLOCK_THREADS), 0, stream,
+        spmv_params, plan.d_tile_coordinates, plan.d_tile_carry_pairs,
+        plan.d_tile_counter, plan.num_merge_tiles);
+
+    hipError_t error = hipSuccess;
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    return error;
+}
+
+/**
+ * Launches the thread-per-row kernel
+ */
+template <bool HAS_BETA, typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t DispatchScalar(
+    const Plan<ValueT>&         plan,
+    SpmvParams<ValueT, int>&    spmv_params,
+    hipStream_t                 stream,
+    bool                        debug_synchronous)
+{
+    const unsigned int grid_size = DivideAndRoundUp(
+        static_cast<unsigned int>(plan.num_rows), SpmvRowKernel_BlockThreads);
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(SpmvScalarKernel<HAS_BETA, ValueT, int>),
+        dim3(grid_size), dim3(SpmvRowKernel_BlockThreads), 0, stream,
+        spmv_params, plan.d_row_offsets);
+
+    hipError_t error = hipSuccess;
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    return error;
+}
+
+/**
+ * Launches the group-per-row kernel with \p VECTOR_THREADS lanes per row
+ */
+template <int VECTOR_THREADS, bool HAS_BETA, typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t DispatchVector(
+    const Plan<ValueT>&         plan,
+    SpmvParams<ValueT, int>&    spmv_params,
+    hipStream_t                 stream,
+    bool                        debug_synchronous)
+{
+    constexpr unsigned int rows_per_block = SpmvRowKernel_BlockThreads / VECTOR_THREADS;
+
+    const unsigned int grid_size = DivideAndRoundUp(
+        static_cast<unsigned int>(plan.num_rows), rows_per_block);
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(SpmvVectorKernel<VECTOR_THREADS, HAS_BETA, ValueT, int>),
+        dim3(grid_size), dim3(SpmvRowKernel_BlockThreads), 0, stream,
+        spmv_params, plan.d_row_offsets);
+
+    hipError_t error = hipSuccess;
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    return error;
+}
+
+/**
+ * Launches the kernel variant selected in \p plan
+ */
+template <bool HAS_BETA, typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t DispatchPlan(
+    const Plan<ValueT>&         plan,
+    SpmvParams<ValueT, int>&    spmv_params,
+    hipStream_t                 stream,
+    bool                        debug_synchronous)
+{
+    switch (plan.algorithm)
+    {
+    case SPMV_SCALAR:
+        return DispatchScalar<HAS_BETA>(plan, spmv_params, stream, debug_synchronous);
+    case SPMV_VECTOR:
+        switch (plan.vector_threads)
+        {
+        case 4:  return DispatchVector<4,  HAS_BETA>(plan, spmv_params, stream, debug_synchronous);
+        case 8:  return DispatchVector<8,  HAS_BETA>(plan, spmv_params, stream, debug_synchronous);
+        case 16: return DispatchVector<16, HAS_BETA>(plan, spmv_params, stream, debug_synchronous);
+        case 32: return DispatchVector<32, HAS_BETA>(plan, spmv_params, stream, debug_synchronous);
+        default: return hipErrorInvalidValue;
+        }
+    case SPMV_MERGE_PATH:
+        return DispatchMergePath<HAS_BETA>(plan, spmv_params, stream, debug_synchronous);
+    default:
+        return hipErrorInvalidValue;
+    }
+}
+
+static constexpr uint32_t SpmvFormatKernel_BlockThreads = 256;
+
+/**
+ * Derives CSR row offsets from the row indices of a row-sorted COO matrix
+ */
+template <typename OffsetT>
+static __global__ __launch_bounds__(SpmvFormatKernel_BlockThreads) void
+CooRowOffsetsKernel(
+    const OffsetT*  d_row_indices,
+    OffsetT         num_nonzeros,
+    OffsetT         num_rows,
+    OffsetT*        d_row_offsets)
+{
+    const OffsetT row = (hipBlockIdx_x * SpmvFormatKernel_BlockThreads) + hipThreadIdx_x;
+    if (row <= num_rows)
+    {
+        d_row_offsets[row] = LowerBound(d_row_indices, num_nonzeros, row);
+    }
+}
+
+/**
+ * Gathers the row lengths and row indices to be sorted, and the offsets of
+ * the sorting windows
+ */
+template <typename OffsetT>
+static __global__ __launch_bounds__(SpmvFormatKernel_BlockThreads) void
+SellPartitionInitKernel(
+    const OffsetT*  d_row_offsets,
+    OffsetT         num_rows,
+    OffsetT         sort_window,
+    OffsetT         num_windows,
+    OffsetT*        d_row_lengths,
+    OffsetT*        d_row_indices,
+    OffsetT*        d_window_offsets)
+{
+    const OffsetT idx = (hipBlockIdx_x * SpmvFormatKernel_BlockThreads) + hipThreadIdx_x;
+    if (idx < num_rows)
+    {
+        d_row_lengths[idx] = d_row_offsets[idx + 1] - d_row_offsets[idx];
+        d_row_indices[idx] = idx;
+    }
+    if (idx <= num_windows)
+    {
+        d_window_offsets[idx] = ::rocprim::min<OffsetT>(idx * sort_window, num_rows);
+    }
+}
+
+/**
+ * Computes the padded size of every slice from the sorted row lengths.  Slice
+ * \p num_slices gets size zero so that an exclusive sum yields the total.
+ */
+template <typename OffsetT>
+static __global__ __launch_bounds__(SpmvFormatKernel_BlockThreads) void
+SellSliceSizesKernel(
+    const OffsetT*  d_sorted_row_lengths,
+    OffsetT         num_rows,
+    OffsetT         slice_height,
+    OffsetT         num_slices,
+    OffsetT*        d_slice_sizes)
+{
+    const OffsetT slice = (hipBlockIdx_x * SpmvFormatKernel_BlockThreads) + hipThreadIdx_x;
+    if (slice > num_slices)
+    {
+        return;
+    }
 
-#endif // HIPCUB_CUB_DEVICE_DEVICE_SELECT_HPP_
+    const OffsetT slice_begin = slice * slice_height;
+    const OffsetT slice_end   = ::rocprim::min<OffsetT>(slice_begin + slice_height, num_rows);
+
+    OffsetT slice_width = 0;
+    for (OffsetT position = slice_begin; position < slice_end; ++position)
+    {
+        slice_width = ::rocprim::max(slice_width, d_sorted_row_lengths[position]);
+    }
+    d_slice_sizes[slice] = slice_width * slice_height;
+}
+
+/**
+ * Scatters the nonzeros of every row into its slice, one row per thread.
+ * Padding entries get value zero and column index -1.
+ */
+template <typename ValueT, typename OffsetT>
+static __global__ __launch_bounds__(SpmvFormatKernel_BlockThreads) void
+CsrToSellKernel(
+    const ValueT*   d_values,
+    const OffsetT*  d_row_offsets,
+    const OffsetT*  d_column_indices,
+    OffsetT         num_rows,
+    OffsetT         slice_height,
+    const OffsetT*  d_row_permutation,
+    const OffsetT*  d_slice_offsets,
+    ValueT*         d_sell_values,
+    OffsetT*        d_sell_column_indices)
+{
+    const OffsetT position     = (hipBlockIdx_x * SpmvFormatKernel_BlockThreads) + hipThreadIdx_x;
+    const OffsetT slice        = position / slice_height;
+    const OffsetT lane         = position % slice_height;
+    const OffsetT num_slices   = DivideAndRoundUp(num_rows, slice_height);
+    if (slice >= num_slices)
+    {
+        return;
+    }
+
+    const OffsetT slice_offset = d_slice_offsets[slice];
+    const OffsetT slice_width  = (d_slice_offsets[slice + 1] - slice_offset) / slice_height;
+
+    OffsetT row_start  = 0;
+    OffsetT row_length = 0;
+    if (position < num_rows)
+    {
+        const OffsetT row = d_row_permutation[position];
+        row_start  = d_row_offsets[row];
+        row_length = d_row_offsets[row + 1] - row_start;
+    }
+
+    for (OffsetT item = 0; item < slice_width; ++item)
+    {
+        const OffsetT sell_idx = slice_offset + (item * slice_height) + lane;
+        if (item < row_length)
+        {
+            d_sell_values[sell_idx]         = d_values[row_start + item];
+            d_sell_column_indices[sell_idx] = d_column_indices[row_start + item];
+        }
+        else
+        {
+            d_sell_values[sell_idx]         = ValueT(0);
+            d_sell_column_indices[sell_idx] = OffsetT(-1);
+        }
+    }
+}
+
+/**
+ * Computes one SELL row per thread.  Consecutive threads read consecutive
+ * entries of their slice, so every load of a slice column is coalesced.
+ */
+template <bool HAS_BETA, typename ValueT, typename OffsetT>
+static __global__ __launch_bounds__(SpmvFormatKernel_BlockThreads) void
+SellMVKernel(
+    const ValueT*   d_sell_values,
+    const OffsetT*  d_sell_column_indices,
+    const OffsetT*  d_slice_offsets,
+    const OffsetT*  d_row_permutation,
+    const ValueT*   d_vector_x,
+    ValueT*         d_vector_y,
+    OffsetT         num_rows,
+    OffsetT         slice_height,
+    ValueT          alpha,
+    ValueT          beta)
+{
+    const OffsetT position = (hipBlockIdx_x * SpmvFormatKernel_BlockThreads) + hipThreadIdx_x;
+    if (position >= num_rows)
+    {
+        return;
+    }
+
+    const OffsetT slice        = position / slice_height;
+    const OffsetT lane         = position % slice_height;
+    const OffsetT slice_offset = d_slice_offsets[slice];
+    const OffsetT slice_width  = (d_slice_offsets[slice + 1] - slice_offset) / slice_height;
+
+    ValueT partial = ValueT(0);
+    for (OffsetT item = 0; item < slice_width; ++item)
+    {
+        const OffsetT sell_idx = slice_offset + (item * slice_height) + lane;
+        const OffsetT column   = d_sell_column_indices[sell_idx];
+        if (column >= 0)
+        {
+            partial += d_sell_values[sell_idx] * d_vector_x[column];
+        }
+    }
+
+    const OffsetT row = d_row_permutation[position];
+    ValueT total = alpha * partial;
+    if (HAS_BETA)
+    {
+        total += beta * d_vector_y[row];
+    }
+    d_vector_y[row] = total;
+}
+
+/**
+ * Multiplies one row by \p NUM_VECTORS column-major dense vectors per group of
+ * \p VECTOR_THREADS lanes.  Each nonzero is loaded once and applied to all the
+ * vectors, whose partial sums stay in registers.
+ */
+template <
+    int      NUM_VECTORS,
+    int      VECTOR_THREADS,
+    bool     HAS_BETA,
+    typename ValueT,
+    typename OffsetT>
+static __global__ __launch_bounds__(SpmvRowKernel_BlockThreads) void
+SpmmVectorKernel(
+    const ValueT*   d_values,
+    const OffsetT*  d_row_offsets,
+    const OffsetT*  d_column_indices,
+    const ValueT*   d_matrix_x,
+    size_t          ldx,
+    ValueT*         d_matrix_y,
+    size_t          ldy,
+    OffsetT         num_rows,
+    ValueT          alpha,
+    ValueT          beta)
+{
+    constexpr int ROWS_PER_BLOCK = SpmvRowKernel_BlockThreads / VECTOR_THREADS;
+
+    using WarpReduceT = WarpReduce<ValueT, VECTOR_THREADS>;
+
+    __shared__ typename WarpReduceT::TempStorage temp_storage[ROWS_PER_BLOCK];
+
+    const int     group = hipThreadIdx_x / VECTOR_THREADS;
+    const int     lane  = hipThreadIdx_x % VECTOR_THREADS;
+    const OffsetT row   = (hipBlockIdx_x * ROWS_PER_BLOCK) + group;
+
+    ValueT partials[NUM_VECTORS];
+
+    #pragma unroll
+    for (int VECTOR = 0; VECTOR < NUM_VECTORS; ++VECTOR)
+    {
+        partials[VECTOR] = ValueT(0);
+    }
+
+    // Lanes of rows past the end stay to take part in the reductions
+    if (row < num_rows)
+    {
+        const OffsetT row_start = d_row_offsets[row];
+        const OffsetT row_end   = d_row_offsets[row + 1];
+        for (OffsetT nonzero_idx = row_start + lane; nonzero_idx < row_end; nonzero_idx += VECTOR_THREADS)
+        {
+            const ValueT  value = d_values[nonzero_idx];
+            const ValueT* x     = d_matrix_x + static_cast<size_t>(d_column_indices[nonzero_idx]);
+
+            #pragma unroll
+            for (int VECTOR = 0; VECTOR < NUM_VECTORS; ++VECTOR)
+            {
+                partials[VECTOR] += value * x[VECTOR * ldx];
+            }
+        }
+    }
+
+    #pragma unroll
+    for (int VECTOR = 0; VECTOR < NUM_VECTORS; ++VECTOR)
+    {
+        partials[VECTOR] = WarpReduceT(temp_storage[group]).Sum(partials[VECTOR]);
+    }
+
+    if ((lane == 0) && (row < num_rows))
+    {
+        ValueT* y = d_matrix_y + static_cast<size_t>(row);
+
+        #pragma unroll
+        for (int VECTOR = 0; VECTOR < NUM_VECTORS; ++VECTOR)
+        {
+            ValueT total = alpha * partials[VECTOR];
+            if (HAS_BETA)
+            {
+                total += beta * y[VECTOR * ldy];
+            }
+            y[VECTOR * ldy] = total;
+        }
+    }
+}
+
+/**
+ * Multiplies one row by \p NUM_VECTORS row-major dense vectors per group of
+ * \p VECTOR_THREADS lanes.  The lanes of a group walk the nonzeros of the row
+ * together, each lane owning the partial sums of every \p VECTOR_THREADS-th
+ * vector, so that the row of X selected by a nonzero is loaded from
+ * consecutive addresses.
+ */
+template <
+    int      NUM_VECTORS,
+    int      VECTOR_THREADS,
+    bool     HAS_BETA,
+    typename ValueT,
+    typename OffsetT>
+static __global__ __launch_bounds__(SpmvRowKernel_BlockThreads) void
+SpmmRowMajorKernel(
+    const ValueT*   d_values,
+    const OffsetT*  d_row_offsets,
+    const OffsetT*  d_column_indices,
+    const ValueT*   d_matrix_x,
+    size_t          ldx,
+    ValueT*         d_matrix_y,
+    size_t          ldy,
+    OffsetT         num_rows,
+    ValueT          alpha,
+    ValueT          beta)
+{
+    constexpr int ROWS_PER_BLOCK   = SpmvRowKernel_BlockThreads / VECTOR_THREADS;
+    constexpr int VECTORS_PER_LANE = (NUM_VECTORS + VECTOR_THREADS - 1) / VECTOR_THREADS;
+
+    const int     group = hipThreadIdx_x / VECTOR_THREADS;
+    const int     lane  = hipThreadIdx_x % VECTOR_THREADS;
+    const OffsetT row   = (hipBlockIdx_x * ROWS_PER_BLOCK) + group;
+
+    if (row >= num_rows)
+    {
+        return;
+    }
+
+    ValueT partials[VECTORS_PER_LANE];
+
+    #pragma unroll
+    for (int ITEM = 0; ITEM < VECTORS_PER_LANE; ++ITEM)
+    {
+        partials[ITEM] = ValueT(0);
+    }
+
+    const OffsetT row_end = d_row_offsets[row + 1];
+    for (OffsetT nonzero_idx = d_row_offsets[row]; nonzero_idx < row_end; ++nonzero_idx)
+    {
+        const ValueT  value = d_values[nonzero_idx];
+        const ValueT* x     = d_matrix_x + (static_cast<size_t>(d_column_indices[nonzero_idx]) * ldx);
+
+        #pragma unroll
+        for (int ITEM = 0; ITEM < VECTORS_PER_LANE; ++ITEM)
+        {
+            const int vector = lane + (ITEM * VECTOR_THREADS);
+            if (vector < NUM_VECTORS)
+            {
+                partials[ITEM] += value * x[vector];
+            }
+        }
+    }
+
+    ValueT* y = d_matrix_y + (static_cast<size_t>(row) * ldy);
+
+    #pragma unroll
+    for (int ITEM = 0; ITEM < VECTORS_PER_LANE; ++ITEM)
+    {
+        const int vector = lane + (ITEM * VECTOR_THREADS);
+        if (vector < NUM_VECTORS)
+        {
+            ValueT total = alpha * partials[ITEM];
+            if (HAS_BETA)
+            {
+                total += beta * y[vector];
+            }
+            y[vector] = total;
+        }
+    }
+}
+
+/**
+ * Launches the column-major SpMM kernel with \p VECTOR_THREADS lanes per row
+ */
+template <int NUM_VECTORS, int VECTOR_THREADS, bool HAS_BETA, typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t DispatchSpmmVector(
+    const ValueT*   d_values,
+    const int*      d_row_offsets,
+    const int*      d_column_indices,
+    const ValueT*   d_matrix_x,
+    size_t          ldx,
+    ValueT*         d_matrix_y,
+    size_t          ldy,
+    int             num_rows,
+    ValueT          alpha,
+    ValueT          beta,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    constexpr unsigned int rows_per_block = SpmvRowKernel_BlockThreads / VECTOR_THREADS;
+
+    const unsigned int grid_size = DivideAndRoundUp(
+        static_cast<unsigned int>(num_rows), rows_per_block);
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(SpmmVectorKernel<NUM_VECTORS, VECTOR_THREADS, HAS_BETA, ValueT, int>),
+        dim3(grid_size), dim3(SpmvRowKernel_BlockThreads), 0, stream,
+        d_values, d_row_offsets, d_column_indices,
+        d_matrix_x, ldx, d_matrix_y, ldy,
+        num_rows, alpha, beta);
+
+    hipError_t error = hipSuccess;
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    return error;
+}
+
+/**
+ * Launches the row-major SpMM kernel with as many lanes per row as there are
+ * vectors, rounded up to a power of two and at most 32
+ */
+template <int NUM_VECTORS, bool HAS_BETA, typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t DispatchSpmmRowMajor(
+    const ValueT*   d_values,
+    const int*      d_row_offsets,
+    const int*      d_column_indices,
+    const ValueT*   d_matrix_x,
+    size_t          ldx,
+    ValueT*         d_matrix_y,
+    size_t          ldy,
+    int             num_rows,
+    ValueT          alpha,
+    ValueT          beta,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    constexpr int vector_threads =
+        (NUM_VECTORS <= 1) ? 1 :
+        (NUM_VECTORS <= 2) ? 2 :
+        (NUM_VECTORS <= 4) ? 4 :
+        (NUM_VECTORS <= 8) ? 8 :
+        (NUM_VECTORS <= 16) ? 16 : 32;
+    constexpr unsigned int rows_per_block = SpmvRowKernel_BlockThreads / vector_threads;
+
+    const unsigned int grid_size = DivideAndRoundUp(
+        static_cast<unsigned int>(num_rows), rows_per_block);
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(SpmmRowMajorKernel<NUM_VECTORS, vector_threads, HAS_BETA, ValueT, int>),
+        dim3(grid_size), dim3(SpmvRowKernel_BlockThreads), 0, stream,
+        d_values, d_row_offsets, d_column_indices,
+        d_matrix_x, ldx, d_matrix_y, ldy,
+        num_rows, alpha, beta);
+
+    hipError_t error = hipSuccess;
+    if (HipcubDebug(error = hipPeekAtLastError())) return error;
+    if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+    return error;
+}
+
+/**
+ * Launches the SpMM kernel of \p layout.  For column-major operands the lanes
+ * per row are picked from the mean row length.
+ */
+template <int NUM_VECTORS, bool HAS_BETA, typename ValueT>
+HIPCUB_RUNTIME_FUNCTION
+static hipError_t DispatchSpmm(
+    const ValueT*   d_values,
+    const int*      d_row_offsets,
+    const int*      d_column_indices,
+    const ValueT*   d_matrix_x,
+    size_t          ldx,
+    ValueT*         d_matrix_y,
+    size_t          ldy,
+    DenseLayout     layout,
+    int             num_rows,
+    int             num_nonzeros,
+    ValueT          alpha,
+    ValueT          beta,
+    hipStream_t     stream,
+    bool            debug_synchronous)
+{
+    if (layout == DENSE_ROW_MAJOR)
+    {
+        return DispatchSpmmRowMajor<NUM_VECTORS, HAS_BETA>(
+            d_values, d_row_offsets, d_column_indices,
+            d_matrix_x, ldx, d_matrix_y, ldy,
+            num_rows, alpha, beta, stream, debug_synchronous);
+    }
+
+    const int mean_row_length = DivideAndRoundUp(num_nonzeros, num_rows);
+    if (mean_row_length <= 4)
+    {
+        return DispatchSpmmVector<NUM_VECTORS, 4, HAS_BETA>(
+            d_values, d_row_offsets, d_column_indices,
+            d_matrix_x, ldx, d_matrix_y, ldy,
+            num_rows, alpha, beta, stream, debug_synchronous);
+    }
+    if (mean_row_length <= 8)
+    {
+        return DispatchSpmmVector<NUM_VECTORS, 8, HAS_BETA>(
+            d_values, d_row_offsets, d_column_indices,
+            d_matrix_x, ldx, d_matrix_y, ldy,
+            num_rows, alpha, beta, stream, debug_synchronous);
+    }
+    if (mean_row_length <= 16)
+    {
+        return DispatchSpmmVector<NUM_VECTORS, 16, HAS_BETA>(
+            d_values, d_row_offsets, d_column_indices,
+            d_matrix_x, ldx, d_matrix_y, ldy,
+            num_rows, alpha, beta, stream, debug_synchronous);
+    }
+    return DispatchSpmmVector<NUM_VECTORS, 32, HAS_BETA>(
+        d_values, d_row_offsets, d_column_indices,
+        d_matrix_x, ldx, d_matrix_y, ldy,
+        num_rows, alpha, beta, stream, debug_synchronous);
+}
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * \brief Analyzes the sparsity structure of a CSR matrix once so that it can be
+ * multiplied repeatedly with CsrMV(const Plan<ValueT>&, ...).
+ *
+ * Computes the row-length statistics, the merge-path partition and the kernel
+ * variant (see Plan), and stores them in \p plan and \p d_temp_storage.  Copies the
+ * statistics to the host, so \p stream is synchronized.
+ */
+template <typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t CsrMVPlan(
+        void*               d_temp_storage,                     ///< [in] %Device-accessible allocation of temporary storage.  When NULL, the required allocation size is written to \p temp_storage_bytes and no work is done.  Must outlive \p plan.
+        size_t&             temp_storage_bytes,                 ///< [in,out] Reference to size in bytes of \p d_temp_storage allocation
+        Plan<ValueT>&       plan,                               ///< [out] Plan to initialize
+        int*                d_row_offsets,                      ///< [in] Pointer to the array of \p m + 1 offsets demarcating the start of every row in \p d_column_indices and \p d_values (with the final entry being equal to \p num_nonzeros)
+        int                 num_rows,                           ///< [in] number of rows of matrix <b>A</b>.
+        int                 num_cols,                           ///< [in] number of columns of matrix <b>A</b>.
+        int                 num_nonzeros,                       ///< [in] number of nonzero elements of matrix <b>A</b>.
+        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
+        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    {
+        plan.d_row_offsets  = d_row_offsets;
+        plan.num_rows       = num_rows;
+        plan.num_cols       = num_cols;
+        plan.num_nonzeros   = num_nonzeros;
+        plan.algorithm      = SPMV_MERGE_PATH;
+        plan.vector_threads = SpmvVectorKernel_MaxThreads;
+
+        size_t partition_bytes = 0;
+        size_t stats_bytes     = 0;
+        hipError_t error = PartitionMergePath(nullptr, partition_bytes, plan, stream, debug_synchronous);
+        if (error != hipSuccess) return error;
+        error = ComputeRowStats(nullptr, stats_bytes, plan, stream, debug_synchronous);
+        if (error != hipSuccess) return error;
+
+        if (d_temp_storage == nullptr)
+        {
+            temp_storage_bytes = partition_bytes + stats_bytes;
+            return hipSuccess;
+        }
+
+        if (temp_storage_bytes < partition_bytes + stats_bytes)
+        {
+            return hipErrorInvalidValue;
+        }
+
+        error = PartitionMergePath(d_temp_storage, partition_bytes, plan, stream, debug_synchronous);
+        if (error != hipSuccess) return error;
+
+        error = ComputeRowStats(
+            static_cast<char*>(d_temp_storage) + partition_bytes, stats_bytes,
+            plan, stream, debug_synchronous);
+        if (error != hipSuccess) return error;
+
+        SelectAlgorithm(plan);
+        return hipSuccess;
+    }
+
+/**
+ * \brief Computes y = alpha * A * x + beta * y using a plan created by CsrMVPlan().
+ *
+ * Performs a single kernel launch.  When \p beta is zero, \p d_vector_y is not read.
+ */
+template <typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t CsrMV(
+        const Plan<ValueT>& plan,                               ///< [in] Plan created by CsrMVPlan() for the sparsity structure of matrix <b>A</b>.
+        ValueT*             d_values,                           ///< [in] Pointer to the array of \p num_nonzeros values of the corresponding nonzero elements of matrix <b>A</b>.
+        int*                d_column_indices,                   ///< [in] Pointer to the array of \p num_nonzeros column-indices of the corresponding nonzero elements of matrix <b>A</b>.  (Indices are zero-valued.)
+        ValueT*             d_vector_x,                         ///< [in] Pointer to the array of \p num_cols values corresponding to the dense input vector <em>x</em>
+        ValueT*             d_vector_y,                         ///< [in,out] Pointer to the array of \p num_rows values corresponding to the dense output vector <em>y</em>
+        ValueT              alpha                   = ValueT(1),///< [in] <b>[optional]</b> Alpha multiplicand.  Default is 1.
+        ValueT              beta                    = ValueT(0),///< [in] <b>[optional]</b> Beta addend-multiplicand.  Default is 0.
+        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
+        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    {
+        if (plan.num_rows == 0)
+        {
+            return hipSuccess;
+        }
+
+        SpmvParams<ValueT, int> spmv_params;
+        spmv_params.d_values             = d_values;
+        spmv_params.d_row_end_offsets    = plan.d_row_offsets + 1;
+        spmv_params.d_column_indices     = d_column_indices;
+        spmv_params.d_vector_x           = d_vector_x;
+        spmv_params.d_vector_y           = d_vector_y;
+        spmv_params.num_rows             = plan.num_rows;
+        spmv_params.num_cols             = plan.num_cols;
+        spmv_params.num_nonzeros         = plan.num_nonzeros;
+        spmv_params.alpha                = alpha;
+        spmv_params.beta                 = beta;
+
+        if (beta != ValueT(0))
+        {
+            return DispatchPlan<true>(plan, spmv_params, stream, debug_synchronous);
+        }
+        return DispatchPlan<false>(plan, spmv_params, stream, debug_synchronous);
+    }
+
+/**
+ * \brief Computes y = alpha * A * x + beta * y for a CSR matrix A.
+ *
+ * The merge path of row end-offsets and nonzero indices is split evenly across
+ * thread blocks, so the cost tracks <tt>num_rows + num_nonzeros</tt> regardless
+ * of how the nonzeros are distributed among rows.  When \p beta is zero,
+ * \p d_vector_y is not read.
+ *
+ * Kernel selection needs the row-length statistics on the host, so only
+ * CsrMVPlan() chooses among the kernel variants; this overload always uses
+ * SPMV_MERGE_PATH.
+ */
+template <typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t CsrMV(
+        void*               d_temp_storage,                     ///< [in] %Device-accessible allocation of temporary storage.  When NULL, the required allocation size is written to \p temp_storage_bytes and no work is done.
+        size_t&             temp_storage_bytes,                 ///< [in,out] Reference to size in bytes of \p d_temp_storage allocation
+        ValueT*             d_values,                           ///< [in] Pointer to the array of \p num_nonzeros values of the corresponding nonzero elements of matrix <b>A</b>.
+        int*                d_row_offsets,                      ///< [in] Pointer to the array of \p m + 1 offsets demarcating the start of every row in \p d_column_indices and \p d_values (with the final entry being equal to \p num_nonzeros)
+        int*                d_column_indices,                   ///< [in] Pointer to the array of \p num_nonzeros column-indices of the corresponding nonzero elements of matrix <b>A</b>.  (Indices are zero-valued.)
+        ValueT*             d_vector_x,                         ///< [in] Pointer to the array of \p num_cols values corresponding to the dense input vector <em>x</em>
+        ValueT*             d_vector_y,                         ///< [in,out] Pointer to the array of \p num_rows values corresponding to the dense output vector <em>y</em>
+        int                 num_rows,                           ///< [in] number of rows of matrix <b>A</b>.
+        int                 num_cols,                           ///< [in] number of columns of matrix <b>A</b>.
+        int                 num_nonzeros,                       ///< [in] number of nonzero elements of matrix <b>A</b>.
+        ValueT              alpha,                              ///< [in] Alpha multiplicand
+        ValueT              beta,                               ///< [in] Beta addend-multiplicand
+        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
+        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    {
+        Plan<ValueT> plan;
+        plan.d_row_offsets  = d_row_offsets;
+        plan.num_rows       = num_rows;
+        plan.num_cols       = num_cols;
+        plan.num_nonzeros   = num_nonzeros;
+        plan.algorithm      = SPMV_MERGE_PATH;
+        plan.vector_threads = SpmvVectorKernel_MaxThreads;
+
+        hipError_t error = PartitionMergePath(
+            d_temp_storage, temp_storage_bytes, plan, stream, debug_synchronous);
+        if ((error != hipSuccess) || (d_temp_storage == nullptr))
+        {
+            return error;
+        }
+
+        return CsrMV(
+            plan, d_values, d_column_indices, d_vector_x, d_vector_y,
+            alpha, beta, stream, debug_synchronous);
+    }
+
+/**
+ * \brief Computes y = A * x for a CSR matrix A.
+ */
+template <typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t CsrMV(
+        void*               d_temp_storage,                     ///< [in] %Device-accessible allocation of temporary storage.  When NULL, the required allocation size is written to \p temp_storage_bytes and no work is done.
+        size_t&             temp_storage_bytes,                 ///< [in,out] Reference to size in bytes of \p d_temp_storage allocation
+        ValueT*             d_values,                           ///< [in] Pointer to the array of \p num_nonzeros values of the corresponding nonzero elements of matrix <b>A</b>.
+        int*                d_row_offsets,                      ///< [in] Pointer to the array of \p m + 1 offsets demarcating the start of every row in \p d_column_indices and \p d_values (with the final entry being equal to \p num_nonzeros)
+        int*                d_column_indices,                   ///< [in] Pointer to the array of \p num_nonzeros column-indices of the corresponding nonzero elements of matrix <b>A</b>.  (Indices are zero-valued.)
+        ValueT*             d_vector_x,                         ///< [in] Pointer to the array of \p num_cols values corresponding to the dense input vector <em>x</em>
+        ValueT*             d_vector_y,                         ///< [out] Pointer to the array of \p num_rows values corresponding to the dense output vector <em>y</em>
+        int                 num_rows,                           ///< [in] number of rows of matrix <b>A</b>.
+        int                 num_cols,                           ///< [in] number of columns of matrix <b>A</b>.
+        int                 num_nonzeros,                       ///< [in] number of nonzero elements of matrix <b>A</b>.
+        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
+        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    {
+        return CsrMV(
+            d_temp_storage, temp_storage_bytes,
+            d_values, d_row_offsets, d_column_indices, d_vector_x, d_vector_y,
+            num_rows, num_cols, num_nonzeros,
+            ValueT(1), ValueT(0),
+            stream, debug_synchronous);
+    }
+
+/**
+ * \brief Analyzes the sparsity structure of a row-sorted COO matrix once so that
+ * it can be multiplied repeatedly with CsrMV(const Plan<ValueT>&, ...), passing
+ * the COO values and column indices.
+ *
+ * The nonzeros must be sorted by row (their order within a row does not
+ * matter); the result is undefined otherwise.  Unsorted matrices can be sorted
+ * by row once with DeviceRadixSort::SortPairs.  CSR row offsets are derived on
+ * the device by binary search of \p d_row_indices into \p d_temp_storage, and
+ * the merge-path partition of the plan is computed from them.  The plan uses
+ * SPMV_MERGE_PATH and does not synchronize \p stream.
+ */
+template <typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t CooMVPlan(
+        void*               d_temp_storage,                     ///< [in] %Device-accessible allocation of temporary storage.  When NULL, the required allocation size is written to \p temp_storage_bytes and no work is done.  Must outlive \p plan.
+        size_t&             temp_storage_bytes,                 ///< [in,out] Reference to size in bytes of \p d_temp_storage allocation
+        Plan<ValueT>&       plan,                               ///< [out] Plan to initialize
+        int*                d_row_indices,                      ///< [in] Pointer to the array of \p num_nonzeros row-indices of the corresponding nonzero elements of matrix <b>A</b>, sorted in nondecreasing order.
+        int                 num_rows,                           ///< [in] number of rows of matrix <b>A</b>.
+        int                 num_cols,                           ///< [in] number of columns of matrix <b>A</b>.
+        int                 num_nonzeros,                       ///< [in] number of nonzero elements of matrix <b>A</b>.
+        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
+        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    {
+        const size_t row_offsets_bytes =
+            ::rocprim::detail::align_size(sizeof(int) * (num_rows + 1));
+
+        plan                = Plan<ValueT>();
+        plan.d_row_offsets  = nullptr;
+        plan.num_rows       = num_rows;
+        plan.num_cols       = num_cols;
+        plan.num_nonzeros   = num_nonzeros;
+        plan.algorithm      = SPMV_MERGE_PATH;
+        plan.vector_threads = SpmvVectorKernel_MaxThreads;
+
+        size_t partition_bytes = 0;
+        hipError_t error = PartitionMergePath(nullptr, partition_bytes, plan, stream, debug_synchronous);
+        if (error != hipSuccess) return error;
+
+        if (d_temp_storage == nullptr)
+        {
+            temp_storage_bytes = row_offsets_bytes + partition_bytes;
+            return hipSuccess;
+        }
+
+        if (temp_storage_bytes < row_offsets_bytes + partition_bytes)
+        {
+            return hipErrorInvalidValue;
+        }
+
+        plan.d_row_offsets = static_cast<int*>(d_temp_storage);
+
+        if (num_rows == 0)
+        {
+            return hipSuccess;
+        }
+
+        const unsigned int grid_size = DivideAndRoundUp(
+            static_cast<unsigned int>(num_rows + 1), SpmvFormatKernel_BlockThreads);
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(CooRowOffsetsKernel<int>),
+            dim3(grid_size), dim3(SpmvFormatKernel_BlockThreads), 0, stream,
+            d_row_indices, num_nonzeros, num_rows, plan.d_row_offsets);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        return PartitionMergePath(
+            static_cast<char*>(d_temp_storage) + row_offsets_bytes, partition_bytes,
+            plan, stream, debug_synchronous);
+    }
+
+/**
+ * \brief Computes y = alpha * A * x + beta * y for a COO matrix A.
+ *
+ * The nonzeros must be sorted by row (their order within a row does not
+ * matter); the result is undefined otherwise.  Every call derives the CSR row
+ * offsets and the merge-path partition again, which costs a binary search per
+ * row and an extra pass over the offsets on top of the product; to multiply
+ * the same sparsity structure repeatedly, create a plan once with CooMVPlan()
+ * instead.  When \p beta is zero, \p d_vector_y is not read.
+ */
+template <typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t CooMV(
+        void*               d_temp_storage,                     ///< [in] %Device-accessible allocation of temporary storage.  When NULL, the required allocation size is written to \p temp_storage_bytes and no work is done.
+        size_t&             temp_storage_bytes,                 ///< [in,out] Reference to size in bytes of \p d_temp_storage allocation
+        ValueT*             d_values,                           ///< [in] Pointer to the array of \p num_nonzeros values of the corresponding nonzero elements of matrix <b>A</b>.
+        int*                d_row_indices,                      ///< [in] Pointer to the array of \p num_nonzeros row-indices of the corresponding nonzero elements of matrix <b>A</b>, sorted in nondecreasing order.
+        int*                d_column_indices,                   ///< [in] Pointer to the array of \p num_nonzeros column-indices of the corresponding nonzero elements of matrix <b>A</b>.  (Indices are zero-valued.)
+        ValueT*             d_vector_x,                         ///< [in] Pointer to the array of \p num_cols values corresponding to the dense input vector <em>x</em>
+        ValueT*             d_vector_y,                         ///< [in,out] Pointer to the array of \p num_rows values corresponding to the dense output vector <em>y</em>
+        int                 num_rows,                           ///< [in] number of rows of matrix <b>A</b>.
+        int                 num_cols,                           ///< [in] number of columns of matrix <b>A</b>.
+        int                 num_nonzeros,                       ///< [in] number of nonzero elements of matrix <b>A</b>.
+        ValueT              alpha                   = ValueT(1),///< [in] <b>[optional]</b> Alpha multiplicand.  Default is 1.
+        ValueT              beta                    = ValueT(0),///< [in] <b>[optional]</b> Beta addend-multiplicand.  Default is 0.
+        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
+        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    {
+        Plan<ValueT> plan;
+        hipError_t error = CooMVPlan(
+            d_temp_storage, temp_storage_bytes, plan, d_row_indices,
+            num_rows, num_cols, num_nonzeros, stream, debug_synchronous);
+        if ((error != hipSuccess) || (d_temp_storage == nullptr) || (num_rows == 0)) return error;
+
+        return CsrMV(
+            plan, d_values, d_column_indices, d_vector_x, d_vector_y,
+            alpha, beta, stream, debug_synchronous);
+    }
+
+/**
+ * \brief Computes the row permutation and slice offsets of the SELL-C-&sigma;
+ * layout of a CSR matrix.
+ *
+ * Rows are sorted by decreasing length within windows of \p sort_window
+ * consecutive rows (with DeviceSegmentedRadixSort), then grouped into slices of
+ * \p slice_height rows.  Each slice is padded to the length of its longest
+ * row and stored column-major, so \p slice_height consecutive threads read
+ * consecutive entries.  A \p slice_height of 64 matches a wavefront; a
+ * \p sort_window that is a multiple of \p slice_height (typically a few
+ * slices) keeps the permutation local while removing most of the padding.
+ *
+ * The number of stored entries, <tt>d_slice_offsets[num_slices]</tt>, sizes the
+ * arrays passed to CsrToSell().
+ */
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t CsrToSellPartition(
+        void*               d_temp_storage,                     ///< [in] %Device-accessible allocation of temporary storage.  When NULL, the required allocation size is written to \p temp_storage_bytes and no work is done.
+        size_t&             temp_storage_bytes,                 ///< [in,out] Reference to size in bytes of \p d_temp_storage allocation
+        int*                d_row_offsets,                      ///< [in] Pointer to the array of \p m + 1 offsets demarcating the start of every row in the CSR matrix
+        int                 num_rows,                           ///< [in] number of rows of matrix <b>A</b>.
+        int                 num_nonzeros,                       ///< [in] number of nonzero elements of matrix <b>A</b>.
+        int                 slice_height,                       ///< [in] Rows per slice (<em>C</em>)
+        int                 sort_window,                        ///< [in] Rows per sorting window (&sigma;); 1 disables sorting
+        int*                d_row_permutation,                  ///< [out] Pointer to the array of \p num_rows original row indices, in SELL order
+        int*                d_slice_offsets,                    ///< [out] Pointer to the array of <tt>num_slices + 1</tt> offsets of every slice in the SELL arrays, where <tt>num_slices = ceil(num_rows / slice_height)</tt>
+        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
+        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    {
+        if ((slice_height <= 0) || (sort_window <= 0))
+        {
+            return hipErrorInvalidValue;
+        }
+
+        const int num_slices  = DivideAndRoundUp(num_rows, slice_height);
+        const int num_windows = DivideAndRoundUp(num_rows, sort_window);
+
+        // Row lengths fit in the bits needed for num_nonzeros
+        int end_bit = 1;
+        while ((end_bit < int(sizeof(int) * 8 - 1)) && ((1 << end_bit) <= num_nonzeros))
+        {
+            ++end_bit;
+        }
+
+        size_t sort_bytes = 0;
+        size_t scan_bytes = 0;
+        hipError_t error = hipSuccess;
+        if (sort_window > 1)
+        {
+            error = DeviceSegmentedRadixSort::SortPairsDescending(
+                nullptr, sort_bytes,
+                static_cast<const int*>(nullptr), static_cast<int*>(nullptr),
+                static_cast<const int*>(nullptr), static_cast<int*>(nullptr),
+                num_rows, num_windows,
+                static_cast<int*>(nullptr), static_cast<int*>(nullptr),
+                0, end_bit, stream, debug_synchronous);
+            if (error != hipSuccess) return error;
+        }
+        error = DeviceScan::ExclusiveSum(
+            nullptr, scan_bytes,
+            static_cast<int*>(nullptr), static_cast<int*>(nullptr),
+            num_slices + 1, stream, debug_synchronous);
+        if (error != hipSuccess) return error;
+
+        const size_t rows_bytes     = ::rocprim::detail::align_size(sizeof(int) * num_rows);
+        const size_t windows_bytes  = ::rocprim::detail::align_size(sizeof(int) * (num_windows + 1));
+        const size_t slices_bytes   = ::rocprim::detail::align_size(sizeof(int) * (num_slices + 1));
+        const size_t nested_bytes   = ::rocprim::max(sort_bytes, scan_bytes);
+        const size_t required_bytes = (3 * rows_bytes) + windows_bytes + slices_bytes + nested_bytes;
+
+        if (d_temp_storage == nullptr)
+        {
+            temp_storage_bytes = required_bytes;
+            return hipSuccess;
+        }
+
+        if (temp_storage_bytes < required_bytes)
+        {
+            return hipErrorInvalidValue;
+        }
+
+        char* d_temp = static_cast<char*>(d_temp_storage);
+        int*  d_row_lengths        = reinterpret_cast<int*>(d_temp);
+        int*  d_sorted_row_lengths = reinterpret_cast<int*>(d_temp + rows_bytes);
+        int*  d_row_indices        = reinterpret_cast<int*>(d_temp + 2 * rows_bytes);
+        int*  d_window_offsets     = reinterpret_cast<int*>(d_temp + 3 * rows_bytes);
+        int*  d_slice_sizes        = reinterpret_cast<int*>(d_temp + 3 * rows_bytes + windows_bytes);
+        void* d_nested_storage     = d_temp + 3 * rows_bytes + windows_bytes + slices_bytes;
+
+        // Without sorting the gathered lengths and indices are final
+        if (sort_window == 1)
+        {
+            d_sorted_row_lengths = d_row_lengths;
+            d_row_indices        = d_row_permutation;
+        }
+
+        if (num_rows > 0)
+        {
+            const unsigned int init_grid_size = DivideAndRoundUp(
+                static_cast<unsigned int>(num_rows + 1), SpmvFormatKernel_BlockThreads);
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(SellPartitionInitKernel<int>),
+                dim3(init_grid_size), dim3(SpmvFormatKernel_BlockThreads), 0, stream,
+                d_row_offsets, num_rows, sort_window, num_windows,
+                d_row_lengths, d_row_indices, d_window_offsets);
+            if (HipcubDebug(error = hipPeekAtLastError())) return error;
+            if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+        }
+
+        if ((sort_window > 1) && (num_rows > 0))
+        {
+            error = DeviceSegmentedRadixSort::SortPairsDescending(
+                d_nested_storage, sort_bytes,
+                static_cast<const int*>(d_row_lengths), d_sorted_row_lengths,
+                static_cast<const int*>(d_row_indices), d_row_permutation,
+                num_rows, num_windows,
+                d_window_offsets, d_window_offsets + 1,
+                0, end_bit, stream, debug_synchronous);
+            if (error != hipSuccess) return error;
+        }
+
+        const unsigned int slices_grid_size = DivideAndRoundUp(
+            static_cast<unsigned int>(num_slices + 1), SpmvFormatKernel_BlockThreads);
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(SellSliceSizesKernel<int>),
+            dim3(slices_grid_size), dim3(SpmvFormatKernel_BlockThreads), 0, stream,
+            static_cast<const int*>(d_sorted_row_lengths), num_rows, slice_height, num_slices,
+            d_slice_sizes);
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        return DeviceScan::ExclusiveSum(
+            d_nested_storage, scan_bytes,
+            d_slice_sizes, d_slice_offsets,
+            num_slices + 1, stream, debug_synchronous);
+    }
+
+/**
+ * \brief Fills the SELL-C-&sigma; arrays of a CSR matrix partitioned by
+ * CsrToSellPartition().
+ */
+template <typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t CsrToSell(
+        ValueT*             d_values,                           ///< [in] Pointer to the array of \p num_nonzeros values of the CSR matrix
+        int*                d_row_offsets,                      ///< [in] Pointer to the array of \p m + 1 offsets demarcating the start of every row in the CSR matrix
+        int*                d_column_indices,                   ///< [in] Pointer to the array of \p num_nonzeros column-indices of the CSR matrix
+        int                 num_rows,                           ///< [in] number of rows of matrix <b>A</b>.
+        int                 slice_height,                       ///< [in] Rows per slice, as passed to CsrToSellPartition()
+        int*                d_row_permutation,                  ///< [in] Row permutation computed by CsrToSellPartition()
+        int*                d_slice_offsets,                    ///< [in] Slice offsets computed by CsrToSellPartition()
+        ValueT*             d_sell_values,                      ///< [out] Pointer to the array of <tt>d_slice_offsets[num_slices]</tt> SELL values
+        int*                d_sell_column_indices,              ///< [out] Pointer to the array of <tt>d_slice_offsets[num_slices]</tt> SELL column-indices (-1 for padding)
+        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
+        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    {
+        if (slice_height <= 0)
+        {
+            return hipErrorInvalidValue;
+        }
+
+        if (num_rows == 0)
+        {
+            return hipSuccess;
+        }
+
+        const unsigned int num_positions = DivideAndRoundUp(num_rows, slice_height) * slice_height;
+        const unsigned int grid_size = DivideAndRoundUp(num_positions, SpmvFormatKernel_BlockThreads);
+        hipLaunchKernelGGL(
+            HIP_KERNEL_NAME(CsrToSellKernel<ValueT, int>),
+            dim3(grid_size), dim3(SpmvFormatKernel_BlockThreads), 0, stream,
+            d_values, d_row_offsets, d_column_indices, num_rows, slice_height,
+            d_row_permutation, d_slice_offsets, d_sell_values, d_sell_column_indices);
+
+        hipError_t error = hipSuccess;
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        return error;
+    }
+
+/**
+ * \brief Computes y = alpha * A * x + beta * y for a SELL-C-&sigma; matrix A
+ * built by CsrToSellPartition() and CsrToSell().
+ *
+ * One thread computes one row; the rows of a slice are read with coalesced
+ * loads.  Best suited to matrices whose rows have similar lengths.  When
+ * \p beta is zero, \p d_vector_y is not read.
+ */
+template <typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t SellMV(
+        ValueT*             d_sell_values,                      ///< [in] Pointer to the SELL values
+        int*                d_sell_column_indices,              ///< [in] Pointer to the SELL column-indices (-1 for padding)
+        int*                d_slice_offsets,                    ///< [in] Pointer to the array of <tt>num_slices + 1</tt> slice offsets
+        int*                d_row_permutation,                  ///< [in] Pointer to the array of \p num_rows original row indices, in SELL order
+        ValueT*             d_vector_x,                         ///< [in] Pointer to the array of \p num_cols values corresponding to the dense input vector <em>x</em>
+        ValueT*             d_vector_y,                         ///< [in,out] Pointer to the array of \p num_rows values corresponding to the dense output vector <em>y</em>
+        int                 num_rows,                           ///< [in] number of rows of matrix <b>A</b>.
+        int                 slice_height,                       ///< [in] Rows per slice, as passed to CsrToSellPartition()
+        ValueT              alpha                   = ValueT(1),///< [in] <b>[optional]</b> Alpha multiplicand.  Default is 1.
+        ValueT              beta                    = ValueT(0),///< [in] <b>[optional]</b> Beta addend-multiplicand.  Default is 0.
+        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
+        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    {
+        if (slice_height <= 0)
+        {
+            return hipErrorInvalidValue;
+        }
+
+        if (num_rows == 0)
+        {
+            return hipSuccess;
+        }
+
+        const unsigned int grid_size = DivideAndRoundUp(
+            static_cast<unsigned int>(num_rows), SpmvFormatKernel_BlockThreads);
+        if (beta != ValueT(0))
+        {
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(SellMVKernel<true, ValueT, int>),
+                dim3(grid_size), dim3(SpmvFormatKernel_BlockThreads), 0, stream,
+                d_sell_values, d_sell_column_indices, d_slice_offsets, d_row_permutation,
+                d_vector_x, d_vector_y, num_rows, slice_height, alpha, beta);
+        }
+        else
+        {
+            hipLaunchKernelGGL(
+                HIP_KERNEL_NAME(SellMVKernel<false, ValueT, int>),
+                dim3(grid_size), dim3(SpmvFormatKernel_BlockThreads), 0, stream,
+                d_sell_values, d_sell_column_indices, d_slice_offsets, d_row_permutation,
+                d_vector_x, d_vector_y, num_rows, slice_height, alpha, beta);
+        }
+
+        hipError_t error = hipSuccess;
+        if (HipcubDebug(error = hipPeekAtLastError())) return error;
+        if (debug_synchronous && HipcubDebug(error = hipStreamSynchronize(stream))) return error;
+
+        return error;
+    }
+
+/**
+ * \brief Computes Y = alpha * A * X + beta * Y for a CSR matrix A and dense
+ * matrices X and Y of \p NUM_VECTORS columns each.
+ *
+ * The matrix is read once for all \p NUM_VECTORS products: every nonzero is
+ * applied to a row of X, and the \p NUM_VECTORS partial sums of a row are
+ * kept in registers.  For column-major operands a group of 4 to 32 lanes,
+ * sized from the mean row length, splits the nonzeros of each row.  For
+ * row-major operands the lanes of a group split the vectors instead, so that
+ * the row of X of every nonzero is read with consecutive loads.  When \p beta
+ * is zero, \p d_matrix_y is not read.
+ *
+ * \tparam NUM_VECTORS  Number of dense vectors (columns of X and Y), at most 64
+ */
+template <int NUM_VECTORS, typename ValueT>
+    HIPCUB_RUNTIME_FUNCTION
+    static hipError_t CsrMM(
+        ValueT*             d_values,                           ///< [in] Pointer to the array of \p num_nonzeros values of the corresponding nonzero elements of matrix <b>A</b>.
+        int*                d_row_offsets,                      ///< [in] Pointer to the array of \p m + 1 offsets demarcating the start of every row in \p d_column_indices and \p d_values (with the final entry being equal to \p num_nonzeros)
+        int*                d_column_indices,                   ///< [in] Pointer to the array of \p num_nonzeros column-indices of the corresponding nonzero elements of matrix <b>A</b>.  (Indices are zero-valued.)
+        ValueT*             d_matrix_x,                         ///< [in] Pointer to the \p num_cols by \p NUM_VECTORS dense input matrix <em>X</em>
+        int                 ldx,                                ///< [in] Leading dimension of <em>X</em>: at least \p NUM_VECTORS if row-major, \p num_cols if column-major
+        ValueT*             d_matrix_y,                         ///< [in,out] Pointer to the \p num_rows by \p NUM_VECTORS dense output matrix <em>Y</em>
+        int                 ldy,                                ///< [in] Leading dimension of <em>Y</em>: at least \p NUM_VECTORS if row-major, \p num_rows if column-major
+        DenseLayout         layout,                             ///< [in] Storage order of <em>X</em> and <em>Y</em>
+        int                 num_rows,                           ///< [in] number of rows of matrix <b>A</b>.
+        int                 num_cols,                           ///< [in] number of columns of matrix <b>A</b>.
+        int                 num_nonzeros,                       ///< [in] number of nonzero elements of matrix <b>A</b>.
+        ValueT              alpha                   = ValueT(1),///< [in] <b>[optional]</b> Alpha multiplicand.  Default is 1.
+        ValueT              beta                    = ValueT(0),///< [in] <b>[optional]</b> Beta addend-multiplicand.  Default is 0.
+        hipStream_t         stream                  = 0,        ///< [in] <b>[optional]</b> hip stream to launch kernels within.  Default is stream<sub>0</sub>.
+        bool                debug_synchronous       = false)    ///< [in] <b>[optional]</b> Whether or not to synchronize the stream after every kernel launch to check for errors.  May cause significant slowdown.  Default is \p false.
+    {
+        static_assert((NUM_VECTORS > 0) && (NUM_VECTORS <= 64), "NUM_VECTORS must be in [1, 64]");
+
+        if (num_rows == 0)
+        {
+            return hipSuccess;
+        }
+
+        if (beta != ValueT(0))
+        {
+            return DispatchSpmm<NUM_VECTORS, true>(
+                d_values, d_row_offsets, d_column_indices,
+                d_matrix_x, static_cast<size_t>(ldx), d_matrix_y, static_cast<size_t>(ldy), layout,
+                num_rows, num_nonzeros, alpha, beta, stream, debug_synchronous);
+        }
+        return DispatchSpmm<NUM_VECTORS, false>(
+            d_values, d_row_offsets, d_column_indices,
+            d_matrix_x, static_cast<size_t>(ldx), d_matrix_y, static_cast<size_t>(ldy), layout,
+            num_rows, num_nonzeros, alpha, beta, stream, debug_synchronous);
+    }
+};
+
+END_HIPCUB_NAMESPACE
 
+#endif // HIPCUB_ROCPRIM_DEVICE_DEVICE_SPMV_HPP_
@@ -0,0 +1,169 @@
+/******************************************************************************
+ * Copyright (c) 2021, Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+
+#ifndef HIPCUB_ROCPRIM_DEVICE_DEVICE_TOPK_HPP_
+#define HIPCUB_ROCPRIM_DEVICE_DEVICE_TOPK_HPP_
+
+#include "../../../config.hpp"
+
+#include "../util_type.hpp"
+#include "detail/device_large_num_items.hpp"
+#include "detail/device_radix_select.hpp"
+
+BEGIN_HIPCUB_NAMESPACE
+
+/**
+ * \brief Order of the keys written by DeviceTopK
+ */
+enum DeviceTopKOrder
+{
+    TOPK_UNORDERED,     ///< Any order, nothing beyond the selection
+    TOPK_SORTED,        ///< Largest first for Max*, smallest first for Min*
+};
+
+/**
+ * \brief DeviceTopK selects the k largest or smallest keys of a sequence by radix select.
+ *
+ * \par Overview
+ * Instead of sorting the whole sequence, the digits of the k-th key are found one
+ * at a time from the most significant one, counting at each pass only the keys
+ * that match the digits found so far.  Refining stops as soon as the k selected
+ * keys are known, and a last pass gathers them.  Among keys equal to the k-th key,
+ * which ones are selected is unspecified.
+ *
+ * \par
+ * - Keys are arithmetic types, compared as by DeviceRadixSort.
+ * - With \p TOPK_SORTED, the k selected keys (and values) are then radix sorted.
+ * - \p k must not exceed \p num_items, which must fit in an <tt>unsigned int</tt>.
+ */
+struct DeviceTopK
+{
+    template<typename KeyT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t MaxKeys(void * d_temp_storage,
+                       size_t& temp_storage_bytes,
+                       const KeyT * d_keys_in,
+                       KeyT * d_keys_out,
+                       NumItemsT num_items,
+                       unsigned int k,
+                       DeviceTopKOrder order = TOPK_UNORDERED,
+                       hipStream_t stream = 0,
+                       bool debug_synchronous = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSelect<true, false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            static_cast<unsigned int>(num_items), k, order == TOPK_SORTED,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t MinKeys(void * d_temp_storage,
+                       size_t& temp_storage_bytes,
+                       const KeyT * d_keys_in,
+                       KeyT * d_keys_out,
+                       NumItemsT num_items,
+                       unsigned int k,
+                       DeviceTopKOrder order = TOPK_UNORDERED,
+                       hipStream_t stream = 0,
+                       bool debug_synchronous = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSelect<false, false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, static_cast<const NullType *>(nullptr), static_cast<NullType *>(nullptr),
+            static_cast<unsigned int>(num_items), k, order == TOPK_SORTED,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t MaxPairs(void * d_temp_storage,
+                        size_t& temp_storage_bytes,
+                        const KeyT * d_keys_in,
+                        KeyT * d_keys_out,
+                        const ValueT * d_values_in,
+                        ValueT * d_values_out,
+                        NumItemsT num_items,
+                        unsigned int k,
+                        DeviceTopKOrder order = TOPK_UNORDERED,
+                        hipStream_t stream = 0,
+                        bool debug_synchronous = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSelect<true, false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            static_cast<unsigned int>(num_items), k, order == TOPK_SORTED,
+            stream, debug_synchronous
+        );
+    }
+
+    template<typename KeyT, typename ValueT, typename NumItemsT>
+    HIPCUB_RUNTIME_FUNCTION static
+    hipError_t MinPairs(void * d_temp_storage,
+                        size_t& temp_storage_bytes,
+                        const KeyT * d_keys_in,
+                        KeyT * d_keys_out,
+                        const ValueT * d_values_in,
+                        ValueT * d_values_out,
+                        NumItemsT num_items,
+                        unsigned int k,
+                        DeviceTopKOrder order = TOPK_UNORDERED,
+                        hipStream_t stream = 0,
+                        bool debug_synchronous = false)
+    {
+        if(!detail::num_items_fit<unsigned int>(num_items))
+        {
+            return hipErrorInvalidValue;
+        }
+        return detail::RadixSelect<false, false>(
+            d_temp_storage, temp_storage_bytes,
+            d_keys_in, d_keys_out, d_values_in, d_values_out,
+            static_cast<unsigned int>(num_items), k, order == TOPK_SORTED,
+            stream, debug_synchronous
+        );
+    }
+};
+
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_ROCPRIM_DEVICE_DEVICE_TOPK_HPP_
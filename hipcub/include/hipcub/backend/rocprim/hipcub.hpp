@@ -60,12 +60,16 @@
 
 // Device
 #include "device/device_histogram.hpp"
+#include "device/device_merge_sort.hpp"
 #include "device/device_radix_sort.hpp"
 #include "device/device_reduce.hpp"
 #include "device/device_run_length_encode.hpp"
 #include "device/device_scan.hpp"
 #include "device/device_segmented_radix_sort.hpp"
 #include "device/device_segmented_reduce.hpp"
+#include "device/device_segmented_sort.hpp"
+#include "device/device_segmented_topk.hpp"
 #include "device/device_select.hpp"
+#include "device/device_topk.hpp"
 
 #endif // HIPCUB_ROCPRIM_HIPCUB_HPP_
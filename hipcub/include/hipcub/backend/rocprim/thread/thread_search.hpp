@@ -32,6 +32,10 @@
 
  #include <iterator>
 
+#include "../../../config.hpp"
+
+#include <rocprim/functional.hpp>
+
  BEGIN_HIPCUB_NAMESPACE
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS    // Do not document
@@ -53,8 +57,8 @@ __host__ __device__ __forceinline__ void MergePathSearch(
     OffsetT         b_len,
     CoordinateT&    path_coordinate)
 {
-    OffsetT split_min = CUB_MAX(diagonal - b_len, 0);
-    OffsetT split_max = CUB_MIN(diagonal, a_len);
+    OffsetT split_min = ::rocprim::max<OffsetT>(diagonal - b_len, 0);
+    OffsetT split_max = ::rocprim::min<OffsetT>(diagonal, a_len);
 
     while (split_min < split_max)
     {
@@ -71,7 +75,50 @@ __host__ __device__ __forceinline__ void MergePathSearch(
         }
     }
 
-    path_coordinate.x = CUB_MIN(split_min, a_len);
+    path_coordinate.x = ::rocprim::min<OffsetT>(split_min, a_len);
+    path_coordinate.y = diagonal - split_min;
+}
+
+
+/**
+ * \brief Computes the begin offsets into A and B for the specific diagonal, ordering
+ * the items by \p compare_op.  Items of A go before equal items of B.
+ */
+template <
+    typename AIteratorT,
+    typename BIteratorT,
+    typename OffsetT,
+    typename CoordinateT,
+    typename CompareOpT>
+__host__ __device__ __forceinline__ void MergePathSearch(
+    OffsetT         diagonal,
+    AIteratorT      a,
+    BIteratorT      b,
+    OffsetT         a_len,
+    OffsetT         b_len,
+    CoordinateT&    path_coordinate,
+    CompareOpT      compare_op)
+{
+    // Written so that unsigned offsets do not wrap around
+    OffsetT split_min = (diagonal > b_len) ? OffsetT(diagonal - b_len) : OffsetT(0);
+    OffsetT split_max = ::rocprim::min<OffsetT>(diagonal, a_len);
+
+    while (split_min < split_max)
+    {
+        OffsetT split_pivot = (split_min + split_max) >> 1;
+        if (!compare_op(b[diagonal - split_pivot - 1], a[split_pivot]))
+        {
+            // Move candidate split range up A, down B
+            split_min = split_pivot + 1;
+        }
+        else
+        {
+            // Move candidate split range up B, down A
+            split_max = split_pivot;
+        }
+    }
+
+    path_coordinate.x = ::rocprim::min<OffsetT>(split_min, a_len);
     path_coordinate.y = diagonal - split_min;
 }
 
@@ -32,20 +32,2781 @@
 
 #include "../../config.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <set>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 
 BEGIN_HIPCUB_NAMESPACE
 
 #define _HipcubLog(format, ...) printf(format, __VA_ARGS__);
 
+// Stream-ordered allocation (hipMallocAsync and memory pools) is available from HIP 5.3
+#if defined(HIP_VERSION) && (HIP_VERSION >= 50300000)
+    #define HIPCUB_STREAM_ORDERED_ALLOCATION 1
+#endif
+
 // Hipified version of cub/util_allocator.cuh
 
-struct CachingDeviceAllocator
+struct CachingDeviceAllocator
+{
+    //---------------------------------------------------------------------
+    // Constants
+    //---------------------------------------------------------------------
+
+    /// Out-of-bounds bin
+    static const unsigned int INVALID_BIN = (unsigned int) -1;
+
+    /// Invalid size
+    static const size_t INVALID_SIZE = (size_t) -1;
+
+    /// Invalid device ordinal
+    static const int INVALID_DEVICE_ORDINAL = -1;
+
+    /// Default number of shards per device in sharded mode
+    static const unsigned int DEFAULT_SHARDS = 16;
+
+    /// Number of free-list slots per bin of each shard
+    static const unsigned int SHARD_BIN_SLOTS = 32;
+
+    /// Maximum number of bins cached in sharded mode
+    static const unsigned int MAX_SHARD_BINS = 64;
+
+    /// Bin of blocks carved from a slab
+    static const unsigned int SLAB_BIN = INVALID_BIN - 1;
+
+    /// Alignment of blocks carved from a slab
+    static const size_t SLAB_ALIGNMENT = 256;
+
+    /// Maximum number of bins with their own hit and miss counts
+    static const unsigned int MAX_STATISTICS_BINS = 128;
+
+    /**
+     * What DeviceAllocate frees when the device is out of memory
+     */
+    enum EvictionPolicy
+    {
+        EVICT_ALL,          ///< Every cached block of the device
+        EVICT_MINIMAL,      ///< The fewest cached blocks covering the request, preferring idle ones, then more if needed
+    };
+
+    /**
+     * Called when the device is out of memory and no cached block is left to
+     * evict.  Returns whether the caller released device memory, in which case
+     * the allocation is retried.
+     */
+    typedef bool (*EvictionCallback)(
+        int             device,             ///< [in] Device ordinal
+        size_t          bytes,              ///< [in] Size of the failed allocation in bytes
+        void            *user_data);        ///< [in] Pointer passed to SetEvictionCallback()
+
+    //---------------------------------------------------------------------
+    // Type definitions and helper types
+    //---------------------------------------------------------------------
+
+    /**
+     * Descriptor for device memory allocations
+     */
+    struct BlockDescriptor
+    {
+        void*           d_ptr;              // Device pointer
+        size_t          bytes;              // Size of allocation in bytes
+        unsigned int    bin;                // Bin enumeration
+        int             device;             // device ordinal
+        hipStream_t     associated_stream;  // Associated associated_stream
+        hipEvent_t      ready_event;        // Signal when associated stream has run to the point at which this block was freed
+        size_t          requested_bytes;    // Size requested by the current user of the block
+
+        // Constructor (suitable for searching maps for a specific block, given its pointer and device)
+        BlockDescriptor(void *d_ptr, int device) :
+            d_ptr(d_ptr),
+            bytes(0),
+            bin(INVALID_BIN),
+            device(device),
+            associated_stream(0),
+            ready_event(0),
+            requested_bytes(0)
+        {}
+
+        // Constructor (suitable for searching maps for a range of suitable blocks, given a device)
+        BlockDescriptor(int device) :
+            d_ptr(NULL),
+            bytes(0),
+            bin(INVALID_BIN),
+            device(device),
+            associated_stream(0),
+            ready_event(0),
+            requested_bytes(0)
+        {}
+
+        // Comparison functor for comparing device pointers
+        static bool PtrCompare(const BlockDescriptor &a, const BlockDescriptor &b)
+        {
+            if (a.device == b.device)
+                return (a.d_ptr < b.d_ptr);
+            else
+                return (a.device < b.device);
+        }
+
+        // Comparison functor for comparing allocation sizes
+        static bool SizeCompare(const BlockDescriptor &a, const BlockDescriptor &b)
+        {
+            if (a.device == b.device)
+                return (a.bytes < b.bytes);
+            else
+                return (a.device < b.device);
+        }
+    };
+
+    /// BlockDescriptor comparator function interface
+    typedef bool (*Compare)(const BlockDescriptor &, const BlockDescriptor &);
+
+    class TotalBytes {
+    public:
+        size_t free;
+        size_t live;
+        TotalBytes() { free = live = 0; }
+    };
+
+    /// Set type for cached blocks (ordered by size)
+    typedef std::multiset<BlockDescriptor, Compare> CachedBlocks;
+
+    /// Set type for live blocks (ordered by ptr)
+    typedef std::multiset<BlockDescriptor, Compare> BusyBlocks;
+
+    /// Map type of device ordinals to the number of cached bytes cached by each device
+    typedef std::map<int, TotalBytes> GpuCachedBytes;
+
+    /**
+     * Lock-free free-list of cached blocks for one bin of one shard.  Every slot
+     * holds either NULL or a cached block, and ownership of a block only changes
+     * hands through a single atomic exchange, so pops are not subject to ABA.
+     */
+    struct ShardBin
+    {
+        std::atomic<BlockDescriptor*> slots[SHARD_BIN_SLOTS];
+
+        ShardBin()
+        {
+            for (unsigned int i = 0; i < SHARD_BIN_SLOTS; i++)
+                slots[i].store(NULL, std::memory_order_relaxed);
+        }
+
+        // Returns false if every slot is occupied
+        bool Push(BlockDescriptor *block)
+        {
+            for (unsigned int i = 0; i < SHARD_BIN_SLOTS; i++)
+            {
+                BlockDescriptor *expected = NULL;
+                if ((slots[i].load(std::memory_order_relaxed) == NULL) &&
+                    slots[i].compare_exchange_strong(expected, block, std::memory_order_release, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Returns NULL once no slot is left to visit
+        BlockDescriptor* Pop(unsigned int &slot)
+        {
+            for (; slot < SHARD_BIN_SLOTS; slot++)
+            {
+                if (slots[slot].load(std::memory_order_relaxed) == NULL) continue;
+                BlockDescriptor *block = slots[slot].exchange(NULL, std::memory_order_acquire);
+                if (block != NULL) return block;
+            }
+            return NULL;
+        }
+    };
+
+    /**
+     * Live device allocations of one shard, keyed by pointer
+     */
+    struct LiveStripe
+    {
+        std::mutex                                  mutex;
+        std::unordered_map<void*, BlockDescriptor*> blocks;
+    };
+
+    /**
+     * Per-device state of the sharded mode: \p num_shards shards of \p num_bins
+     * free-lists each, plus the live allocations striped by pointer
+     */
+    struct DeviceShards
+    {
+        unsigned int                    num_shards;
+        unsigned int                    first_bin;
+        unsigned int                    num_bins;
+        std::unique_ptr<ShardBin[]>     bins;
+        std::unique_ptr<LiveStripe[]>   live;
+        std::atomic<size_t>             free_bytes;
+        std::atomic<size_t>             live_bytes;
+
+        DeviceShards(unsigned int num_shards, unsigned int first_bin, unsigned int num_bins) :
+            num_shards(num_shards),
+            first_bin(first_bin),
+            num_bins(num_bins),
+            bins(new ShardBin[num_shards * num_bins]),
+            live(new LiveStripe[num_shards]),
+            free_bytes(0),
+            live_bytes(0)
+        {}
+
+        // Whether blocks of \p bin are cached in the shards
+        bool Caches(unsigned int bin) const
+        {
+            return (bin >= first_bin) && (bin - first_bin < num_bins);
+        }
+
+        ShardBin& Bin(unsigned int shard, unsigned int bin)
+        {
+            return bins[shard * num_bins + (bin - first_bin)];
+        }
+
+        LiveStripe& Stripe(void *d_ptr)
+        {
+            return live[(reinterpret_cast<size_t>(d_ptr) >> 8) % num_shards];
+        }
+
+        // Releases the descriptors still owned by the shards (device memory is not touched)
+        ~DeviceShards()
+        {
+            for (unsigned int i = 0; i < num_shards * num_bins; i++)
+            {
+                for (unsigned int slot = 0; slot < SHARD_BIN_SLOTS; slot++)
+                    delete bins[i].slots[slot].load(std::memory_order_relaxed);
+            }
+            for (unsigned int i = 0; i < num_shards; i++)
+            {
+                for (auto &entry : live[i].blocks)
+                    delete entry.second;
+            }
+        }
+    };
+
+    /**
+     * Device memory slab that blocks beyond the largest bin are carved from
+     */
+    struct Slab
+    {
+        char                        *d_ptr;         // Device pointer
+        size_t                      bytes;          // Size of the slab in bytes
+        size_t                      carved;         // Bytes carved out, live or pending
+        std::map<size_t, size_t>    free_ranges;    // Offset -> length of each free range
+    };
+
+    /**
+     * Per-device slabs.  A block freed back to its slab stays pending until its
+     * ready event has completed, except for reuse by its associated stream.
+     */
+    struct SlabHeap
+    {
+        std::mutex                      mutex;
+        std::vector<Slab>               slabs;
+        std::vector<BlockDescriptor>    pending;    // Freed blocks whose ready event may not have completed
+        std::vector<hipEvent_t>         events;     // Spare ready events
+    };
+
+    /**
+     * Cached block considered for eviction
+     */
+    struct EvictionCandidate
+    {
+        size_t          bytes;              // Size of the block in bytes
+        bool            ready;              // Whether the ready event of the block has completed
+        bool            evict;              // Whether the block was chosen
+    };
+
+    /**
+     * Kinds of allocator events recorded in the trace
+     */
+    enum TraceEventType
+    {
+        TRACE_REUSE,        ///< DeviceAllocate served by a cached block
+        TRACE_ALLOCATE,     ///< DeviceAllocate served by new device memory or a slab
+        TRACE_RECACHE,      ///< DeviceFree kept the block for reuse
+        TRACE_RELEASE,      ///< DeviceFree gave the block back to the runtime or to its slab
+        TRACE_MALLOC,       ///< hipMalloc call
+        TRACE_HIP_FREE,     ///< hipFree call
+    };
+
+    /**
+     * Allocator event recorded in the trace
+     */
+    struct TraceEvent
+    {
+        double          timestamp_us;       // Microseconds since statistics were enabled
+        TraceEventType  type;               // Kind of event
+        int             device;             // Device ordinal
+        hipStream_t     stream;             // Associated stream
+        void*           d_ptr;              // Device pointer
+        size_t          bytes;              // Size of the block in bytes
+        size_t          requested_bytes;    // Size requested by the user of the block
+    };
+
+    /**
+     * Hit and miss counts of one bin, see GetStatistics()
+     */
+    struct BinStatistics
+    {
+        unsigned int    bin;                ///< Bin enumeration (INVALID_BIN for the bins without counts of their own)
+        size_t          bin_bytes;          ///< Size of the blocks of the bin
+        size_t          hits;               ///< Allocations served by a cached block
+        size_t          misses;             ///< Allocations that needed a new block
+    };
+
+    /**
+     * Allocator statistics of one device, see GetStatistics()
+     */
+    struct DeviceStatistics
+    {
+        size_t          live_bytes;             ///< Bytes in live blocks
+        size_t          requested_bytes;        ///< Bytes requested by the users of the live blocks
+        size_t          peak_live_bytes;        ///< Largest value of \p live_bytes since statistics were enabled
+        size_t          cached_bytes;           ///< Bytes in cached blocks available for reuse
+        size_t          slab_bytes;             ///< Bytes reserved by slabs
+        size_t          slab_free_bytes;        ///< Bytes of slabs not carved out
+        size_t          slab_largest_free;      ///< Largest range of slab bytes not carved out
+        size_t          malloc_calls;           ///< Number of successful hipMalloc calls
+        size_t          free_calls;             ///< Number of hipFree calls
+        size_t          uncached_allocations;   ///< Allocations beyond the largest bin, served exactly or by a slab
+        size_t          evicted_blocks;         ///< Cached blocks freed because the device was out of memory
+        double          lock_wait_seconds;      ///< Time spent waiting for the allocator's locks
+        std::vector<BinStatistics> bins;        ///< Hit and miss counts per bin
+
+        /// Share of the live bytes lost to rounding requests up to their bin
+        double InternalFragmentation() const
+        {
+            return (live_bytes == 0) ? 0.0 : 1.0 - double(requested_bytes) / double(live_bytes);
+        }
+
+        /// Share of the free slab bytes outside of the largest free range
+        double SlabFragmentation() const
+        {
+            return (slab_free_bytes == 0) ? 0.0 : 1.0 - double(slab_largest_free) / double(slab_free_bytes);
+        }
+    };
+
+    /**
+     * Per-device statistics counters
+     */
+    struct StatisticsCounters
+    {
+        std::atomic<size_t>                     live_bytes;
+        std::atomic<size_t>                     requested_bytes;
+        std::atomic<size_t>                     peak_live_bytes;
+        std::atomic<size_t>                     malloc_calls;
+        std::atomic<size_t>                     free_calls;
+        std::atomic<size_t>                     uncached_allocations;
+        std::atomic<size_t>                     evicted_blocks;
+        std::atomic<long long>                  lock_wait_ns;
+        std::unique_ptr<std::atomic<size_t>[]>  hits;       // Per bin, plus one for the bins beyond
+        std::unique_ptr<std::atomic<size_t>[]>  misses;     // Per bin, plus one for the bins beyond
+
+        StatisticsCounters(unsigned int num_bins) :
+            live_bytes(0),
+            requested_bytes(0),
+            peak_live_bytes(0),
+            malloc_calls(0),
+            free_calls(0),
+            uncached_allocations(0),
+            evicted_blocks(0),
+            lock_wait_ns(0),
+            hits(new std::atomic<size_t>[num_bins + 1]),
+            misses(new std::atomic<size_t>[num_bins + 1])
+        {
+            for (unsigned int i = 0; i <= num_bins; i++)
+            {
+                hits[i].store(0);
+                misses[i].store(0);
+            }
+        }
+    };
+
+
+    //---------------------------------------------------------------------
+    // Utility functions
+    //---------------------------------------------------------------------
+
+    /**
+     * Integer pow function for unsigned base and exponent
+     */
+    static unsigned int IntPow(
+        unsigned int base,
+        unsigned int exp)
+    {
+        unsigned int retval = 1;
+        while (exp > 0)
+        {
+            if (exp & 1) {
+                retval = retval * base;        // multiply the result by the current base
+            }
+            base = base * base;                // square the base
+            exp = exp >> 1;                    // divide the exponent in half
+        }
+        return retval;
+    }
+
+
+    /**
+     * Round up to the nearest size class with \p steps classes per doubling,
+     * 2^k * (1 + i / steps) for i in [1, steps].  \p steps must be a power of two.
+     */
+    void NearestSizeClass(
+        unsigned int    &bin,
+        size_t          &rounded_bytes,
+        unsigned int    steps,
+        size_t          value)
+    {
+        if (value <= steps)
+        {
+            bin = (unsigned int) value;
+            rounded_bytes = value;
+            return;
+        }
+
+        unsigned int k = 0;
+        while ((value - 1) >> (k + 1)) k++;
+
+        if (k + 1 >= sizeof(size_t) * 8)
+        {
+            // Overflow
+            bin = (sizeof(size_t) * 8 + 2) * steps;
+            rounded_bytes = size_t(0) - 1;
+            return;
+        }
+
+        size_t base = size_t(1) << k;
+        size_t step = base / steps;
+        size_t i = (value - base + step - 1) / step;
+
+        bin = (k + 1) * steps + (unsigned int) i;
+        rounded_bytes = base + i * step;
+    }
+
+
+    /**
+     * Round up to the nearest power-of
+     */
+    static void NearestPowerOf(
+        unsigned int    &power,
+        size_t          &rounded_bytes,
+        unsigned int    base,
+        size_t          value)
+    {
+        power = 0;
+        rounded_bytes = 1;
+
+        if (value * base < value)
+        {
+            // Overflow
+            power = sizeof(size_t) * 8;
+            rounded_bytes = size_t(0) - 1;
+            return;
+        }
+
+        while (rounded_bytes < value)
+        {
+            rounded_bytes *= base;
+            power++;
+        }
+    }
+
+
+    //---------------------------------------------------------------------
+    // Fields
+    //---------------------------------------------------------------------
+
+    std::mutex      mutex;              /// Mutex for thread-safety
+
+    unsigned int    bin_growth;         /// Geometric growth factor for bin-sizes
+    unsigned int    min_bin;            /// Minimum bin enumeration
+    unsigned int    max_bin;            /// Maximum bin enumeration
+
+    size_t          min_bin_bytes;      /// Minimum bin size
+    size_t          max_bin_bytes;      /// Maximum bin size
+    size_t          max_cached_bytes;   /// Maximum aggregate cached bytes per device
+
+    const bool      skip_cleanup;       /// Whether or not to skip a call to FreeAllCached() when destructor is called.  (The CUDA runtime may have already shut down for statically declared allocators)
+    bool            debug;              /// Whether or not to print (de)allocation events to stdout
+
+    GpuCachedBytes  cached_bytes;       /// Map of device ordinal to aggregate cached bytes on that device
+    CachedBlocks    cached_blocks;      /// Set of cached device allocations available for reuse
+    BusyBlocks      live_blocks;        /// Set of live device allocations currently in use
+
+    unsigned int    num_shards;         /// Number of shards per device (zero unless sharded mode is enabled)
+    std::vector<std::unique_ptr<DeviceShards>> device_shards;   /// Per-device shards in sharded mode, indexed by device ordinal
+
+    unsigned int    bin_steps;          /// Size classes per doubling (zero for bins at powers of bin_growth)
+    size_t          slab_bytes;         /// Size of the slabs blocks beyond the largest bin are carved from (zero disables slabs)
+    std::vector<std::unique_ptr<SlabHeap>> slab_heaps;          /// Per-device slabs, indexed by device ordinal
+
+    std::vector<std::unique_ptr<StatisticsCounters>> statistics;    /// Per-device statistics, indexed by device ordinal (empty unless enabled)
+    unsigned int    statistics_first_bin;   /// First bin with hit and miss counts of its own
+    unsigned int    statistics_num_bins;    /// Number of bins with hit and miss counts of their own
+    std::chrono::steady_clock::time_point statistics_start;     /// Time statistics were enabled
+    std::mutex      trace_mutex;        /// Mutex for the trace
+    std::vector<TraceEvent> trace;      /// Ring buffer of the latest allocator events (empty unless enabled)
+    size_t          trace_next;         /// Number of events recorded in the trace so far
+
+    EvictionPolicy  eviction_policy;    /// What to free when the device is out of memory
+    EvictionCallback eviction_callback; /// Last resort when the device is out of memory (may be NULL)
+    void            *eviction_user_data;    /// Passed to eviction_callback
+
+    //---------------------------------------------------------------------
+    // Methods
+    //---------------------------------------------------------------------
+
+    /**
+     * \brief Constructor.
+     */
+    CachingDeviceAllocator(
+        unsigned int    bin_growth,                             ///< Geometric growth factor for bin-sizes
+        unsigned int    min_bin             = 1,                ///< Minimum bin (default is bin_growth ^ 1)
+        unsigned int    max_bin             = INVALID_BIN,      ///< Maximum bin (default is no max bin)
+        size_t          max_cached_bytes    = INVALID_SIZE,     ///< Maximum aggregate cached bytes per device (default is no limit)
+        bool            skip_cleanup        = false,            ///< Whether or not to skip a call to \p FreeAllCached() when the destructor is called (default is to deallocate)
+        bool            debug               = false)            ///< Whether or not to print (de)allocation events to stdout (default is no stderr output)
+    :
+        bin_growth(bin_growth),
+        min_bin(min_bin),
+        max_bin(max_bin),
+        min_bin_bytes(IntPow(bin_growth, min_bin)),
+        max_bin_bytes(IntPow(bin_growth, max_bin)),
+        max_cached_bytes(max_cached_bytes),
+        skip_cleanup(skip_cleanup),
+        debug(debug),
+        cached_blocks(BlockDescriptor::SizeCompare),
+        live_blocks(BlockDescriptor::PtrCompare),
+        num_shards(0),
+        bin_steps(0),
+        slab_bytes(0),
+        statistics_first_bin(0),
+        statistics_num_bins(0),
+        trace_next(0),
+        eviction_policy(EVICT_ALL),
+        eviction_callback(NULL),
+        eviction_user_data(NULL)
+    {}
+
+
+    /**
+     * \brief Default constructor.
+     *
+     * Configured with:
+     * \par
+     * - \p bin_growth          = 8
+     * - \p min_bin             = 3
+     * - \p max_bin             = 7
+     * - \p max_cached_bytes    = (\p bin_growth ^ \p max_bin) * 3) - 1 = 6,291,455 bytes
+     *
+     * which delineates five bin-sizes: 512B, 4KB, 32KB, 256KB, and 2MB and
+     * sets a maximum of 6,291,455 cached bytes per device
+     */
+    CachingDeviceAllocator(
+        bool skip_cleanup = false,
+        bool debug = false)
+    :
+        bin_growth(8),
+        min_bin(3),
+        max_bin(7),
+        min_bin_bytes(IntPow(bin_growth, min_bin)),
+        max_bin_bytes(IntPow(bin_growth, max_bin)),
+        max_cached_bytes((max_bin_bytes * 3) - 1),
+        skip_cleanup(skip_cleanup),
+        debug(debug),
+        cached_blocks(BlockDescriptor::SizeCompare),
+        live_blocks(BlockDescriptor::PtrCompare),
+        num_shards(0),
+        bin_steps(0),
+        slab_bytes(0),
+        statistics_first_bin(0),
+        statistics_num_bins(0),
+        trace_next(0),
+        eviction_policy(EVICT_ALL),
+        eviction_callback(NULL),
+        eviction_user_data(NULL)
+    {}
+
+
+    /**
+     * \brief Sets the limit on the number bytes this allocator is allowed to cache per device.
+     *
+     * Changing the ceiling of cached bytes does not cause any allocations (in-use or
+     * cached-in-reserve) to be freed.  See \p FreeAllCached().
+     */
+    hipError_t SetMaxCachedBytes(
+        size_t max_cached_bytes)
+    {
+        // Lock
+        mutex.lock();
+
+        if (debug) _HipcubLog("Changing max_cached_bytes (%lld -> %lld)\n", (long long) this->max_cached_bytes, (long long) max_cached_bytes);
+
+        this->max_cached_bytes = max_cached_bytes;
+
+        // Unlock
+        mutex.unlock();
+
+        return hipSuccess;
+    }
+
+
+    /**
+     * \brief Sets what DeviceAllocate frees when the device is out of memory.
+     *
+     * \p EVICT_ALL (the default) frees every cached block of the device before
+     * retrying.  \p EVICT_MINIMAL frees the smallest cached block that covers the
+     * shortfall between the request and the free memory reported by hipMemGetInfo,
+     * or else the fewest largest blocks, considering blocks whose ready event has
+     * completed first; if the retry still fails it evicts another set, until no
+     * cached block is left.
+     */
+    hipError_t SetEvictionPolicy(
+        EvictionPolicy policy)
+    {
+        // Lock
+        mutex.lock();
+
+        eviction_policy = policy;
+
+        // Unlock
+        mutex.unlock();
+
+        return hipSuccess;
+    }
+
+
+    /**
+     * \brief Sets a callback invoked when the device is out of memory and no cached
+     * block is left to evict, to let the caller release device memory of its own.
+     * The allocation is retried while the callback returns true.
+     */
+    hipError_t SetEvictionCallback(
+        EvictionCallback    callback,               ///< [in] Callback, or NULL to remove it
+        void                *user_data = NULL)      ///< [in] Passed to \p callback
+    {
+        // Lock
+        mutex.lock();
+
+        eviction_callback   = callback;
+        eviction_user_data  = user_data;
+
+        // Unlock
+        mutex.unlock();
+
+        return hipSuccess;
+    }
+
+
+    /**
+     * \brief Replaces the bins at powers of \p bin_growth by finer size classes.
+     *
+     * Every doubling of the block size is split into \p steps size classes, so
+     * with four steps a request is rounded up by at most 25% rather than by up
+     * to \p bin_growth times.  The classes span [\p min_bin_bytes, \p max_bin_bytes].
+     *
+     * Must be called before EnableSharding(), EnableStatistics() and the first allocation.
+     */
+    hipError_t SetSizeClasses(
+        unsigned int steps)     ///< [in] Size classes per doubling, a power of two no larger than 64
+    {
+        hipError_t error = hipSuccess;
+
+        // Lock
+        mutex.lock();
+
+        if ((steps == 0) || (steps > 64) || ((steps & (steps - 1)) != 0) || (num_shards != 0) ||
+            !statistics.empty() || !live_blocks.empty() || !cached_blocks.empty())
+        {
+            error = hipErrorInvalidValue;
+        }
+        else
+        {
+            if (debug) _HipcubLog("Changing size classes per doubling (%u -> %u)\n", bin_steps, steps);
+            bin_steps = steps;
+        }
+
+        // Unlock
+        mutex.unlock();
+
+        return error;
+    }
+
+
+    /**
+     * \brief Carves blocks beyond the largest bin out of slabs of \p slab_bytes.
+     *
+     * Requests larger than \p max_bin_bytes and no larger than \p slab_bytes are
+     * sub-allocated from per-device slabs instead of calling hipMalloc and hipFree
+     * on their own.  A freed block returns to its slab once its ready event has
+     * completed; until then it is only reused by its associated stream, for a
+     * request of the same size.  Slabs that become empty are released, except
+     * for one per device.
+     *
+     * Must be called before EnableSharding() and before the first allocation.
+     */
+    hipError_t SetSlabs(
+        size_t slab_bytes)      ///< [in] Size of each slab in bytes
+    {
+        hipError_t error    = hipSuccess;
+        int num_devices     = 0;
+
+        if (HipcubDebug(error = hipGetDeviceCount(&num_devices))) return error;
+
+        // Lock
+        mutex.lock();
+
+        if ((slab_bytes == 0) || (this->slab_bytes != 0) || (num_shards != 0) ||
+            !live_blocks.empty() || !cached_blocks.empty())
+        {
+            error = hipErrorInvalidValue;
+        }
+        else
+        {
+            slab_heaps.resize(num_devices);
+            for (int device = 0; device < num_devices; device++)
+                slab_heaps[device].reset(new SlabHeap());
+            this->slab_bytes = slab_bytes;
+
+            if (debug) _HipcubLog("Enabled slabs of %lld bytes\n", (long long) slab_bytes);
+        }
+
+        // Unlock
+        mutex.unlock();
+
+        return error;
+    }
+
+
+    /**
+     * Bin of a request for \p bytes and the size of the block serving it.
+     * Requests below the smallest bin are rounded up to it.  Requests beyond
+     * the largest bin get \p SLAB_BIN if they can be carved from a slab and
+     * \p INVALID_BIN otherwise; they are not cached when returned.
+     */
+    void BinOf(
+        unsigned int    &bin,
+        size_t          &bin_bytes,
+        size_t          bytes)
+    {
+        bool beyond_max_bin;
+        if (bin_steps == 0)
+        {
+            NearestPowerOf(bin, bin_bytes, bin_growth, bytes);
+            if (bin < min_bin)
+            {
+                // Bin is less than minimum bin: round up
+                bin         = min_bin;
+                bin_bytes   = min_bin_bytes;
+            }
+            beyond_max_bin = (bin > max_bin);
+        }
+        else
+        {
+            NearestSizeClass(bin, bin_bytes, bin_steps, (bytes < min_bin_bytes) ? min_bin_bytes : bytes);
+            beyond_max_bin = (max_bin != INVALID_BIN) && (bin_bytes > max_bin_bytes);
+        }
+
+        if (beyond_max_bin)
+        {
+            if ((slab_bytes != 0) && (bytes <= slab_bytes))
+            {
+                // Keep the size class rounding, if any, so that blocks of similar
+                // sizes can be reused by their stream before returning to the slab
+                bin         = SLAB_BIN;
+                bin_bytes   = (bin_steps == 0) ? bytes : bin_bytes;
+                bin_bytes   = (bin_bytes + SLAB_ALIGNMENT - 1) / SLAB_ALIGNMENT * SLAB_ALIGNMENT;
+            }
+            else
+            {
+                bin         = INVALID_BIN;
+                bin_bytes   = bytes;
+            }
+        }
+    }
+
+
+    /**
+     * The first bin of cached blocks and the number of bins from there on,
+     * up to \p max_bins
+     */
+    void CachedBinRange(
+        unsigned int    &first_bin,
+        unsigned int    &num_bins,
+        unsigned int    max_bins)
+    {
+        unsigned int last_bin;
+        size_t bin_bytes;
+        BinOf(first_bin, bin_bytes, min_bin_bytes);
+        if (bin_steps == 0)
+            last_bin = max_bin;
+        else if (max_bin == INVALID_BIN)
+            last_bin = INVALID_BIN;
+        else
+            NearestSizeClass(last_bin, bin_bytes, bin_steps, max_bin_bytes);
+
+        if (last_bin < first_bin)
+            num_bins = 0;
+        else
+            num_bins = (last_bin - first_bin < max_bins) ? last_bin - first_bin + 1 : max_bins;
+    }
+
+
+    /**
+     * Size of the blocks of \p bin
+     */
+    size_t BinBytes(
+        unsigned int    bin)
+    {
+        if (bin_steps == 0)
+        {
+            size_t bin_bytes = 1;
+            for (unsigned int i = 0; i < bin; i++) bin_bytes *= bin_growth;
+            return bin_bytes;
+        }
+        if (bin <= bin_steps) return bin;
+
+        unsigned int k = (bin - 1) / bin_steps - 1;
+        size_t base = size_t(1) << k;
+        return base + (bin - (k + 1) * bin_steps) * (base / bin_steps);
+    }
+
+
+    /**
+     * \brief Switches the allocator to sharded mode.
+     *
+     * In sharded mode every device gets \p shards shards, and each stream is
+     * hashed to one of them.  Each shard keeps a lock-free free-list per bin,
+     * so threads driving different streams do not contend on \p mutex.  An
+     * allocation first looks in the bin of its own shard and only steals from
+     * the other shards of the device when no block there can be reused.  Blocks
+     * are reused under the same rules as in the default mode: immediately by the
+     * stream that freed them, and by other streams once the ready event of the
+     * block has completed; blocks still in use are skipped, never waited for.
+     * Live allocations are tracked per shard, striped by pointer, each stripe
+     * under a lock of its own.
+     *
+     * Must be called before the first allocation.  In sharded mode \p live_blocks,
+     * \p cached_blocks and \p cached_bytes are not maintained.
+     */
+    hipError_t EnableSharding(
+        unsigned int shards = DEFAULT_SHARDS)   ///< [in] Number of shards per device
+    {
+        hipError_t error    = hipSuccess;
+        int num_devices     = 0;
+
+        if (HipcubDebug(error = hipGetDeviceCount(&num_devices))) return error;
+
+        // Lock
+        mutex.lock();
+
+        if ((shards == 0) || (num_shards != 0) || (min_bin > max_bin) ||
+            !live_blocks.empty() || !cached_blocks.empty())
+        {
+            error = hipErrorInvalidValue;
+        }
+        else
+        {
+            unsigned int first_bin;
+            unsigned int num_bins;
+            CachedBinRange(first_bin, num_bins, MAX_SHARD_BINS);
+
+            if (num_bins == 0)
+            {
+                // No bin is cached, e.g. min_bin_bytes rounds above max_bin_bytes
+                error = hipErrorInvalidValue;
+            }
+            else
+            {
+                device_shards.resize(num_devices);
+                for (int device = 0; device < num_devices; device++)
+                    device_shards[device].reset(new DeviceShards(shards, first_bin, num_bins));
+                num_shards = shards;
+
+                if (debug) _HipcubLog("Enabled sharded mode (%u shards x %u bins per device)\n", shards, num_bins);
+            }
+        }
+
+        // Unlock
+        mutex.unlock();
+
+        return error;
+    }
+
+
+    /**
+     * \brief Starts collecting statistics, and optionally a trace of the latest allocator events.
+     *
+     * Statistics cover hits and misses per bin, live, cached and peak bytes,
+     * fragmentation, hipMalloc and hipFree calls and the time spent waiting for
+     * the allocator's locks; see GetStatistics().  With a nonzero \p trace_capacity
+     * the latest \p trace_capacity allocator events are kept in a ring buffer,
+     * see DumpTrace().  Recording the trace takes a lock of its own.
+     *
+     * Must be called after SetSizeClasses() and before the first allocation.
+     */
+    hipError_t EnableStatistics(
+        size_t trace_capacity = 0)      ///< [in] Number of events kept in the trace (zero disables the trace)
+    {
+        hipError_t error    = hipSuccess;
+        int num_devices     = 0;
+
+        if (HipcubDebug(error = hipGetDeviceCount(&num_devices))) return error;
+
+        // Lock
+        mutex.lock();
+
+        bool live = !live_blocks.empty() || !cached_blocks.empty();
+        for (size_t device = 0; device < device_shards.size(); device++)
+            live = live || (device_shards[device]->live_bytes.load() != 0);
+
+        if (!statistics.empty() || live)
+        {
+            error = hipErrorInvalidValue;
+        }
+        else
+        {
+            CachedBinRange(statistics_first_bin, statistics_num_bins, MAX_STATISTICS_BINS);
+
+            statistics.resize(num_devices);
+            for (int device = 0; device < num_devices; device++)
+                statistics[device].reset(new StatisticsCounters(statistics_num_bins));
+
+            trace.resize(trace_capacity);
+            trace_next          = 0;
+            statistics_start    = std::chrono::steady_clock::now();
+        }
+
+        // Unlock
+        mutex.unlock();
+
+        return error;
+    }
+
+
+    /**
+     * \brief Reports the statistics of the specified device.
+     *
+     * Requires EnableStatistics().  The counters are read one by one, so a report
+     * taken while other threads allocate is not an atomic snapshot.
+     */
+    hipError_t GetStatistics(
+        int                 device,         ///< [in] Device ordinal (INVALID_DEVICE_ORDINAL for the current device)
+        DeviceStatistics    &stats)         ///< [out] Statistics of \p device
+    {
+        hipError_t error = hipSuccess;
+
+        if (device == INVALID_DEVICE_ORDINAL)
+        {
+            if (HipcubDebug(error = hipGetDevice(&device))) return error;
+        }
+        if ((device < 0) || (device >= (int) statistics.size())) return hipErrorInvalidValue;
+
+        StatisticsCounters &counters = *statistics[device];
+        stats.live_bytes            = counters.live_bytes.load();
+        stats.requested_bytes       = counters.requested_bytes.load();
+        stats.peak_live_bytes       = counters.peak_live_bytes.load();
+        stats.malloc_calls          = counters.malloc_calls.load();
+        stats.free_calls            = counters.free_calls.load();
+        stats.uncached_allocations  = counters.uncached_allocations.load();
+        stats.evicted_blocks        = counters.evicted_blocks.load();
+        stats.lock_wait_seconds     = counters.lock_wait_ns.load() * 1e-9;
+
+        stats.bins.clear();
+        for (unsigned int i = 0; i <= statistics_num_bins; i++)
+        {
+            BinStatistics bin;
+            bin.bin         = (i < statistics_num_bins) ? statistics_first_bin + i : INVALID_BIN;
+            bin.bin_bytes   = (i < statistics_num_bins) ? BinBytes(bin.bin) : 0;
+            bin.hits        = counters.hits[i].load();
+            bin.misses      = counters.misses[i].load();
+            if ((i < statistics_num_bins) || (bin.hits + bin.misses > 0))
+                stats.bins.push_back(bin);
+        }
+
+        if (num_shards != 0)
+        {
+            stats.cached_bytes = device_shards[device]->free_bytes.load();
+        }
+        else
+        {
+            mutex.lock();
+            GpuCachedBytes::iterator device_bytes = cached_bytes.find(device);
+            stats.cached_bytes = (device_bytes != cached_bytes.end()) ? device_bytes->second.free : 0;
+            mutex.unlock();
+        }
+
+        stats.slab_bytes        = 0;
+        stats.slab_free_bytes   = 0;
+        stats.slab_largest_free = 0;
+        if (device < (int) slab_heaps.size())
+        {
+            SlabHeap &heap = *slab_heaps[device];
+            heap.mutex.lock();
+            for (size_t i = 0; i < heap.slabs.size(); i++)
+            {
+                stats.slab_bytes += heap.slabs[i].bytes;
+                for (std::map<size_t, size_t>::iterator range = heap.slabs[i].free_ranges.begin(); range != heap.slabs[i].free_ranges.end(); ++range)
+                {
+                    stats.slab_free_bytes += range->second;
+                    if (range->second > stats.slab_largest_free) stats.slab_largest_free = range->second;
+                }
+            }
+            heap.mutex.unlock();
+        }
+
+        return error;
+    }
+
+
+    /**
+     * \brief Writes the trace to \p path as CSV, oldest event first.
+     *
+     * Requires EnableStatistics() with a nonzero trace capacity.
+     */
+    hipError_t DumpTrace(
+        const char *path)       ///< [in] Output file
+    {
+        static const char* const type_names[] = { "reuse", "allocate", "recache", "release", "hipMalloc", "hipFree" };
+
+        if (trace.empty()) return hipErrorInvalidValue;
+
+        FILE *file = fopen(path, "w");
+        if (file == NULL) return hipErrorInvalidValue;
+
+        fprintf(file, "timestamp_us,device,event,stream,ptr,bytes,requested_bytes\n");
+
+        trace_mutex.lock();
+        size_t count = (trace_next < trace.size()) ? trace_next : trace.size();
+        for (size_t i = trace_next - count; i < trace_next; i++)
+        {
+            const TraceEvent &event = trace[i % trace.size()];
+            fprintf(file, "%.3f,%d,%s,%p,%p,%lld,%lld\n",
+                event.timestamp_us, event.device, type_names[event.type], (void*) event.stream, event.d_ptr,
+                (long long) event.bytes, (long long) event.requested_bytes);
+        }
+        trace_mutex.unlock();
+
+        return (fclose(file) == 0) ? hipSuccess : hipErrorInvalidValue;
+    }
+
+
+    /**
+     * Locks \p lock, adding the time spent waiting for it to the statistics of \p device
+     */
+    void Lock(
+        std::mutex      &lock,
+        int             device)
+    {
+        if (lock.try_lock()) return;
+        if ((device < 0) || (device >= (int) statistics.size()))
+        {
+            lock.lock();
+            return;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        lock.lock();
+        statistics[device]->lock_wait_ns +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+
+    /**
+     * Appends an event to the trace, if enabled
+     */
+    void Trace(
+        TraceEventType  type,
+        int             device,
+        hipStream_t     stream,
+        void            *d_ptr,
+        size_t          bytes,
+        size_t          requested_bytes)
+    {
+        if (trace.empty()) return;
+
+        TraceEvent event;
+        event.timestamp_us      = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - statistics_start).count();
+        event.type              = type;
+        event.device            = device;
+        event.stream            = stream;
+        event.d_ptr             = d_ptr;
+        event.bytes             = bytes;
+        event.requested_bytes   = requested_bytes;
+
+        trace_mutex.lock();
+        trace[trace_next % trace.size()] = event;
+        trace_next++;
+        trace_mutex.unlock();
+    }
+
+
+    /**
+     * Accounts a successful DeviceAllocate of \p block, served from the cache if \p reused
+     */
+    void RecordAllocation(
+        const BlockDescriptor   &block,
+        bool                    reused)
+    {
+        Trace(reused ? TRACE_REUSE : TRACE_ALLOCATE, block.device, block.associated_stream, block.d_ptr, block.bytes, block.requested_bytes);
+        if ((block.device < 0) || (block.device >= (int) statistics.size())) return;
+
+        StatisticsCounters &counters = *statistics[block.device];
+        if ((block.bin == INVALID_BIN) || (block.bin == SLAB_BIN))
+        {
+            counters.uncached_allocations++;
+        }
+        else
+        {
+            unsigned int i = block.bin - statistics_first_bin;
+            i = (i < statistics_num_bins) ? i : statistics_num_bins;
+            if (reused) counters.hits[i]++;
+            else counters.misses[i]++;
+        }
+
+        counters.requested_bytes += block.requested_bytes;
+        size_t live_bytes = (counters.live_bytes += block.bytes);
+        size_t peak_live_bytes = counters.peak_live_bytes.load();
+        while ((live_bytes > peak_live_bytes) && !counters.peak_live_bytes.compare_exchange_weak(peak_live_bytes, live_bytes)) {}
+    }
+
+
+    /**
+     * Accounts a DeviceFree of \p block, kept for reuse if \p recached
+     */
+    void RecordFree(
+        const BlockDescriptor   &block,
+        bool                    recached)
+    {
+        Trace(recached ? TRACE_RECACHE : TRACE_RELEASE, block.device, block.associated_stream, block.d_ptr, block.bytes, block.requested_bytes);
+        if ((block.device < 0) || (block.device >= (int) statistics.size())) return;
+
+        StatisticsCounters &counters = *statistics[block.device];
+        counters.requested_bytes -= block.requested_bytes;
+        counters.live_bytes -= block.bytes;
+    }
+
+
+    /**
+     * hipMalloc, counted in the statistics of \p device if it succeeds
+     */
+    hipError_t DeviceMalloc(
+        int             device,
+        void            **d_ptr,
+        size_t          bytes)
+    {
+        hipError_t error = hipMalloc(d_ptr, bytes);
+        if ((error == hipSuccess) && (device < (int) statistics.size()))
+        {
+            statistics[device]->malloc_calls++;
+            Trace(TRACE_MALLOC, device, 0, *d_ptr, bytes, bytes);
+        }
+        return error;
+    }
+
+
+    /**
+     * hipFree, counted in the statistics of \p device
+     */
+    hipError_t DeviceRelease(
+        int             device,
+        void            *d_ptr,
+        size_t          bytes)
+    {
+        if (device < (int) statistics.size())
+        {
+            statistics[device]->free_calls++;
+            Trace(TRACE_HIP_FREE, device, 0, d_ptr, bytes, 0);
+        }
+        return hipFree(d_ptr);
+    }
+
+
+    /**
+     * Shard of \p stream in sharded mode
+     */
+    unsigned int ShardIndex(
+        hipStream_t stream) const
+    {
+        size_t key = reinterpret_cast<size_t>(stream);
+        key = (key >> 4) * 2654435761u;
+        return (unsigned int) ((key >> 8) % num_shards);
+    }
+
+
+    /**
+     * Inserts cached \p block into its bin of shard \p local, or of any shard
+     * with room.  Returns false if every shard's bin is full.
+     */
+    bool PushShards(
+        DeviceShards    &shards,
+        unsigned int    local,
+        BlockDescriptor *block)
+    {
+        for (unsigned int i = 0; i < num_shards; i++)
+        {
+            if (shards.Bin((local + i) % num_shards, block->bin).Push(block)) return true;
+        }
+        return false;
+    }
+
+
+    /**
+     * Takes a block from \p bin of shard \p shard that \p active_stream may reuse,
+     * or returns NULL.  Blocks that are still in use by another stream are skipped
+     * and put back; one that no shard has room for any more is released.
+     */
+    BlockDescriptor* PopReusable(
+        int             device,
+        unsigned int    shard,
+        unsigned int    bin,
+        hipStream_t     active_stream)
+    {
+        DeviceShards &shards = *device_shards[device];
+        ShardBin &shard_bin = shards.Bin(shard, bin);
+
+        unsigned int slot = 0;
+        BlockDescriptor *block;
+        while ((block = shard_bin.Pop(slot)) != NULL)
+        {
+            if ((active_stream == block->associated_stream) ||
+                (hipEventQuery(block->ready_event) != hipErrorNotReady))
+            {
+                return block;
+            }
+
+            // Still in use: put it back.  If other threads filled every slot in
+            // the meantime, release the block rather than waiting for it.
+            if (!PushShards(shards, shard, block))
+            {
+                shards.free_bytes -= block->bytes;
+                DeviceRelease(device, block->d_ptr, block->bytes);
+                hipEventDestroy(block->ready_event);
+
+                if (debug) _HipcubLog("\tDevice %d freed busy cached block at %p (%lld bytes), no shard has room for it.\n",
+                    device, block->d_ptr, (long long) block->bytes);
+
+                delete block;
+            }
+            slot++;
+        }
+        return NULL;
+    }
+
+
+    /**
+     * Frees the cached blocks of \p device in sharded mode.  The current device
+     * must already be \p device.
+     */
+    hipError_t FreeShardedCached(
+        int             device)
+    {
+        hipError_t error        = hipSuccess;
+        DeviceShards &shards    = *device_shards[device];
+
+        for (unsigned int i = 0; i < num_shards * shards.num_bins; i++)
+        {
+            unsigned int slot = 0;
+            BlockDescriptor *block;
+            while ((block = shards.bins[i].Pop(slot)) != NULL)
+            {
+                // Free device memory and destroy stream event.
+                if (HipcubDebug(error = DeviceRelease(device, block->d_ptr, block->bytes))) return error;
+                if (HipcubDebug(error = hipEventDestroy(block->ready_event))) return error;
+
+                shards.free_bytes -= block->bytes;
+
+                if (debug) _HipcubLog("\tDevice %d freed %lld bytes.\n\t\t  %lld bytes cached, %lld live bytes outstanding.\n",
+                    device, (long long) block->bytes, (long long) shards.free_bytes.load(), (long long) shards.live_bytes.load());
+
+                delete block;
+            }
+        }
+        return error;
+    }
+
+
+    /**
+     * DeviceAllocate in sharded mode.  \p device must be a valid device ordinal.
+     */
+    hipError_t ShardedAllocate(
+        int             device,
+        int             entrypoint_device,
+        void            **d_ptr,
+        size_t          bytes,
+        hipStream_t     active_stream)
+    {
+        hipError_t error = hipSuccess;
+
+        if ((device < 0) || (device >= (int) device_shards.size())) return hipErrorInvalidDevice;
+        DeviceShards &shards = *device_shards[device];
+
+        unsigned int bin;
+        size_t bin_bytes;
+        BinOf(bin, bin_bytes, bytes);
+        if ((bin != SLAB_BIN) && !shards.Caches(bin))
+        {
+            // Allocate the request exactly; it will not be cached when returned
+            bin         = INVALID_BIN;
+            bin_bytes   = bytes;
+        }
+
+        // Look in the local shard first and only then steal from the others
+        BlockDescriptor *block = NULL;
+        if ((bin != INVALID_BIN) && (bin != SLAB_BIN))
+        {
+            unsigned int local = ShardIndex(active_stream);
+            for (unsigned int i = 0; (i < num_shards) && (block == NULL); i++)
+                block = PopReusable(device, (local + i) % num_shards, bin, active_stream);
+        }
+
+        bool reused = (block != NULL);
+        if (reused)
+        {
+            if (debug) _HipcubLog("\tDevice %d reused cached block at %p (%lld bytes) for stream %lld (previously associated with stream %lld).\n",
+                device, block->d_ptr, (long long) block->bytes, (long long) active_stream, (long long) block->associated_stream);
+
+            block->associated_stream    = active_stream;
+            block->requested_bytes      = bytes;
+            shards.free_bytes -= block->bytes;
+        }
+        else
+        {
+            // Set runtime's current device to specified device (entrypoint may not be set)
+            if (device != entrypoint_device)
+            {
+                if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) return error;
+                if (HipcubDebug(error = hipSetDevice(device))) return error;
+            }
+
+            BlockDescriptor new_block(device);
+            new_block.bytes             = bin_bytes;
+            new_block.bin               = bin;
+            new_block.associated_stream = active_stream;
+            new_block.requested_bytes   = bytes;
+
+            // Attempt to allocate, evicting cached blocks while the device is out of memory
+            if (HipcubDebug(error = AllocateEvicting(device, new_block))) return error;
+
+            // Create ready event (blocks carved from a slab already have one)
+            if ((bin != SLAB_BIN) &&
+                HipcubDebug(error = hipEventCreateWithFlags(&new_block.ready_event, hipEventDisableTiming)))
+            {
+                DeviceRelease(device, new_block.d_ptr, new_block.bytes);
+                return error;
+            }
+
+            block = new BlockDescriptor(new_block);
+
+            if (debug) _HipcubLog("\tDevice %d allocated new device block at %p (%lld bytes associated with stream %lld).\n",
+                      device, block->d_ptr, (long long) block->bytes, (long long) active_stream);
+
+            // Attempt to revert back to previous device if necessary
+            if ((entrypoint_device != INVALID_DEVICE_ORDINAL) && (entrypoint_device != device))
+            {
+                if (HipcubDebug(error = hipSetDevice(entrypoint_device))) return error;
+            }
+        }
+
+        RecordAllocation(*block, reused);
+
+        // Insert into live blocks
+        shards.live_bytes += block->bytes;
+        LiveStripe &stripe = shards.Stripe(block->d_ptr);
+        Lock(stripe.mutex, device);
+        stripe.blocks[block->d_ptr] = block;
+        stripe.mutex.unlock();
+
+        *d_ptr = block->d_ptr;
+        return error;
+    }
+
+
+    /**
+     * DeviceFree in sharded mode.  \p device must be a valid device ordinal.
+     */
+    hipError_t ShardedFree(
+        int             device,
+        int             entrypoint_device,
+        void*           d_ptr)
+    {
+        hipError_t error = hipSuccess;
+
+        if ((device < 0) || (device >= (int) device_shards.size())) return hipErrorInvalidDevice;
+        DeviceShards &shards = *device_shards[device];
+
+        // Remove from live blocks
+        BlockDescriptor *block = NULL;
+        LiveStripe &stripe = shards.Stripe(d_ptr);
+        Lock(stripe.mutex, device);
+        std::unordered_map<void*, BlockDescriptor*>::iterator block_itr = stripe.blocks.find(d_ptr);
+        if (block_itr != stripe.blocks.end())
+        {
+            block = block_itr->second;
+            stripe.blocks.erase(block_itr);
+        }
+        stripe.mutex.unlock();
+
+        // The block may be reused by another thread as soon as it is recached
+        BlockDescriptor freed(d_ptr, device);
+        if (block != NULL) freed = *block;
+
+        // Keep the returned allocation if bin is valid and we won't exceed the max cached threshold
+        bool recached = false;
+        if (block != NULL)
+        {
+            shards.live_bytes -= block->bytes;
+            if ((block->bin != INVALID_BIN) && (block->bin != SLAB_BIN))
+            {
+                size_t free_bytes = shards.free_bytes.fetch_add(block->bytes);
+                recached = (free_bytes + block->bytes <= max_cached_bytes);
+                if (!recached) shards.free_bytes -= block->bytes;
+            }
+        }
+
+        // First set to specified device (entrypoint may not be set)
+        if (device != entrypoint_device)
+        {
+            if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) return error;
+            if (HipcubDebug(error = hipSetDevice(device))) return error;
+        }
+
+        if (recached)
+        {
+            // The event must be recorded before the block becomes visible to other threads
+            if (HipcubDebug(error = hipEventRecord(block->ready_event, block->associated_stream))) return error;
+
+            // Insert into the free-list of the associated stream's shard, or of any shard
+            // with room.  Once pushed, \p block may be popped and released by another
+            // thread, so only \p freed is read from here on.
+            recached = PushShards(shards, ShardIndex(freed.associated_stream), block);
+            if (!recached) shards.free_bytes -= freed.bytes;
+        }
+
+        if (block != NULL) RecordFree(freed, recached);
+
+        if (recached)
+        {
+            if (debug) _HipcubLog("\tDevice %d returned %lld bytes from associated stream %lld.\n\t\t %lld bytes cached, %lld live bytes outstanding.\n",
+                device, (long long) freed.bytes, (long long) freed.associated_stream,
+                (long long) shards.free_bytes.load(), (long long) shards.live_bytes.load());
+        }
+        else if ((block != NULL) && (block->bin == SLAB_BIN))
+        {
+            // Return the block to its slab
+            error = SlabFree(device, *block);
+            delete block;
+            if (HipcubDebug(error)) return error;
+        }
+        else
+        {
+            // Free the allocation from the runtime and cleanup the event.
+            if (HipcubDebug(error = DeviceRelease(device, d_ptr, (block != NULL) ? block->bytes : 0))) return error;
+            if (block != NULL)
+            {
+                if (HipcubDebug(error = hipEventDestroy(block->ready_event))) return error;
+
+                if (debug) _HipcubLog("\tDevice %d freed %lld bytes from associated stream %lld.\n\t\t  %lld bytes cached, %lld live bytes outstanding.\n",
+                    device, (long long) block->bytes, (long long) block->associated_stream,
+                    (long long) shards.free_bytes.load(), (long long) shards.live_bytes.load());
+
+                delete block;
+            }
+        }
+
+        // Reset device
+        if ((entrypoint_device != INVALID_DEVICE_ORDINAL) && (entrypoint_device != device))
+        {
+            if (HipcubDebug(error = hipSetDevice(entrypoint_device))) return error;
+        }
+
+        return error;
+    }
+
+
+    /**
+     * Returns [\p offset, \p offset + \p bytes) to the free ranges of \p slab,
+     * merging it with the adjacent free ranges
+     */
+    static void ReturnSlabRange(
+        Slab            &slab,
+        size_t          offset,
+        size_t          bytes)
+    {
+        slab.carved -= bytes;
+
+        std::map<size_t, size_t>::iterator next = slab.free_ranges.lower_bound(offset);
+        if ((next != slab.free_ranges.end()) && (offset + bytes == next->first))
+        {
+            bytes += next->second;
+            next = slab.free_ranges.erase(next);
+        }
+        if (next != slab.free_ranges.begin())
+        {
+            std::map<size_t, size_t>::iterator prev = next;
+            --prev;
+            if (prev->first + prev->second == offset)
+            {
+                prev->second += bytes;
+                return;
+            }
+        }
+        slab.free_ranges.insert(next, std::make_pair(offset, bytes));
+    }
+
+
+    /**
+     * Carves \p bytes out of the best fitting free range of \p heap.  Returns false
+     * if no free range is large enough.
+     */
+    static bool CarveSlabRange(
+        SlabHeap        &heap,
+        size_t          bytes,
+        void            **d_ptr)
+    {
+        Slab *best_slab = NULL;
+        std::map<size_t, size_t>::iterator best_range;
+        for (size_t i = 0; i < heap.slabs.size(); i++)
+        {
+            Slab &slab = heap.slabs[i];
+            for (std::map<size_t, size_t>::iterator range = slab.free_ranges.begin(); range != slab.free_ranges.end(); ++range)
+            {
+                if ((range->second >= bytes) && ((best_slab == NULL) || (range->second < best_range->second)))
+                {
+                    best_slab   = &slab;
+                    best_range  = range;
+                }
+            }
+        }
+        if (best_slab == NULL) return false;
+
+        size_t offset       = best_range->first;
+        size_t remainder    = best_range->second - bytes;
+        best_slab->free_ranges.erase(best_range);
+        if (remainder > 0)
+            best_slab->free_ranges[offset + bytes] = remainder;
+        best_slab->carved += bytes;
+
+        *d_ptr = best_slab->d_ptr + offset;
+        return true;
+    }
+
+
+    /**
+     * Returns the pending blocks of \p heap whose ready event has completed to
+     * their slabs.  With \p wait, waits for every pending block.
+     */
+    hipError_t ReclaimSlabBlocks(
+        SlabHeap        &heap,
+        bool            wait)
+    {
+        hipError_t error = hipSuccess;
+
+        size_t i = 0;
+        while (i < heap.pending.size())
+        {
+            BlockDescriptor &block = heap.pending[i];
+            if (wait)
+            {
+                if (HipcubDebug(error = hipEventSynchronize(block.ready_event))) return error;
+            }
+            else if (hipEventQuery(block.ready_event) == hipErrorNotReady)
+            {
+                i++;
+                continue;
+            }
+
+            for (size_t j = 0; j < heap.slabs.size(); j++)
+            {
+                char *d_slab = heap.slabs[j].d_ptr;
+                if ((static_cast<char*>(block.d_ptr) >= d_slab) && (static_cast<char*>(block.d_ptr) < d_slab + heap.slabs[j].bytes))
+                {
+                    ReturnSlabRange(heap.slabs[j], static_cast<char*>(block.d_ptr) - d_slab, block.bytes);
+                    break;
+                }
+            }
+            heap.events.push_back(block.ready_event);
+
+            heap.pending[i] = heap.pending.back();
+            heap.pending.pop_back();
+        }
+        return error;
+    }
+
+
+    /**
+     * Frees the empty slabs of \p heap beyond the first \p keep.  The current
+     * device must be \p device.
+     */
+    hipError_t ReleaseEmptySlabs(
+        SlabHeap        &heap,
+        int             device,
+        size_t          keep)
+    {
+        hipError_t error = hipSuccess;
+
+        size_t kept = 0;
+        size_t i = 0;
+        while (i < heap.slabs.size())
+        {
+            if ((heap.slabs[i].carved != 0) || (kept++ < keep))
+            {
+                i++;
+                continue;
+            }
+
+            if (HipcubDebug(error = DeviceRelease(device, heap.slabs[i].d_ptr, heap.slabs[i].bytes))) return error;
+
+            if (debug) _HipcubLog("\tDevice %d freed slab of %lld bytes.\n", device, (long long) heap.slabs[i].bytes);
+
+            heap.slabs.erase(heap.slabs.begin() + i);
+        }
+        return error;
+    }
+
+
+    /**
+     * Carves \p block out of a slab of \p device, giving it a ready event.
+     * The current device must be \p device.
+     */
+    hipError_t SlabAllocate(
+        int             device,
+        BlockDescriptor &block)
+    {
+        hipError_t error    = hipSuccess;
+        SlabHeap &heap      = *slab_heaps[device];
+
+        // Lock
+        Lock(heap.mutex, device);
+
+        // A pending block of the same stream and size is reused right away
+        for (size_t i = 0; i < heap.pending.size(); i++)
+        {
+            if ((heap.pending[i].associated_stream == block.associated_stream) && (heap.pending[i].bytes == block.bytes))
+            {
+                block.d_ptr         = heap.pending[i].d_ptr;
+                block.ready_event   = heap.pending[i].ready_event;
+                heap.pending[i]     = heap.pending.back();
+                heap.pending.pop_back();
+
+                heap.mutex.unlock();
+                return error;
+            }
+        }
+
+        hipEvent_t ready_event = NULL;
+        if (!heap.events.empty())
+        {
+            ready_event = heap.events.back();
+            heap.events.pop_back();
+        }
+        else
+        {
+            error = hipEventCreateWithFlags(&ready_event, hipEventDisableTiming);
+        }
+
+        if ((error == hipSuccess) &&
+            ((error = ReclaimSlabBlocks(heap, false)) == hipSuccess) &&
+            !CarveSlabRange(heap, block.bytes, &block.d_ptr))
+        {
+            // Start a new slab
+            Slab slab;
+            slab.bytes  = (block.bytes > slab_bytes) ? block.bytes : slab_bytes;
+            slab.carved = 0;
+            if (HipcubDebug(error = DeviceMalloc(device, (void**) &slab.d_ptr, slab.bytes)) == hipErrorMemoryAllocation)
+            {
+                // Wait for the pending blocks and give back the empty slabs before retrying
+                error = hipGetLastError();     // Reset error
+                if (!HipcubDebug(error = ReclaimSlabBlocks(heap, true)) &&
+                    !HipcubDebug(error = ReleaseEmptySlabs(heap, device, 0)) &&
+                    !CarveSlabRange(heap, block.bytes, &block.d_ptr))
+                {
+                    error = DeviceMalloc(device, (void**) &slab.d_ptr, slab.bytes);
+                }
+            }
+
+            if ((error == hipSuccess) && (block.d_ptr == NULL))
+            {
+                if (debug) _HipcubLog("\tDevice %d allocated new slab at %p (%lld bytes).\n",
+                    device, slab.d_ptr, (long long) slab.bytes);
+
+                slab.free_ranges[0] = slab.bytes;
+                heap.slabs.push_back(slab);
+                CarveSlabRange(heap, block.bytes, &block.d_ptr);
+            }
+        }
+
+        if (error == hipSuccess)
+            block.ready_event = ready_event;
+        else if (ready_event != NULL)
+            heap.events.push_back(ready_event);
+
+        // Unlock
+        heap.mutex.unlock();
+
+        return error;
+    }
+
+
+    /**
+     * Returns \p block to its slab once all work submitted to its associated
+     * stream so far has completed.  The current device must be \p device.
+     */
+    hipError_t SlabFree(
+        int                     device,
+        const BlockDescriptor   &block)
+    {
+        hipError_t error    = hipSuccess;
+        SlabHeap &heap      = *slab_heaps[device];
+
+        // Lock
+        Lock(heap.mutex, device);
+
+        if (!HipcubDebug(error = hipEventRecord(block.ready_event, block.associated_stream)))
+        {
+            heap.pending.push_back(block);
+            if (!HipcubDebug(error = ReclaimSlabBlocks(heap, false)))
+                error = ReleaseEmptySlabs(heap, device, 1);
+        }
+
+        // Unlock
+        heap.mutex.unlock();
+
+        return error;
+    }
+
+
+    /**
+     * Chooses the \p candidates to evict to free at least \p bytes: the smallest
+     * block that covers them on its own, or else the largest block and then the
+     * same for the rest.  Blocks whose ready event has completed are considered
+     * before the others.
+     */
+    static void SelectEvictions(
+        std::vector<EvictionCandidate>  &candidates,
+        size_t                          bytes)
+    {
+        for (int pass = 0; pass < 2; pass++)
+        {
+            while (true)
+            {
+                EvictionCandidate *covering = NULL;
+                EvictionCandidate *largest  = NULL;
+                for (size_t i = 0; i < candidates.size(); i++)
+                {
+                    EvictionCandidate &candidate = candidates[i];
+                    if (candidate.evict || (!candidate.ready && (pass == 0))) continue;
+
+                    if ((candidate.bytes >= bytes) && ((covering == NULL) || (candidate.bytes < covering->bytes)))
+                        covering = &candidate;
+                    if ((largest == NULL) || (candidate.bytes > largest->bytes))
+                        largest = &candidate;
+                }
+
+                if (covering != NULL)
+                {
+                    covering->evict = true;
+                    return;
+                }
+                if (largest == NULL) break;
+
+                largest->evict = true;
+                bytes -= largest->bytes;
+            }
+        }
+    }
+
+
+    /**
+     * Evicts cached blocks of \p device to free at least \p bytes (or every cached
+     * block for \p INVALID_SIZE), adding the number of bytes freed to \p evicted_bytes.
+     * Empty slabs are released first.  The current device must be \p device.
+     */
+    hipError_t EvictCached(
+        int             device,
+        size_t          bytes,
+        size_t          &evicted_bytes)
+    {
+        hipError_t error = hipSuccess;
+        size_t evicted_blocks = 0;
+
+        if (device < (int) slab_heaps.size())
+        {
+            SlabHeap &heap = *slab_heaps[device];
+            Lock(heap.mutex, device);
+            size_t released_slab_bytes = 0;
+            for (size_t i = 0; i < heap.slabs.size(); i++) released_slab_bytes += heap.slabs[i].bytes;
+            if (!HipcubDebug(error = ReclaimSlabBlocks(heap, false)))
+                error = ReleaseEmptySlabs(heap, device, 0);
+            for (size_t i = 0; i < heap.slabs.size(); i++) released_slab_bytes -= heap.slabs[i].bytes;
+            heap.mutex.unlock();
+
+            if (error) return error;
+            evicted_bytes += released_slab_bytes;
+            bytes = (released_slab_bytes < bytes) ? bytes - released_slab_bytes : 0;
+            if (bytes == 0) return error;
+        }
+
+        std::vector<EvictionCandidate> candidates;
+        if (num_shards != 0)
+        {
+            // Take every cached block of the device and put back the ones that stay
+            // before freeing any, so that concurrent allocations miss the cache only
+            // while the victims are chosen
+            DeviceShards &shards = *device_shards[device];
+            std::vector<BlockDescriptor*> blocks;
+            for (unsigned int i = 0; i < num_shards * shards.num_bins; i++)
+            {
+                unsigned int slot = 0;
+                BlockDescriptor *block;
+                while ((block = shards.bins[i].Pop(slot)) != NULL)
+                {
+                    EvictionCandidate candidate = { block->bytes, hipEventQuery(block->ready_event) != hipErrorNotReady, false };
+                    candidates.push_back(candidate);
+                    blocks.push_back(block);
+                }
+            }
+            SelectEvictions(candidates, bytes);
+
+            // Blocks that no shard has room for any more are evicted as well
+            size_t num_victims = 0;
+            for (size_t i = 0; i < blocks.size(); i++)
+            {
+                BlockDescriptor *block = blocks[i];
+                if (!candidates[i].evict && PushShards(shards, ShardIndex(block->associated_stream), block)) continue;
+                blocks[num_victims++] = block;
+            }
+
+            for (size_t i = 0; i < num_victims; i++)
+            {
+                BlockDescriptor *block = blocks[i];
+
+                // Free device memory and destroy stream event.  After an error the
+                // remaining victims stay cached, or are freed if there is no room.
+                if (error || HipcubDebug(error = DeviceRelease(device, block->d_ptr, block->bytes)))
+                {
+                    if (PushShards(shards, ShardIndex(block->associated_stream), block)) continue;
+                    DeviceRelease(device, block->d_ptr, block->bytes);
+                    hipEventDestroy(block->ready_event);
+                }
+                else
+                {
+                    HipcubDebug(error = hipEventDestroy(block->ready_event));
+                }
+
+                shards.free_bytes -= block->bytes;
+                evicted_bytes += block->bytes;
+                evicted_blocks++;
+
+                if (debug) _HipcubLog("\tDevice %d evicted %lld bytes.\n\t\t  %lld bytes cached, %lld live bytes outstanding.\n",
+                    device, (long long) block->bytes, (long long) shards.free_bytes.load(), (long long) shards.live_bytes.load());
+
+                delete block;
+            }
+        }
+        else
+        {
+            // Lock
+            Lock(mutex, device);
+
+            // Iterate the range of free blocks on the same device
+            std::vector<CachedBlocks::iterator> blocks;
+            BlockDescriptor free_key(device);
+            for (CachedBlocks::iterator block_itr = cached_blocks.lower_bound(free_key);
+                 (block_itr != cached_blocks.end()) && (block_itr->device == device);
+                 ++block_itr)
+            {
+                EvictionCandidate candidate = { block_itr->bytes, hipEventQuery(block_itr->ready_event) != hipErrorNotReady, false };
+                candidates.push_back(candidate);
+                blocks.push_back(block_itr);
+            }
+            SelectEvictions(candidates, bytes);
+
+            for (size_t i = 0; (i < blocks.size()) && !error; i++)
+            {
+                if (!candidates[i].evict) continue;
+
+                // No need to worry about synchronization with the device: hipFree is
+                // blocking and will synchronize across all kernels executing
+                // on the current device
+
+                // Free device memory and destroy stream event.
+                if (HipcubDebug(error = DeviceRelease(device, blocks[i]->d_ptr, blocks[i]->bytes))) break;
+                if (HipcubDebug(error = hipEventDestroy(blocks[i]->ready_event))) break;
+
+                // Reduce balance and erase entry
+                cached_bytes[device].free -= blocks[i]->bytes;
+                evicted_bytes += blocks[i]->bytes;
+                evicted_blocks++;
+
+                if (debug) _HipcubLog("\tDevice %d evicted %lld bytes.\n\t\t  %lld available blocks cached (%lld bytes), %lld live blocks (%lld bytes) outstanding.\n",
+                    device, (long long) blocks[i]->bytes, (long long) cached_blocks.size() - 1, (long long) cached_bytes[device].free, (long long) live_blocks.size(), (long long) cached_bytes[device].live);
+
+                cached_blocks.erase(blocks[i]);
+            }
+
+            // Unlock
+            mutex.unlock();
+        }
+
+        if (device < (int) statistics.size())
+            statistics[device]->evicted_blocks += evicted_blocks;
+
+        return error;
+    }
+
+
+    /**
+     * Allocates device memory for \p block, evicting cached blocks of \p device
+     * according to \p eviction_policy while the device is out of memory, and
+     * calling \p eviction_callback once nothing is left to evict.  The current
+     * device must be \p device.
+     */
+    hipError_t AllocateEvicting(
+        int             device,
+        BlockDescriptor &block)
+    {
+        hipError_t error = AllocateBlock(device, block);
+        while (error == hipErrorMemoryAllocation)
+        {
+            if (debug) _HipcubLog("\tDevice %d failed to allocate %lld bytes for stream %lld, retrying after evicting cached allocations\n",
+                  device, (long long) block.bytes, (long long) block.associated_stream);
+
+            error = hipGetLastError();     // Reset error
+
+            // Under EVICT_MINIMAL only evict what the runtime reports to be missing
+            size_t evict_bytes = INVALID_SIZE;
+            if (eviction_policy == EVICT_MINIMAL)
+            {
+                size_t free_memory  = 0;
+                size_t total_memory = 0;
+                evict_bytes = block.bytes;
+                if ((hipMemGetInfo(&free_memory, &total_memory) == hipSuccess) && (free_memory < block.bytes))
+                    evict_bytes = block.bytes - free_memory;
+            }
+
+            size_t evicted_bytes = 0;
+            if (HipcubDebug(error = EvictCached(device, evict_bytes, evicted_bytes))) return error;
+
+            if ((evicted_bytes == 0) &&
+                ((eviction_callback == NULL) || !eviction_callback(device, block.bytes, eviction_user_data)))
+            {
+                return hipErrorMemoryAllocation;
+            }
+
+            error = AllocateBlock(device, block);
+        }
+        return error;
+    }
+
+
+    /**
+     * Allocates device memory for \p block, carving it from a slab for \p SLAB_BIN.
+     * The current device must be \p device.
+     */
+    hipError_t AllocateBlock(
+        int             device,
+        BlockDescriptor &block)
+    {
+        if (block.bin == SLAB_BIN)
+            return SlabAllocate(device, block);
+        return DeviceMalloc(device, &block.d_ptr, block.bytes);
+    }
+
+
+    /**
+     * \brief Provides a suitable allocation of device memory for the given size on the specified device.
+     *
+     * Once freed, the allocation becomes available immediately for reuse within the \p active_stream
+     * with which it was associated with during allocation, and it becomes available for reuse within other
+     * streams when all prior work submitted to \p active_stream has completed.
+     */
+    hipError_t DeviceAllocate(
+        int             device,             ///< [in] Device on which to place the allocation
+        void            **d_ptr,            ///< [out] Reference to pointer to the allocation
+        size_t          bytes,              ///< [in] Minimum number of bytes for the allocation
+        hipStream_t     active_stream = 0)  ///< [in] The stream to be associated with this allocation
+    {
+        *d_ptr                          = NULL;
+        int entrypoint_device           = INVALID_DEVICE_ORDINAL;
+        hipError_t error                = hipSuccess;
+
+        if (device == INVALID_DEVICE_ORDINAL)
+        {
+            if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) return error;
+            device = entrypoint_device;
+        }
+
+        if (num_shards != 0)
+            return ShardedAllocate(device, entrypoint_device, d_ptr, bytes, active_stream);
+
+        // Create a block descriptor for the requested allocation
+        bool found = false;
+        BlockDescriptor search_key(device);
+        search_key.associated_stream = active_stream;
+        search_key.requested_bytes = bytes;
+        BinOf(search_key.bin, search_key.bytes, bytes);
+
+        // Requests beyond the maximum bin are allocated exactly (or carved from
+        // a slab) and are not cached for reuse when returned
+        if ((search_key.bin != INVALID_BIN) && (search_key.bin != SLAB_BIN))
+        {
+            // Search for a suitable cached allocation: lock
+            Lock(mutex, device);
+
+            // Iterate through the range of cached blocks on the same device in the same bin
+            CachedBlocks::iterator block_itr = cached_blocks.lower_bound(search_key);
+            while ((block_itr != cached_blocks.end())
+                    && (block_itr->device == device)
+                    && (block_itr->bin == search_key.bin))
+            {
+                // To prevent races with reusing blocks returned by the host but still
+                // in use by the device, only consider cached blocks that are
+                // either (from the active stream) or (from an idle stream)
+                if ((active_stream == block_itr->associated_stream) ||
+                    (hipEventQuery(block_itr->ready_event) != hipErrorNotReady))
+                {
+                    // Reuse existing cache block.  Insert into live blocks.
+                    found = true;
+                    search_key = *block_itr;
+                    search_key.associated_stream = active_stream;
+                    search_key.requested_bytes = bytes;
+                    live_blocks.insert(search_key);
+
+                    // Remove from free blocks
+                    cached_bytes[device].free -= search_key.bytes;
+                    cached_bytes[device].live += search_key.bytes;
+
+                    if (debug) _HipcubLog("\tDevice %d reused cached block at %p (%lld bytes) for stream %lld (previously associated with stream %lld).\n",
+                        device, search_key.d_ptr, (long long) search_key.bytes, (long long) search_key.associated_stream, (long long)  block_itr->associated_stream);
+
+                    cached_blocks.erase(block_itr);
+
+                    break;
+                }
+                block_itr++;
+            }
+
+            // Done searching: unlock
+            mutex.unlock();
+        }
+
+        // Allocate the block if necessary
+        if (!found)
+        {
+            // Set runtime's current device to specified device (entrypoint may not be set)
+            if (device != entrypoint_device)
+            {
+                if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) return error;
+                if (HipcubDebug(error = hipSetDevice(device))) return error;
+            }
+
+            // Attempt to allocate, evicting cached blocks while the device is out of memory
+            if (HipcubDebug(error = AllocateEvicting(device, search_key))) return error;
+
+            // Create ready event (blocks carved from a slab already have one)
+            if ((search_key.bin != SLAB_BIN) &&
+                HipcubDebug(error = hipEventCreateWithFlags(&search_key.ready_event, hipEventDisableTiming)))
+                return error;
+
+            // Insert into live blocks
+            Lock(mutex, device);
+            live_blocks.insert(search_key);
+            cached_bytes[device].live += search_key.bytes;
+            mutex.unlock();
+
+            if (debug) _HipcubLog("\tDevice %d allocated new device block at %p (%lld bytes associated with stream %lld).\n",
+                      device, search_key.d_ptr, (long long) search_key.bytes, (long long) search_key.associated_stream);
+
+            // Attempt to revert back to previous device if necessary
+            if ((entrypoint_device != INVALID_DEVICE_ORDINAL) && (entrypoint_device != device))
+            {
+                if (HipcubDebug(error = hipSetDevice(entrypoint_device))) return error;
+            }
+        }
+
+        RecordAllocation(search_key, found);
+
+        // Copy device pointer to output parameter
+        *d_ptr = search_key.d_ptr;
+
+        if (debug) _HipcubLog("\t\t%lld available blocks cached (%lld bytes), %lld live blocks outstanding(%lld bytes).\n",
+            (long long) cached_blocks.size(), (long long) cached_bytes[device].free, (long long) live_blocks.size(), (long long) cached_bytes[device].live);
+
+        return error;
+    }
+
+
+    /**
+     * \brief Provides a suitable allocation of device memory for the given size on the current device.
+     *
+     * Once freed, the allocation becomes available immediately for reuse within the \p active_stream
+     * with which it was associated with during allocation, and it becomes available for reuse within other
+     * streams when all prior work submitted to \p active_stream has completed.
+     */
+    hipError_t DeviceAllocate(
+        void            **d_ptr,            ///< [out] Reference to pointer to the allocation
+        size_t          bytes,              ///< [in] Minimum number of bytes for the allocation
+        hipStream_t     active_stream = 0)  ///< [in] The stream to be associated with this allocation
+    {
+        return DeviceAllocate(INVALID_DEVICE_ORDINAL, d_ptr, bytes, active_stream);
+    }
+
+
+    /**
+     * \brief Frees a live allocation of device memory on the specified device, returning it to the allocator.
+     *
+     * Once freed, the allocation becomes available immediately for reuse within the \p active_stream
+     * with which it was associated with during allocation, and it becomes available for reuse within other
+     * streams when all prior work submitted to \p active_stream has completed.
+     */
+    hipError_t DeviceFree(
+        int             device,
+        void*           d_ptr)
+    {
+        int entrypoint_device           = INVALID_DEVICE_ORDINAL;
+        hipError_t error                = hipSuccess;
+
+        if (device == INVALID_DEVICE_ORDINAL)
+        {
+            if (HipcubDebug(error = hipGetDevice(&entrypoint_device)))
+                return error;
+            device = entrypoint_device;
+        }
+
+        if (num_shards != 0)
+            return ShardedFree(device, entrypoint_device, d_ptr);
+
+        // Lock
+        Lock(mutex, device);
+
+        // Find corresponding block descriptor
+        bool recached = false;
+        BlockDescriptor search_key(d_ptr, device);
+        BusyBlocks::iterator block_itr = live_blocks.find(search_key);
+        if (block_itr != live_blocks.end())
+        {
+            // Remove from live blocks
+            search_key = *block_itr;
+            live_blocks.erase(block_itr);
+            cached_bytes[device].live -= search_key.bytes;
+
+            // Keep the returned allocation if bin is valid and we won't exceed the max cached threshold
+            if ((search_key.bin != INVALID_BIN) && (search_key.bin != SLAB_BIN) &&
+                (cached_bytes[device].free + search_key.bytes <= max_cached_bytes))
+            {
+                // Insert returned allocation into free blocks
+                recached = true;
+                cached_blocks.insert(search_key);
+                cached_bytes[device].free += search_key.bytes;
+
+                if (debug) _HipcubLog("\tDevice %d returned %lld bytes from associated stream %lld.\n\t\t %lld available blocks cached (%lld bytes), %lld live blocks outstanding. (%lld bytes)\n",
+                    device, (long long) search_key.bytes, (long long) search_key.associated_stream, (long long) cached_blocks.size(),
+                    (long long) cached_bytes[device].free, (long long) live_blocks.size(), (long long) cached_bytes[device].live);
+            }
+
+            RecordFree(search_key, recached);
+        }
+
+        // First set to specified device (entrypoint may not be set)
+        if (device != entrypoint_device)
+        {
+            if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) return error;
+            if (HipcubDebug(error = hipSetDevice(device))) return error;
+        }
+
+        if (recached)
+        {
+            // Insert the ready event in the associated stream (must have current device set properly)
+            if (HipcubDebug(error = hipEventRecord(search_key.ready_event, search_key.associated_stream))) return error;
+        }
+
+        // Unlock
+        mutex.unlock();
+
+        if (search_key.bin == SLAB_BIN)
+        {
+            // Return the block to its slab
+            if (HipcubDebug(error = SlabFree(device, search_key))) return error;
+        }
+        else if (!recached)
+        {
+            // Free the allocation from the runtime and cleanup the event.
+            if (HipcubDebug(error = DeviceRelease(device, d_ptr, search_key.bytes))) return error;
+            if (HipcubDebug(error = hipEventDestroy(search_key.ready_event))) return error;
+
+            if (debug) _HipcubLog("\tDevice %d freed %lld bytes from associated stream %lld.\n\t\t  %lld available blocks cached (%lld bytes), %lld live blocks (%lld bytes) outstanding.\n",
+                device, (long long) search_key.bytes, (long long) search_key.associated_stream, (long long) cached_blocks.size(), (long long) cached_bytes[device].free, (long long) live_blocks.size(), (long long) cached_bytes[device].live);
+        }
+
+        // Reset device
+        if ((entrypoint_device != INVALID_DEVICE_ORDINAL) && (entrypoint_device != device))
+        {
+            if (HipcubDebug(error = hipSetDevice(entrypoint_device))) return error;
+        }
+
+        return error;
+    }
+
+
+    /**
+     * \brief Frees a live allocation of device memory on the current device, returning it to the allocator.
+     *
+     * Once freed, the allocation becomes available immediately for reuse within the \p active_stream
+     * with which it was associated with during allocation, and it becomes available for reuse within other
+     * streams when all prior work submitted to \p active_stream has completed.
+     */
+    hipError_t DeviceFree(
+        void*           d_ptr)
+    {
+        return DeviceFree(INVALID_DEVICE_ORDINAL, d_ptr);
+    }
+
+
+    /**
+     * \brief Frees all cached device allocations on all devices
+     */
+    hipError_t FreeAllCached()
+    {
+        hipError_t error          = hipSuccess;
+        int entrypoint_device     = INVALID_DEVICE_ORDINAL;
+        int current_device        = INVALID_DEVICE_ORDINAL;
+
+        mutex.lock();
+
+        while (!cached_blocks.empty())
+        {
+            // Get first block
+            CachedBlocks::iterator begin = cached_blocks.begin();
+
+            // Get entry-point device ordinal if necessary
+            if (entrypoint_device == INVALID_DEVICE_ORDINAL)
+            {
+                if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) break;
+            }
+
+            // Set current device ordinal if necessary
+            if (begin->device != current_device)
+            {
+                if (HipcubDebug(error = hipSetDevice(begin->device))) break;
+                current_device = begin->device;
+            }
+
+            // Free device memory
+            if (HipcubDebug(error = DeviceRelease(current_device, begin->d_ptr, begin->bytes))) break;
+            if (HipcubDebug(error = hipEventDestroy(begin->ready_event))) break;
+
+            // Reduce balance and erase entry
+            cached_bytes[current_device].free -= begin->bytes;
+
+            if (debug) _HipcubLog("\tDevice %d freed %lld bytes.\n\t\t  %lld available blocks cached (%lld bytes), %lld live blocks (%lld bytes) outstanding.\n",
+                current_device, (long long) begin->bytes, (long long) cached_blocks.size(), (long long) cached_bytes[current_device].free, (long long) live_blocks.size(), (long long) cached_bytes[current_device].live);
+
+            cached_blocks.erase(begin);
+        }
+
+        mutex.unlock();
+
+        // Free the cached blocks of every device in sharded mode
+        for (int device = 0; (error == hipSuccess) && (device < (int) device_shards.size()); device++)
+        {
+            if (entrypoint_device == INVALID_DEVICE_ORDINAL)
+            {
+                if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) break;
+            }
+            if (HipcubDebug(error = hipSetDevice(device))) break;
+            error = FreeShardedCached(device);
+        }
+
+        // Give back the empty slabs of every device
+        for (int device = 0; (error == hipSuccess) && (device < (int) slab_heaps.size()); device++)
+        {
+            if (entrypoint_device == INVALID_DEVICE_ORDINAL)
+            {
+                if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) break;
+            }
+            if (HipcubDebug(error = hipSetDevice(device))) break;
+
+            SlabHeap &heap = *slab_heaps[device];
+            heap.mutex.lock();
+            if (!HipcubDebug(error = ReclaimSlabBlocks(heap, true)))
+                error = ReleaseEmptySlabs(heap, device, 0);
+            while ((error == hipSuccess) && !heap.events.empty())
+            {
+                error = hipEventDestroy(heap.events.back());
+                heap.events.pop_back();
+            }
+            heap.mutex.unlock();
+        }
+
+        // Attempt to revert back to entry-point device if necessary
+        if (entrypoint_device != INVALID_DEVICE_ORDINAL)
+        {
+            if (HipcubDebug(error = hipSetDevice(entrypoint_device))) return error;
+        }
+
+        return error;
+    }
+
+
+    /**
+     * \brief Destructor
+     */
+    virtual ~CachingDeviceAllocator()
+    {
+        if (!skip_cleanup)
+            FreeAllCached();
+    }
+
+};
+
+
+/**
+ * \brief A device allocator backed by the stream-ordered memory pools of the HIP runtime.
+ *
+ * \par Overview
+ * PoolDeviceAllocator has the \p DeviceAllocate / \p DeviceFree interface of
+ * CachingDeviceAllocator, so either can be used wherever temporary storage is
+ * allocated.  Allocations are served by \p hipMallocFromPoolAsync from a memory
+ * pool the allocator creates for each device and returned with \p hipFreeAsync on
+ * the stream they were associated with, so reuse is ordered by the runtime rather
+ * than by recording and polling an event per block.
+ *
+ * \par
+ * - Freed memory stays reserved by the pool until the pool holds more than
+ *   \p release_threshold bytes at a synchronization point, after which the
+ *   excess is returned to the system.  The default threshold keeps all memory
+ *   reserved, like an unbounded CachingDeviceAllocator.
+ * - The pools are private to the allocator: the default pool of the device, and
+ *   with it every other library that allocates from it, is left untouched.
+ *   Memory reserved by one pool is not available to the others, so keep the
+ *   number of allocators, and the memory each keeps reserved, in check.
+ * - Devices without memory pool support, and builds against HIP versions without
+ *   stream-ordered allocation, are served by the CachingDeviceAllocator
+ *   \p fallback instead.  Setting \p force_fallback routes every device to it,
+ *   which allows both implementations to be compared in the same binary.
+ *
+ */
+struct PoolDeviceAllocator
+{
+    //---------------------------------------------------------------------
+    // Constants
+    //---------------------------------------------------------------------
+
+    /// Invalid size
+    static const size_t INVALID_SIZE = (size_t) -1;
+
+    /// Invalid device ordinal
+    static const int INVALID_DEVICE_ORDINAL = -1;
+
+    //---------------------------------------------------------------------
+    // Type definitions and helper types
+    //---------------------------------------------------------------------
+
+    /**
+     * Stream and device of a live pool allocation
+     */
+    struct LiveAllocation
+    {
+        int         device;
+        hipStream_t associated_stream;
+    };
+
+    /// Map type of live pool allocations
+    typedef std::unordered_map<void*, LiveAllocation> LiveAllocations;
+
+    //---------------------------------------------------------------------
+    // Fields
+    //---------------------------------------------------------------------
+
+    std::mutex      mutex;              /// Mutex for thread-safety
+    size_t          release_threshold;  /// Bytes each pool keeps reserved at synchronization points
+    const bool      force_fallback;     /// Whether or not to serve every device by the fallback allocator
+    const bool      skip_cleanup;       /// Whether or not to skip a call to FreeAllCached() when destructor is called
+    bool            debug;              /// Whether or not to print (de)allocation events to stdout
+
+    std::vector<int> pool_support;      /// Per-device memory pool support (-1 until queried), indexed by device ordinal
+#ifdef HIPCUB_STREAM_ORDERED_ALLOCATION
+    std::vector<hipMemPool_t> pools;    /// Per-device memory pools created by the allocator, indexed by device ordinal
+#endif
+    LiveAllocations live_allocations;   /// Live allocations served by a memory pool
+    CachingDeviceAllocator fallback;    /// Allocator for devices without memory pool support
+
+    //---------------------------------------------------------------------
+    // Methods
+    //---------------------------------------------------------------------
+
+    /**
+     * \brief Constructor.
+     */
+    PoolDeviceAllocator(
+        size_t  release_threshold   = INVALID_SIZE,     ///< Bytes each pool keeps reserved at synchronization points (default is to keep everything)
+        bool    force_fallback      = false,            ///< Whether or not to serve every device by the fallback allocator (default is to use memory pools where supported)
+        bool    skip_cleanup        = false,            ///< Whether or not to skip a call to \p FreeAllCached() when the destructor is called (default is to deallocate)
+        bool    debug               = false)            ///< Whether or not to print (de)allocation events to stdout (default is no stderr output)
+    :
+        release_threshold(release_threshold),
+        force_fallback(force_fallback),
+        skip_cleanup(skip_cleanup),
+        debug(debug),
+        fallback(skip_cleanup, debug)
+    {}
+
+
+    /**
+     * \brief Sets the number of bytes each pool keeps reserved at synchronization points.
+     *
+     * Applies to the pools of all devices, including those already in use.  Does not
+     * affect devices served by the fallback allocator (see CachingDeviceAllocator::SetMaxCachedBytes()).
+     */
+    hipError_t SetReleaseThreshold(
+        size_t release_threshold)
+    {
+        hipError_t error = hipSuccess;
+
+        mutex.lock();
+
+        if (debug) _HipcubLog("Changing release_threshold (%lld -> %lld)\n", (long long) this->release_threshold, (long long) release_threshold);
+
+        this->release_threshold = release_threshold;
+
+#ifdef HIPCUB_STREAM_ORDERED_ALLOCATION
+        for (size_t device = 0; device < pools.size(); ++device)
+        {
+            if (pool_support[device] != 1)
+                continue;
+            uint64_t threshold = release_threshold;
+            if (HipcubDebug(error = hipMemPoolSetAttribute(pools[device], hipMemPoolAttrReleaseThreshold, &threshold))) break;
+        }
+#endif
+
+        mutex.unlock();
+
+        return error;
+    }
+
+
+    /**
+     * \brief Determines whether allocations on \p device are served by its memory pool.
+     *
+     * Creates the device's pool the first time a device is seen.
+     */
+    hipError_t UsesPool(
+        int     device,             ///< [in] Device ordinal
+        bool    &uses_pool)         ///< [out] Whether or not the device is served by its memory pool
+    {
+        hipError_t error = hipSuccess;
+        uses_pool = false;
+
+        if (force_fallback)
+            return error;
+
+#ifdef HIPCUB_STREAM_ORDERED_ALLOCATION
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (device >= (int) pool_support.size())
+        {
+            pool_support.resize(device + 1, -1);
+            pools.resize(device + 1, NULL);
+        }
+
+        if (pool_support[device] == -1)
+        {
+            int supported = 0;
+            if (HipcubDebug(error = hipDeviceGetAttribute(&supported, hipDeviceAttributeMemoryPoolsSupported, device))) return error;
+
+            if (supported)
+            {
+                hipMemPoolProps pool_props  = {};
+                pool_props.allocType        = hipMemAllocationTypePinned;
+                pool_props.handleTypes      = hipMemHandleTypeNone;
+                pool_props.location.type    = hipMemLocationTypeDevice;
+                pool_props.location.id      = device;
+
+                uint64_t threshold = release_threshold;
+                if (HipcubDebug(error = hipMemPoolCreate(&pools[device], &pool_props))) return error;
+                if (HipcubDebug(error = hipMemPoolSetAttribute(pools[device], hipMemPoolAttrReleaseThreshold, &threshold)))
+                {
+                    hipMemPoolDestroy(pools[device]);
+                    pools[device] = NULL;
+                    return error;
+                }
+            }
+            pool_support[device] = supported ? 1 : 0;
+
+            if (debug) _HipcubLog("Device %d is served by %s\n", device, supported ? "its memory pool" : "the fallback allocator");
+        }
+
+        uses_pool = (pool_support[device] == 1);
+#else
+        (void) device;
+#endif
+        return error;
+    }
+
+
+    /**
+     * \brief Provides a suitable allocation of device memory for the given size on the specified device.
+     *
+     * The allocation is ordered after all prior work submitted to \p active_stream.
+     */
+    hipError_t DeviceAllocate(
+        int             device,             ///< [in] Device on which to place the allocation
+        void            **d_ptr,            ///< [out] Reference to pointer to the allocation
+        size_t          bytes,              ///< [in] Minimum number of bytes for the allocation
+        hipStream_t     active_stream = 0)  ///< [in] The stream to be associated with this allocation
+    {
+        *d_ptr                          = NULL;
+        int entrypoint_device           = INVALID_DEVICE_ORDINAL;
+        hipError_t error                = hipSuccess;
+
+        if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) return error;
+        if (device == INVALID_DEVICE_ORDINAL)
+            device = entrypoint_device;
+
+        bool uses_pool;
+        if (HipcubDebug(error = UsesPool(device, uses_pool))) return error;
+        if (!uses_pool)
+            return fallback.DeviceAllocate(device, d_ptr, bytes, active_stream);
+
+#ifdef HIPCUB_STREAM_ORDERED_ALLOCATION
+        // Set runtime's current device to specified device (entrypoint may not be set)
+        if (device != entrypoint_device)
+        {
+            if (HipcubDebug(error = hipSetDevice(device))) return error;
+        }
+
+        hipMemPool_t pool;
+        mutex.lock();
+        pool = pools[device];
+        mutex.unlock();
+
+        error = hipMallocFromPoolAsync(d_ptr, bytes, pool, active_stream);
+        if (error == hipErrorMemoryAllocation)
+        {
+            // Return the memory the pool keeps reserved to the system and retry once
+            if (debug) _HipcubLog("\tDevice %d failed to allocate %lld bytes for stream %lld, trimming its pool and retrying\n",
+                device, (long long) bytes, (long long) active_stream);
+
+            hipGetLastError();  // Reset error
+            if (!HipcubDebug(error = hipDeviceSynchronize())
+                && !HipcubDebug(error = hipMemPoolTrimTo(pool, 0)))
+            {
+                error = hipMallocFromPoolAsync(d_ptr, bytes, pool, active_stream);
+            }
+        }
+
+        if (!HipcubDebug(error))
+        {
+            LiveAllocation allocation;
+            allocation.device               = device;
+            allocation.associated_stream    = active_stream;
+
+            mutex.lock();
+            live_allocations[*d_ptr] = allocation;
+            size_t num_live = live_allocations.size();
+            mutex.unlock();
+
+            if (debug) _HipcubLog("\tDevice %d allocated %lld bytes from its pool for stream %lld (%lld live allocations outstanding)\n",
+                device, (long long) bytes, (long long) active_stream, (long long) num_live);
+        }
+
+        // Attempt to revert back to previous device if necessary
+        if (device != entrypoint_device)
+        {
+            hipError_t revert_error = hipSetDevice(entrypoint_device);
+            if (error == hipSuccess)
+                error = revert_error;
+            HipcubDebug(revert_error);
+        }
+#endif
+
+        return error;
+    }
+
+
+    /**
+     * \brief Provides a suitable allocation of device memory for the given size on the current device.
+     *
+     * The allocation is ordered after all prior work submitted to \p active_stream.
+     */
+    hipError_t DeviceAllocate(
+        void            **d_ptr,            ///< [out] Reference to pointer to the allocation
+        size_t          bytes,              ///< [in] Minimum number of bytes for the allocation
+        hipStream_t     active_stream = 0)  ///< [in] The stream to be associated with this allocation
+    {
+        return DeviceAllocate(INVALID_DEVICE_ORDINAL, d_ptr, bytes, active_stream);
+    }
+
+
+    /**
+     * \brief Frees a live allocation of device memory on the specified device, returning it to its pool.
+     *
+     * The memory may be reused by work submitted to the stream associated with the allocation
+     * right away, and by other streams once that prior work has completed.
+     */
+    hipError_t DeviceFree(
+        int             device,
+        void*           d_ptr)
+    {
+        hipError_t error = hipSuccess;
+
+        mutex.lock();
+        LiveAllocations::iterator it = live_allocations.find(d_ptr);
+        bool from_pool = (it != live_allocations.end());
+        LiveAllocation allocation = {};
+        if (from_pool)
+        {
+            allocation = it->second;
+            live_allocations.erase(it);
+        }
+        size_t num_live = live_allocations.size();
+        mutex.unlock();
+
+        if (!from_pool)
+            return fallback.DeviceFree(device, d_ptr);
+
+#ifdef HIPCUB_STREAM_ORDERED_ALLOCATION
+        if (HipcubDebug(error = hipFreeAsync(d_ptr, allocation.associated_stream))) return error;
+
+        if (debug) _HipcubLog("\tDevice %d returned %p to its pool for stream %lld (%lld live allocations outstanding)\n",
+            allocation.device, d_ptr, (long long) allocation.associated_stream, (long long) num_live);
+#else
+        (void) num_live;
+#endif
+
+        return error;
+    }
+
+
+    /**
+     * \brief Frees a live allocation of device memory on the current device, returning it to its pool.
+     *
+     * The memory may be reused by work submitted to the stream associated with the allocation
+     * right away, and by other streams once that prior work has completed.
+     */
+    hipError_t DeviceFree(
+        void*           d_ptr)
+    {
+        return DeviceFree(INVALID_DEVICE_ORDINAL, d_ptr);
+    }
+
+
+    /**
+     * \brief Returns the memory reserved by the pools of all devices to the system and frees
+     * all allocations cached by the fallback allocator
+     */
+    hipError_t FreeAllCached()
+    {
+        hipError_t error = hipSuccess;
+
+#ifdef HIPCUB_STREAM_ORDERED_ALLOCATION
+        int entrypoint_device = INVALID_DEVICE_ORDINAL;
+
+        mutex.lock();
+        for (size_t device = 0; device < pools.size(); ++device)
+        {
+            if (pool_support[device] != 1)
+                continue;
+
+            if (entrypoint_device == INVALID_DEVICE_ORDINAL)
+            {
+                if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) break;
+            }
+
+            // Frees still pending on a stream do not become releasable until it has caught up
+            if (HipcubDebug(error = hipSetDevice((int) device))) break;
+            if (HipcubDebug(error = hipDeviceSynchronize())) break;
+            if (HipcubDebug(error = hipMemPoolTrimTo(pools[device], 0))) break;
+
+            if (debug) _HipcubLog("Device %d trimmed its pool\n", (int) device);
+        }
+        mutex.unlock();
+
+        // Attempt to revert back to entry-point device if necessary
+        if (entrypoint_device != INVALID_DEVICE_ORDINAL)
+        {
+            hipError_t revert_error = hipSetDevice(entrypoint_device);
+            if (error == hipSuccess)
+                error = revert_error;
+            HipcubDebug(revert_error);
+        }
+#endif
+
+        hipError_t fallback_error = fallback.FreeAllCached();
+        return (error != hipSuccess) ? error : fallback_error;
+    }
+
+
+    /**
+     * \brief Destructor.  Destroys the pools, whose memory is released once their
+     * outstanding allocations have been freed.
+     */
+    virtual ~PoolDeviceAllocator()
+    {
+        if (!skip_cleanup)
+        {
+            FreeAllCached();
+#ifdef HIPCUB_STREAM_ORDERED_ALLOCATION
+            for (size_t device = 0; device < pools.size(); ++device)
+            {
+                if (pools[device] != NULL)
+                    HipcubDebug(hipMemPoolDestroy(pools[device]));
+            }
+#endif
+        }
+    }
+
+};
+
+
+/**
+ * \brief A simple caching allocator for pinned host memory allocations.
+ *
+ * \par Overview
+ * CachingHostAllocator is the host-side companion of CachingDeviceAllocator, meant
+ * for the staging buffers results are copied into with \p hipMemcpyAsync.  Pinning
+ * and unpinning pages with \p hipHostMalloc and \p hipHostFree is expensive and
+ * synchronous, so freed buffers are cached and handed out again, with the same
+ * binning, stream-safety and caching limit as CachingDeviceAllocator:
+ *
+ * \par
+ * - Allocations are categorized and cached by bin size.  A new allocation request of
+ *   a given size will only consider cached allocations within the corresponding bin.
+ * - Bin limits progress geometrically in accordance with the growth factor
+ *   \p bin_growth provided during construction.  Unused host allocations within
+ *   a larger bin cache are not reused for allocation requests that categorize to
+ *   smaller bin sizes.
+ * - Allocation requests below (\p bin_growth ^ \p min_bin) are rounded up to
+ *   (\p bin_growth ^ \p min_bin).
+ * - Allocations above (\p bin_growth ^ \p max_bin) are not rounded up to the nearest
+ *   bin and are simply freed when they are deallocated instead of being returned
+ *   to a bin-cache.
+ * - %If the total storage of cached allocations associated with a device will exceed
+ *   \p max_cached_bytes, allocations for that device are simply freed when they are
+ *   deallocated instead of being returned to their bin-cache.
+ * - A freed allocation becomes available immediately for reuse within the stream it
+ *   was associated with, and for other streams once all work submitted to that stream
+ *   before the free has completed.  Copies into the buffer therefore never race with
+ *   its next user.
+ *
+ * \par
+ * Allocations are associated with the device that is current when they are made:
+ * its streams order their reuse and their bytes count towards its caching limit.
+ * Buffers are allocated with \p hipHostMallocPortable and may be used from any device.
+ *
+ */
+struct CachingHostAllocator
 {
     //---------------------------------------------------------------------
     // Constants
@@ -65,20 +2826,20 @@ struct CachingDeviceAllocator
     //---------------------------------------------------------------------
 
     /**
-     * Descriptor for device memory allocations
+     * Descriptor for pinned host memory allocations
      */
     struct BlockDescriptor
     {
-        void*           d_ptr;              // Device pointer
+        void*           h_ptr;              // Host pointer
         size_t          bytes;              // Size of allocation in bytes
         unsigned int    bin;                // Bin enumeration
-        int             device;             // device ordinal
+        int             device;             // Device ordinal of the associated stream
         hipStream_t     associated_stream;  // Associated associated_stream
         hipEvent_t      ready_event;        // Signal when associated stream has run to the point at which this block was freed
 
         // Constructor (suitable for searching maps for a specific block, given its pointer and device)
-        BlockDescriptor(void *d_ptr, int device) :
-            d_ptr(d_ptr),
+        BlockDescriptor(void *h_ptr, int device) :
+            h_ptr(h_ptr),
             bytes(0),
             bin(INVALID_BIN),
             device(device),
@@ -88,7 +2849,7 @@ struct CachingDeviceAllocator
 
         // Constructor (suitable for searching maps for a range of suitable blocks, given a device)
         BlockDescriptor(int device) :
-            d_ptr(NULL),
+            h_ptr(NULL),
             bytes(0),
             bin(INVALID_BIN),
             device(device),
@@ -96,11 +2857,11 @@ struct CachingDeviceAllocator
             ready_event(0)
         {}
 
-        // Comparison functor for comparing device pointers
+        // Comparison functor for comparing host pointers
         static bool PtrCompare(const BlockDescriptor &a, const BlockDescriptor &b)
         {
             if (a.device == b.device)
-                return (a.d_ptr < b.d_ptr);
+                return (a.h_ptr < b.h_ptr);
             else
                 return (a.device < b.device);
         }
@@ -118,12 +2879,7 @@ struct CachingDeviceAllocator
     /// BlockDescriptor comparator function interface
     typedef bool (*Compare)(const BlockDescriptor &, const BlockDescriptor &);
 
-    class TotalBytes {
-    public:
-        size_t free;
-        size_t live;
-        TotalBytes() { free = live = 0; }
-    };
+    typedef CachingDeviceAllocator::TotalBytes TotalBytes;
 
     /// Set type for cached blocks (ordered by size)
     typedef std::multiset<BlockDescriptor, Compare> CachedBlocks;
@@ -131,62 +2887,9 @@ struct CachingDeviceAllocator
     /// Set type for live blocks (ordered by ptr)
     typedef std::multiset<BlockDescriptor, Compare> BusyBlocks;
 
-    /// Map type of device ordinals to the number of cached bytes cached by each device
+    /// Map type of device ordinals to the number of bytes cached for each device
     typedef std::map<int, TotalBytes> GpuCachedBytes;
 
-
-    //---------------------------------------------------------------------
-    // Utility functions
-    //---------------------------------------------------------------------
-
-    /**
-     * Integer pow function for unsigned base and exponent
-     */
-    static unsigned int IntPow(
-        unsigned int base,
-        unsigned int exp)
-    {
-        unsigned int retval = 1;
-        while (exp > 0)
-        {
-            if (exp & 1) {
-                retval = retval * base;        // multiply the result by the current base
-            }
-            base = base * base;                // square the base
-            exp = exp >> 1;                    // divide the exponent in half
-        }
-        return retval;
-    }
-
-
-    /**
-     * Round up to the nearest power-of
-     */
-    void NearestPowerOf(
-        unsigned int    &power,
-        size_t          &rounded_bytes,
-        unsigned int    base,
-        size_t          value)
-    {
-        power = 0;
-        rounded_bytes = 1;
-
-        if (value * base < value)
-        {
-            // Overflow
-            power = sizeof(size_t) * 8;
-            rounded_bytes = size_t(0) - 1;
-            return;
-        }
-
-        while (rounded_bytes < value)
-        {
-            rounded_bytes *= base;
-            power++;
-        }
-    }
-
-
     //---------------------------------------------------------------------
     // Fields
     //---------------------------------------------------------------------
@@ -201,12 +2904,12 @@ struct CachingDeviceAllocator
     size_t          max_bin_bytes;      /// Maximum bin size
     size_t          max_cached_bytes;   /// Maximum aggregate cached bytes per device
 
-    const bool      skip_cleanup;       /// Whether or not to skip a call to FreeAllCached() when destructor is called.  (The CUDA runtime may have already shut down for statically declared allocators)
+    const bool      skip_cleanup;       /// Whether or not to skip a call to FreeAllCached() when destructor is called.  (The HIP runtime may have already shut down for statically declared allocators)
     bool            debug;              /// Whether or not to print (de)allocation events to stdout
 
-    GpuCachedBytes  cached_bytes;       /// Map of device ordinal to aggregate cached bytes on that device
-    CachedBlocks    cached_blocks;      /// Set of cached device allocations available for reuse
-    BusyBlocks      live_blocks;        /// Set of live device allocations currently in use
+    GpuCachedBytes  cached_bytes;       /// Map of device ordinal to aggregate cached bytes for that device
+    CachedBlocks    cached_blocks;      /// Set of cached host allocations available for reuse
+    BusyBlocks      live_blocks;        /// Set of live host allocations currently in use
 
     //---------------------------------------------------------------------
     // Methods
@@ -215,7 +2918,7 @@ struct CachingDeviceAllocator
     /**
      * \brief Constructor.
      */
-    CachingDeviceAllocator(
+    CachingHostAllocator(
         unsigned int    bin_growth,                             ///< Geometric growth factor for bin-sizes
         unsigned int    min_bin             = 1,                ///< Minimum bin (default is bin_growth ^ 1)
         unsigned int    max_bin             = INVALID_BIN,      ///< Maximum bin (default is no max bin)
@@ -226,8 +2929,8 @@ struct CachingDeviceAllocator
         bin_growth(bin_growth),
         min_bin(min_bin),
         max_bin(max_bin),
-        min_bin_bytes(IntPow(bin_growth, min_bin)),
-        max_bin_bytes(IntPow(bin_growth, max_bin)),
+        min_bin_bytes(CachingDeviceAllocator::IntPow(bin_growth, min_bin)),
+        max_bin_bytes(CachingDeviceAllocator::IntPow(bin_growth, max_bin)),
         max_cached_bytes(max_cached_bytes),
         skip_cleanup(skip_cleanup),
         debug(debug),
@@ -249,15 +2952,15 @@ struct CachingDeviceAllocator
      * which delineates five bin-sizes: 512B, 4KB, 32KB, 256KB, and 2MB and
      * sets a maximum of 6,291,455 cached bytes per device
      */
-    CachingDeviceAllocator(
+    CachingHostAllocator(
         bool skip_cleanup = false,
         bool debug = false)
     :
         bin_growth(8),
         min_bin(3),
         max_bin(7),
-        min_bin_bytes(IntPow(bin_growth, min_bin)),
-        max_bin_bytes(IntPow(bin_growth, max_bin)),
+        min_bin_bytes(CachingDeviceAllocator::IntPow(bin_growth, min_bin)),
+        max_bin_bytes(CachingDeviceAllocator::IntPow(bin_growth, max_bin)),
         max_cached_bytes((max_bin_bytes * 3) - 1),
         skip_cleanup(skip_cleanup),
         debug(debug),
@@ -290,19 +2993,20 @@ struct CachingDeviceAllocator
 
 
     /**
-     * \brief Provides a suitable allocation of device memory for the given size on the specified device.
+     * \brief Provides a suitable allocation of pinned host memory for the given size, associated
+     * with a stream of the specified device.
      *
      * Once freed, the allocation becomes available immediately for reuse within the \p active_stream
      * with which it was associated with during allocation, and it becomes available for reuse within other
      * streams when all prior work submitted to \p active_stream has completed.
      */
-    hipError_t DeviceAllocate(
-        int             device,             ///< [in] Device on which to place the allocation
-        void            **d_ptr,            ///< [out] Reference to pointer to the allocation
+    hipError_t HostAllocate(
+        int             device,             ///< [in] Device of \p active_stream
+        void            **h_ptr,            ///< [out] Reference to pointer to the allocation
         size_t          bytes,              ///< [in] Minimum number of bytes for the allocation
         hipStream_t     active_stream = 0)  ///< [in] The stream to be associated with this allocation
     {
-        *d_ptr                          = NULL;
+        *h_ptr                          = NULL;
         int entrypoint_device           = INVALID_DEVICE_ORDINAL;
         hipError_t error                = hipSuccess;
 
@@ -316,7 +3020,7 @@ struct CachingDeviceAllocator
         bool found = false;
         BlockDescriptor search_key(device);
         search_key.associated_stream = active_stream;
-        NearestPowerOf(search_key.bin, search_key.bytes, bin_growth, bytes);
+        CachingDeviceAllocator::NearestPowerOf(search_key.bin, search_key.bytes, bin_growth, bytes);
 
         if (search_key.bin > max_bin)
         {
@@ -338,14 +3042,14 @@ struct CachingDeviceAllocator
                 search_key.bytes    = min_bin_bytes;
             }
 
-            // Iterate through the range of cached blocks on the same device in the same bin
+            // Iterate through the range of cached blocks of the same device in the same bin
             CachedBlocks::iterator block_itr = cached_blocks.lower_bound(search_key);
             while ((block_itr != cached_blocks.end())
                     && (block_itr->device == device)
                     && (block_itr->bin == search_key.bin))
             {
                 // To prevent races with reusing blocks returned by the host but still
-                // in use by the device, only consider cached blocks that are
+                // read or written by the device, only consider cached blocks that are
                 // either (from the active stream) or (from an idle stream)
                 if ((active_stream == block_itr->associated_stream) ||
                     (hipEventQuery(block_itr->ready_event) != hipErrorNotReady))
@@ -360,8 +3064,8 @@ struct CachingDeviceAllocator
                     cached_bytes[device].free -= search_key.bytes;
                     cached_bytes[device].live += search_key.bytes;
 
-                    if (debug) _HipcubLog("\tDevice %d reused cached block at %p (%lld bytes) for stream %lld (previously associated with stream %lld).\n",
-                        device, search_key.d_ptr, (long long) search_key.bytes, (long long) search_key.associated_stream, (long long)  block_itr->associated_stream);
+                    if (debug) _HipcubLog("\tDevice %d reused cached host block at %p (%lld bytes) for stream %lld (previously associated with stream %lld).\n",
+                        device, search_key.h_ptr, (long long) search_key.bytes, (long long) search_key.associated_stream, (long long)  block_itr->associated_stream);
 
                     cached_blocks.erase(block_itr);
 
@@ -385,10 +3089,10 @@ struct CachingDeviceAllocator
             }
 
             // Attempt to allocate
-            if (HipcubDebug(error = hipMalloc(&search_key.d_ptr, search_key.bytes)) == hipErrorMemoryAllocation)
+            if (HipcubDebug(error = hipHostMalloc(&search_key.h_ptr, search_key.bytes, hipHostMallocPortable)) == hipErrorMemoryAllocation)
             {
-                // The allocation attempt failed: free all cached blocks on device and retry
-                if (debug) _HipcubLog("\tDevice %d failed to allocate %lld bytes for stream %lld, retrying after freeing cached allocations",
+                // The allocation attempt failed: free all cached blocks of the device and retry
+                if (debug) _HipcubLog("\tDevice %d failed to allocate %lld host bytes for stream %lld, retrying after freeing cached allocations",
                       device, (long long) search_key.bytes, (long long) search_key.associated_stream);
 
                 error = hipGetLastError();     // Reset error
@@ -397,29 +3101,27 @@ struct CachingDeviceAllocator
                 // Lock
                 mutex.lock();
 
-                // Iterate the range of free blocks on the same device
+                // Iterate the range of free blocks of the same device
                 BlockDescriptor free_key(device);
                 CachedBlocks::iterator block_itr = cached_blocks.lower_bound(free_key);
 
                 while ((block_itr != cached_blocks.end()) && (block_itr->device == device))
                 {
-                    // No need to worry about synchronization with the device: hipFree is
+                    // No need to worry about synchronization with the device: hipHostFree is
                     // blocking and will synchronize across all kernels executing
                     // on the current device
 
-                    // Free device memory and destroy stream event.
-                    if (HipcubDebug(error = hipFree(block_itr->d_ptr))) break;
+                    // Free pinned memory and destroy stream event.
+                    if (HipcubDebug(error = hipHostFree(block_itr->h_ptr))) break;
                     if (HipcubDebug(error = hipEventDestroy(block_itr->ready_event))) break;
 
                     // Reduce balance and erase entry
                     cached_bytes[device].free -= block_itr->bytes;
 
-                    if (debug) _HipcubLog("\tDevice %d freed %lld bytes.\n\t\t  %lld available blocks cached (%lld bytes), %lld live blocks (%lld bytes) outstanding.\n",
+                    if (debug) _HipcubLog("\tDevice %d freed %lld host bytes.\n\t\t  %lld available blocks cached (%lld bytes), %lld live blocks (%lld bytes) outstanding.\n",
                         device, (long long) block_itr->bytes, (long long) cached_blocks.size(), (long long) cached_bytes[device].free, (long long) live_blocks.size(), (long long) cached_bytes[device].live);
 
-                    cached_blocks.erase(block_itr);
-
-                    block_itr++;
+                    block_itr = cached_blocks.erase(block_itr);
                 }
 
                 // Unlock
@@ -429,7 +3131,11 @@ struct CachingDeviceAllocator
                 if (error) return error;
 
                 // Try to allocate again
-                if (HipcubDebug(error = hipMalloc(&search_key.d_ptr, search_key.bytes))) return error;
+                if (HipcubDebug(error = hipHostMalloc(&search_key.h_ptr, search_key.bytes, hipHostMallocPortable))) return error;
+            }
+            else if (error)
+            {
+                return error;
             }
 
             // Create ready event
@@ -442,8 +3148,8 @@ struct CachingDeviceAllocator
             cached_bytes[device].live += search_key.bytes;
             mutex.unlock();
 
-            if (debug) _HipcubLog("\tDevice %d allocated new device block at %p (%lld bytes associated with stream %lld).\n",
-                      device, search_key.d_ptr, (long long) search_key.bytes, (long long) search_key.associated_stream);
+            if (debug) _HipcubLog("\tDevice %d allocated new host block at %p (%lld bytes associated with stream %lld).\n",
+                      device, search_key.h_ptr, (long long) search_key.bytes, (long long) search_key.associated_stream);
 
             // Attempt to revert back to previous device if necessary
             if ((entrypoint_device != INVALID_DEVICE_ORDINAL) && (entrypoint_device != device))
@@ -452,10 +3158,10 @@ struct CachingDeviceAllocator
             }
         }
 
-        // Copy device pointer to output parameter
-        *d_ptr = search_key.d_ptr;
+        // Copy host pointer to output parameter
+        *h_ptr = search_key.h_ptr;
 
-        if (debug) _HipcubLog("\t\t%lld available blocks cached (%lld bytes), %lld live blocks outstanding(%lld bytes).\n",
+        if (debug) _HipcubLog("\t\t%lld available host blocks cached (%lld bytes), %lld live blocks outstanding(%lld bytes).\n",
             (long long) cached_blocks.size(), (long long) cached_bytes[device].free, (long long) live_blocks.size(), (long long) cached_bytes[device].live);
 
         return error;
@@ -463,31 +3169,33 @@ struct CachingDeviceAllocator
 
 
     /**
-     * \brief Provides a suitable allocation of device memory for the given size on the current device.
+     * \brief Provides a suitable allocation of pinned host memory for the given size, associated
+     * with a stream of the current device.
      *
      * Once freed, the allocation becomes available immediately for reuse within the \p active_stream
      * with which it was associated with during allocation, and it becomes available for reuse within other
      * streams when all prior work submitted to \p active_stream has completed.
      */
-    hipError_t DeviceAllocate(
-        void            **d_ptr,            ///< [out] Reference to pointer to the allocation
+    hipError_t HostAllocate(
+        void            **h_ptr,            ///< [out] Reference to pointer to the allocation
         size_t          bytes,              ///< [in] Minimum number of bytes for the allocation
         hipStream_t     active_stream = 0)  ///< [in] The stream to be associated with this allocation
     {
-        return DeviceAllocate(INVALID_DEVICE_ORDINAL, d_ptr, bytes, active_stream);
+        return HostAllocate(INVALID_DEVICE_ORDINAL, h_ptr, bytes, active_stream);
     }
 
 
     /**
-     * \brief Frees a live allocation of device memory on the specified device, returning it to the allocator.
+     * \brief Frees a live allocation of pinned host memory associated with the specified device,
+     * returning it to the allocator.
      *
      * Once freed, the allocation becomes available immediately for reuse within the \p active_stream
      * with which it was associated with during allocation, and it becomes available for reuse within other
      * streams when all prior work submitted to \p active_stream has completed.
      */
-    hipError_t DeviceFree(
+    hipError_t HostFree(
         int             device,
-        void*           d_ptr)
+        void*           h_ptr)
     {
         int entrypoint_device           = INVALID_DEVICE_ORDINAL;
         hipError_t error                = hipSuccess;
@@ -504,7 +3212,7 @@ struct CachingDeviceAllocator
 
         // Find corresponding block descriptor
         bool recached = false;
-        BlockDescriptor search_key(d_ptr, device);
+        BlockDescriptor search_key(h_ptr, device);
         BusyBlocks::iterator block_itr = live_blocks.find(search_key);
         if (block_itr != live_blocks.end())
         {
@@ -521,7 +3229,7 @@ struct CachingDeviceAllocator
                 cached_blocks.insert(search_key);
                 cached_bytes[device].free += search_key.bytes;
 
-                if (debug) _HipcubLog("\tDevice %d returned %lld bytes from associated stream %lld.\n\t\t %lld available blocks cached (%lld bytes), %lld live blocks outstanding. (%lld bytes)\n",
+                if (debug) _HipcubLog("\tDevice %d returned %lld host bytes from associated stream %lld.\n\t\t %lld available blocks cached (%lld bytes), %lld live blocks outstanding. (%lld bytes)\n",
                     device, (long long) search_key.bytes, (long long) search_key.associated_stream, (long long) cached_blocks.size(),
                     (long long) cached_bytes[device].free, (long long) live_blocks.size(), (long long) cached_bytes[device].live);
             }
@@ -530,14 +3238,14 @@ struct CachingDeviceAllocator
         // First set to specified device (entrypoint may not be set)
         if (device != entrypoint_device)
         {
-            if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) return error;
-            if (HipcubDebug(error = hipSetDevice(device))) return error;
+            if (HipcubDebug(error = hipGetDevice(&entrypoint_device))) { mutex.unlock(); return error; }
+            if (HipcubDebug(error = hipSetDevice(device))) { mutex.unlock(); return error; }
         }
 
         if (recached)
         {
             // Insert the ready event in the associated stream (must have current device set properly)
-            if (HipcubDebug(error = hipEventRecord(search_key.ready_event, search_key.associated_stream))) return error;
+            if (HipcubDebug(error = hipEventRecord(search_key.ready_event, search_key.associated_stream))) { mutex.unlock(); return error; }
         }
 
         // Unlock
@@ -546,10 +3254,10 @@ struct CachingDeviceAllocator
         if (!recached)
         {
             // Free the allocation from the runtime and cleanup the event.
-            if (HipcubDebug(error = hipFree(d_ptr))) return error;
+            if (HipcubDebug(error = hipHostFree(h_ptr))) return error;
             if (HipcubDebug(error = hipEventDestroy(search_key.ready_event))) return error;
 
-            if (debug) _HipcubLog("\tDevice %d freed %lld bytes from associated stream %lld.\n\t\t  %lld available blocks cached (%lld bytes), %lld live blocks (%lld bytes) outstanding.\n",
+            if (debug) _HipcubLog("\tDevice %d freed %lld host bytes from associated stream %lld.\n\t\t  %lld available blocks cached (%lld bytes), %lld live blocks (%lld bytes) outstanding.\n",
                 device, (long long) search_key.bytes, (long long) search_key.associated_stream, (long long) cached_blocks.size(), (long long) cached_bytes[device].free, (long long) live_blocks.size(), (long long) cached_bytes[device].live);
         }
 
@@ -564,21 +3272,22 @@ struct CachingDeviceAllocator
 
 
     /**
-     * \brief Frees a live allocation of device memory on the current device, returning it to the allocator.
+     * \brief Frees a live allocation of pinned host memory associated with the current device,
+     * returning it to the allocator.
      *
      * Once freed, the allocation becomes available immediately for reuse within the \p active_stream
      * with which it was associated with during allocation, and it becomes available for reuse within other
      * streams when all prior work submitted to \p active_stream has completed.
      */
-    hipError_t DeviceFree(
-        void*           d_ptr)
+    hipError_t HostFree(
+        void*           h_ptr)
     {
-        return DeviceFree(INVALID_DEVICE_ORDINAL, d_ptr);
+        return HostFree(INVALID_DEVICE_ORDINAL, h_ptr);
     }
 
 
     /**
-     * \brief Frees all cached device allocations on all devices
+     * \brief Frees all cached pinned host allocations of all devices
      */
     hipError_t FreeAllCached()
     {
@@ -606,14 +3315,14 @@ struct CachingDeviceAllocator
                 current_device = begin->device;
             }
 
-            // Free device memory
-            if (HipcubDebug(error = hipFree(begin->d_ptr))) break;
+            // Free pinned memory
+            if (HipcubDebug(error = hipHostFree(begin->h_ptr))) break;
             if (HipcubDebug(error = hipEventDestroy(begin->ready_event))) break;
 
             // Reduce balance and erase entry
             cached_bytes[current_device].free -= begin->bytes;
 
-            if (debug) _HipcubLog("\tDevice %d freed %lld bytes.\n\t\t  %lld available blocks cached (%lld bytes), %lld live blocks (%lld bytes) outstanding.\n",
+            if (debug) _HipcubLog("\tDevice %d freed %lld host bytes.\n\t\t  %lld available blocks cached (%lld bytes), %lld live blocks (%lld bytes) outstanding.\n",
                 current_device, (long long) begin->bytes, (long long) cached_blocks.size(), (long long) cached_bytes[current_device].free, (long long) live_blocks.size(), (long long) cached_bytes[current_device].live);
 
             cached_blocks.erase(begin);
@@ -634,7 +3343,7 @@ struct CachingDeviceAllocator
     /**
      * \brief Destructor
      */
-    virtual ~CachingDeviceAllocator()
+    virtual ~CachingHostAllocator()
     {
         if (!skip_cleanup)
             FreeAllCached();
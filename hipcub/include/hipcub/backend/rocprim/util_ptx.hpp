@@ -51,7 +51,6 @@ BEGIN_HIPCUB_NAMESPACE
 // * FFMA_RZ, FMUL_RZ - not in CUB public API
 // * WARP_SYNC - not supported, not CUB public API
 // * CTA_SYNC_AND - not supported, not CUB public API
-// * MatchAny - not in CUB public API
 //
 // Differences:
 // * Warp thread masks (when used) are 64-bit unsigned integers
@@ -304,6 +303,24 @@ int64_t WARP_BALLOT(int predicate, uint64_t member_mask)
     return __ballot(predicate);
 }
 
+// Returns the warp lane mask of all active lanes whose \p label has the same
+// \p LABEL_BITS least significant bits as the label of the calling thread
+template <int LABEL_BITS>
+HIPCUB_DEVICE inline
+uint64_t MatchAny(unsigned int label)
+{
+    uint64_t retval = __ballot(1);
+
+    #pragma unroll
+    for (int BIT = 0; BIT < LABEL_BITS; ++BIT)
+    {
+        const uint64_t mask = WARP_BALLOT(label & (1u << BIT), uint64_t(-1));
+        retval &= (label & (1u << BIT)) ? mask : ~mask;
+    }
+
+    return retval;
+}
+
 END_HIPCUB_NAMESPACE
 
 #endif // HIPCUB_ROCPRIM_UTIL_PTX_HPP_
@@ -38,4 +38,7 @@
     #include "backend/cub/hipcub.hpp"
 #endif
 
+// Backend-independent utilities
+#include "util_temp_storage.hpp"
+
 #endif // HIPCUB_HPP_
@@ -0,0 +1,353 @@
+// Copyright (c) 2021 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef HIPCUB_UTIL_TEMP_STORAGE_HPP_
+#define HIPCUB_UTIL_TEMP_STORAGE_HPP_
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+BEGIN_HIPCUB_NAMESPACE
+
+/**
+ * \brief Lays out the temporary storage of a sequence of device-wide calls in a single arena.
+ *
+ * \par Overview
+ * Every device-wide algorithm is called twice: once with a \p NULL \p d_temp_storage
+ * to query its temporary storage size, and once to run.  A pipeline such as
+ * sort, reduce-by-key, select therefore either allocates once per call or needs
+ * hand-written size arithmetic.  TempStoragePlan collects the buffers of the whole
+ * pipeline first, each with the range of steps it is live in, and then computes one
+ * arena in which buffers whose step ranges do not overlap share the same bytes.
+ *
+ * \par
+ * - A step is any caller-chosen ordinal, typically the index of a call in the pipeline.
+ *   Buffers are live from their first to their last step, inclusive.
+ * - \p Query records the size query of a call as a buffer live in one step.  \p Reserve
+ *   records any other buffer, such as an intermediate result passed between steps.
+ * - Every buffer starts at a multiple of \p alignment bytes from the start of the arena
+ *   and occupies at least \p alignment bytes, so even buffers of zero bytes get a
+ *   distinct non-\p NULL pointer that algorithms do not mistake for a size query.
+ * - Buffers are placed largest first at the lowest offset not in use by any buffer
+ *   live in an overlapping step range.
+ * - Aliasing is only safe if the steps run in order on the device: every call of the
+ *   plan must be issued to the same stream, or the caller must order the steps
+ *   otherwise (e.g. with events), so that a step does not start while a buffer it
+ *   shares bytes with is still in use by an earlier step.
+ * - Once \p ArenaBytes() has been allocated, \p Bind the arena and run each call
+ *   with \p Run, or fetch buffers with \p Pointer.
+ *
+ * \par Snippet
+ * \code
+ * hipcub::TempStoragePlan plan;
+ * hipcub::TempStoragePlan::Buffer keys_out, sort_storage, unique_storage;
+ *
+ * auto sort = [&](void *d_temp, size_t &bytes) {
+ *     return hipcub::DeviceRadixSort::SortKeys(d_temp, bytes, d_keys_in, plan.Pointer<int>(keys_out), num_items);
+ * };
+ * auto unique = [&](void *d_temp, size_t &bytes) {
+ *     return hipcub::DeviceSelect::Unique(d_temp, bytes, plan.Pointer<int>(keys_out), d_out, d_num_selected_out, num_items);
+ * };
+ *
+ * // Step 0 sorts into keys_out, step 1 selects from it
+ * plan.Reserve(keys_out, num_items * sizeof(int), 0, 1);
+ * plan.Query(0, sort_storage, sort);
+ * plan.Query(1, unique_storage, unique);
+ *
+ * void *d_arena;
+ * allocator.DeviceAllocate(&d_arena, plan.ArenaBytes());
+ * plan.Bind(d_arena, plan.ArenaBytes());
+ *
+ * plan.Run(sort_storage, sort);
+ * plan.Run(unique_storage, unique);
+ * \endcode
+ */
+struct TempStoragePlan
+{
+    /// Handle of a buffer in the plan
+    typedef unsigned int Buffer;
+
+    /// Default alignment of buffers, matching the alignment of device allocations
+    static const size_t DEFAULT_ALIGNMENT = 256;
+
+    /**
+     * A buffer and its place in the arena
+     */
+    struct BufferDescriptor
+    {
+        size_t          bytes;              // Requested size in bytes
+        unsigned int    first_step;         // First step the buffer is live in
+        unsigned int    last_step;          // Last step the buffer is live in
+        size_t          offset;             // Offset from the start of the arena
+    };
+
+    size_t          alignment;          /// Alignment of buffers in bytes (a power of two)
+    std::vector<BufferDescriptor> buffers;  /// Buffers of the plan, indexed by handle
+    bool            laid_out;           /// Whether or not the offsets of buffers are up to date
+    size_t          arena_bytes;        /// Size of the arena (valid when laid out)
+    char            *d_arena;           /// Bound arena (NULL until bound)
+
+    /**
+     * \brief Constructor.
+     *
+     * An \p alignment that is not a power of two makes \p Reserve, \p Query and
+     * \p Bind fail with \p hipErrorInvalidValue and \p ArenaBytes() return zero.
+     */
+    TempStoragePlan(
+        size_t alignment = DEFAULT_ALIGNMENT)   ///< [in] Alignment of buffers in bytes (a power of two)
+    :
+        alignment(alignment),
+        laid_out(true),
+        arena_bytes(0),
+        d_arena(NULL)
+    {}
+
+    /**
+     * \brief Records a buffer of \p bytes live from \p first_step to \p last_step.
+     *
+     * Invalidates a previous layout and binding.
+     */
+    hipError_t Reserve(
+        Buffer          &buffer,            ///< [out] Handle of the buffer
+        size_t          bytes,              ///< [in] Size of the buffer in bytes
+        unsigned int    first_step,         ///< [in] First step the buffer is live in
+        unsigned int    last_step)          ///< [in] Last step the buffer is live in
+    {
+        if (last_step < first_step || !ValidAlignment())
+            return hipErrorInvalidValue;
+
+        BufferDescriptor descriptor;
+        descriptor.bytes        = bytes;
+        descriptor.first_step   = first_step;
+        descriptor.last_step    = last_step;
+        descriptor.offset       = 0;
+
+        buffer = static_cast<Buffer>(buffers.size());
+        buffers.push_back(descriptor);
+        laid_out = false;
+        d_arena = NULL;
+        return hipSuccess;
+    }
+
+    /**
+     * \brief Records a buffer of \p bytes live in \p step only.
+     */
+    hipError_t Reserve(
+        Buffer          &buffer,            ///< [out] Handle of the buffer
+        size_t          bytes,              ///< [in] Size of the buffer in bytes
+        unsigned int    step)               ///< [in] Step the buffer is live in
+    {
+        return Reserve(buffer, bytes, step, step);
+    }
+
+    /**
+     * \brief Runs the size query of a device-wide call and records its temporary storage as a buffer live in \p step.
+     *
+     * \p call is invoked as <tt>call(void *d_temp_storage, size_t &temp_storage_bytes)</tt> with a \p NULL
+     * \p d_temp_storage and must return a \p hipError_t.
+     */
+    template <typename Call>
+    hipError_t Query(
+        unsigned int    step,               ///< [in] Step the call runs in
+        Buffer          &buffer,            ///< [out] Handle of the call's temporary storage
+        Call            call)               ///< [in] The call
+    {
+        if (!ValidAlignment())
+            return hipErrorInvalidValue;
+
+        size_t bytes = 0;
+        hipError_t error = call(static_cast<void *>(NULL), bytes);
+        if (error != hipSuccess)
+            return error;
+        return Reserve(buffer, bytes, step, step);
+    }
+
+    /**
+     * \brief Computes the layout if necessary and returns the size of the arena in bytes.
+     */
+    size_t ArenaBytes()
+    {
+        Layout();
+        return arena_bytes;
+    }
+
+    /**
+     * \brief Returns the size the buffers would take without aliasing, in bytes.
+     */
+    size_t UnaliasedBytes() const
+    {
+        size_t bytes = 0;
+        for (size_t i = 0; i < buffers.size(); ++i)
+            bytes += PaddedBytes(buffers[i].bytes);
+        return bytes;
+    }
+
+    /**
+     * \brief Binds the arena the buffers are placed in.
+     *
+     * Returns \p hipErrorInvalidValue if \p alignment is not a power of two, \p d_arena
+     * is not aligned to \p alignment or \p arena_bytes is less than \p ArenaBytes().
+     */
+    hipError_t Bind(
+        void            *d_arena,           ///< [in] Device allocation of at least \p ArenaBytes() bytes
+        size_t          arena_bytes)        ///< [in] Size of the allocation in bytes
+    {
+        Layout();
+        if (!ValidAlignment()
+            || d_arena == NULL
+            || (reinterpret_cast<uintptr_t>(d_arena) & (alignment - 1)) != 0
+            || arena_bytes < this->arena_bytes)
+        {
+            return hipErrorInvalidValue;
+        }
+        this->d_arena = static_cast<char *>(d_arena);
+        return hipSuccess;
+    }
+
+    /**
+     * \brief Returns the offset of \p buffer from the start of the arena.
+     */
+    size_t Offset(
+        Buffer          buffer)
+    {
+        Layout();
+        return buffers[buffer].offset;
+    }
+
+    /**
+     * \brief Returns the requested size of \p buffer in bytes.
+     */
+    size_t Bytes(
+        Buffer          buffer) const
+    {
+        return buffers[buffer].bytes;
+    }
+
+    /**
+     * \brief Returns the device pointer of \p buffer (\p NULL until an arena is bound).
+     */
+    void *Pointer(
+        Buffer          buffer)
+    {
+        if (d_arena == NULL)
+            return NULL;
+        return d_arena + buffers[buffer].offset;
+    }
+
+    /**
+     * \brief Returns the device pointer of \p buffer as a \p T* (\p NULL until an arena is bound).
+     */
+    template <typename T>
+    T *Pointer(
+        Buffer          buffer)
+    {
+        return static_cast<T *>(Pointer(buffer));
+    }
+
+    /**
+     * \brief Runs a device-wide call with the temporary storage recorded by \p Query.
+     *
+     * Returns \p hipErrorInvalidValue if no arena is bound.
+     */
+    template <typename Call>
+    hipError_t Run(
+        Buffer          buffer,             ///< [in] Handle returned by \p Query
+        Call            call)               ///< [in] The call
+    {
+        if (d_arena == NULL)
+            return hipErrorInvalidValue;
+        size_t bytes = buffers[buffer].bytes;
+        return call(Pointer(buffer), bytes);
+    }
+
+private:
+
+    bool ValidAlignment() const
+    {
+        return alignment != 0 && (alignment & (alignment - 1)) == 0;
+    }
+
+    size_t PaddedBytes(
+        size_t          bytes) const
+    {
+        return (bytes == 0) ? alignment : (bytes + alignment - 1) & ~(alignment - 1);
+    }
+
+    /**
+     * Places every buffer, largest first, at the lowest aligned offset that does not
+     * intersect any placed buffer live in an overlapping step range
+     */
+    void Layout()
+    {
+        if (laid_out || !ValidAlignment())
+            return;
+
+        std::vector<Buffer> order(buffers.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = static_cast<Buffer>(i);
+        std::stable_sort(order.begin(), order.end(), [this](Buffer a, Buffer b)
+        {
+            return buffers[a].bytes > buffers[b].bytes;
+        });
+
+        arena_bytes = 0;
+        std::vector<Buffer> placed;
+        std::vector<std::pair<size_t, size_t>> conflicts;
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            BufferDescriptor &buffer = buffers[order[i]];
+            const size_t bytes = PaddedBytes(buffer.bytes);
+
+            // Address ranges of placed buffers live at the same time, by offset
+            conflicts.clear();
+            for (size_t j = 0; j < placed.size(); ++j)
+            {
+                const BufferDescriptor &other = buffers[placed[j]];
+                if (other.first_step <= buffer.last_step && buffer.first_step <= other.last_step)
+                    conflicts.push_back(std::make_pair(other.offset, other.offset + PaddedBytes(other.bytes)));
+            }
+            std::sort(conflicts.begin(), conflicts.end());
+
+            // Lowest gap that fits
+            size_t offset = 0;
+            for (size_t j = 0; j < conflicts.size(); ++j)
+            {
+                if (offset + bytes <= conflicts[j].first)
+                    break;
+                offset = std::max(offset, conflicts[j].second);
+            }
+
+            buffer.offset = offset;
+            arena_bytes = std::max(arena_bytes, offset + bytes);
+            placed.push_back(order[i]);
+        }
+
+        laid_out = true;
+    }
+};
+
+END_HIPCUB_NAMESPACE
+
+#endif // HIPCUB_UTIL_TEMP_STORAGE_HPP_
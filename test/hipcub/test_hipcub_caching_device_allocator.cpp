@@ -31,6 +31,11 @@
 
 #include "hipcub/util_allocator.hpp"
 
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
 __global__ void EmptyKernel() { }
 
 // Hipified test/test_allocator.cu
@@ -333,3 +338,381 @@ TEST(HipcubCachingDeviceAllocatorTests, Test1)
         ASSERT_EQ(allocator.live_blocks.size(), 0u);
     }
 }
+
+#ifdef HIPCUB_ROCPRIM_API
+
+TEST(HipcubCachingDeviceAllocatorTests, Sharded)
+{
+    int initial_gpu;
+    HIP_CHECK(hipGetDevice(&initial_gpu));
+
+    hipcub::CachingDeviceAllocator allocator;
+    HIP_CHECK(allocator.EnableSharding(4));
+
+    // Sharding can only be enabled once
+    ASSERT_EQ(allocator.EnableSharding(4), hipErrorInvalidValue);
+
+    hipStream_t other_stream;
+    HIP_CHECK(hipStreamCreate(&other_stream));
+
+    // A block freed in a stream is reused by the same stream right away
+    char *d_a;
+    char *d_b;
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_a, 999, 0));
+    hipLaunchKernelGGL(
+        HIP_KERNEL_NAME(EmptyKernel),
+        dim3(32000), dim3(256), 1024 * 8, 0
+    );
+    HIP_CHECK(allocator.DeviceFree(d_a));
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_b, 999, 0));
+    ASSERT_EQ(d_a, d_b);
+
+    // Once the stream is idle, another stream steals it
+    HIP_CHECK(allocator.DeviceFree(d_b));
+    HIP_CHECK(hipStreamSynchronize(0));
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_b, 999, other_stream));
+    ASSERT_EQ(d_a, d_b);
+    HIP_CHECK(allocator.DeviceFree(d_b));
+
+    // Blocks larger than the largest bin are not cached
+    char *d_big;
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_big, allocator.max_bin_bytes + 1, other_stream));
+    HIP_CHECK(allocator.DeviceFree(d_big));
+
+    // Many host threads, each driving its own stream
+    const int num_threads = 8;
+    const int iterations = 200;
+    std::vector<hipStream_t> streams(num_threads);
+    std::vector<hipError_t> errors(num_threads, hipSuccess);
+    for(int t = 0; t < num_threads; t++)
+    {
+        HIP_CHECK(hipStreamCreate(&streams[t]));
+    }
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < num_threads; t++)
+    {
+        threads.emplace_back(
+            [&, t]()
+            {
+                hipError_t error = hipSetDevice(initial_gpu);
+                for(int i = 0; (i < iterations) && (error == hipSuccess); i++)
+                {
+                    void * d_ptrs[3];
+                    for(int j = 0; (j < 3) && (error == hipSuccess); j++)
+                    {
+                        error = allocator.DeviceAllocate(&d_ptrs[j], 512 << (3 * j), streams[t]);
+                        if(error == hipSuccess)
+                        {
+                            error = hipMemsetAsync(d_ptrs[j], t, 512, streams[t]);
+                        }
+                    }
+                    for(int j = 0; (j < 3) && (error == hipSuccess); j++)
+                    {
+                        error = allocator.DeviceFree(d_ptrs[j]);
+                    }
+                }
+                errors[t] = error;
+            }
+        );
+    }
+    for(int t = 0; t < num_threads; t++)
+    {
+        threads[t].join();
+        ASSERT_EQ(errors[t], hipSuccess);
+    }
+
+    HIP_CHECK(allocator.FreeAllCached());
+    for(int t = 0; t < num_threads; t++)
+    {
+        HIP_CHECK(hipStreamDestroy(streams[t]));
+    }
+    HIP_CHECK(hipStreamDestroy(other_stream));
+}
+
+TEST(HipcubCachingDeviceAllocatorTests, SizeClassesAndSlabs)
+{
+    int initial_gpu;
+    HIP_CHECK(hipGetDevice(&initial_gpu));
+
+    hipcub::CachingDeviceAllocator allocator;
+    HIP_CHECK(allocator.SetSizeClasses(4));
+    HIP_CHECK(allocator.SetSlabs(size_t(64) << 20));
+
+    // 4.1KB rounds up to the 5KB size class instead of the 32KB bin
+    char *d_a;
+    char *d_b;
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_a, 4100));
+    HIP_CHECK(allocator.DeviceFree(d_a));
+    ASSERT_EQ(allocator.cached_bytes[initial_gpu].free, 5120u);
+
+    // Requests of the same size class reuse the block
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_b, 4500));
+    ASSERT_EQ(d_a, d_b);
+    HIP_CHECK(allocator.DeviceFree(d_b));
+
+    // Blocks beyond the largest bin are carved from the same slab
+    char *d_big_a;
+    char *d_big_b;
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_big_a, size_t(3) << 20));
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_big_b, size_t(5) << 20));
+    ASSERT_EQ(d_big_b, d_big_a + (size_t(3) << 20));
+    ASSERT_EQ(allocator.live_blocks.size(), 2u);
+    ASSERT_EQ(allocator.cached_blocks.size(), 1u);
+
+    // A freed block is reused right away by its stream
+    HIP_CHECK(allocator.DeviceFree(d_big_a));
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_big_a, size_t(3) << 20));
+    ASSERT_EQ(d_big_b, d_big_a + (size_t(3) << 20));
+
+    // Once both are back in the slab, their ranges merge again
+    HIP_CHECK(allocator.DeviceFree(d_big_a));
+    HIP_CHECK(allocator.DeviceFree(d_big_b));
+    HIP_CHECK(hipDeviceSynchronize());
+    char *d_big_c;
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_big_c, size_t(7) << 20));
+    ASSERT_EQ(d_big_c, d_big_a);
+    HIP_CHECK(allocator.DeviceFree(d_big_c));
+
+    // Larger than a slab: allocated on its own
+    char *d_huge;
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_huge, size_t(65) << 20));
+    HIP_CHECK(allocator.DeviceFree(d_huge));
+
+    HIP_CHECK(allocator.FreeAllCached());
+    ASSERT_EQ(allocator.live_blocks.size(), 0u);
+    ASSERT_EQ(allocator.cached_blocks.size(), 0u);
+}
+
+TEST(HipcubCachingDeviceAllocatorTests, Statistics)
+{
+    hipcub::CachingDeviceAllocator allocator;
+    HIP_CHECK(allocator.EnableStatistics(64));
+
+    // A miss, a hit and a second miss, all in the 4KB bin
+    char *d_a;
+    char *d_b;
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_a, 1000));
+    HIP_CHECK(allocator.DeviceFree(d_a));
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_a, 1000));
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_b, 3000));
+
+    hipcub::CachingDeviceAllocator::DeviceStatistics stats;
+    HIP_CHECK(allocator.GetStatistics(hipcub::CachingDeviceAllocator::INVALID_DEVICE_ORDINAL, stats));
+    ASSERT_EQ(stats.live_bytes, 8192u);
+    ASSERT_EQ(stats.requested_bytes, 4000u);
+    ASSERT_EQ(stats.peak_live_bytes, 8192u);
+    ASSERT_EQ(stats.cached_bytes, 0u);
+    ASSERT_EQ(stats.malloc_calls, 2u);
+    ASSERT_EQ(stats.free_calls, 0u);
+    ASSERT_NEAR(stats.InternalFragmentation(), 1.0 - 4000.0 / 8192.0, 1e-9);
+
+    ASSERT_EQ(stats.bins.size(), 5u);
+    ASSERT_EQ(stats.bins[0].bin, allocator.min_bin);
+    ASSERT_EQ(stats.bins[0].bin_bytes, allocator.min_bin_bytes);
+    ASSERT_EQ(stats.bins[1].bin_bytes, 4096u);
+    ASSERT_EQ(stats.bins[1].hits, 1u);
+    ASSERT_EQ(stats.bins[1].misses, 2u);
+
+    HIP_CHECK(allocator.DeviceFree(d_a));
+    HIP_CHECK(allocator.DeviceFree(d_b));
+
+    // Blocks beyond the largest bin are neither hits nor misses
+    char *d_big;
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_big, allocator.max_bin_bytes + 1));
+    HIP_CHECK(allocator.DeviceFree(d_big));
+
+    HIP_CHECK(allocator.GetStatistics(hipcub::CachingDeviceAllocator::INVALID_DEVICE_ORDINAL, stats));
+    ASSERT_EQ(stats.live_bytes, 0u);
+    ASSERT_EQ(stats.requested_bytes, 0u);
+    ASSERT_EQ(stats.peak_live_bytes, allocator.max_bin_bytes + 1);
+    ASSERT_EQ(stats.cached_bytes, 8192u);
+    ASSERT_EQ(stats.malloc_calls, 3u);
+    ASSERT_EQ(stats.free_calls, 1u);
+    ASSERT_EQ(stats.uncached_allocations, 1u);
+
+    // Header and one line per event
+    const char * path = "hipcub_allocator_trace.csv";
+    HIP_CHECK(allocator.DumpTrace(path));
+    std::ifstream trace(path);
+    std::string line;
+    size_t lines = 0;
+    while(std::getline(trace, line))
+    {
+        lines++;
+    }
+    trace.close();
+    std::remove(path);
+    ASSERT_EQ(lines, 13u);
+}
+
+TEST(HipcubCachingDeviceAllocatorTests, EvictionSelection)
+{
+    using Allocator = hipcub::CachingDeviceAllocator;
+
+    // 4KB idle, 8KB busy, 32KB idle, 512B idle
+    const std::vector<Allocator::EvictionCandidate> candidates = {
+        { 4096, true, false }, { 8192, false, false }, { 32768, true, false }, { 512, true, false }
+    };
+    auto select = [&](size_t bytes)
+    {
+        std::vector<Allocator::EvictionCandidate> selection = candidates;
+        Allocator::SelectEvictions(selection, bytes);
+        std::vector<bool> evict;
+        for(const auto& candidate : selection)
+        {
+            evict.push_back(candidate.evict);
+        }
+        return evict;
+    };
+
+    // The smallest idle block that covers the request
+    ASSERT_EQ(select(3000), std::vector<bool>({ true, false, false, false }));
+
+    // Idle blocks are preferred over smaller busy ones
+    ASSERT_EQ(select(5000), std::vector<bool>({ false, false, true, false }));
+
+    // All idle blocks, largest first, then the smallest busy block covering the rest
+    ASSERT_EQ(select(40000), std::vector<bool>({ true, true, true, true }));
+    ASSERT_EQ(select(36000), std::vector<bool>({ true, false, true, false }));
+
+    // Everything
+    ASSERT_EQ(select(Allocator::INVALID_SIZE), std::vector<bool>({ true, true, true, true }));
+
+    Allocator allocator;
+    HIP_CHECK(allocator.SetEvictionPolicy(Allocator::EVICT_MINIMAL));
+    HIP_CHECK(allocator.SetEvictionCallback(
+        [](int, size_t, void *) { return false; }
+    ));
+
+    char *d_a;
+    HIP_CHECK(allocator.DeviceAllocate((void **) &d_a, 1000));
+    HIP_CHECK(allocator.DeviceFree(d_a));
+    HIP_CHECK(allocator.FreeAllCached());
+}
+
+TEST(HipcubCachingDeviceAllocatorTests, PoolDeviceAllocator)
+{
+    int device;
+    HIP_CHECK(hipGetDevice(&device));
+
+    hipStream_t stream;
+    HIP_CHECK(hipStreamCreate(&stream));
+
+    // Memory pools where supported, and the caching allocator forced
+    for(bool force_fallback : { false, true })
+    {
+        SCOPED_TRACE(testing::Message() << "with force_fallback = " << force_fallback);
+
+        hipcub::PoolDeviceAllocator allocator(1024 * 1024, force_fallback);
+
+        bool uses_pool;
+        HIP_CHECK(allocator.UsesPool(device, uses_pool));
+        if(force_fallback)
+        {
+            ASSERT_FALSE(uses_pool);
+        }
+
+        char *d_a, *d_b;
+        HIP_CHECK(allocator.DeviceAllocate((void **) &d_a, 1000, stream));
+        HIP_CHECK(allocator.DeviceAllocate(device, (void **) &d_b, 3000 * 1024, stream));
+        ASSERT_NE(d_a, nullptr);
+        ASSERT_NE(d_b, nullptr);
+        HIP_CHECK(hipMemsetAsync(d_a, 1, 1000, stream));
+        HIP_CHECK(hipMemsetAsync(d_b, 2, 3000 * 1024, stream));
+
+        if(uses_pool)
+        {
+            ASSERT_EQ(allocator.live_allocations.size(), 2u);
+            ASSERT_EQ(allocator.fallback.live_blocks.size(), 0u);
+        }
+        else
+        {
+            ASSERT_EQ(allocator.live_allocations.size(), 0u);
+            ASSERT_EQ(allocator.fallback.live_blocks.size(), 2u);
+        }
+
+        HIP_CHECK(allocator.DeviceFree(d_a));
+        HIP_CHECK(allocator.DeviceFree(device, d_b));
+        ASSERT_EQ(allocator.live_allocations.size(), 0u);
+        ASSERT_EQ(allocator.fallback.live_blocks.size(), 0u);
+
+        // Allocations after a free are ordered behind it on the same stream
+        HIP_CHECK(allocator.SetReleaseThreshold(0));
+        HIP_CHECK(allocator.DeviceAllocate((void **) &d_a, 1000, stream));
+        HIP_CHECK(hipMemsetAsync(d_a, 3, 1000, stream));
+        HIP_CHECK(allocator.DeviceFree(d_a));
+
+        HIP_CHECK(hipStreamSynchronize(stream));
+        HIP_CHECK(allocator.FreeAllCached());
+        ASSERT_EQ(allocator.fallback.cached_blocks.size(), 0u);
+    }
+
+    HIP_CHECK(hipStreamDestroy(stream));
+}
+
+TEST(HipcubCachingDeviceAllocatorTests, CachingHostAllocator)
+{
+    // 512B, 4KB, 32KB, 256KB and 2MB bins, with at most 6,291,455 bytes cached
+    hipcub::CachingHostAllocator allocator;
+
+    int device;
+    HIP_CHECK(hipGetDevice(&device));
+
+    hipStream_t other_stream;
+    HIP_CHECK(hipStreamCreate(&other_stream));
+
+    char *d_count;
+    HIP_CHECK(hipMalloc(&d_count, 4096));
+    HIP_CHECK(hipMemset(d_count, 7, 4096));
+
+    // A staging buffer is rounded up to its bin and reused by the stream it is associated with
+    char *h_a;
+    HIP_CHECK(allocator.HostAllocate((void **) &h_a, 1000));
+    ASSERT_EQ(allocator.live_blocks.size(), 1u);
+    ASSERT_EQ(allocator.cached_bytes[device].live, 4096u);
+    HIP_CHECK(hipMemcpyAsync(h_a, d_count, 1000, hipMemcpyDeviceToHost, 0));
+    HIP_CHECK(hipStreamSynchronize(0));
+    ASSERT_EQ(h_a[999], 7);
+    HIP_CHECK(allocator.HostFree(h_a));
+    ASSERT_EQ(allocator.cached_blocks.size(), 1u);
+    ASSERT_EQ(allocator.cached_bytes[device].free, 4096u);
+
+    char *h_b;
+    HIP_CHECK(allocator.HostAllocate((void **) &h_b, 4000));
+    ASSERT_EQ(h_b, h_a);
+    ASSERT_EQ(allocator.cached_blocks.size(), 0u);
+
+    // A block freed with work pending on its stream is handed to other streams once that work is done
+    HIP_CHECK(hipMemcpyAsync(h_b, d_count, 4000, hipMemcpyDeviceToHost, 0));
+    HIP_CHECK(allocator.HostFree(h_b));
+    HIP_CHECK(hipDeviceSynchronize());
+    char *h_c;
+    HIP_CHECK(allocator.HostAllocate((void **) &h_c, 4000, other_stream));
+    ASSERT_EQ(h_c, h_a);
+    HIP_CHECK(allocator.HostFree(h_c));
+
+    // Allocations beyond the largest bin are not cached
+    char *h_d;
+    HIP_CHECK(allocator.HostAllocate(device, (void **) &h_d, allocator.max_bin_bytes + 1));
+    HIP_CHECK(allocator.HostFree(device, h_d));
+    ASSERT_EQ(allocator.cached_blocks.size(), 1u);
+
+    // Neither are allocations exceeding max_cached_bytes
+    HIP_CHECK(allocator.SetMaxCachedBytes(4096));
+    char *h_e;
+    HIP_CHECK(allocator.HostAllocate((void **) &h_e, 32768));
+    HIP_CHECK(allocator.HostFree(h_e));
+    ASSERT_EQ(allocator.cached_blocks.size(), 1u);
+    ASSERT_EQ(allocator.cached_bytes[device].free, 4096u);
+
+    HIP_CHECK(allocator.FreeAllCached());
+    ASSERT_EQ(allocator.cached_blocks.size(), 0u);
+    ASSERT_EQ(allocator.cached_bytes[device].free, 0u);
+    ASSERT_EQ(allocator.cached_bytes[device].live, 0u);
+
+    HIP_CHECK(hipFree(d_count));
+    HIP_CHECK(hipStreamDestroy(other_stream));
+}
+
+#endif // HIPCUB_ROCPRIM_API
@@ -0,0 +1,532 @@
+// MIT License
+//
+// Copyright (c) 2021 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "common_test_header.hpp"
+
+// hipcub API
+#include "hipcub/device/device_merge_sort.hpp"
+
+template<class Key>
+struct less_op
+{
+    HIPCUB_HOST_DEVICE inline
+    bool operator()(const Key& lhs, const Key& rhs) const
+    {
+        return lhs < rhs;
+    }
+};
+
+// Orders keys by the opposite of operator<
+template<class Key>
+struct greater_op
+{
+    HIPCUB_HOST_DEVICE inline
+    bool operator()(const Key& lhs, const Key& rhs) const
+    {
+        return rhs < lhs;
+    }
+};
+
+// Orders custom keys by their first field only, which leaves many keys equal
+template<class Key>
+struct first_field_less_op
+{
+    HIPCUB_HOST_DEVICE inline
+    bool operator()(const Key& lhs, const Key& rhs) const
+    {
+        return lhs.x < rhs.x;
+    }
+};
+
+// Orders floats by absolute value
+struct absolute_less_op
+{
+    HIPCUB_HOST_DEVICE inline
+    bool operator()(const float& lhs, const float& rhs) const
+    {
+        return (lhs < 0 ? -lhs : lhs) < (rhs < 0 ? -rhs : rhs);
+    }
+};
+
+template<class Key, class CompareOp, int MinKey, int MaxKey>
+struct params
+{
+    using key_type = Key;
+    using compare_op_type = CompareOp;
+    static constexpr int min_key = MinKey;
+    static constexpr int max_key = MaxKey;
+};
+
+template<class Params>
+class HipcubDeviceMergeSort : public ::testing::Test {
+public:
+    using params = Params;
+};
+
+typedef ::testing::Types<
+    params<int, less_op<int>, -100000, 100000>,
+    params<unsigned char, greater_op<unsigned char>, 0, 255>,
+    params<long long, greater_op<long long>, -1000000, 1000000>,
+    params<double, less_op<double>, -1000, 1000>,
+    params<float, absolute_less_op, -1000, 1000>,
+    params<short, less_op<short>, 0, 10>,
+    params<test_utils::custom_test_type<int>, first_field_less_op<test_utils::custom_test_type<int>>, 0, 100>
+> Params;
+
+TYPED_TEST_SUITE(HipcubDeviceMergeSort, Params);
+
+std::vector<size_t> get_sizes()
+{
+    std::vector<size_t> sizes = { 1, 10, 53, 211, 1024, 2048, 2345, 4096, 34567, (1 << 16) - 1220, (1 << 20) - 123 };
+    const std::vector<size_t> random_sizes = test_utils::get_random_data<size_t>(3, 1, 100000, rand());
+    sizes.insert(sizes.end(), random_sizes.begin(), random_sizes.end());
+    return sizes;
+}
+
+enum class merge_sort_variant
+{
+    pairs,
+    pairs_copy,
+    keys,
+    keys_copy,
+    stable_pairs,
+    stable_keys
+};
+
+template<class Params>
+void test_merge_sort(merge_sort_variant variant)
+{
+    using key_type = typename Params::key_type;
+    using value_type = unsigned int;
+    using compare_op_type = typename Params::compare_op_type;
+
+    const bool with_values = variant == merge_sort_variant::pairs
+        || variant == merge_sort_variant::pairs_copy
+        || variant == merge_sort_variant::stable_pairs;
+    const bool copy = variant == merge_sort_variant::pairs_copy
+        || variant == merge_sort_variant::keys_copy;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    compare_op_type compare_op;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(size_t size : sizes)
+    {
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+            // Generate data
+            std::vector<key_type> keys_input = test_utils::get_random_data<key_type>(
+                size, Params::min_key, Params::max_key, seed_value
+            );
+            std::vector<value_type> values_input(size);
+            std::iota(values_input.begin(), values_input.end(), 0);
+
+            key_type * d_keys_input;
+            key_type * d_keys_output = nullptr;
+            value_type * d_values_input;
+            value_type * d_values_output = nullptr;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_input, size * sizeof(value_type)));
+            if(copy)
+            {
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_output, size * sizeof(value_type)));
+            }
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+            HIP_CHECK(
+                hipMemcpy(
+                    d_values_input, values_input.data(),
+                    size * sizeof(value_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            // Calculate expected results on host, equal keys keep the order of their values
+            std::vector<value_type> expected(values_input);
+            std::stable_sort(
+                expected.begin(), expected.end(),
+                [&](const value_type& lhs, const value_type& rhs)
+                {
+                    return compare_op(keys_input[lhs], keys_input[rhs]);
+                }
+            );
+
+            auto run = [&](void * d_temp_storage, size_t& temp_storage_size_bytes)
+            {
+                switch(variant)
+                {
+                    case merge_sort_variant::pairs:
+                        return hipcub::DeviceMergeSort::SortPairs(
+                            d_temp_storage, temp_storage_size_bytes,
+                            d_keys_input, d_values_input, size, compare_op,
+                            stream, debug_synchronous);
+                    case merge_sort_variant::pairs_copy:
+                        return hipcub::DeviceMergeSort::SortPairsCopy(
+                            d_temp_storage, temp_storage_size_bytes,
+                            d_keys_input, d_values_input, d_keys_output, d_values_output,
+                            size, compare_op, stream, debug_synchronous);
+                    case merge_sort_variant::keys:
+                        return hipcub::DeviceMergeSort::SortKeys(
+                            d_temp_storage, temp_storage_size_bytes,
+                            d_keys_input, size, compare_op,
+                            stream, debug_synchronous);
+                    case merge_sort_variant::keys_copy:
+                        return hipcub::DeviceMergeSort::SortKeysCopy(
+                            d_temp_storage, temp_storage_size_bytes,
+                            d_keys_input, d_keys_output, size, compare_op,
+                            stream, debug_synchronous);
+                    case merge_sort_variant::stable_pairs:
+                        return hipcub::DeviceMergeSort::StableSortPairs(
+                            d_temp_storage, temp_storage_size_bytes,
+                            d_keys_input, d_values_input, size, compare_op,
+                            stream, debug_synchronous);
+                    case merge_sort_variant::stable_keys:
+                    default:
+                        return hipcub::DeviceMergeSort::StableSortKeys(
+                            d_temp_storage, temp_storage_size_bytes,
+                            d_keys_input, size, compare_op,
+                            stream, debug_synchronous);
+                }
+            };
+
+            size_t temp_storage_size_bytes;
+            void * d_temp_storage = nullptr;
+            HIP_CHECK(run(d_temp_storage, temp_storage_size_bytes));
+
+            ASSERT_GT(temp_storage_size_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+
+            HIP_CHECK(run(d_temp_storage, temp_storage_size_bytes));
+
+            HIP_CHECK(hipFree(d_temp_storage));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), copy ? d_keys_output : d_keys_input,
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            std::vector<value_type> values_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    values_output.data(), copy ? d_values_output : d_values_input,
+                    size * sizeof(value_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(keys_output[i], keys_input[expected[i]]) << "where index = " << i;
+                if(with_values)
+                {
+                    ASSERT_EQ(values_output[i], expected[i]) << "where index = " << i;
+                }
+                else if(!copy)
+                {
+                    // Sorting keys leaves the values alone
+                    ASSERT_EQ(values_output[i], values_input[i]) << "where index = " << i;
+                }
+            }
+
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_values_input));
+            if(copy)
+            {
+                HIP_CHECK(hipFree(d_keys_output));
+                HIP_CHECK(hipFree(d_values_output));
+            }
+        }
+    }
+}
+
+TYPED_TEST(HipcubDeviceMergeSort, SortPairs)
+{
+    test_merge_sort<typename TestFixture::params>(merge_sort_variant::pairs);
+}
+
+TYPED_TEST(HipcubDeviceMergeSort, SortPairsCopy)
+{
+    test_merge_sort<typename TestFixture::params>(merge_sort_variant::pairs_copy);
+}
+
+TYPED_TEST(HipcubDeviceMergeSort, SortKeys)
+{
+    test_merge_sort<typename TestFixture::params>(merge_sort_variant::keys);
+}
+
+TYPED_TEST(HipcubDeviceMergeSort, SortKeysCopy)
+{
+    test_merge_sort<typename TestFixture::params>(merge_sort_variant::keys_copy);
+}
+
+TYPED_TEST(HipcubDeviceMergeSort, StableSortPairs)
+{
+    test_merge_sort<typename TestFixture::params>(merge_sort_variant::stable_pairs);
+}
+
+TYPED_TEST(HipcubDeviceMergeSort, StableSortKeys)
+{
+    test_merge_sort<typename TestFixture::params>(merge_sort_variant::stable_keys);
+}
+
+// int num_items, up to sizes where twice the run length of the last pass is
+// past INT_MAX.  Sizes that do not fit in the free device memory are skipped.
+TEST(HipcubDeviceMergeSortIntNumItems, SortKeys)
+{
+    using key_type = unsigned char;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<int> sizes = { 34567, (1 << 20) - 123, (1 << 30) + 4321 };
+    for(int size : sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        size_t free_bytes, total_bytes;
+        HIP_CHECK(hipMemGetInfo(&free_bytes, &total_bytes));
+        if(free_bytes < size_t(size) * sizeof(key_type) * 3)
+        {
+            continue;
+        }
+
+        std::vector<key_type> keys_input(size);
+        for(size_t i = 0; i < keys_input.size(); i++)
+        {
+            keys_input[i] = static_cast<key_type>((i * 2654435761ULL) >> 13);
+        }
+
+        key_type * d_keys;
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys, size * sizeof(key_type)));
+        HIP_CHECK(
+            hipMemcpy(
+                d_keys, keys_input.data(),
+                size * sizeof(key_type),
+                hipMemcpyHostToDevice
+            )
+        );
+
+        size_t temp_storage_size_bytes;
+        void * d_temp_storage = nullptr;
+        HIP_CHECK(
+            hipcub::DeviceMergeSort::SortKeys(
+                d_temp_storage, temp_storage_size_bytes,
+                d_keys, size, less_op<key_type>(),
+                stream, debug_synchronous
+            )
+        );
+
+        ASSERT_GT(temp_storage_size_bytes, 0U);
+
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+
+        HIP_CHECK(
+            hipcub::DeviceMergeSort::SortKeys(
+                d_temp_storage, temp_storage_size_bytes,
+                d_keys, size, less_op<key_type>(),
+                stream, debug_synchronous
+            )
+        );
+
+        HIP_CHECK(hipFree(d_temp_storage));
+
+        std::vector<key_type> keys_output(size);
+        HIP_CHECK(
+            hipMemcpy(
+                keys_output.data(), d_keys,
+                size * sizeof(key_type),
+                hipMemcpyDeviceToHost
+            )
+        );
+        HIP_CHECK(hipFree(d_keys));
+
+        // Sorted, and a permutation of the input
+        std::vector<size_t> counts(256, 0);
+        for(size_t i = 0; i < keys_input.size(); i++)
+        {
+            counts[keys_input[i]]++;
+        }
+        for(size_t i = 0; i < keys_output.size(); i++)
+        {
+            if(i > 0)
+            {
+                ASSERT_LE(keys_output[i - 1], keys_output[i]) << "where index = " << i;
+            }
+            counts[keys_output[i]]--;
+        }
+        for(size_t key = 0; key < counts.size(); key++)
+        {
+            ASSERT_EQ(counts[key], 0U) << "where key = " << key;
+        }
+    }
+}
+
+// 64-byte records ordered by one field, whose tile needs fewer items per thread
+// to fit in shared memory.  The other fields tell equal keys apart, so that the
+// order of equal keys is checked for keys as well as pairs.
+struct wide_key
+{
+    int x;
+    int fields[15];
+
+    bool operator==(const wide_key& other) const
+    {
+        return std::equal(fields, fields + 15, other.fields) && x == other.x;
+    }
+};
+
+static_assert(sizeof(wide_key) == 64, "wide_key should be 64 bytes");
+
+TEST(HipcubDeviceMergeSortWideKeys, StableSort)
+{
+    using key_type = wide_key;
+    using value_type = unsigned int;
+    using compare_op_type = first_field_less_op<key_type>;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    compare_op_type compare_op;
+
+    const std::vector<size_t> sizes = { 1, 211, 2345, 34567 };
+    for(size_t size : sizes)
+    {
+        for(bool with_values : { false, true })
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+            SCOPED_TRACE(testing::Message() << "with values = " << with_values);
+
+            const std::vector<int> x = test_utils::get_random_data<int>(size, 0, 100, size + seed_value_addition);
+            std::vector<key_type> keys_input(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                keys_input[i].x = x[i];
+                for(int field = 0; field < 15; field++)
+                {
+                    keys_input[i].fields[field] = int(i) + field;
+                }
+            }
+            std::vector<value_type> values_input(size);
+            std::iota(values_input.begin(), values_input.end(), 0);
+
+            key_type * d_keys;
+            value_type * d_values;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values, size * sizeof(value_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+            HIP_CHECK(
+                hipMemcpy(
+                    d_values, values_input.data(),
+                    size * sizeof(value_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            std::vector<value_type> expected(values_input);
+            std::stable_sort(
+                expected.begin(), expected.end(),
+                [&](const value_type& lhs, const value_type& rhs)
+                {
+                    return compare_op(keys_input[lhs], keys_input[rhs]);
+                }
+            );
+
+            auto run = [&](void * d_temp_storage, size_t& temp_storage_size_bytes)
+            {
+                return with_values
+                    ? hipcub::DeviceMergeSort::StableSortPairs(
+                        d_temp_storage, temp_storage_size_bytes,
+                        d_keys, d_values, size, compare_op,
+                        stream, debug_synchronous)
+                    : hipcub::DeviceMergeSort::StableSortKeys(
+                        d_temp_storage, temp_storage_size_bytes,
+                        d_keys, size, compare_op,
+                        stream, debug_synchronous);
+            };
+
+            size_t temp_storage_size_bytes;
+            void * d_temp_storage = nullptr;
+            HIP_CHECK(run(d_temp_storage, temp_storage_size_bytes));
+
+            ASSERT_GT(temp_storage_size_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+
+            HIP_CHECK(run(d_temp_storage, temp_storage_size_bytes));
+
+            HIP_CHECK(hipFree(d_temp_storage));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys,
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            std::vector<value_type> values_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    values_output.data(), d_values,
+                    size * sizeof(value_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys));
+            HIP_CHECK(hipFree(d_values));
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_TRUE(keys_output[i] == keys_input[expected[i]]) << "where index = " << i;
+                ASSERT_EQ(values_output[i], with_values ? expected[i] : values_input[i]) << "where index = " << i;
+            }
+        }
+    }
+}
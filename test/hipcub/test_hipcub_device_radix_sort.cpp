@@ -684,3 +684,1767 @@ TYPED_TEST(HipcubDeviceRadixSort, SortPairsDoubleBuffer)
         }
     }
 }
+
+#ifdef HIPCUB_ROCPRIM_API
+
+// ---------------------------------------------------------
+// Test for the onesweep radix sort
+// ---------------------------------------------------------
+
+TYPED_TEST(HipcubDeviceRadixSort, SortPairsOnesweep)
+{
+    using key_type = typename TestFixture::params::key_type;
+    using value_type = typename TestFixture::params::value_type;
+    constexpr bool descending = TestFixture::params::descending;
+    constexpr unsigned int start_bit = TestFixture::params::start_bit;
+    constexpr unsigned int end_bit = TestFixture::params::end_bit;
+    constexpr bool check_huge_sizes = TestFixture::params::check_huge_sizes;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20) && !check_huge_sizes) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+            // Generate data
+            std::vector<key_type> keys_input;
+            if(std::is_floating_point<key_type>::value)
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    (key_type)-1000,
+                    (key_type)+1000,
+                    seed_value
+                );
+            }
+            else
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    std::numeric_limits<key_type>::min(),
+                    std::numeric_limits<key_type>::max(),
+                    seed_value + seed_value_addition
+                );
+            }
+
+            std::vector<value_type> values_input(size);
+            std::iota(values_input.begin(), values_input.end(), 0);
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            value_type * d_values_input;
+            value_type * d_values_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_input, size * sizeof(value_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_output, size * sizeof(value_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_values_input, values_input.data(),
+                    size * sizeof(value_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            using key_value = std::pair<key_type, value_type>;
+
+            // Calculate expected results on host
+            std::vector<key_value> expected(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                expected[i] = key_value(keys_input[i], values_input[i]);
+            }
+            std::stable_sort(
+                expected.begin(), expected.end(),
+                key_value_comparator<key_type, value_type, descending, start_bit, end_bit>()
+            );
+
+            void * d_temporary_storage = nullptr;
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortPairsOnesweep(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                    start_bit, end_bit
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            if(descending)
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortPairsDescendingOnesweep(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                        start_bit, end_bit,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+            else
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortPairsOnesweep(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                        start_bit, end_bit,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_values_input));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys_output,
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            std::vector<value_type> values_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    values_output.data(), d_values_output,
+                    size * sizeof(value_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys_output));
+            HIP_CHECK(hipFree(d_values_output));
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(keys_output[i], expected[i].first);
+                ASSERT_EQ(values_output[i], expected[i].second);
+            }
+        }
+    }
+}
+
+TYPED_TEST(HipcubDeviceRadixSort, SortKeysDoubleBufferOnesweep)
+{
+    using key_type = typename TestFixture::params::key_type;
+    constexpr bool descending = TestFixture::params::descending;
+    constexpr unsigned int start_bit = TestFixture::params::start_bit;
+    constexpr unsigned int end_bit = TestFixture::params::end_bit;
+    constexpr bool check_huge_sizes = TestFixture::params::check_huge_sizes;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20) && !check_huge_sizes) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+            // Generate data
+            std::vector<key_type> keys_input;
+            if(std::is_floating_point<key_type>::value)
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    (key_type)-1000,
+                    (key_type)+1000,
+                    seed_value
+                );
+            }
+            else
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    std::numeric_limits<key_type>::min(),
+                    std::numeric_limits<key_type>::max(),
+                    seed_value + seed_value_addition
+                );
+            }
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            // Calculate expected results on host
+            std::vector<key_type> expected(keys_input);
+            std::stable_sort(expected.begin(), expected.end(), key_comparator<key_type, descending, start_bit, end_bit>());
+
+            hipcub::DoubleBuffer<key_type> d_keys(d_keys_input, d_keys_output);
+
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortKeysOnesweep(
+                    nullptr, temporary_storage_bytes,
+                    d_keys, size,
+                    start_bit, end_bit
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            void * d_temporary_storage;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            if(descending)
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortKeysDescendingOnesweep(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys, size,
+                        start_bit, end_bit,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+            else
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortKeysOnesweep(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys, size,
+                        start_bit, end_bit,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys.Current(),
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_keys_output));
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(keys_output[i], expected[i]);
+            }
+        }
+    }
+}
+
+TYPED_TEST(HipcubDeviceRadixSort, SortIndices)
+{
+    using key_type = typename TestFixture::params::key_type;
+    using index_type = unsigned int;
+    constexpr bool descending = TestFixture::params::descending;
+    constexpr unsigned int start_bit = TestFixture::params::start_bit;
+    constexpr unsigned int end_bit = TestFixture::params::end_bit;
+    constexpr bool check_huge_sizes = TestFixture::params::check_huge_sizes;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20) && !check_huge_sizes) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+            // Every other run skips writing the sorted keys
+            const bool write_keys = (seed_index % 2) == 0;
+            SCOPED_TRACE(testing::Message() << "with write_keys = " << write_keys);
+
+            // Generate data
+            std::vector<key_type> keys_input;
+            if(std::is_floating_point<key_type>::value)
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    (key_type)-1000,
+                    (key_type)+1000,
+                    seed_value
+                );
+            }
+            else
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    std::numeric_limits<key_type>::min(),
+                    std::numeric_limits<key_type>::max(),
+                    seed_value + seed_value_addition
+                );
+            }
+
+            key_type * d_keys_input;
+            key_type * d_keys_output = nullptr;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            if(write_keys)
+            {
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            }
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            index_type * d_indices_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_indices_output, size * sizeof(index_type)));
+
+            using key_value = std::pair<key_type, index_type>;
+
+            // Calculate expected results on host
+            std::vector<key_value> expected(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                expected[i] = key_value(keys_input[i], static_cast<index_type>(i));
+            }
+            std::stable_sort(
+                expected.begin(), expected.end(),
+                key_value_comparator<key_type, index_type, descending, start_bit, end_bit>()
+            );
+
+            void * d_temporary_storage = nullptr;
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortIndices(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys_input, d_keys_output, d_indices_output, size,
+                    start_bit, end_bit
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            if(descending)
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortIndicesDescending(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_indices_output, size,
+                        start_bit, end_bit,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+            else
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortIndices(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_indices_output, size,
+                        start_bit, end_bit,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+            HIP_CHECK(hipFree(d_keys_input));
+
+            std::vector<key_type> keys_output(size);
+            if(write_keys)
+            {
+                HIP_CHECK(
+                    hipMemcpy(
+                        keys_output.data(), d_keys_output,
+                        size * sizeof(key_type),
+                        hipMemcpyDeviceToHost
+                    )
+                );
+                HIP_CHECK(hipFree(d_keys_output));
+            }
+
+            std::vector<index_type> indices_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    indices_output.data(), d_indices_output,
+                    size * sizeof(index_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_indices_output));
+
+            for(size_t i = 0; i < size; i++)
+            {
+                if(write_keys)
+                {
+                    ASSERT_EQ(keys_output[i], expected[i].first);
+                }
+                ASSERT_EQ(indices_output[i], expected[i].second);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------
+// Test for the in-place radix sort
+// ---------------------------------------------------------
+
+// The in-place sort is not stable, so the output is checked to be in order and to
+// hold the same keys (and pairs) as the input, rather than against std::stable_sort.
+// A size above the largest segment a single block partitions is added so that the
+// keys are split by the whole device first.
+std::vector<size_t> get_in_place_sizes()
+{
+    std::vector<size_t> sizes = get_sizes();
+    sizes.push_back((1 << 18) + 54321);
+    return sizes;
+}
+
+TYPED_TEST(HipcubDeviceRadixSort, SortKeysInPlace)
+{
+    using key_type = typename TestFixture::params::key_type;
+    constexpr bool descending = TestFixture::params::descending;
+    constexpr unsigned int start_bit = TestFixture::params::start_bit;
+    constexpr unsigned int end_bit = TestFixture::params::end_bit;
+    constexpr bool check_huge_sizes = TestFixture::params::check_huge_sizes;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_in_place_sizes();
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20) && !check_huge_sizes) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+            // Generate data
+            std::vector<key_type> keys_input;
+            if(std::is_floating_point<key_type>::value)
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    (key_type)-1000,
+                    (key_type)+1000,
+                    seed_value
+                );
+            }
+            else
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    std::numeric_limits<key_type>::min(),
+                    std::numeric_limits<key_type>::max(),
+                    seed_value + seed_value_addition
+                );
+            }
+
+            key_type * d_keys;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortKeysInPlace(
+                    nullptr, temporary_storage_bytes,
+                    d_keys, size,
+                    start_bit, end_bit
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            void * d_temporary_storage;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            if(descending)
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortKeysDescendingInPlace(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys, size,
+                        start_bit, end_bit,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+            else
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortKeysInPlace(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys, size,
+                        start_bit, end_bit,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys,
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys));
+
+            key_comparator<key_type, descending, start_bit, end_bit> comparator;
+            for(size_t i = 1; i < size; i++)
+            {
+                ASSERT_FALSE(comparator(keys_output[i], keys_output[i - 1])) << "where index = " << i;
+            }
+
+            std::sort(keys_input.begin(), keys_input.end());
+            std::sort(keys_output.begin(), keys_output.end());
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(keys_output[i], keys_input[i]);
+            }
+        }
+    }
+}
+
+TYPED_TEST(HipcubDeviceRadixSort, SortPairsInPlace)
+{
+    using key_type = typename TestFixture::params::key_type;
+    using value_type = typename TestFixture::params::value_type;
+    constexpr bool descending = TestFixture::params::descending;
+    constexpr unsigned int start_bit = TestFixture::params::start_bit;
+    constexpr unsigned int end_bit = TestFixture::params::end_bit;
+    constexpr bool check_huge_sizes = TestFixture::params::check_huge_sizes;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_in_place_sizes();
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20) && !check_huge_sizes) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+            // Generate data
+            std::vector<key_type> keys_input;
+            if(std::is_floating_point<key_type>::value)
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    (key_type)-1000,
+                    (key_type)+1000,
+                    seed_value
+                );
+            }
+            else
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    std::numeric_limits<key_type>::min(),
+                    std::numeric_limits<key_type>::max(),
+                    seed_value + seed_value_addition
+                );
+            }
+
+            std::vector<value_type> values_input(size);
+            std::iota(values_input.begin(), values_input.end(), 0);
+
+            key_type * d_keys;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            value_type * d_values;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values, size * sizeof(value_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_values, values_input.data(),
+                    size * sizeof(value_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortPairsInPlace(
+                    nullptr, temporary_storage_bytes,
+                    d_keys, d_values, size,
+                    start_bit, end_bit
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            void * d_temporary_storage;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            if(descending)
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortPairsDescendingInPlace(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys, d_values, size,
+                        start_bit, end_bit,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+            else
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortPairsInPlace(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys, d_values, size,
+                        start_bit, end_bit,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys,
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            std::vector<value_type> values_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    values_output.data(), d_values,
+                    size * sizeof(value_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys));
+            HIP_CHECK(hipFree(d_values));
+
+            key_comparator<key_type, descending, start_bit, end_bit> comparator;
+            for(size_t i = 1; i < size; i++)
+            {
+                ASSERT_FALSE(comparator(keys_output[i], keys_output[i - 1])) << "where index = " << i;
+            }
+
+            // Values must still be paired with their keys
+            using key_value = std::pair<key_type, value_type>;
+
+            std::vector<key_value> expected(size);
+            std::vector<key_value> output(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                expected[i] = key_value(keys_input[i], values_input[i]);
+                output[i] = key_value(keys_output[i], values_output[i]);
+            }
+            std::sort(expected.begin(), expected.end());
+            std::sort(output.begin(), output.end());
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(output[i].first, expected[i].first);
+                ASSERT_EQ(output[i].second, expected[i].second);
+            }
+        }
+    }
+}
+
+// size_t num_items past 2^32 - 1, with the keys of the largest upper digit at the
+// end, so that a block sorts them at places beyond 32 bits.  Sizes that do not
+// fit in the free device memory are skipped.
+TEST(HipcubDeviceRadixSortInPlaceLargeNumItems, SortKeys)
+{
+    using key_type = unsigned short;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const size_t tail_size = 100000;
+    const std::vector<size_t> sizes = { 34567, (size_t(1) << 20) - 123, (size_t(1) << 32) + 4321 };
+    for(size_t size : sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        size_t free_bytes, total_bytes;
+        HIP_CHECK(hipMemGetInfo(&free_bytes, &total_bytes));
+        if(free_bytes < size * sizeof(key_type) * 2)
+        {
+            continue;
+        }
+
+        std::vector<key_type> keys_input(size);
+        for(size_t i = 0; i < keys_input.size(); i++)
+        {
+            const key_type low = static_cast<key_type>(((i * 2654435761ULL) >> 13) & 0xFF);
+            keys_input[i] = (i + tail_size < size) ? low : static_cast<key_type>(0xFF00 | low);
+        }
+
+        key_type * d_keys;
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys, size * sizeof(key_type)));
+        HIP_CHECK(
+            hipMemcpy(
+                d_keys, keys_input.data(),
+                size * sizeof(key_type),
+                hipMemcpyHostToDevice
+            )
+        );
+
+        size_t temp_storage_size_bytes;
+        void * d_temp_storage = nullptr;
+        HIP_CHECK(
+            hipcub::DeviceRadixSort::SortKeysInPlace(
+                d_temp_storage, temp_storage_size_bytes,
+                d_keys, size, 0, int(sizeof(key_type) * 8),
+                stream, debug_synchronous
+            )
+        );
+
+        ASSERT_GT(temp_storage_size_bytes, 0U);
+
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+
+        HIP_CHECK(
+            hipcub::DeviceRadixSort::SortKeysInPlace(
+                d_temp_storage, temp_storage_size_bytes,
+                d_keys, size, 0, int(sizeof(key_type) * 8),
+                stream, debug_synchronous
+            )
+        );
+
+        HIP_CHECK(hipFree(d_temp_storage));
+
+        std::vector<key_type> keys_output(size);
+        HIP_CHECK(
+            hipMemcpy(
+                keys_output.data(), d_keys,
+                size * sizeof(key_type),
+                hipMemcpyDeviceToHost
+            )
+        );
+        HIP_CHECK(hipFree(d_keys));
+
+        // Sorted, and a permutation of the input
+        std::vector<size_t> counts(size_t(1) << (sizeof(key_type) * 8), 0);
+        for(size_t i = 0; i < keys_input.size(); i++)
+        {
+            counts[keys_input[i]]++;
+        }
+        for(size_t i = 0; i < keys_output.size(); i++)
+        {
+            if(i > 0)
+            {
+                ASSERT_LE(keys_output[i - 1], keys_output[i]) << "where index = " << i;
+            }
+            counts[keys_output[i]]--;
+        }
+        for(size_t key = 0; key < counts.size(); key++)
+        {
+            ASSERT_EQ(counts[key], 0U) << "where key = " << key;
+        }
+    }
+}
+
+// Keys of a few significant bits above a common base, e.g. timestamps, for which
+// narrowing the bit range skips the passes over the upper digits.  With
+// significant_bits == 0 all keys are equal and no pass is left.
+std::vector<long long> get_narrow_range_keys(size_t size, int significant_bits, unsigned int seed_value)
+{
+    const long long base = 1600000000000LL;
+    const long long span = (1LL << significant_bits) - 1;
+    std::vector<long long> keys = test_utils::get_random_data<long long>(size, 0, span, seed_value);
+    for(size_t i = 0; i < size; i++)
+    {
+        keys[i] += base;
+    }
+    return keys;
+}
+
+template<bool Descending>
+void test_sort_pairs_onesweep_narrow_bit_range()
+{
+    using key_type = long long;
+    using value_type = unsigned int;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(int significant_bits : { 0, 5, 20, 28 })
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20)) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+            SCOPED_TRACE(testing::Message() << "with significant_bits = " << significant_bits);
+
+            // Generate data
+            std::vector<key_type> keys_input = get_narrow_range_keys(size, significant_bits, seed_value);
+            std::vector<value_type> values_input(size);
+            std::iota(values_input.begin(), values_input.end(), 0);
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            value_type * d_values_input;
+            value_type * d_values_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_input, size * sizeof(value_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_output, size * sizeof(value_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_values_input, values_input.data(),
+                    size * sizeof(value_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            using key_value = std::pair<key_type, value_type>;
+
+            // Calculate expected results on host
+            std::vector<key_value> expected(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                expected[i] = key_value(keys_input[i], values_input[i]);
+            }
+            std::stable_sort(
+                expected.begin(), expected.end(),
+                key_value_comparator<key_type, value_type, Descending, 0, sizeof(key_type) * 8>()
+            );
+
+            void * d_temporary_storage = nullptr;
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortPairsOnesweep(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                    0, sizeof(key_type) * 8,
+                    stream, debug_synchronous,
+                    true
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            if(Descending)
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortPairsDescendingOnesweep(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                        0, sizeof(key_type) * 8,
+                        stream, debug_synchronous,
+                        true
+                    )
+                );
+            }
+            else
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortPairsOnesweep(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                        0, sizeof(key_type) * 8,
+                        stream, debug_synchronous,
+                        true
+                    )
+                );
+            }
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_values_input));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys_output,
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            std::vector<value_type> values_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    values_output.data(), d_values_output,
+                    size * sizeof(value_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys_output));
+            HIP_CHECK(hipFree(d_values_output));
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(keys_output[i], expected[i].first);
+                ASSERT_EQ(values_output[i], expected[i].second);
+            }
+        }
+    }
+}
+
+TEST(HipcubDeviceRadixSortNarrowBitRange, SortPairsOnesweep)
+{
+    test_sort_pairs_onesweep_narrow_bit_range<false>();
+}
+
+TEST(HipcubDeviceRadixSortNarrowBitRange, SortPairsDescendingOnesweep)
+{
+    test_sort_pairs_onesweep_narrow_bit_range<true>();
+}
+
+TEST(HipcubDeviceRadixSortNarrowBitRange, SortKeysDoubleBufferOnesweep)
+{
+    using key_type = long long;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(int significant_bits : { 0, 5, 20, 28 })
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20)) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+            SCOPED_TRACE(testing::Message() << "with significant_bits = " << significant_bits);
+
+            // Generate data
+            std::vector<key_type> keys_input = get_narrow_range_keys(size, significant_bits, seed_value);
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            // Calculate expected results on host
+            std::vector<key_type> expected(keys_input);
+            std::stable_sort(expected.begin(), expected.end());
+
+            hipcub::DoubleBuffer<key_type> d_keys(d_keys_input, d_keys_output);
+
+            void * d_temporary_storage = nullptr;
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortKeysOnesweep(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys, size,
+                    0, sizeof(key_type) * 8,
+                    stream, debug_synchronous,
+                    true
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortKeysOnesweep(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys, size,
+                    0, sizeof(key_type) * 8,
+                    stream, debug_synchronous,
+                    true
+                )
+            );
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys.Current(),
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_keys_output));
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(keys_output[i], expected[i]);
+            }
+        }
+    }
+}
+
+// Keys in the orders that check_presorted tells apart: in order, in reverse order,
+// strictly in reverse order, nearly in order and random.  Only strictly reversed
+// keys are sorted by a reversal, as equal keys would not keep their order otherwise.
+enum class presorted_order { random, ascending, descending, strictly_descending, nearly_ascending };
+
+std::vector<long long> get_presorted_keys(size_t size, presorted_order order, unsigned int seed_value)
+{
+    const long long base = 1600000000000LL;
+    std::vector<long long> keys = test_utils::get_random_data<long long>(size, 0, 1 << 20, seed_value);
+    switch(order)
+    {
+        case presorted_order::ascending:
+            std::sort(keys.begin(), keys.end());
+            break;
+        case presorted_order::descending:
+            std::sort(keys.begin(), keys.end(), std::greater<long long>());
+            break;
+        case presorted_order::strictly_descending:
+            for(size_t i = 0; i < size; i++)
+            {
+                keys[i] = static_cast<long long>(size - i) * 3;
+            }
+            break;
+        case presorted_order::nearly_ascending:
+            std::sort(keys.begin(), keys.end());
+            if(size > 1)
+            {
+                std::swap(keys[0], keys[size - 1]);
+            }
+            break;
+        default:
+            break;
+    }
+    for(size_t i = 0; i < size; i++)
+    {
+        keys[i] += base;
+    }
+    return keys;
+}
+
+const std::vector<presorted_order> presorted_orders = {
+    presorted_order::random,
+    presorted_order::ascending,
+    presorted_order::descending,
+    presorted_order::strictly_descending,
+    presorted_order::nearly_ascending
+};
+
+template<bool Descending>
+void test_sort_pairs_onesweep_check_presorted()
+{
+    using key_type = long long;
+    using value_type = unsigned int;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(bool narrow_bit_range : { false, true })
+    for(presorted_order order : presorted_orders)
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20)) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+            SCOPED_TRACE(testing::Message() << "with order = " << static_cast<int>(order));
+            SCOPED_TRACE(testing::Message() << "with narrow_bit_range = " << narrow_bit_range);
+
+            // Generate data
+            std::vector<key_type> keys_input = get_presorted_keys(size, order, seed_value);
+            std::vector<value_type> values_input(size);
+            std::iota(values_input.begin(), values_input.end(), 0);
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            value_type * d_values_input;
+            value_type * d_values_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_input, size * sizeof(value_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_output, size * sizeof(value_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_values_input, values_input.data(),
+                    size * sizeof(value_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            using key_value = std::pair<key_type, value_type>;
+
+            // Calculate expected results on host
+            std::vector<key_value> expected(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                expected[i] = key_value(keys_input[i], values_input[i]);
+            }
+            std::stable_sort(
+                expected.begin(), expected.end(),
+                key_value_comparator<key_type, value_type, Descending, 0, sizeof(key_type) * 8>()
+            );
+
+            void * d_temporary_storage = nullptr;
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortPairsOnesweep(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                    0, sizeof(key_type) * 8,
+                    stream, debug_synchronous,
+                    narrow_bit_range, true
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            if(Descending)
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortPairsDescendingOnesweep(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                        0, sizeof(key_type) * 8,
+                        stream, debug_synchronous,
+                        narrow_bit_range, true
+                    )
+                );
+            }
+            else
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortPairsOnesweep(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                        0, sizeof(key_type) * 8,
+                        stream, debug_synchronous,
+                        narrow_bit_range, true
+                    )
+                );
+            }
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_values_input));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys_output,
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            std::vector<value_type> values_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    values_output.data(), d_values_output,
+                    size * sizeof(value_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys_output));
+            HIP_CHECK(hipFree(d_values_output));
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(keys_output[i], expected[i].first);
+                ASSERT_EQ(values_output[i], expected[i].second);
+            }
+        }
+    }
+}
+
+TEST(HipcubDeviceRadixSortCheckPresorted, SortPairsOnesweep)
+{
+    test_sort_pairs_onesweep_check_presorted<false>();
+}
+
+TEST(HipcubDeviceRadixSortCheckPresorted, SortPairsDescendingOnesweep)
+{
+    test_sort_pairs_onesweep_check_presorted<true>();
+}
+
+// In place, with an even (64 bits) and an odd (24 bits) number of passes, so that
+// presorted keys end up in either buffer
+TEST(HipcubDeviceRadixSortCheckPresorted, SortKeysDoubleBufferOnesweep)
+{
+    using key_type = long long;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(int end_bit : { 64, 24 })
+    for(presorted_order order : presorted_orders)
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20)) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+            SCOPED_TRACE(testing::Message() << "with order = " << static_cast<int>(order));
+            SCOPED_TRACE(testing::Message() << "with end_bit = " << end_bit);
+
+            // Generate data
+            std::vector<key_type> keys_input = get_presorted_keys(size, order, seed_value);
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            // Calculate expected results on host, the keys are positive so that the
+            // bits below end_bit compare as unsigned
+            const long long mask = (end_bit == 64) ? -1LL : ((1LL << end_bit) - 1);
+            std::vector<key_type> expected(keys_input);
+            std::stable_sort(
+                expected.begin(), expected.end(),
+                [mask](const key_type& a, const key_type& b) { return (a & mask) < (b & mask); }
+            );
+
+            hipcub::DoubleBuffer<key_type> d_keys(d_keys_input, d_keys_output);
+
+            void * d_temporary_storage = nullptr;
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortKeysOnesweep(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys, size,
+                    0, end_bit,
+                    stream, debug_synchronous,
+                    false, true
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortKeysOnesweep(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys, size,
+                    0, end_bit,
+                    stream, debug_synchronous,
+                    false, true
+                )
+            );
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys.Current(),
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_keys_output));
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(keys_output[i], expected[i]);
+            }
+        }
+    }
+}
+
+// Indices of presorted keys are generated in order or in reverse order
+TEST(HipcubDeviceRadixSortCheckPresorted, SortIndices)
+{
+    using key_type = long long;
+    using index_type = unsigned int;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(presorted_order order : presorted_orders)
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20)) continue;
+
+        unsigned int seed_value = rand();
+        SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+        SCOPED_TRACE(testing::Message() << "with order = " << static_cast<int>(order));
+
+        // Generate data
+        std::vector<key_type> keys_input = get_presorted_keys(size, order, seed_value);
+
+        key_type * d_keys_input;
+        index_type * d_indices_output;
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_indices_output, size * sizeof(index_type)));
+        HIP_CHECK(
+            hipMemcpy(
+                d_keys_input, keys_input.data(),
+                size * sizeof(key_type),
+                hipMemcpyHostToDevice
+            )
+        );
+
+        // Calculate expected results on host
+        std::vector<index_type> expected(size);
+        std::iota(expected.begin(), expected.end(), 0);
+        std::stable_sort(
+            expected.begin(), expected.end(),
+            [&keys_input](index_type a, index_type b) { return keys_input[a] < keys_input[b]; }
+        );
+
+        void * d_temporary_storage = nullptr;
+        size_t temporary_storage_bytes = 0;
+        HIP_CHECK(
+            hipcub::DeviceRadixSort::SortIndices(
+                d_temporary_storage, temporary_storage_bytes,
+                d_keys_input, static_cast<key_type *>(nullptr), d_indices_output, size,
+                0, sizeof(key_type) * 8,
+                stream, debug_synchronous,
+                false, true
+            )
+        );
+
+        ASSERT_GT(temporary_storage_bytes, 0U);
+
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+        HIP_CHECK(
+            hipcub::DeviceRadixSort::SortIndices(
+                d_temporary_storage, temporary_storage_bytes,
+                d_keys_input, static_cast<key_type *>(nullptr), d_indices_output, size,
+                0, sizeof(key_type) * 8,
+                stream, debug_synchronous,
+                false, true
+            )
+        );
+
+        HIP_CHECK(hipFree(d_temporary_storage));
+
+        std::vector<index_type> indices_output(size);
+        HIP_CHECK(
+            hipMemcpy(
+                indices_output.data(), d_indices_output,
+                size * sizeof(index_type),
+                hipMemcpyDeviceToHost
+            )
+        );
+
+        HIP_CHECK(hipFree(d_keys_input));
+        HIP_CHECK(hipFree(d_indices_output));
+
+        for(size_t i = 0; i < size; i++)
+        {
+            ASSERT_EQ(indices_output[i], expected[i]);
+        }
+    }
+}
+
+// ---------------------------------------------------------
+// Test for radix sort over composite keys
+// ---------------------------------------------------------
+
+struct custom_record_key
+{
+    uint16_t tenant;
+    int64_t timestamp;
+    float score;
+};
+
+struct custom_record_key_decomposer
+{
+    HIPCUB_HOST_DEVICE
+    ::rocprim::tuple<uint16_t&, int64_t&, float&> operator()(custom_record_key& key) const
+    {
+        return ::rocprim::tuple<uint16_t&, int64_t&, float&>(key.tenant, key.timestamp, key.score);
+    }
+};
+
+template<bool Descending>
+struct custom_record_key_comparator
+{
+    bool operator()(const custom_record_key& lhs, const custom_record_key& rhs) const
+    {
+        const auto l = std::make_tuple(lhs.tenant, lhs.timestamp, lhs.score);
+        const auto r = std::make_tuple(rhs.tenant, rhs.timestamp, rhs.score);
+        return Descending ? (r < l) : (l < r);
+    }
+};
+
+std::vector<custom_record_key> get_custom_record_keys(size_t size, unsigned int seed_value)
+{
+    // Few tenants and timestamps so that every field decides some comparisons
+    const std::vector<uint16_t> tenants = test_utils::get_random_data<uint16_t>(size, 0, 7, seed_value);
+    const std::vector<int64_t> timestamps = test_utils::get_random_data<int64_t>(size, -100, 100, seed_value + 1);
+    const std::vector<float> scores = test_utils::get_random_data<float>(size, -1000.0f, 1000.0f, seed_value + 2);
+
+    std::vector<custom_record_key> keys(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        keys[i].tenant = tenants[i];
+        keys[i].timestamp = timestamps[i];
+        keys[i].score = scores[i];
+    }
+    return keys;
+}
+
+template<bool Descending>
+void test_custom_record_key_sort_pairs()
+{
+    using key_type = custom_record_key;
+    using value_type = unsigned int;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20)) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+            // Generate data
+            std::vector<key_type> keys_input = get_custom_record_keys(size, seed_value);
+            std::vector<value_type> values_input(size);
+            std::iota(values_input.begin(), values_input.end(), 0);
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            value_type * d_values_input;
+            value_type * d_values_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_input, size * sizeof(value_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_output, size * sizeof(value_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_values_input, values_input.data(),
+                    size * sizeof(value_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            // Calculate expected results on host
+            std::vector<value_type> expected(values_input);
+            std::stable_sort(
+                expected.begin(), expected.end(),
+                [&](value_type lhs, value_type rhs)
+                {
+                    return custom_record_key_comparator<Descending>()(keys_input[lhs], keys_input[rhs]);
+                }
+            );
+
+            void * d_temporary_storage = nullptr;
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortPairs(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                    custom_record_key_decomposer()
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            if(Descending)
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortPairsDescending(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                        custom_record_key_decomposer(),
+                        0, sizeof(uint16_t) * 8 + sizeof(int64_t) * 8 + sizeof(float) * 8,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+            else
+            {
+                HIP_CHECK(
+                    hipcub::DeviceRadixSort::SortPairs(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_values_input, d_values_output, size,
+                        custom_record_key_decomposer(),
+                        0, sizeof(uint16_t) * 8 + sizeof(int64_t) * 8 + sizeof(float) * 8,
+                        stream, debug_synchronous
+                    )
+                );
+            }
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_values_input));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys_output,
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            std::vector<value_type> values_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    values_output.data(), d_values_output,
+                    size * sizeof(value_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys_output));
+            HIP_CHECK(hipFree(d_values_output));
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(values_output[i], expected[i]);
+                ASSERT_EQ(keys_output[i].tenant, keys_input[expected[i]].tenant);
+                ASSERT_EQ(keys_output[i].timestamp, keys_input[expected[i]].timestamp);
+                ASSERT_EQ(keys_output[i].score, keys_input[expected[i]].score);
+            }
+        }
+    }
+}
+
+TEST(HipcubDeviceRadixSortDecomposer, SortPairs)
+{
+    test_custom_record_key_sort_pairs<false>();
+}
+
+TEST(HipcubDeviceRadixSortDecomposer, SortPairsDescending)
+{
+    test_custom_record_key_sort_pairs<true>();
+}
+
+TEST(HipcubDeviceRadixSortDecomposer, SortKeysDoubleBuffer)
+{
+    using key_type = custom_record_key;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    // Sort by tenant and timestamp only, ignoring the score
+    constexpr int begin_bit = sizeof(float) * 8;
+    constexpr int end_bit = begin_bit + sizeof(int64_t) * 8 + sizeof(uint16_t) * 8;
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(size_t size : sizes)
+    {
+        if(size > (1 << 20)) continue;
+
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+            // Generate data
+            std::vector<key_type> keys_input = get_custom_record_keys(size, seed_value);
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            // Calculate expected results on host, stable on the ignored score
+            std::vector<key_type> expected(keys_input);
+            std::stable_sort(
+                expected.begin(), expected.end(),
+                [](const key_type& lhs, const key_type& rhs)
+                {
+                    return std::make_tuple(lhs.tenant, lhs.timestamp) < std::make_tuple(rhs.tenant, rhs.timestamp);
+                }
+            );
+
+            hipcub::DoubleBuffer<key_type> d_keys(d_keys_input, d_keys_output);
+
+            void * d_temporary_storage = nullptr;
+            size_t temporary_storage_bytes = 0;
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortKeys(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys, size,
+                    custom_record_key_decomposer(),
+                    begin_bit, end_bit
+                )
+            );
+
+            ASSERT_GT(temporary_storage_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+            HIP_CHECK(
+                hipcub::DeviceRadixSort::SortKeys(
+                    d_temporary_storage, temporary_storage_bytes,
+                    d_keys, size,
+                    custom_record_key_decomposer(),
+                    begin_bit, end_bit,
+                    stream, debug_synchronous
+                )
+            );
+
+            HIP_CHECK(hipFree(d_temporary_storage));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys.Current(),
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_keys_output));
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(keys_output[i].tenant, expected[i].tenant);
+                ASSERT_EQ(keys_output[i].timestamp, expected[i].timestamp);
+                ASSERT_EQ(keys_output[i].score, expected[i].score);
+            }
+        }
+    }
+}
+
+#endif // HIPCUB_ROCPRIM_API
@@ -447,3 +447,125 @@ TYPED_TEST(HipcubDeviceReduceTests, ReduceArgMaximum)
         }
     }
 }
+
+// ---------------------------------------------------------
+// Test for 64-bit num_items
+// ---------------------------------------------------------
+
+#ifdef HIPCUB_ROCPRIM_API
+
+// Inputs of more than 2^31 - 1 items are reduced in chunks of 2^30 items; the same
+// code path is exercised here with small chunks
+TEST(HipcubDeviceReduceLargeNumItemsTests, ReduceChunks)
+{
+    hipStream_t stream = 0; // default
+
+    const size_t size = 100000;
+    std::vector<long long> input = test_utils::get_random_data<long long>(size, -1000, 1000, 0);
+    std::vector<long long> output(1, 0);
+
+    long long * d_input;
+    long long * d_output;
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_input, size * sizeof(long long)));
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_output, sizeof(long long)));
+    HIP_CHECK(hipMemcpy(d_input, input.data(), size * sizeof(long long), hipMemcpyHostToDevice));
+
+    const long long init = 5;
+    const long long expected = std::accumulate(input.begin(), input.end(), init);
+    auto reduce_op = hipcub::detail::convert_result_type<long long *, long long *>(hipcub::Sum());
+
+    for(size_t chunk_items : { size_t(1000), size_t(4096), size_t(33333), size_t(1) << 20 })
+    {
+        SCOPED_TRACE(testing::Message() << "with chunk_items = " << chunk_items);
+
+        size_t temp_storage_size_bytes;
+        HIP_CHECK(
+            hipcub::detail::reduce_large<long long>(
+                nullptr, temp_storage_size_bytes,
+                d_input, d_output, size, reduce_op, init,
+                stream, false, chunk_items
+            )
+        );
+        ASSERT_GT(temp_storage_size_bytes, 0U);
+
+        void * d_temp_storage = nullptr;
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+        HIP_CHECK(
+            hipcub::detail::reduce_large<long long>(
+                d_temp_storage, temp_storage_size_bytes,
+                d_input, d_output, size, reduce_op, init,
+                stream, false, chunk_items
+            )
+        );
+        HIP_CHECK(hipDeviceSynchronize());
+
+        HIP_CHECK(hipMemcpy(output.data(), d_output, sizeof(long long), hipMemcpyDeviceToHost));
+        ASSERT_EQ(output[0], expected);
+
+        hipFree(d_temp_storage);
+    }
+
+    hipFree(d_input);
+    hipFree(d_output);
+}
+
+TEST(HipcubDeviceReduceLargeNumItemsTests, NumItemsTypes)
+{
+    hipStream_t stream = 0; // default
+
+    const size_t size = 12345;
+    std::vector<int> input = test_utils::get_random_data<int>(size, 0, 100, 0);
+    input[size - 7] = 1000;
+
+    int * d_input;
+    long long * d_sum;
+    hipcub::KeyValuePair<int64_t, int> * d_arg_max;
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_input, size * sizeof(int)));
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_sum, sizeof(long long)));
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_arg_max, sizeof(hipcub::KeyValuePair<int64_t, int>)));
+    HIP_CHECK(hipMemcpy(d_input, input.data(), size * sizeof(int), hipMemcpyHostToDevice));
+
+    size_t temp_storage_size_bytes = 0;
+    size_t bytes;
+    HIP_CHECK(hipcub::DeviceReduce::Sum(nullptr, bytes, d_input, d_sum, int64_t(size), stream));
+    temp_storage_size_bytes = std::max(temp_storage_size_bytes, bytes);
+    HIP_CHECK(hipcub::DeviceReduce::ArgMax(nullptr, bytes, d_input, d_arg_max, uint64_t(size), stream));
+    temp_storage_size_bytes = std::max(temp_storage_size_bytes, bytes);
+
+    void * d_temp_storage = nullptr;
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+
+    bytes = temp_storage_size_bytes;
+    HIP_CHECK(hipcub::DeviceReduce::Sum(d_temp_storage, bytes, d_input, d_sum, int64_t(size), stream));
+    bytes = temp_storage_size_bytes;
+    HIP_CHECK(hipcub::DeviceReduce::ArgMax(d_temp_storage, bytes, d_input, d_arg_max, uint64_t(size), stream));
+    HIP_CHECK(hipDeviceSynchronize());
+
+    long long sum;
+    hipcub::KeyValuePair<int64_t, int> arg_max;
+    HIP_CHECK(hipMemcpy(&sum, d_sum, sizeof(long long), hipMemcpyDeviceToHost));
+    HIP_CHECK(hipMemcpy(&arg_max, d_arg_max, sizeof(arg_max), hipMemcpyDeviceToHost));
+    ASSERT_EQ(sum, std::accumulate(input.begin(), input.end(), 0LL));
+    ASSERT_EQ(arg_max.key, int64_t(size - 7));
+    ASSERT_EQ(arg_max.value, 1000);
+
+    // Negative sizes and indices that do not fit in the key type are rejected
+    ASSERT_EQ(
+        hipcub::DeviceReduce::Sum(nullptr, bytes, d_input, d_sum, int64_t(-1), stream),
+        hipErrorInvalidValue
+    );
+    ASSERT_EQ(
+        hipcub::DeviceReduce::ArgMax(
+            nullptr, bytes, d_input, reinterpret_cast<hipcub::KeyValuePair<int, int> *>(d_arg_max),
+            int64_t(1) << 31, stream
+        ),
+        hipErrorInvalidValue
+    );
+
+    hipFree(d_input);
+    hipFree(d_sum);
+    hipFree(d_arg_max);
+    hipFree(d_temp_storage);
+}
+
+#endif // HIPCUB_ROCPRIM_API
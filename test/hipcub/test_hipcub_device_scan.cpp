@@ -331,3 +331,125 @@ TYPED_TEST(HipcubDeviceScanTests, ExclusiveScan)
         }
     }
 }
+
+// ---------------------------------------------------------
+// Test for 64-bit num_items
+// ---------------------------------------------------------
+
+#ifdef HIPCUB_ROCPRIM_API
+
+// Inputs of more than 2^31 - 1 items are scanned in chunks of 2^30 items; the same
+// code path is exercised here with small chunks, out of place and in place
+TEST(HipcubDeviceScanLargeNumItemsTests, ScanChunks)
+{
+    hipStream_t stream = 0; // default
+
+    const size_t size = 100000;
+    const long long init = 7;
+    std::vector<long long> input = test_utils::get_random_data<long long>(size, -1000, 1000, 0);
+
+    std::vector<long long> expected_inclusive(size);
+    std::vector<long long> expected_exclusive(size);
+    test_utils::host_inclusive_scan(
+        input.begin(), input.end(), expected_inclusive.begin(), hipcub::Sum()
+    );
+    test_utils::host_exclusive_scan(
+        input.begin(), input.end(), init, expected_exclusive.begin(), hipcub::Sum()
+    );
+
+    long long * d_input;
+    long long * d_output;
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_input, size * sizeof(long long)));
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_output, size * sizeof(long long)));
+
+    auto scan_op = hipcub::detail::convert_result_type<long long *, long long *>(hipcub::Sum());
+
+    for(size_t chunk_items : { size_t(1000), size_t(4096), size_t(33333), size_t(1) << 20 })
+    for(bool exclusive : { false, true })
+    for(bool in_place : { false, true })
+    {
+        SCOPED_TRACE(testing::Message() << "with chunk_items = " << chunk_items);
+        SCOPED_TRACE(testing::Message() << "with exclusive = " << exclusive);
+        SCOPED_TRACE(testing::Message() << "with in_place = " << in_place);
+
+        HIP_CHECK(hipMemcpy(d_input, input.data(), size * sizeof(long long), hipMemcpyHostToDevice));
+        long long * d_scan_output = in_place ? d_input : d_output;
+
+        auto scan = [&](void * d_temp_storage, size_t& temp_storage_size_bytes)
+        {
+            return exclusive
+                ? hipcub::detail::scan_large<true, long long>(
+                    d_temp_storage, temp_storage_size_bytes,
+                    d_input, d_scan_output, size, scan_op, init,
+                    stream, false, chunk_items)
+                : hipcub::detail::scan_large<false, long long>(
+                    d_temp_storage, temp_storage_size_bytes,
+                    d_input, d_scan_output, size, scan_op, 0LL,
+                    stream, false, chunk_items);
+        };
+
+        size_t temp_storage_size_bytes;
+        HIP_CHECK(scan(nullptr, temp_storage_size_bytes));
+        ASSERT_GT(temp_storage_size_bytes, 0U);
+
+        void * d_temp_storage = nullptr;
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+        HIP_CHECK(scan(d_temp_storage, temp_storage_size_bytes));
+        HIP_CHECK(hipDeviceSynchronize());
+
+        std::vector<long long> output(size);
+        HIP_CHECK(hipMemcpy(output.data(), d_scan_output, size * sizeof(long long), hipMemcpyDeviceToHost));
+        const std::vector<long long>& expected = exclusive ? expected_exclusive : expected_inclusive;
+        for(size_t i = 0; i < size; i++)
+        {
+            ASSERT_EQ(output[i], expected[i]) << "where index = " << i;
+        }
+
+        hipFree(d_temp_storage);
+    }
+
+    hipFree(d_input);
+    hipFree(d_output);
+}
+
+TEST(HipcubDeviceScanLargeNumItemsTests, NumItemsTypes)
+{
+    hipStream_t stream = 0; // default
+
+    const size_t size = 12345;
+    std::vector<int> input = test_utils::get_random_data<int>(size, 0, 100, 0);
+    std::vector<long long> expected(size);
+    test_utils::host_inclusive_scan(input.begin(), input.end(), expected.begin(), hipcub::Sum());
+
+    int * d_input;
+    long long * d_output;
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_input, size * sizeof(int)));
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_output, size * sizeof(long long)));
+    HIP_CHECK(hipMemcpy(d_input, input.data(), size * sizeof(int), hipMemcpyHostToDevice));
+
+    size_t temp_storage_size_bytes;
+    HIP_CHECK(hipcub::DeviceScan::InclusiveSum(nullptr, temp_storage_size_bytes, d_input, d_output, int64_t(size), stream));
+
+    void * d_temp_storage = nullptr;
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+    HIP_CHECK(hipcub::DeviceScan::InclusiveSum(d_temp_storage, temp_storage_size_bytes, d_input, d_output, int64_t(size), stream));
+    HIP_CHECK(hipDeviceSynchronize());
+
+    std::vector<long long> output(size);
+    HIP_CHECK(hipMemcpy(output.data(), d_output, size * sizeof(long long), hipMemcpyDeviceToHost));
+    for(size_t i = 0; i < size; i++)
+    {
+        ASSERT_EQ(output[i], expected[i]) << "where index = " << i;
+    }
+
+    ASSERT_EQ(
+        hipcub::DeviceScan::ExclusiveSum(nullptr, temp_storage_size_bytes, d_input, d_output, int64_t(-1), stream),
+        hipErrorInvalidValue
+    );
+
+    hipFree(d_input);
+    hipFree(d_output);
+    hipFree(d_temp_storage);
+}
+
+#endif // HIPCUB_ROCPRIM_API
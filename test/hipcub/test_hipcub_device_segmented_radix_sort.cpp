@@ -838,3 +838,313 @@ TYPED_TEST(HipcubDeviceSegmentedRadixSort, SortPairsDoubleBuffer)
         }
     }
 }
+
+#ifdef HIPCUB_ROCPRIM_API
+
+template<bool Descending, class Key, class Value>
+hipError_t run_sort_batched(void * d_temp_storage,
+                            size_t& temp_storage_bytes,
+                            const Key * d_keys_input,
+                            Key * d_keys_output,
+                            const Value * d_values_input,
+                            Value * d_values_output,
+                            int segments_count,
+                            int segment_length,
+                            int segment_stride,
+                            int start_bit,
+                            int end_bit,
+                            hipStream_t stream,
+                            bool debug_synchronous)
+{
+    if(d_values_input == nullptr)
+    {
+        return Descending
+            ? hipcub::DeviceSegmentedRadixSort::SortKeysDescendingBatched(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                segments_count, segment_length, segment_stride,
+                start_bit, end_bit, stream, debug_synchronous)
+            : hipcub::DeviceSegmentedRadixSort::SortKeysBatched(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                segments_count, segment_length, segment_stride,
+                start_bit, end_bit, stream, debug_synchronous);
+    }
+    return Descending
+        ? hipcub::DeviceSegmentedRadixSort::SortPairsDescendingBatched(
+            d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+            d_values_input, d_values_output,
+            segments_count, segment_length, segment_stride,
+            start_bit, end_bit, stream, debug_synchronous)
+        : hipcub::DeviceSegmentedRadixSort::SortPairsBatched(
+            d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+            d_values_input, d_values_output,
+            segments_count, segment_length, segment_stride,
+            start_bit, end_bit, stream, debug_synchronous);
+}
+
+// The same sorts with the length of the segments known at compile time
+template<int SegmentLength, bool Descending, class Key, class Value>
+hipError_t run_sort_batched(void * d_temp_storage,
+                            size_t& temp_storage_bytes,
+                            const Key * d_keys_input,
+                            Key * d_keys_output,
+                            const Value * d_values_input,
+                            Value * d_values_output,
+                            int segments_count,
+                            int segment_stride,
+                            int start_bit,
+                            int end_bit,
+                            hipStream_t stream,
+                            bool debug_synchronous)
+{
+    if(d_values_input == nullptr)
+    {
+        return Descending
+            ? hipcub::DeviceSegmentedRadixSort::SortKeysDescendingBatched<SegmentLength>(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                segments_count, segment_stride,
+                start_bit, end_bit, stream, debug_synchronous)
+            : hipcub::DeviceSegmentedRadixSort::SortKeysBatched<SegmentLength>(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                segments_count, segment_stride,
+                start_bit, end_bit, stream, debug_synchronous);
+    }
+    return Descending
+        ? hipcub::DeviceSegmentedRadixSort::SortPairsDescendingBatched<SegmentLength>(
+            d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+            d_values_input, d_values_output,
+            segments_count, segment_stride,
+            start_bit, end_bit, stream, debug_synchronous)
+        : hipcub::DeviceSegmentedRadixSort::SortPairsBatched<SegmentLength>(
+            d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+            d_values_input, d_values_output,
+            segments_count, segment_stride,
+            start_bit, end_bit, stream, debug_synchronous);
+}
+
+template<bool Descending, class Key, class Value>
+hipError_t run_sort_batched_any(void * d_temp_storage,
+                                size_t& temp_storage_bytes,
+                                const Key * d_keys_input,
+                                Key * d_keys_output,
+                                const Value * d_values_input,
+                                Value * d_values_output,
+                                int segments_count,
+                                int segment_length,
+                                int segment_stride,
+                                int start_bit,
+                                int end_bit,
+                                hipStream_t stream,
+                                bool debug_synchronous)
+{
+    switch(segment_length)
+    {
+        case 1000:
+            return run_sort_batched<1000, Descending>(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                d_values_input, d_values_output, segments_count, segment_stride,
+                start_bit, end_bit, stream, debug_synchronous);
+        case 5000:
+            return run_sort_batched<5000, Descending>(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                d_values_input, d_values_output, segments_count, segment_stride,
+                start_bit, end_bit, stream, debug_synchronous);
+        default:
+            return run_sort_batched<Descending>(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                d_values_input, d_values_output, segments_count, segment_length, segment_stride,
+                start_bit, end_bit, stream, debug_synchronous);
+    }
+}
+
+template<class Params, bool WithValues>
+void test_sort_batched()
+{
+    using key_type = typename Params::key_type;
+    using value_type = typename Params::value_type;
+    constexpr bool descending = Params::descending;
+    constexpr unsigned int start_bit = Params::start_bit;
+    constexpr unsigned int end_bit = Params::end_bit;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    // Lengths sorted by blocks, with the length known at run time or compile time,
+    // and by the segmented sort
+    const std::vector<size_t> segment_lengths = { 1, 37, 128, 1000, 1792, 4096, 5000, 12345 };
+    for(size_t segment_length : segment_lengths)
+    {
+        // Segments either follow each other or leave gaps that must be left untouched
+        for(size_t gap : { 0, 5 })
+        {
+            const size_t segment_stride = segment_length + gap;
+            const size_t segments_count = std::max<size_t>(1, std::min<size_t>(1000, (1 << 18) / segment_stride));
+            const size_t size = segments_count * segment_stride;
+            SCOPED_TRACE(testing::Message() << "with segment_length = " << segment_length);
+            SCOPED_TRACE(testing::Message() << "with segment_stride = " << segment_stride);
+
+            for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+            {
+                unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+                SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+
+                // Generate data
+                std::vector<key_type> keys_input;
+                if(std::is_floating_point<key_type>::value)
+                {
+                    keys_input = test_utils::get_random_data<key_type>(
+                        size,
+                        (key_type)-1000,
+                        (key_type)+1000,
+                        seed_value
+                    );
+                }
+                else
+                {
+                    keys_input = test_utils::get_random_data<key_type>(
+                        size,
+                        std::numeric_limits<key_type>::min(),
+                        std::numeric_limits<key_type>::max(),
+                        seed_value + seed_value_addition
+                    );
+                }
+
+                std::vector<value_type> values_input(size);
+                std::iota(values_input.begin(), values_input.end(), 0);
+
+                key_type * d_keys_input;
+                key_type * d_keys_output;
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+                HIP_CHECK(
+                    hipMemcpy(
+                        d_keys_input, keys_input.data(),
+                        size * sizeof(key_type),
+                        hipMemcpyHostToDevice
+                    )
+                );
+                HIP_CHECK(hipMemset(d_keys_output, 0, size * sizeof(key_type)));
+
+                value_type * d_values_input = nullptr;
+                value_type * d_values_output = nullptr;
+                if(WithValues)
+                {
+                    HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_input, size * sizeof(value_type)));
+                    HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_output, size * sizeof(value_type)));
+                    HIP_CHECK(
+                        hipMemcpy(
+                            d_values_input, values_input.data(),
+                            size * sizeof(value_type),
+                            hipMemcpyHostToDevice
+                        )
+                    );
+                    HIP_CHECK(hipMemset(d_values_output, 0, size * sizeof(value_type)));
+                }
+
+                // Calculate expected results on host, gaps are left as they were
+                using key_value = std::pair<key_type, value_type>;
+                std::vector<key_value> expected(size, key_value(key_type(0), value_type(0)));
+                for(size_t i = 0; i < segments_count; i++)
+                {
+                    const size_t segment_begin = i * segment_stride;
+                    for(size_t j = segment_begin; j < segment_begin + segment_length; j++)
+                    {
+                        expected[j] = key_value(keys_input[j], values_input[j]);
+                    }
+                    std::stable_sort(
+                        expected.begin() + segment_begin,
+                        expected.begin() + segment_begin + segment_length,
+                        key_value_comparator<key_type, value_type, descending, start_bit, end_bit>()
+                    );
+                }
+
+                size_t temporary_storage_bytes = 0;
+                HIP_CHECK(
+                    run_sort_batched_any<descending>(
+                        nullptr, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_values_input, d_values_output,
+                        int(segments_count), int(segment_length), int(segment_stride),
+                        start_bit, end_bit, stream, debug_synchronous
+                    )
+                );
+
+                ASSERT_GT(temporary_storage_bytes, 0U);
+
+                void * d_temporary_storage;
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_temporary_storage, temporary_storage_bytes));
+
+                HIP_CHECK(
+                    run_sort_batched_any<descending>(
+                        d_temporary_storage, temporary_storage_bytes,
+                        d_keys_input, d_keys_output, d_values_input, d_values_output,
+                        int(segments_count), int(segment_length), int(segment_stride),
+                        start_bit, end_bit, stream, debug_synchronous
+                    )
+                );
+
+                std::vector<key_type> keys_output(size);
+                HIP_CHECK(
+                    hipMemcpy(
+                        keys_output.data(), d_keys_output,
+                        size * sizeof(key_type),
+                        hipMemcpyDeviceToHost
+                    )
+                );
+
+                std::vector<value_type> values_output(size);
+                if(WithValues)
+                {
+                    HIP_CHECK(
+                        hipMemcpy(
+                            values_output.data(), d_values_output,
+                            size * sizeof(value_type),
+                            hipMemcpyDeviceToHost
+                        )
+                    );
+                }
+
+                HIP_CHECK(hipFree(d_temporary_storage));
+                HIP_CHECK(hipFree(d_keys_input));
+                HIP_CHECK(hipFree(d_keys_output));
+                if(WithValues)
+                {
+                    HIP_CHECK(hipFree(d_values_input));
+                    HIP_CHECK(hipFree(d_values_output));
+                }
+
+                for(size_t i = 0; i < size; i++)
+                {
+                    ASSERT_EQ(keys_output[i], expected[i].first) << "where index = " << i;
+                    if(WithValues)
+                    {
+                        ASSERT_EQ(values_output[i], expected[i].second) << "where index = " << i;
+                    }
+                }
+            }
+        }
+    }
+
+    // Overlapping segments are rejected
+    size_t temporary_storage_bytes = 0;
+    ASSERT_EQ(
+        run_sort_batched<descending>(
+            nullptr, temporary_storage_bytes,
+            static_cast<const key_type *>(nullptr), static_cast<key_type *>(nullptr),
+            static_cast<const value_type *>(nullptr), static_cast<value_type *>(nullptr),
+            10, 100, 99, start_bit, end_bit, stream, debug_synchronous
+        ),
+        hipErrorInvalidValue
+    );
+}
+
+TYPED_TEST(HipcubDeviceSegmentedRadixSort, SortKeysBatched)
+{
+    test_sort_batched<typename TestFixture::params, false>();
+}
+
+TYPED_TEST(HipcubDeviceSegmentedRadixSort, SortPairsBatched)
+{
+    test_sort_batched<typename TestFixture::params, true>();
+}
+
+#endif // HIPCUB_ROCPRIM_API
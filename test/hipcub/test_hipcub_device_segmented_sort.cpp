@@ -0,0 +1,304 @@
+// MIT License
+//
+// Copyright (c) 2021 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "common_test_header.hpp"
+
+// hipcub API
+#include "hipcub/device/device_segmented_sort.hpp"
+
+template<
+    class Key,
+    bool Descending,
+    unsigned int MinSegmentLength,
+    unsigned int MaxSegmentLength
+>
+struct params
+{
+    using key_type = Key;
+    static constexpr bool descending = Descending;
+    static constexpr unsigned int min_segment_length = MinSegmentLength;
+    static constexpr unsigned int max_segment_length = MaxSegmentLength;
+};
+
+template<class Params>
+class HipcubDeviceSegmentedSort : public ::testing::Test {
+public:
+    using params = Params;
+};
+
+typedef ::testing::Types<
+    // segments sorted by threads
+    params<int, false, 0, 16>,
+    params<unsigned char, true, 1, 10>,
+
+    // segments sorted by blocks
+    params<float, false, 17, 1000>,
+    params<short, true, 0, 2048>,
+
+    // all classes mixed
+    params<double, false, 0, 5000>,
+    params<long long, true, 0, 300>,
+
+    // segments sorted by the device, one at a time or a block each when many
+    params<int, true, 3000, 30000>,
+    params<unsigned int, false, 10000, 100000>
+> Params;
+
+TYPED_TEST_SUITE(HipcubDeviceSegmentedSort, Params);
+
+std::vector<size_t> get_sizes()
+{
+    std::vector<size_t> sizes = { 1, 10, 53, 211, 1024, 2345, 11001, 34567, (1 << 16) - 1220, 1000000 };
+    const std::vector<size_t> random_sizes = test_utils::get_random_data<size_t>(3, 1, 100000, rand());
+    sizes.insert(sizes.end(), random_sizes.begin(), random_sizes.end());
+    return sizes;
+}
+
+template<bool Descending, class Key, class Value, class OffsetIteratorT>
+hipError_t run_segmented_sort(void * d_temp_storage,
+                              size_t& temp_storage_bytes,
+                              const Key * d_keys_input,
+                              Key * d_keys_output,
+                              const Value * d_values_input,
+                              Value * d_values_output,
+                              int size,
+                              int segments_count,
+                              OffsetIteratorT d_offsets,
+                              hipStream_t stream,
+                              bool debug_synchronous)
+{
+    if(d_values_input == nullptr)
+    {
+        return Descending
+            ? hipcub::DeviceSegmentedSort::SortKeysDescending(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                size, segments_count, d_offsets, d_offsets + 1, stream, debug_synchronous)
+            : hipcub::DeviceSegmentedSort::SortKeys(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                size, segments_count, d_offsets, d_offsets + 1, stream, debug_synchronous);
+    }
+    return Descending
+        ? hipcub::DeviceSegmentedSort::StableSortPairsDescending(
+            d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+            d_values_input, d_values_output,
+            size, segments_count, d_offsets, d_offsets + 1, stream, debug_synchronous)
+        : hipcub::DeviceSegmentedSort::StableSortPairs(
+            d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+            d_values_input, d_values_output,
+            size, segments_count, d_offsets, d_offsets + 1, stream, debug_synchronous);
+}
+
+template<class Params, bool WithValues>
+void test_segmented_sort()
+{
+    using key_type = typename Params::key_type;
+    using value_type = unsigned int;
+    using offset_type = unsigned int;
+    constexpr bool descending = Params::descending;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    auto key_less = [](const key_type& lhs, const key_type& rhs)
+    {
+        return descending ? (rhs < lhs) : (lhs < rhs);
+    };
+
+    std::random_device rd;
+    std::default_random_engine gen(rd());
+
+    std::uniform_int_distribution<size_t> segment_length_dis(
+        Params::min_segment_length,
+        Params::max_segment_length
+    );
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(size_t size : sizes)
+    {
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+            // Generate data, with many equal keys to check stability
+            std::vector<key_type> keys_input;
+            if(std::is_floating_point<key_type>::value)
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size, (key_type)-1000, (key_type)+1000, seed_value
+                );
+            }
+            else
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    std::is_signed<key_type>::value ? (key_type)-100 : (key_type)0,
+                    (key_type)100,
+                    seed_value + seed_value_addition
+                );
+            }
+
+            std::vector<value_type> values_input(size);
+            std::iota(values_input.begin(), values_input.end(), 0);
+
+            std::vector<offset_type> offsets;
+            unsigned int segments_count = 0;
+            size_t offset = 0;
+            while(offset < size)
+            {
+                const size_t segment_length = segment_length_dis(gen);
+                offsets.push_back(offset);
+                segments_count++;
+                offset += segment_length;
+            }
+            offsets.push_back(size);
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            offset_type * d_offsets;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_offsets, (segments_count + 1) * sizeof(offset_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+            HIP_CHECK(
+                hipMemcpy(
+                    d_offsets, offsets.data(),
+                    (segments_count + 1) * sizeof(offset_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            value_type * d_values_input = nullptr;
+            value_type * d_values_output = nullptr;
+            if(WithValues)
+            {
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_input, size * sizeof(value_type)));
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_output, size * sizeof(value_type)));
+                HIP_CHECK(
+                    hipMemcpy(
+                        d_values_input, values_input.data(),
+                        size * sizeof(value_type),
+                        hipMemcpyHostToDevice
+                    )
+                );
+            }
+
+            // Calculate expected results on host
+            std::vector<value_type> expected_values(values_input);
+            for(unsigned int segment = 0; segment < segments_count; segment++)
+            {
+                std::stable_sort(
+                    expected_values.begin() + offsets[segment],
+                    expected_values.begin() + offsets[segment + 1],
+                    [&](const value_type& lhs, const value_type& rhs)
+                    {
+                        return key_less(keys_input[lhs], keys_input[rhs]);
+                    }
+                );
+            }
+
+            size_t temp_storage_size_bytes;
+            void * d_temp_storage = nullptr;
+            HIP_CHECK(
+                run_segmented_sort<descending>(
+                    d_temp_storage, temp_storage_size_bytes,
+                    d_keys_input, d_keys_output, d_values_input, d_values_output,
+                    int(size), int(segments_count), d_offsets,
+                    stream, debug_synchronous
+                )
+            );
+
+            ASSERT_GT(temp_storage_size_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+
+            HIP_CHECK(
+                run_segmented_sort<descending>(
+                    d_temp_storage, temp_storage_size_bytes,
+                    d_keys_input, d_keys_output, d_values_input, d_values_output,
+                    int(size), int(segments_count), d_offsets,
+                    stream, debug_synchronous
+                )
+            );
+
+            HIP_CHECK(hipFree(d_temp_storage));
+
+            std::vector<key_type> keys_output(size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys_output,
+                    size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            std::vector<value_type> values_output(size);
+            if(WithValues)
+            {
+                HIP_CHECK(
+                    hipMemcpy(
+                        values_output.data(), d_values_output,
+                        size * sizeof(value_type),
+                        hipMemcpyDeviceToHost
+                    )
+                );
+            }
+
+            for(size_t i = 0; i < size; i++)
+            {
+                ASSERT_EQ(keys_output[i], keys_input[expected_values[i]]) << "where index = " << i;
+                if(WithValues)
+                {
+                    ASSERT_EQ(values_output[i], expected_values[i]) << "where index = " << i;
+                }
+            }
+
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_keys_output));
+            HIP_CHECK(hipFree(d_offsets));
+            if(WithValues)
+            {
+                HIP_CHECK(hipFree(d_values_input));
+                HIP_CHECK(hipFree(d_values_output));
+            }
+        }
+    }
+}
+
+TYPED_TEST(HipcubDeviceSegmentedSort, SortKeys)
+{
+    test_segmented_sort<typename TestFixture::params, false>();
+}
+
+TYPED_TEST(HipcubDeviceSegmentedSort, SortPairs)
+{
+    test_segmented_sort<typename TestFixture::params, true>();
+}
@@ -0,0 +1,441 @@
+// MIT License
+//
+// Copyright (c) 2021 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "common_test_header.hpp"
+
+// hipcub API
+#include "hipcub/device/device_segmented_topk.hpp"
+
+template<
+    class Key,
+    bool SelectMax,
+    unsigned int K,
+    unsigned int MinSegmentLength,
+    unsigned int MaxSegmentLength
+>
+struct params
+{
+    using key_type = Key;
+    static constexpr bool select_max = SelectMax;
+    static constexpr unsigned int k = K;
+    static constexpr unsigned int min_segment_length = MinSegmentLength;
+    static constexpr unsigned int max_segment_length = MaxSegmentLength;
+};
+
+template<class Params>
+class HipcubDeviceSegmentedTopK : public ::testing::Test {
+public:
+    using params = Params;
+};
+
+typedef ::testing::Types<
+    // segments selected from by warps
+    params<int, true, 10, 50, 500>,
+    params<float, false, 1, 0, 100>,
+    params<unsigned char, true, 32, 0, 1000>,
+    params<double, false, 100, 50, 1024>,
+
+    // segments selected from by blocks, resident or read at each pass
+    params<short, true, 64, 1000, 5000>,
+    params<long long, false, 10, 2000, 10000>,
+    params<unsigned int, true, 1000, 0, 5000>,
+    params<float, true, 5000, 4000, 6000>
+> Params;
+
+TYPED_TEST_SUITE(HipcubDeviceSegmentedTopK, Params);
+
+std::vector<size_t> get_sizes()
+{
+    std::vector<size_t> sizes = { 1, 10, 53, 211, 1024, 2345, 11001, 34567, (1 << 16) - 1220, 1000000 };
+    const std::vector<size_t> random_sizes = test_utils::get_random_data<size_t>(3, 1, 100000, rand());
+    sizes.insert(sizes.end(), random_sizes.begin(), random_sizes.end());
+    return sizes;
+}
+
+template<bool SelectMax, class Key, class Value, class OffsetIteratorT>
+hipError_t run_segmented_topk(void * d_temp_storage,
+                              size_t& temp_storage_bytes,
+                              const Key * d_keys_input,
+                              Key * d_keys_output,
+                              const Value * d_values_input,
+                              Value * d_values_output,
+                              int size,
+                              int segments_count,
+                              OffsetIteratorT d_offsets,
+                              unsigned int k,
+                              hipStream_t stream,
+                              bool debug_synchronous)
+{
+    if(d_values_input == nullptr)
+    {
+        return SelectMax
+            ? hipcub::DeviceSegmentedTopK::MaxKeys(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                size, segments_count, d_offsets, d_offsets + 1, k, stream, debug_synchronous)
+            : hipcub::DeviceSegmentedTopK::MinKeys(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                size, segments_count, d_offsets, d_offsets + 1, k, stream, debug_synchronous);
+    }
+    return SelectMax
+        ? hipcub::DeviceSegmentedTopK::MaxPairs(
+            d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+            d_values_input, d_values_output,
+            size, segments_count, d_offsets, d_offsets + 1, k, stream, debug_synchronous)
+        : hipcub::DeviceSegmentedTopK::MinPairs(
+            d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+            d_values_input, d_values_output,
+            size, segments_count, d_offsets, d_offsets + 1, k, stream, debug_synchronous);
+}
+
+template<class Params, bool WithValues>
+void test_segmented_topk()
+{
+    using key_type = typename Params::key_type;
+    using value_type = unsigned int;
+    using offset_type = unsigned int;
+    constexpr bool select_max = Params::select_max;
+    constexpr unsigned int k = Params::k;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    auto key_less = [](const key_type& lhs, const key_type& rhs)
+    {
+        return select_max ? (rhs < lhs) : (lhs < rhs);
+    };
+
+    std::random_device rd;
+    std::default_random_engine gen(rd());
+
+    std::uniform_int_distribution<size_t> segment_length_dis(
+        Params::min_segment_length,
+        Params::max_segment_length
+    );
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(size_t size : sizes)
+    {
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+            SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+            // Generate data
+            std::vector<key_type> keys_input;
+            if(std::is_floating_point<key_type>::value)
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size, (key_type)-1000, (key_type)+1000, seed_value
+                );
+            }
+            else
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    std::numeric_limits<key_type>::min(),
+                    std::numeric_limits<key_type>::max(),
+                    seed_value + seed_value_addition
+                );
+            }
+
+            std::vector<value_type> values_input(size);
+            std::iota(values_input.begin(), values_input.end(), 0);
+
+            std::vector<offset_type> offsets;
+            unsigned int segments_count = 0;
+            size_t offset = 0;
+            while(offset < size)
+            {
+                const size_t segment_length = segment_length_dis(gen);
+                offsets.push_back(offset);
+                segments_count++;
+                offset += segment_length;
+            }
+            offsets.push_back(size);
+
+            const size_t output_size = size_t(segments_count) * k;
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            offset_type * d_offsets;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, output_size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_offsets, (segments_count + 1) * sizeof(offset_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+            HIP_CHECK(
+                hipMemcpy(
+                    d_offsets, offsets.data(),
+                    (segments_count + 1) * sizeof(offset_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            value_type * d_values_input = nullptr;
+            value_type * d_values_output = nullptr;
+            if(WithValues)
+            {
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_input, size * sizeof(value_type)));
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_output, output_size * sizeof(value_type)));
+                HIP_CHECK(
+                    hipMemcpy(
+                        d_values_input, values_input.data(),
+                        size * sizeof(value_type),
+                        hipMemcpyHostToDevice
+                    )
+                );
+            }
+
+            size_t temp_storage_size_bytes;
+            void * d_temp_storage = nullptr;
+            HIP_CHECK(
+                run_segmented_topk<select_max>(
+                    d_temp_storage, temp_storage_size_bytes,
+                    d_keys_input, d_keys_output, d_values_input, d_values_output,
+                    int(size), int(segments_count), d_offsets, k,
+                    stream, debug_synchronous
+                )
+            );
+
+            ASSERT_GT(temp_storage_size_bytes, 0U);
+
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+
+            HIP_CHECK(
+                run_segmented_topk<select_max>(
+                    d_temp_storage, temp_storage_size_bytes,
+                    d_keys_input, d_keys_output, d_values_input, d_values_output,
+                    int(size), int(segments_count), d_offsets, k,
+                    stream, debug_synchronous
+                )
+            );
+
+            HIP_CHECK(hipFree(d_temp_storage));
+
+            std::vector<key_type> keys_output(output_size);
+            HIP_CHECK(
+                hipMemcpy(
+                    keys_output.data(), d_keys_output,
+                    output_size * sizeof(key_type),
+                    hipMemcpyDeviceToHost
+                )
+            );
+
+            std::vector<value_type> values_output(output_size);
+            if(WithValues)
+            {
+                HIP_CHECK(
+                    hipMemcpy(
+                        values_output.data(), d_values_output,
+                        output_size * sizeof(value_type),
+                        hipMemcpyDeviceToHost
+                    )
+                );
+            }
+
+            for(unsigned int segment = 0; segment < segments_count; segment++)
+            {
+                SCOPED_TRACE(testing::Message() << "with segment = " << segment);
+
+                const size_t segment_begin = offsets[segment];
+                const size_t segment_end = offsets[segment + 1];
+                const size_t selected = std::min(size_t(k), segment_end - segment_begin);
+                const size_t output_begin = size_t(segment) * k;
+
+                // Calculate expected results on host
+                std::vector<key_type> expected(
+                    keys_input.begin() + segment_begin,
+                    keys_input.begin() + segment_end
+                );
+                std::sort(expected.begin(), expected.end(), key_less);
+
+                if(WithValues)
+                {
+                    // Every value must stay with its key, and no item may be selected twice
+                    std::vector<bool> taken(segment_end - segment_begin, false);
+                    for(size_t i = 0; i < selected; i++)
+                    {
+                        const value_type index = values_output[output_begin + i];
+                        ASSERT_GE(index, segment_begin) << "where index = " << i;
+                        ASSERT_LT(index, segment_end) << "where index = " << i;
+                        ASSERT_FALSE(taken[index - segment_begin]) << "where index = " << i;
+                        taken[index - segment_begin] = true;
+                        ASSERT_EQ(keys_input[index], keys_output[output_begin + i]) << "where index = " << i;
+                    }
+                }
+
+                std::sort(
+                    keys_output.begin() + output_begin,
+                    keys_output.begin() + output_begin + selected,
+                    key_less
+                );
+                for(size_t i = 0; i < selected; i++)
+                {
+                    ASSERT_EQ(keys_output[output_begin + i], expected[i]) << "where index = " << i;
+                }
+            }
+
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_keys_output));
+            HIP_CHECK(hipFree(d_offsets));
+            if(WithValues)
+            {
+                HIP_CHECK(hipFree(d_values_input));
+                HIP_CHECK(hipFree(d_values_output));
+            }
+        }
+    }
+}
+
+TYPED_TEST(HipcubDeviceSegmentedTopK, Keys)
+{
+    test_segmented_topk<typename TestFixture::params, false>();
+}
+
+TYPED_TEST(HipcubDeviceSegmentedTopK, Pairs)
+{
+    test_segmented_topk<typename TestFixture::params, true>();
+}
+
+// Numbers of segments that do not fill the last block of warps, whether a block
+// holds 4 warps of 64 threads or 8 of 32, so that some warps have no segment
+TEST(HipcubDeviceSegmentedTopKSegmentCounts, MaxKeys)
+{
+    using key_type = int;
+    using offset_type = unsigned int;
+    constexpr unsigned int k = 4;
+    constexpr size_t segment_length = 37;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    const std::vector<unsigned int> segment_counts = { 1, 3, 5, 7, 9, 13, 31, 33, 1001 };
+    for(unsigned int segments_count : segment_counts)
+    {
+        SCOPED_TRACE(testing::Message() << "with segments_count = " << segments_count);
+
+        const size_t size = size_t(segments_count) * segment_length;
+        const size_t output_size = size_t(segments_count) * k;
+
+        std::vector<key_type> keys_input = test_utils::get_random_data<key_type>(
+            size, -1000, 1000, segments_count + seed_value_addition
+        );
+
+        std::vector<offset_type> offsets(segments_count + 1);
+        for(size_t segment = 0; segment <= segments_count; segment++)
+        {
+            offsets[segment] = offset_type(segment * segment_length);
+        }
+
+        key_type * d_keys_input;
+        key_type * d_keys_output;
+        offset_type * d_offsets;
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, output_size * sizeof(key_type)));
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_offsets, (segments_count + 1) * sizeof(offset_type)));
+        HIP_CHECK(
+            hipMemcpy(
+                d_keys_input, keys_input.data(),
+                size * sizeof(key_type),
+                hipMemcpyHostToDevice
+            )
+        );
+        HIP_CHECK(
+            hipMemcpy(
+                d_offsets, offsets.data(),
+                (segments_count + 1) * sizeof(offset_type),
+                hipMemcpyHostToDevice
+            )
+        );
+
+        size_t temp_storage_size_bytes;
+        void * d_temp_storage = nullptr;
+        HIP_CHECK(
+            run_segmented_topk<true>(
+                d_temp_storage, temp_storage_size_bytes,
+                d_keys_input, d_keys_output,
+                static_cast<const unsigned int *>(nullptr), static_cast<unsigned int *>(nullptr),
+                int(size), int(segments_count), d_offsets, k,
+                stream, debug_synchronous
+            )
+        );
+
+        ASSERT_GT(temp_storage_size_bytes, 0U);
+
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+
+        HIP_CHECK(
+            run_segmented_topk<true>(
+                d_temp_storage, temp_storage_size_bytes,
+                d_keys_input, d_keys_output,
+                static_cast<const unsigned int *>(nullptr), static_cast<unsigned int *>(nullptr),
+                int(size), int(segments_count), d_offsets, k,
+                stream, debug_synchronous
+            )
+        );
+
+        HIP_CHECK(hipFree(d_temp_storage));
+
+        std::vector<key_type> keys_output(output_size);
+        HIP_CHECK(
+            hipMemcpy(
+                keys_output.data(), d_keys_output,
+                output_size * sizeof(key_type),
+                hipMemcpyDeviceToHost
+            )
+        );
+
+        HIP_CHECK(hipFree(d_keys_input));
+        HIP_CHECK(hipFree(d_keys_output));
+        HIP_CHECK(hipFree(d_offsets));
+
+        for(unsigned int segment = 0; segment < segments_count; segment++)
+        {
+            SCOPED_TRACE(testing::Message() << "with segment = " << segment);
+
+            std::vector<key_type> expected(
+                keys_input.begin() + offsets[segment],
+                keys_input.begin() + offsets[segment + 1]
+            );
+            std::sort(expected.begin(), expected.end(), std::greater<key_type>());
+
+            const size_t output_begin = size_t(segment) * k;
+            std::sort(
+                keys_output.begin() + output_begin,
+                keys_output.begin() + output_begin + k,
+                std::greater<key_type>()
+            );
+            for(size_t i = 0; i < k; i++)
+            {
+                ASSERT_EQ(keys_output[output_begin + i], expected[i]) << "where index = " << i;
+            }
+        }
+    }
+}
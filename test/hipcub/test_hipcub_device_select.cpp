@@ -486,3 +486,277 @@ TYPED_TEST(HipcubDeviceSelectTests, Unique)
         }
     }
 }
+
+// ---------------------------------------------------------
+// Test for 64-bit num_items
+// ---------------------------------------------------------
+
+#ifdef HIPCUB_ROCPRIM_API
+
+// Inputs of more than 2^31 - 1 items are selected from in chunks of 2^30 items; the
+// same code path is exercised here with small chunks and a 64-bit selected count
+TEST(HipcubDeviceSelectLargeNumItemsTests, SelectChunks)
+{
+    hipStream_t stream = 0; // default stream
+
+    const size_t size = 100000;
+    std::vector<int> input(size);
+    {
+        std::vector<int> input01 = test_utils::get_random_data01<int>(size, 0.5f, 0);
+        test_utils::host_inclusive_scan(
+            input01.begin(), input01.end(), input.begin(), hipcub::Sum()
+        );
+    }
+    std::vector<unsigned char> flags = test_utils::get_random_data01<unsigned char>(size, 0.25f, 1);
+
+    std::vector<int> expected_flagged;
+    std::vector<int> expected_unique;
+    for(size_t i = 0; i < size; i++)
+    {
+        if(flags[i] != 0)
+        {
+            expected_flagged.push_back(input[i]);
+        }
+        if(i == 0 || input[i - 1] != input[i])
+        {
+            expected_unique.push_back(input[i]);
+        }
+    }
+
+    int * d_input;
+    unsigned char * d_flags;
+    int * d_output;
+    unsigned long long * d_selected_count_output;
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_input, size * sizeof(int)));
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_flags, size * sizeof(unsigned char)));
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_output, size * sizeof(int)));
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_selected_count_output, sizeof(unsigned long long)));
+    HIP_CHECK(hipMemcpy(d_input, input.data(), size * sizeof(int), hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_flags, flags.data(), size * sizeof(unsigned char), hipMemcpyHostToDevice));
+
+    using flag_op = hipcub::detail::unique_flag_op<int *, hipcub::Equality>;
+    using flag_iterator =
+        rocprim::transform_iterator<rocprim::counting_iterator<size_t>, flag_op, bool>;
+
+    for(size_t chunk_items : { size_t(1000), size_t(4096), size_t(33333), size_t(1) << 20 })
+    for(bool unique : { false, true })
+    {
+        SCOPED_TRACE(testing::Message() << "with chunk_items = " << chunk_items);
+        SCOPED_TRACE(testing::Message() << "with unique = " << unique);
+
+        auto select_chunk = [&](void * d_temp_storage, size_t& temp_storage_size_bytes,
+                                size_t begin, auto output, size_t * d_count, size_t num_items)
+        {
+            return unique
+                ? rocprim::select(
+                    d_temp_storage, temp_storage_size_bytes,
+                    d_input + begin,
+                    flag_iterator(rocprim::counting_iterator<size_t>(begin), flag_op{ d_input, hipcub::Equality() }),
+                    output, d_count, num_items, stream)
+                : rocprim::select(
+                    d_temp_storage, temp_storage_size_bytes,
+                    d_input + begin, d_flags + begin, output, d_count, num_items, stream);
+        };
+
+        size_t temp_storage_size_bytes;
+        HIP_CHECK(
+            hipcub::detail::select_large(
+                nullptr, temp_storage_size_bytes,
+                d_output, d_selected_count_output, size, select_chunk,
+                stream, false, chunk_items
+            )
+        );
+        ASSERT_GT(temp_storage_size_bytes, 0U);
+
+        void * d_temp_storage = nullptr;
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+        HIP_CHECK(
+            hipcub::detail::select_large(
+                d_temp_storage, temp_storage_size_bytes,
+                d_output, d_selected_count_output, size, select_chunk,
+                stream, false, chunk_items
+            )
+        );
+        HIP_CHECK(hipDeviceSynchronize());
+
+        const std::vector<int>& expected = unique ? expected_unique : expected_flagged;
+        unsigned long long selected_count_output = 0;
+        HIP_CHECK(
+            hipMemcpy(
+                &selected_count_output, d_selected_count_output,
+                sizeof(unsigned long long),
+                hipMemcpyDeviceToHost
+            )
+        );
+        ASSERT_EQ(selected_count_output, expected.size());
+
+        std::vector<int> output(size);
+        HIP_CHECK(hipMemcpy(output.data(), d_output, size * sizeof(int), hipMemcpyDeviceToHost));
+        for(size_t i = 0; i < expected.size(); i++)
+        {
+            ASSERT_EQ(output[i], expected[i]) << "where index = " << i;
+        }
+
+        hipFree(d_temp_storage);
+    }
+
+    // 64-bit num_items that fit in an int take the single-call path
+    size_t temp_storage_size_bytes;
+    HIP_CHECK(
+        hipcub::DeviceSelect::Unique(
+            nullptr, temp_storage_size_bytes,
+            d_input, d_output, d_selected_count_output, int64_t(size),
+            stream
+        )
+    );
+    void * d_temp_storage = nullptr;
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+    HIP_CHECK(
+        hipcub::DeviceSelect::Unique(
+            d_temp_storage, temp_storage_size_bytes,
+            d_input, d_output, d_selected_count_output, int64_t(size),
+            stream
+        )
+    );
+    HIP_CHECK(hipDeviceSynchronize());
+
+    unsigned long long selected_count_output = 0;
+    HIP_CHECK(
+        hipMemcpy(
+            &selected_count_output, d_selected_count_output,
+            sizeof(unsigned long long),
+            hipMemcpyDeviceToHost
+        )
+    );
+    ASSERT_EQ(selected_count_output, expected_unique.size());
+
+    ASSERT_EQ(
+        hipcub::DeviceSelect::Flagged(
+            nullptr, temp_storage_size_bytes,
+            d_input, d_flags, d_output, d_selected_count_output, int64_t(-1),
+            stream
+        ),
+        hipErrorInvalidValue
+    );
+
+    hipFree(d_input);
+    hipFree(d_flags);
+    hipFree(d_output);
+    hipFree(d_selected_count_output);
+    hipFree(d_temp_storage);
+}
+
+// ---------------------------------------------------------
+// Test for NthElement
+// ---------------------------------------------------------
+
+TYPED_TEST(HipcubDeviceSelectTests, NthElement)
+{
+    using T = typename TestFixture::input_type;
+    const bool debug_synchronous = TestFixture::debug_synchronous;
+
+    hipStream_t stream = 0; // default stream
+
+    const auto sizes = get_sizes();
+    for(auto size : sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+
+            // Generate data
+            std::vector<T> input = test_utils::get_random_data<T>(
+                size,
+                std::numeric_limits<T>::min(),
+                std::numeric_limits<T>::max(),
+                seed_value
+            );
+
+            T * d_input;
+            T * d_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_input, input.size() * sizeof(T)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_output, sizeof(T)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_input, input.data(),
+                    input.size() * sizeof(T),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            // Calculate expected results on host
+            std::vector<T> sorted(input);
+            std::sort(sorted.begin(), sorted.end());
+
+            size_t temp_storage_size_bytes;
+            HIP_CHECK(
+                hipcub::DeviceSelect::NthElement(
+                    nullptr,
+                    temp_storage_size_bytes,
+                    d_input,
+                    d_output,
+                    0,
+                    input.size(),
+                    stream,
+                    debug_synchronous
+                )
+            );
+
+            ASSERT_GT(temp_storage_size_bytes, 0U);
+
+            void * d_temp_storage = nullptr;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+
+            const std::vector<size_t> nths = { 0, size / 3, size / 2, size - 1 };
+            for(size_t nth : nths)
+            {
+                SCOPED_TRACE(testing::Message() << "with nth = " << nth);
+
+                HIP_CHECK(
+                    hipcub::DeviceSelect::NthElement(
+                        d_temp_storage,
+                        temp_storage_size_bytes,
+                        d_input,
+                        d_output,
+                        nth,
+                        input.size(),
+                        stream,
+                        debug_synchronous
+                    )
+                );
+
+                T output;
+                HIP_CHECK(
+                    hipMemcpy(
+                        &output, d_output,
+                        sizeof(T),
+                        hipMemcpyDeviceToHost
+                    )
+                );
+                ASSERT_EQ(output, sorted[nth]);
+            }
+
+            ASSERT_EQ(
+                hipcub::DeviceSelect::NthElement(
+                    d_temp_storage,
+                    temp_storage_size_bytes,
+                    d_input,
+                    d_output,
+                    input.size(),
+                    input.size(),
+                    stream,
+                    debug_synchronous
+                ),
+                hipErrorInvalidValue
+            );
+
+            hipFree(d_input);
+            hipFree(d_output);
+            hipFree(d_temp_storage);
+        }
+    }
+}
+
+#endif // HIPCUB_ROCPRIM_API
@@ -65,7 +65,13 @@ public:
 };
 
 typedef ::testing::Types<
-    DeviceSpmvParams<float, 4, 0, 0, 0>
+    DeviceSpmvParams<float, 4, 0, 0, 0>,
+    DeviceSpmvParams<double, 0, 8, 0, 0>,
+    DeviceSpmvParams<float, 0, 0, 16, 0>,
+    DeviceSpmvParams<float, 0, 0, 50000, 0>,
+    DeviceSpmvParams<double, 0, 0, 50000, 0>,
+    DeviceSpmvParams<double, 0, 0, 0, 12>,
+    DeviceSpmvParams<float, 0, 0, 0, 64>
 > HipcubDeviceSpmvTestsParams;
 
 template<typename T, typename OffsetType>
@@ -93,15 +99,10 @@ generate_matrix(CooMatrix<T, OffsetType> &coo_matrix,
     }
     else if (dense > 0)
     {
-        #if 0
         // Generate dense graph
-        OffsetType size = 1 << 24; // 16M nnz
-        args.GetCmdLineArgument("size", size);
-
+        OffsetType size = 1 << 16; // 64K nnz
         OffsetType rows = size / dense;
-        printf("dense_%d_x_%d, ", rows, dense); fflush(stdout);
         coo_matrix.InitDense(rows, dense);
-        #endif
     }
 }
 
@@ -235,3 +236,714 @@ TYPED_TEST(HipcubDeviceSpmvTests, Spmv)
 
 }
 
+
+TYPED_TEST(HipcubDeviceSpmvTests, SpmvAlphaBeta)
+{
+    using T = typename TestFixture::value_type;
+    using OffsetType = int32_t;
+    constexpr int32_t grid_2d = TestFixture::grid_2d;
+    constexpr int32_t grid_3d = TestFixture::grid_3d;
+    constexpr int32_t wheel   = TestFixture::wheel;
+    constexpr int32_t dense   = TestFixture::dense;
+
+    const T test_alpha = T(2);
+    const T test_beta  = T(0.5);
+
+    hipStream_t stream = 0; // default
+
+    CooMatrix<T, OffsetType> coo_matrix;
+    generate_matrix(coo_matrix, grid_2d, grid_3d, wheel, dense);
+
+    CsrMatrix<T, OffsetType> csr_matrix;
+    csr_matrix.FromCoo(coo_matrix);
+
+    std::vector<T> vector_x(csr_matrix.num_cols);
+    std::vector<T> vector_y_in(csr_matrix.num_rows);
+    std::vector<T> vector_y_out(csr_matrix.num_rows);
+
+    for (int col = 0; col < csr_matrix.num_cols; ++col)
+        vector_x[col] = T(col % 7) - T(3);
+
+    for (int row = 0; row < csr_matrix.num_rows; ++row)
+        vector_y_in[row] = T(row % 5);
+
+    SpmvGold(csr_matrix, vector_x.data(), vector_y_in.data(), vector_y_out.data(), test_alpha, test_beta);
+
+    T*          d_values;
+    OffsetType* d_row_offsets;
+    OffsetType* d_column_indices;
+    T*          d_vector_x;
+    T*          d_vector_y;
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_values,         sizeof(T) * csr_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_row_offsets,    sizeof(OffsetType) * (csr_matrix.num_rows + 1)));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_column_indices, sizeof(OffsetType) * csr_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_vector_x,       sizeof(T) * csr_matrix.num_cols));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_vector_y,       sizeof(T) * csr_matrix.num_rows));
+
+    HIP_CHECK(hipMemcpy(d_values,         csr_matrix.values,         sizeof(T) * csr_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_row_offsets,    csr_matrix.row_offsets,    sizeof(OffsetType) * (csr_matrix.num_rows + 1), hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_column_indices, csr_matrix.column_indices, sizeof(OffsetType) * csr_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_vector_x,       vector_x.data(),           sizeof(T) * csr_matrix.num_cols, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_vector_y,       vector_y_in.data(),        sizeof(T) * csr_matrix.num_rows, hipMemcpyHostToDevice));
+
+    size_t temp_storage_bytes = 0;
+    void *d_temp_storage = nullptr;
+    HIP_CHECK(hipcub::DeviceSpmv::CsrMV(
+                d_temp_storage, temp_storage_bytes,
+                d_values, d_row_offsets, d_column_indices, d_vector_x, d_vector_y,
+                csr_matrix.num_rows, csr_matrix.num_cols, csr_matrix.num_nonzeros,
+                test_alpha, test_beta, stream, false));
+
+    HIP_CHECK(g_allocator.DeviceAllocate(&d_temp_storage, temp_storage_bytes));
+
+    HIP_CHECK(hipcub::DeviceSpmv::CsrMV(
+                d_temp_storage, temp_storage_bytes,
+                d_values, d_row_offsets, d_column_indices, d_vector_x, d_vector_y,
+                csr_matrix.num_rows, csr_matrix.num_cols, csr_matrix.num_nonzeros,
+                test_alpha, test_beta, stream, false));
+
+    HIP_CHECK(hipPeekAtLastError());
+    HIP_CHECK(hipDeviceSynchronize());
+
+    std::vector<T> vector_y(csr_matrix.num_rows);
+    HIP_CHECK(hipMemcpy(vector_y.data(), d_vector_y, sizeof(T) * csr_matrix.num_rows, hipMemcpyDeviceToHost));
+
+    for(int32_t i = 0; i < csr_matrix.num_rows; i++)
+    {
+        auto diff = std::max<T>(std::abs(0.01f * vector_y_out[i]), 0.01f);
+        ASSERT_NEAR(vector_y[i], vector_y_out[i], diff) << "where index = " << i;
+    }
+
+    HIP_CHECK(g_allocator.DeviceFree(d_temp_storage));
+    HIP_CHECK(g_allocator.DeviceFree(d_values));
+    HIP_CHECK(g_allocator.DeviceFree(d_row_offsets));
+    HIP_CHECK(g_allocator.DeviceFree(d_column_indices));
+    HIP_CHECK(g_allocator.DeviceFree(d_vector_x));
+    HIP_CHECK(g_allocator.DeviceFree(d_vector_y));
+}
+
+#ifdef HIPCUB_ROCPRIM_API
+
+TYPED_TEST(HipcubDeviceSpmvTests, SpmvPlan)
+{
+    using T = typename TestFixture::value_type;
+    using OffsetType = int32_t;
+    constexpr int32_t grid_2d = TestFixture::grid_2d;
+    constexpr int32_t grid_3d = TestFixture::grid_3d;
+    constexpr int32_t wheel   = TestFixture::wheel;
+    constexpr int32_t dense   = TestFixture::dense;
+
+    hipStream_t stream = 0; // default
+
+    CooMatrix<T, OffsetType> coo_matrix;
+    generate_matrix(coo_matrix, grid_2d, grid_3d, wheel, dense);
+
+    CsrMatrix<T, OffsetType> csr_matrix;
+    csr_matrix.FromCoo(coo_matrix);
+
+    std::vector<T> vector_x(csr_matrix.num_cols);
+    std::vector<T> vector_y_in(csr_matrix.num_rows);
+    std::vector<T> vector_y_out(csr_matrix.num_rows);
+
+    for (int col = 0; col < csr_matrix.num_cols; ++col)
+        vector_x[col] = T(col % 3) + T(1);
+
+    for (int row = 0; row < csr_matrix.num_rows; ++row)
+        vector_y_in[row] = T(1);
+
+    T*          d_values;
+    OffsetType* d_row_offsets;
+    OffsetType* d_column_indices;
+    T*          d_vector_x;
+    T*          d_vector_y;
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_values,         sizeof(T) * csr_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_row_offsets,    sizeof(OffsetType) * (csr_matrix.num_rows + 1)));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_column_indices, sizeof(OffsetType) * csr_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_vector_x,       sizeof(T) * csr_matrix.num_cols));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_vector_y,       sizeof(T) * csr_matrix.num_rows));
+
+    HIP_CHECK(hipMemcpy(d_values,         csr_matrix.values,         sizeof(T) * csr_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_row_offsets,    csr_matrix.row_offsets,    sizeof(OffsetType) * (csr_matrix.num_rows + 1), hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_column_indices, csr_matrix.column_indices, sizeof(OffsetType) * csr_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_vector_x,       vector_x.data(),           sizeof(T) * csr_matrix.num_cols, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_vector_y,       vector_y_in.data(),        sizeof(T) * csr_matrix.num_rows, hipMemcpyHostToDevice));
+
+    hipcub::DeviceSpmv::Plan<T> plan;
+    size_t temp_storage_bytes = 0;
+    void *d_temp_storage = nullptr;
+    HIP_CHECK(hipcub::DeviceSpmv::CsrMVPlan(
+                d_temp_storage, temp_storage_bytes, plan, d_row_offsets,
+                csr_matrix.num_rows, csr_matrix.num_cols, csr_matrix.num_nonzeros,
+                stream, false));
+
+    HIP_CHECK(g_allocator.DeviceAllocate(&d_temp_storage, temp_storage_bytes));
+
+    HIP_CHECK(hipcub::DeviceSpmv::CsrMVPlan(
+                d_temp_storage, temp_storage_bytes, plan, d_row_offsets,
+                csr_matrix.num_rows, csr_matrix.num_cols, csr_matrix.num_nonzeros,
+                stream, false));
+
+    // Row statistics match the host analysis
+    GraphStats stats = csr_matrix.Stats();
+    ASSERT_NEAR(plan.row_stats.row_length_mean, stats.row_length_mean, 1e-6 * stats.row_length_mean);
+    ASSERT_NEAR(plan.row_stats.row_length_std_dev, stats.row_length_std_dev, 1e-6 * std::max(stats.row_length_std_dev, 1.0));
+    if (stats.row_length_std_dev > 0.0)
+    {
+        ASSERT_NEAR(plan.row_stats.row_length_skewness, stats.row_length_skewness, 1e-4 * std::max(std::abs(stats.row_length_skewness), 1.0));
+    }
+
+    OffsetType min_row_length = csr_matrix.num_cols;
+    OffsetType max_row_length = 0;
+    OffsetType empty_rows = 0;
+    for (OffsetType row = 0; row < csr_matrix.num_rows; ++row)
+    {
+        const OffsetType row_length = csr_matrix.row_offsets[row + 1] - csr_matrix.row_offsets[row];
+        min_row_length = std::min(min_row_length, row_length);
+        max_row_length = std::max(max_row_length, row_length);
+        empty_rows += (row_length == 0) ? 1 : 0;
+    }
+    ASSERT_EQ(plan.row_stats.min_row_length, min_row_length);
+    ASSERT_EQ(plan.row_stats.max_row_length, max_row_length);
+    ASSERT_EQ(plan.row_stats.empty_rows, empty_rows);
+
+    // Repeated products reuse the plan: y <- 0.5 * A * x + 0.5 * y
+    const T test_alpha = T(0.5);
+    const T test_beta  = T(0.5);
+    for (int iteration = 0; iteration < 3; ++iteration)
+    {
+        SpmvGold(csr_matrix, vector_x.data(), vector_y_in.data(), vector_y_out.data(), test_alpha, test_beta);
+        std::swap(vector_y_in, vector_y_out);
+
+        HIP_CHECK(hipcub::DeviceSpmv::CsrMV(
+                    plan, d_values, d_column_indices, d_vector_x, d_vector_y,
+                    test_alpha, test_beta, stream, false));
+    }
+
+    HIP_CHECK(hipPeekAtLastError());
+    HIP_CHECK(hipDeviceSynchronize());
+
+    std::vector<T> vector_y(csr_matrix.num_rows);
+    HIP_CHECK(hipMemcpy(vector_y.data(), d_vector_y, sizeof(T) * csr_matrix.num_rows, hipMemcpyDeviceToHost));
+
+    for(int32_t i = 0; i < csr_matrix.num_rows; i++)
+    {
+        auto diff = std::max<T>(std::abs(0.01f * vector_y_in[i]), 0.01f);
+        ASSERT_NEAR(vector_y[i], vector_y_in[i], diff) << "where index = " << i;
+    }
+
+    HIP_CHECK(g_allocator.DeviceFree(d_temp_storage));
+    HIP_CHECK(g_allocator.DeviceFree(d_values));
+    HIP_CHECK(g_allocator.DeviceFree(d_row_offsets));
+    HIP_CHECK(g_allocator.DeviceFree(d_column_indices));
+    HIP_CHECK(g_allocator.DeviceFree(d_vector_x));
+    HIP_CHECK(g_allocator.DeviceFree(d_vector_y));
+}
+
+TYPED_TEST(HipcubDeviceSpmvTests, SpmvPlanAlgorithms)
+{
+    using T = typename TestFixture::value_type;
+    using OffsetType = int32_t;
+    constexpr int32_t grid_2d = TestFixture::grid_2d;
+    constexpr int32_t grid_3d = TestFixture::grid_3d;
+    constexpr int32_t wheel   = TestFixture::wheel;
+    constexpr int32_t dense   = TestFixture::dense;
+
+    const T test_alpha = T(2);
+    const T test_beta  = T(0.5);
+
+    hipStream_t stream = 0; // default
+
+    CooMatrix<T, OffsetType> coo_matrix;
+    generate_matrix(coo_matrix, grid_2d, grid_3d, wheel, dense);
+
+    CsrMatrix<T, OffsetType> csr_matrix;
+    csr_matrix.FromCoo(coo_matrix);
+
+    std::vector<T> vector_x(csr_matrix.num_cols);
+    std::vector<T> vector_y_in(csr_matrix.num_rows);
+    std::vector<T> vector_y_out(csr_matrix.num_rows);
+
+    for (int col = 0; col < csr_matrix.num_cols; ++col)
+        vector_x[col] = T(col % 7) - T(3);
+
+    for (int row = 0; row < csr_matrix.num_rows; ++row)
+        vector_y_in[row] = T(row % 5);
+
+    SpmvGold(csr_matrix, vector_x.data(), vector_y_in.data(), vector_y_out.data(), test_alpha, test_beta);
+
+    T*          d_values;
+    OffsetType* d_row_offsets;
+    OffsetType* d_column_indices;
+    T*          d_vector_x;
+    T*          d_vector_y;
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_values,         sizeof(T) * csr_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_row_offsets,    sizeof(OffsetType) * (csr_matrix.num_rows + 1)));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_column_indices, sizeof(OffsetType) * csr_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_vector_x,       sizeof(T) * csr_matrix.num_cols));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_vector_y,       sizeof(T) * csr_matrix.num_rows));
+
+    HIP_CHECK(hipMemcpy(d_values,         csr_matrix.values,         sizeof(T) * csr_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_row_offsets,    csr_matrix.row_offsets,    sizeof(OffsetType) * (csr_matrix.num_rows + 1), hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_column_indices, csr_matrix.column_indices, sizeof(OffsetType) * csr_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_vector_x,       vector_x.data(),           sizeof(T) * csr_matrix.num_cols, hipMemcpyHostToDevice));
+
+    hipcub::DeviceSpmv::Plan<T> plan;
+    size_t temp_storage_bytes = 0;
+    void *d_temp_storage = nullptr;
+    HIP_CHECK(hipcub::DeviceSpmv::CsrMVPlan(
+                d_temp_storage, temp_storage_bytes, plan, d_row_offsets,
+                csr_matrix.num_rows, csr_matrix.num_cols, csr_matrix.num_nonzeros,
+                stream, false));
+
+    HIP_CHECK(g_allocator.DeviceAllocate(&d_temp_storage, temp_storage_bytes));
+
+    HIP_CHECK(hipcub::DeviceSpmv::CsrMVPlan(
+                d_temp_storage, temp_storage_bytes, plan, d_row_offsets,
+                csr_matrix.num_rows, csr_matrix.num_cols, csr_matrix.num_nonzeros,
+                stream, false));
+
+    // The skewed wheel graph must not be given a row-per-thread kernel
+    if (wheel > 1000)
+    {
+        ASSERT_EQ(plan.algorithm, hipcub::SPMV_MERGE_PATH);
+    }
+
+    // Every variant computes the same product, whatever the selection
+    const std::vector<std::pair<hipcub::SpmvAlgorithm, int>> variants = {
+        { plan.algorithm, plan.vector_threads },
+        { hipcub::SPMV_MERGE_PATH, 4 },
+        { hipcub::SPMV_SCALAR, 4 },
+        { hipcub::SPMV_VECTOR, 4 },
+        { hipcub::SPMV_VECTOR, 8 },
+        { hipcub::SPMV_VECTOR, 16 },
+        { hipcub::SPMV_VECTOR, 32 }
+    };
+
+    for (const auto& variant : variants)
+    {
+        SCOPED_TRACE(testing::Message() << "with algorithm = " << variant.first
+                                        << ", vector_threads = " << variant.second);
+
+        plan.algorithm      = variant.first;
+        plan.vector_threads = variant.second;
+
+        HIP_CHECK(hipMemcpy(d_vector_y, vector_y_in.data(), sizeof(T) * csr_matrix.num_rows, hipMemcpyHostToDevice));
+
+        HIP_CHECK(hipcub::DeviceSpmv::CsrMV(
+                    plan, d_values, d_column_indices, d_vector_x, d_vector_y,
+                    test_alpha, test_beta, stream, false));
+
+        HIP_CHECK(hipPeekAtLastError());
+        HIP_CHECK(hipDeviceSynchronize());
+
+        std::vector<T> vector_y(csr_matrix.num_rows);
+        HIP_CHECK(hipMemcpy(vector_y.data(), d_vector_y, sizeof(T) * csr_matrix.num_rows, hipMemcpyDeviceToHost));
+
+        for(int32_t i = 0; i < csr_matrix.num_rows; i++)
+        {
+            auto diff = std::max<T>(std::abs(0.01f * vector_y_out[i]), 0.01f);
+            ASSERT_NEAR(vector_y[i], vector_y_out[i], diff) << "where index = " << i;
+        }
+    }
+
+    HIP_CHECK(g_allocator.DeviceFree(d_temp_storage));
+    HIP_CHECK(g_allocator.DeviceFree(d_values));
+    HIP_CHECK(g_allocator.DeviceFree(d_row_offsets));
+    HIP_CHECK(g_allocator.DeviceFree(d_column_indices));
+    HIP_CHECK(g_allocator.DeviceFree(d_vector_x));
+    HIP_CHECK(g_allocator.DeviceFree(d_vector_y));
+}
+
+TYPED_TEST(HipcubDeviceSpmvTests, SpmvCoo)
+{
+    using T = typename TestFixture::value_type;
+    using OffsetType = int32_t;
+    constexpr int32_t grid_2d = TestFixture::grid_2d;
+    constexpr int32_t grid_3d = TestFixture::grid_3d;
+    constexpr int32_t wheel   = TestFixture::wheel;
+    constexpr int32_t dense   = TestFixture::dense;
+
+    const T test_alpha = T(2);
+    const T test_beta  = T(0.5);
+
+    hipStream_t stream = 0; // default
+
+    CooMatrix<T, OffsetType> coo_matrix;
+    generate_matrix(coo_matrix, grid_2d, grid_3d, wheel, dense);
+
+    CsrMatrix<T, OffsetType> csr_matrix;
+    csr_matrix.FromCoo(coo_matrix);
+
+    // Row-sorted COO arrays
+    std::vector<OffsetType> row_indices(coo_matrix.num_nonzeros);
+    std::vector<OffsetType> column_indices(coo_matrix.num_nonzeros);
+    std::vector<T>          values(coo_matrix.num_nonzeros);
+    for (int i = 0; i < coo_matrix.num_nonzeros; ++i)
+    {
+        row_indices[i]    = coo_matrix.coo_tuples[i].row;
+        column_indices[i] = coo_matrix.coo_tuples[i].col;
+        values[i]         = coo_matrix.coo_tuples[i].val;
+    }
+
+    std::vector<T> vector_x(csr_matrix.num_cols);
+    std::vector<T> vector_y_in(csr_matrix.num_rows);
+    std::vector<T> vector_y_out(csr_matrix.num_rows);
+
+    for (int col = 0; col < csr_matrix.num_cols; ++col)
+        vector_x[col] = T(col % 7) - T(3);
+
+    for (int row = 0; row < csr_matrix.num_rows; ++row)
+        vector_y_in[row] = T(row % 5);
+
+    SpmvGold(csr_matrix, vector_x.data(), vector_y_in.data(), vector_y_out.data(), test_alpha, test_beta);
+
+    T*          d_values;
+    OffsetType* d_row_indices;
+    OffsetType* d_column_indices;
+    T*          d_vector_x;
+    T*          d_vector_y;
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_values,         sizeof(T) * coo_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_row_indices,    sizeof(OffsetType) * coo_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_column_indices, sizeof(OffsetType) * coo_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_vector_x,       sizeof(T) * csr_matrix.num_cols));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_vector_y,       sizeof(T) * csr_matrix.num_rows));
+
+    HIP_CHECK(hipMemcpy(d_values,         values.data(),         sizeof(T) * coo_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_row_indices,    row_indices.data(),    sizeof(OffsetType) * coo_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_column_indices, column_indices.data(), sizeof(OffsetType) * coo_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_vector_x,       vector_x.data(),       sizeof(T) * csr_matrix.num_cols, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_vector_y,       vector_y_in.data(),    sizeof(T) * csr_matrix.num_rows, hipMemcpyHostToDevice));
+
+    size_t temp_storage_bytes = 0;
+    void *d_temp_storage = nullptr;
+    HIP_CHECK(hipcub::DeviceSpmv::CooMV(
+                d_temp_storage, temp_storage_bytes,
+                d_values, d_row_indices, d_column_indices, d_vector_x, d_vector_y,
+                coo_matrix.num_rows, coo_matrix.num_cols, coo_matrix.num_nonzeros,
+                test_alpha, test_beta, stream, false));
+
+    HIP_CHECK(g_allocator.DeviceAllocate(&d_temp_storage, temp_storage_bytes));
+
+    HIP_CHECK(hipcub::DeviceSpmv::CooMV(
+                d_temp_storage, temp_storage_bytes,
+                d_values, d_row_indices, d_column_indices, d_vector_x, d_vector_y,
+                coo_matrix.num_rows, coo_matrix.num_cols, coo_matrix.num_nonzeros,
+                test_alpha, test_beta, stream, false));
+
+    HIP_CHECK(hipPeekAtLastError());
+    HIP_CHECK(hipDeviceSynchronize());
+
+    std::vector<T> vector_y(csr_matrix.num_rows);
+    HIP_CHECK(hipMemcpy(vector_y.data(), d_vector_y, sizeof(T) * csr_matrix.num_rows, hipMemcpyDeviceToHost));
+
+    for(int32_t i = 0; i < csr_matrix.num_rows; i++)
+    {
+        auto diff = std::max<T>(std::abs(0.01f * vector_y_out[i]), 0.01f);
+        ASSERT_NEAR(vector_y[i], vector_y_out[i], diff) << "where index = " << i;
+    }
+
+    HIP_CHECK(g_allocator.DeviceFree(d_temp_storage));
+
+    // The same product through a plan
+    hipcub::DeviceSpmv::Plan<T> plan;
+    d_temp_storage = nullptr;
+    HIP_CHECK(hipcub::DeviceSpmv::CooMVPlan(
+                d_temp_storage, temp_storage_bytes, plan, d_row_indices,
+                coo_matrix.num_rows, coo_matrix.num_cols, coo_matrix.num_nonzeros,
+                stream, false));
+
+    HIP_CHECK(g_allocator.DeviceAllocate(&d_temp_storage, temp_storage_bytes));
+
+    HIP_CHECK(hipcub::DeviceSpmv::CooMVPlan(
+                d_temp_storage, temp_storage_bytes, plan, d_row_indices,
+                coo_matrix.num_rows, coo_matrix.num_cols, coo_matrix.num_nonzeros,
+                stream, false));
+
+    HIP_CHECK(hipMemcpy(d_vector_y, vector_y_in.data(), sizeof(T) * csr_matrix.num_rows, hipMemcpyHostToDevice));
+    HIP_CHECK(hipcub::DeviceSpmv::CsrMV(
+                plan, d_values, d_column_indices, d_vector_x, d_vector_y,
+                test_alpha, test_beta, stream, false));
+
+    HIP_CHECK(hipPeekAtLastError());
+    HIP_CHECK(hipDeviceSynchronize());
+
+    HIP_CHECK(hipMemcpy(vector_y.data(), d_vector_y, sizeof(T) * csr_matrix.num_rows, hipMemcpyDeviceToHost));
+
+    for(int32_t i = 0; i < csr_matrix.num_rows; i++)
+    {
+        auto diff = std::max<T>(std::abs(0.01f * vector_y_out[i]), 0.01f);
+        ASSERT_NEAR(vector_y[i], vector_y_out[i], diff) << "where index = " << i;
+    }
+
+    HIP_CHECK(g_allocator.DeviceFree(d_temp_storage));
+    HIP_CHECK(g_allocator.DeviceFree(d_values));
+    HIP_CHECK(g_allocator.DeviceFree(d_row_indices));
+    HIP_CHECK(g_allocator.DeviceFree(d_column_indices));
+    HIP_CHECK(g_allocator.DeviceFree(d_vector_x));
+    HIP_CHECK(g_allocator.DeviceFree(d_vector_y));
+}
+
+TYPED_TEST(HipcubDeviceSpmvTests, SpmvSell)
+{
+    using T = typename TestFixture::value_type;
+    using OffsetType = int32_t;
+    constexpr int32_t grid_2d = TestFixture::grid_2d;
+    constexpr int32_t grid_3d = TestFixture::grid_3d;
+    constexpr int32_t wheel   = TestFixture::wheel;
+    constexpr int32_t dense   = TestFixture::dense;
+
+    const T test_alpha = T(2);
+    const T test_beta  = T(0.5);
+
+    hipStream_t stream = 0; // default
+
+    CooMatrix<T, OffsetType> coo_matrix;
+    generate_matrix(coo_matrix, grid_2d, grid_3d, wheel, dense);
+
+    CsrMatrix<T, OffsetType> csr_matrix;
+    csr_matrix.FromCoo(coo_matrix);
+
+    std::vector<T> vector_x(csr_matrix.num_cols);
+    std::vector<T> vector_y_in(csr_matrix.num_rows);
+    std::vector<T> vector_y_out(csr_matrix.num_rows);
+
+    for (int col = 0; col < csr_matrix.num_cols; ++col)
+        vector_x[col] = T(col % 7) - T(3);
+
+    for (int row = 0; row < csr_matrix.num_rows; ++row)
+        vector_y_in[row] = T(row % 5);
+
+    SpmvGold(csr_matrix, vector_x.data(), vector_y_in.data(), vector_y_out.data(), test_alpha, test_beta);
+
+    T*          d_values;
+    OffsetType* d_row_offsets;
+    OffsetType* d_column_indices;
+    T*          d_vector_x;
+    T*          d_vector_y;
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_values,         sizeof(T) * csr_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_row_offsets,    sizeof(OffsetType) * (csr_matrix.num_rows + 1)));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_column_indices, sizeof(OffsetType) * csr_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_vector_x,       sizeof(T) * csr_matrix.num_cols));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_vector_y,       sizeof(T) * csr_matrix.num_rows));
+
+    HIP_CHECK(hipMemcpy(d_values,         csr_matrix.values,         sizeof(T) * csr_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_row_offsets,    csr_matrix.row_offsets,    sizeof(OffsetType) * (csr_matrix.num_rows + 1), hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_column_indices, csr_matrix.column_indices, sizeof(OffsetType) * csr_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_vector_x,       vector_x.data(),           sizeof(T) * csr_matrix.num_cols, hipMemcpyHostToDevice));
+
+    const int slice_height = 64;
+    const int num_slices = (csr_matrix.num_rows + slice_height - 1) / slice_height;
+
+    for (int sort_window : { 1, 256, 1 << 20 })
+    {
+        SCOPED_TRACE(testing::Message() << "with sort_window = " << sort_window);
+
+        OffsetType* d_row_permutation;
+        OffsetType* d_slice_offsets;
+        HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_row_permutation, sizeof(OffsetType) * csr_matrix.num_rows));
+        HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_slice_offsets,   sizeof(OffsetType) * (num_slices + 1)));
+
+        size_t temp_storage_bytes = 0;
+        void *d_temp_storage = nullptr;
+        HIP_CHECK(hipcub::DeviceSpmv::CsrToSellPartition(
+                    d_temp_storage, temp_storage_bytes,
+                    d_row_offsets, csr_matrix.num_rows, csr_matrix.num_nonzeros,
+                    slice_height, sort_window, d_row_permutation, d_slice_offsets,
+                    stream, false));
+
+        HIP_CHECK(g_allocator.DeviceAllocate(&d_temp_storage, temp_storage_bytes));
+
+        HIP_CHECK(hipcub::DeviceSpmv::CsrToSellPartition(
+                    d_temp_storage, temp_storage_bytes,
+                    d_row_offsets, csr_matrix.num_rows, csr_matrix.num_nonzeros,
+                    slice_height, sort_window, d_row_permutation, d_slice_offsets,
+                    stream, false));
+
+        // The permutation must be a permutation, and sorting must not add padding
+        std::vector<OffsetType> row_permutation(csr_matrix.num_rows);
+        std::vector<OffsetType> slice_offsets(num_slices + 1);
+        HIP_CHECK(hipMemcpy(row_permutation.data(), d_row_permutation, sizeof(OffsetType) * csr_matrix.num_rows, hipMemcpyDeviceToHost));
+        HIP_CHECK(hipMemcpy(slice_offsets.data(),   d_slice_offsets,   sizeof(OffsetType) * (num_slices + 1), hipMemcpyDeviceToHost));
+
+        std::vector<OffsetType> sorted_permutation(row_permutation);
+        std::sort(sorted_permutation.begin(), sorted_permutation.end());
+        for (int row = 0; row < csr_matrix.num_rows; ++row)
+        {
+            ASSERT_EQ(sorted_permutation[row], row);
+        }
+
+        const OffsetType num_stored = slice_offsets[num_slices];
+        ASSERT_GE(num_stored, csr_matrix.num_nonzeros);
+
+        T*          d_sell_values;
+        OffsetType* d_sell_column_indices;
+        HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_sell_values,         sizeof(T) * num_stored));
+        HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_sell_column_indices, sizeof(OffsetType) * num_stored));
+
+        HIP_CHECK(hipcub::DeviceSpmv::CsrToSell(
+                    d_values, d_row_offsets, d_column_indices, csr_matrix.num_rows,
+                    slice_height, d_row_permutation, d_slice_offsets,
+                    d_sell_values, d_sell_column_indices, stream, false));
+
+        HIP_CHECK(hipMemcpy(d_vector_y, vector_y_in.data(), sizeof(T) * csr_matrix.num_rows, hipMemcpyHostToDevice));
+
+        HIP_CHECK(hipcub::DeviceSpmv::SellMV(
+                    d_sell_values, d_sell_column_indices, d_slice_offsets, d_row_permutation,
+                    d_vector_x, d_vector_y, csr_matrix.num_rows, slice_height,
+                    test_alpha, test_beta, stream, false));
+
+        HIP_CHECK(hipPeekAtLastError());
+        HIP_CHECK(hipDeviceSynchronize());
+
+        std::vector<T> vector_y(csr_matrix.num_rows);
+        HIP_CHECK(hipMemcpy(vector_y.data(), d_vector_y, sizeof(T) * csr_matrix.num_rows, hipMemcpyDeviceToHost));
+
+        for(int32_t i = 0; i < csr_matrix.num_rows; i++)
+        {
+            auto diff = std::max<T>(std::abs(0.01f * vector_y_out[i]), 0.01f);
+            ASSERT_NEAR(vector_y[i], vector_y_out[i], diff) << "where index = " << i;
+        }
+
+        HIP_CHECK(g_allocator.DeviceFree(d_temp_storage));
+        HIP_CHECK(g_allocator.DeviceFree(d_row_permutation));
+        HIP_CHECK(g_allocator.DeviceFree(d_slice_offsets));
+        HIP_CHECK(g_allocator.DeviceFree(d_sell_values));
+        HIP_CHECK(g_allocator.DeviceFree(d_sell_column_indices));
+    }
+
+    HIP_CHECK(g_allocator.DeviceFree(d_values));
+    HIP_CHECK(g_allocator.DeviceFree(d_row_offsets));
+    HIP_CHECK(g_allocator.DeviceFree(d_column_indices));
+    HIP_CHECK(g_allocator.DeviceFree(d_vector_x));
+    HIP_CHECK(g_allocator.DeviceFree(d_vector_y));
+}
+
+template<int NumVectors, class T>
+void TestSpmm(CsrMatrix<T, int32_t>& csr_matrix,
+              T* d_values,
+              int32_t* d_row_offsets,
+              int32_t* d_column_indices,
+              hipcub::DenseLayout layout)
+{
+    using OffsetType = int32_t;
+
+    SCOPED_TRACE(testing::Message() << "with num_vectors = " << NumVectors
+                                    << ", layout = " << layout);
+
+    const T test_alpha = T(2);
+    const T test_beta  = T(0.5);
+
+    hipStream_t stream = 0; // default
+
+    // Leading dimensions with padding
+    const bool row_major = (layout == hipcub::DENSE_ROW_MAJOR);
+    const int ldx = row_major ? NumVectors + 2 : csr_matrix.num_cols + 5;
+    const int ldy = row_major ? NumVectors + 3 : csr_matrix.num_rows + 7;
+    const size_t x_size = row_major ? size_t(csr_matrix.num_cols) * ldx : size_t(NumVectors) * ldx;
+    const size_t y_size = row_major ? size_t(csr_matrix.num_rows) * ldy : size_t(NumVectors) * ldy;
+    auto x_index = [&](int i, int j) { return row_major ? size_t(i) * ldx + j : i + size_t(j) * ldx; };
+    auto y_index = [&](int i, int j) { return row_major ? size_t(i) * ldy + j : i + size_t(j) * ldy; };
+
+    std::vector<T> matrix_x(x_size, T(0));
+    std::vector<T> matrix_y_in(y_size, T(0));
+    std::vector<T> matrix_y_out(y_size, T(0));
+
+    for (int col = 0; col < csr_matrix.num_cols; ++col)
+        for (int vector = 0; vector < NumVectors; ++vector)
+            matrix_x[x_index(col, vector)] = T((col + vector) % 7) - T(3);
+
+    for (int row = 0; row < csr_matrix.num_rows; ++row)
+        for (int vector = 0; vector < NumVectors; ++vector)
+            matrix_y_in[y_index(row, vector)] = T((row + 2 * vector) % 5);
+
+    // Reference answer, one vector at a time
+    std::vector<T> vector_x(csr_matrix.num_cols);
+    std::vector<T> vector_y_in(csr_matrix.num_rows);
+    std::vector<T> vector_y_out(csr_matrix.num_rows);
+    for (int vector = 0; vector < NumVectors; ++vector)
+    {
+        for (int col = 0; col < csr_matrix.num_cols; ++col)
+            vector_x[col] = matrix_x[x_index(col, vector)];
+        for (int row = 0; row < csr_matrix.num_rows; ++row)
+            vector_y_in[row] = matrix_y_in[y_index(row, vector)];
+
+        SpmvGold(csr_matrix, vector_x.data(), vector_y_in.data(), vector_y_out.data(), test_alpha, test_beta);
+
+        for (int row = 0; row < csr_matrix.num_rows; ++row)
+            matrix_y_out[y_index(row, vector)] = vector_y_out[row];
+    }
+
+    T* d_matrix_x;
+    T* d_matrix_y;
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_matrix_x, sizeof(T) * x_size));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_matrix_y, sizeof(T) * y_size));
+    HIP_CHECK(hipMemcpy(d_matrix_x, matrix_x.data(),    sizeof(T) * x_size, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_matrix_y, matrix_y_in.data(), sizeof(T) * y_size, hipMemcpyHostToDevice));
+
+    HIP_CHECK(hipcub::DeviceSpmv::CsrMM<NumVectors>(
+                d_values, d_row_offsets, d_column_indices,
+                d_matrix_x, ldx, d_matrix_y, ldy, layout,
+                csr_matrix.num_rows, csr_matrix.num_cols, csr_matrix.num_nonzeros,
+                test_alpha, test_beta, stream, false));
+
+    HIP_CHECK(hipPeekAtLastError());
+    HIP_CHECK(hipDeviceSynchronize());
+
+    std::vector<T> matrix_y(y_size);
+    HIP_CHECK(hipMemcpy(matrix_y.data(), d_matrix_y, sizeof(T) * y_size, hipMemcpyDeviceToHost));
+
+    for (OffsetType row = 0; row < csr_matrix.num_rows; ++row)
+    {
+        for (int vector = 0; vector < NumVectors; ++vector)
+        {
+            const T expected = matrix_y_out[y_index(row, vector)];
+            auto diff = std::max<T>(std::abs(0.01f * expected), 0.01f);
+            ASSERT_NEAR(matrix_y[y_index(row, vector)], expected, diff)
+                << "where row = " << row << ", vector = " << vector;
+        }
+    }
+
+    HIP_CHECK(g_allocator.DeviceFree(d_matrix_x));
+    HIP_CHECK(g_allocator.DeviceFree(d_matrix_y));
+}
+
+TYPED_TEST(HipcubDeviceSpmvTests, Spmm)
+{
+    using T = typename TestFixture::value_type;
+    using OffsetType = int32_t;
+    constexpr int32_t grid_2d = TestFixture::grid_2d;
+    constexpr int32_t grid_3d = TestFixture::grid_3d;
+    constexpr int32_t wheel   = TestFixture::wheel;
+    constexpr int32_t dense   = TestFixture::dense;
+
+    CooMatrix<T, OffsetType> coo_matrix;
+    generate_matrix(coo_matrix, grid_2d, grid_3d, wheel, dense);
+
+    CsrMatrix<T, OffsetType> csr_matrix;
+    csr_matrix.FromCoo(coo_matrix);
+
+    T*          d_values;
+    OffsetType* d_row_offsets;
+    OffsetType* d_column_indices;
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_values,         sizeof(T) * csr_matrix.num_nonzeros));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_row_offsets,    sizeof(OffsetType) * (csr_matrix.num_rows + 1)));
+    HIP_CHECK(g_allocator.DeviceAllocate((void **) &d_column_indices, sizeof(OffsetType) * csr_matrix.num_nonzeros));
+
+    HIP_CHECK(hipMemcpy(d_values,         csr_matrix.values,         sizeof(T) * csr_matrix.num_nonzeros, hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_row_offsets,    csr_matrix.row_offsets,    sizeof(OffsetType) * (csr_matrix.num_rows + 1), hipMemcpyHostToDevice));
+    HIP_CHECK(hipMemcpy(d_column_indices, csr_matrix.column_indices, sizeof(OffsetType) * csr_matrix.num_nonzeros, hipMemcpyHostToDevice));
+
+    for (hipcub::DenseLayout layout : { hipcub::DENSE_ROW_MAJOR, hipcub::DENSE_COLUMN_MAJOR })
+    {
+        TestSpmm<1>(csr_matrix, d_values, d_row_offsets, d_column_indices, layout);
+        TestSpmm<4>(csr_matrix, d_values, d_row_offsets, d_column_indices, layout);
+        TestSpmm<17>(csr_matrix, d_values, d_row_offsets, d_column_indices, layout);
+        TestSpmm<64>(csr_matrix, d_values, d_row_offsets, d_column_indices, layout);
+    }
+
+    HIP_CHECK(g_allocator.DeviceFree(d_values));
+    HIP_CHECK(g_allocator.DeviceFree(d_row_offsets));
+    HIP_CHECK(g_allocator.DeviceFree(d_column_indices));
+}
+
+#endif // HIPCUB_ROCPRIM_API
@@ -0,0 +1,282 @@
+// MIT License
+//
+// Copyright (c) 2021 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "common_test_header.hpp"
+
+// hipcub API
+#include "hipcub/device/device_topk.hpp"
+
+template<class Key, bool SelectMax>
+struct params
+{
+    using key_type = Key;
+    static constexpr bool select_max = SelectMax;
+};
+
+template<class Params>
+class HipcubDeviceTopK : public ::testing::Test {
+public:
+    using params = Params;
+};
+
+typedef ::testing::Types<
+    params<int, true>,
+    params<int, false>,
+    params<unsigned char, true>,
+    params<short, false>,
+    params<long long, true>,
+    params<unsigned long long, false>,
+    params<float, true>,
+    params<double, false>
+> Params;
+
+TYPED_TEST_SUITE(HipcubDeviceTopK, Params);
+
+std::vector<size_t> get_sizes()
+{
+    std::vector<size_t> sizes = { 1, 10, 53, 211, 1024, 2345, 4096, 34567, (1 << 16) - 1220, (1 << 20) - 123 };
+    const std::vector<size_t> random_sizes = test_utils::get_random_data<size_t>(5, 1, 100000, rand());
+    sizes.insert(sizes.end(), random_sizes.begin(), random_sizes.end());
+    return sizes;
+}
+
+std::vector<unsigned int> get_ks(size_t size)
+{
+    std::vector<unsigned int> ks = { 0, 1, 10, 100, static_cast<unsigned int>(size / 2), static_cast<unsigned int>(size) };
+    ks.erase(
+        std::remove_if(ks.begin(), ks.end(), [&](unsigned int k) { return k > size; }),
+        ks.end()
+    );
+    return ks;
+}
+
+template<bool SelectMax, class Key, class Value>
+hipError_t run_topk(void * d_temp_storage,
+                    size_t& temp_storage_bytes,
+                    const Key * d_keys_input,
+                    Key * d_keys_output,
+                    const Value * d_values_input,
+                    Value * d_values_output,
+                    size_t size,
+                    unsigned int k,
+                    hipcub::DeviceTopKOrder order,
+                    hipStream_t stream,
+                    bool debug_synchronous)
+{
+    if(d_values_input == nullptr)
+    {
+        return SelectMax
+            ? hipcub::DeviceTopK::MaxKeys(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                size, k, order, stream, debug_synchronous)
+            : hipcub::DeviceTopK::MinKeys(
+                d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+                size, k, order, stream, debug_synchronous);
+    }
+    return SelectMax
+        ? hipcub::DeviceTopK::MaxPairs(
+            d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+            d_values_input, d_values_output, size, k, order, stream, debug_synchronous)
+        : hipcub::DeviceTopK::MinPairs(
+            d_temp_storage, temp_storage_bytes, d_keys_input, d_keys_output,
+            d_values_input, d_values_output, size, k, order, stream, debug_synchronous);
+}
+
+template<class Params, bool WithValues>
+void test_topk()
+{
+    using key_type = typename Params::key_type;
+    using value_type = unsigned int;
+    constexpr bool select_max = Params::select_max;
+
+    hipStream_t stream = 0;
+
+    const bool debug_synchronous = false;
+
+    auto key_less = [](const key_type& lhs, const key_type& rhs)
+    {
+        return select_max ? (rhs < lhs) : (lhs < rhs);
+    };
+
+    const std::vector<size_t> sizes = get_sizes();
+    for(size_t size : sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+        for (size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value = seed_index < random_seeds_count  ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+
+            std::vector<key_type> keys_input;
+            if(std::is_floating_point<key_type>::value)
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size, (key_type)-1000, (key_type)+1000, seed_value
+                );
+            }
+            else
+            {
+                keys_input = test_utils::get_random_data<key_type>(
+                    size,
+                    std::numeric_limits<key_type>::min(),
+                    std::numeric_limits<key_type>::max(),
+                    seed_value
+                );
+            }
+
+            std::vector<value_type> values_input(size);
+            std::iota(values_input.begin(), values_input.end(), 0);
+
+            key_type * d_keys_input;
+            key_type * d_keys_output;
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_input, size * sizeof(key_type)));
+            HIP_CHECK(test_common_utils::hipMallocHelper(&d_keys_output, size * sizeof(key_type)));
+            HIP_CHECK(
+                hipMemcpy(
+                    d_keys_input, keys_input.data(),
+                    size * sizeof(key_type),
+                    hipMemcpyHostToDevice
+                )
+            );
+
+            value_type * d_values_input = nullptr;
+            value_type * d_values_output = nullptr;
+            if(WithValues)
+            {
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_input, size * sizeof(value_type)));
+                HIP_CHECK(test_common_utils::hipMallocHelper(&d_values_output, size * sizeof(value_type)));
+                HIP_CHECK(
+                    hipMemcpy(
+                        d_values_input, values_input.data(),
+                        size * sizeof(value_type),
+                        hipMemcpyHostToDevice
+                    )
+                );
+            }
+
+            // Calculate expected results on host
+            std::vector<key_type> expected(keys_input);
+            std::stable_sort(expected.begin(), expected.end(), key_less);
+
+            for(unsigned int k : get_ks(size))
+            {
+                for(hipcub::DeviceTopKOrder order : { hipcub::TOPK_UNORDERED, hipcub::TOPK_SORTED })
+                {
+                    SCOPED_TRACE(testing::Message() << "with k = " << k << ", sorted = " << (order == hipcub::TOPK_SORTED));
+
+                    size_t temp_storage_size_bytes;
+                    void * d_temp_storage = nullptr;
+                    HIP_CHECK(
+                        run_topk<select_max>(
+                            d_temp_storage, temp_storage_size_bytes,
+                            d_keys_input, d_keys_output, d_values_input, d_values_output,
+                            size, k, order, stream, debug_synchronous
+                        )
+                    );
+
+                    ASSERT_GT(temp_storage_size_bytes, 0U);
+
+                    HIP_CHECK(test_common_utils::hipMallocHelper(&d_temp_storage, temp_storage_size_bytes));
+
+                    HIP_CHECK(
+                        run_topk<select_max>(
+                            d_temp_storage, temp_storage_size_bytes,
+                            d_keys_input, d_keys_output, d_values_input, d_values_output,
+                            size, k, order, stream, debug_synchronous
+                        )
+                    );
+
+                    HIP_CHECK(hipFree(d_temp_storage));
+
+                    std::vector<key_type> keys_output(k);
+                    HIP_CHECK(
+                        hipMemcpy(
+                            keys_output.data(), d_keys_output,
+                            k * sizeof(key_type),
+                            hipMemcpyDeviceToHost
+                        )
+                    );
+
+                    if(WithValues)
+                    {
+                        std::vector<value_type> values_output(k);
+                        HIP_CHECK(
+                            hipMemcpy(
+                                values_output.data(), d_values_output,
+                                k * sizeof(value_type),
+                                hipMemcpyDeviceToHost
+                            )
+                        );
+
+                        // Every value must stay with its key, and no item may be selected twice
+                        std::vector<bool> selected(size, false);
+                        for(size_t i = 0; i < k; i++)
+                        {
+                            ASSERT_LT(values_output[i], size) << "where index = " << i;
+                            ASSERT_FALSE(selected[values_output[i]]) << "where index = " << i;
+                            selected[values_output[i]] = true;
+                            ASSERT_EQ(keys_input[values_output[i]], keys_output[i]) << "where index = " << i;
+                        }
+                    }
+
+                    if(order == hipcub::TOPK_UNORDERED)
+                    {
+                        std::sort(keys_output.begin(), keys_output.end(), key_less);
+                    }
+                    for(size_t i = 0; i < k; i++)
+                    {
+                        ASSERT_EQ(keys_output[i], expected[i]) << "where index = " << i;
+                    }
+                }
+            }
+
+            size_t temp_storage_size_bytes;
+            ASSERT_EQ(
+                run_topk<select_max>(
+                    nullptr, temp_storage_size_bytes,
+                    d_keys_input, d_keys_output, d_values_input, d_values_output,
+                    size, static_cast<unsigned int>(size + 1), hipcub::TOPK_UNORDERED,
+                    stream, debug_synchronous
+                ),
+                hipErrorInvalidValue
+            );
+
+            HIP_CHECK(hipFree(d_keys_input));
+            HIP_CHECK(hipFree(d_keys_output));
+            if(WithValues)
+            {
+                HIP_CHECK(hipFree(d_values_input));
+                HIP_CHECK(hipFree(d_values_output));
+            }
+        }
+    }
+}
+
+TYPED_TEST(HipcubDeviceTopK, Keys)
+{
+    test_topk<typename TestFixture::params, false>();
+}
+
+TYPED_TEST(HipcubDeviceTopK, Pairs)
+{
+    test_topk<typename TestFixture::params, true>();
+}
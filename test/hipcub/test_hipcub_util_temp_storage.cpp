@@ -0,0 +1,206 @@
+// MIT License
+//
+// Copyright (c) 2021 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "common_test_header.hpp"
+
+// hipcub API
+#include "hipcub/util_temp_storage.hpp"
+#include "hipcub/device/device_radix_sort.hpp"
+#include "hipcub/device/device_reduce.hpp"
+#include "hipcub/device/device_select.hpp"
+
+TEST(HipcubTempStoragePlanTests, Layout)
+{
+    hipcub::TempStoragePlan plan;
+    hipcub::TempStoragePlan::Buffer a, b, c, d, e;
+
+    // a and c are never live at the same time, b spans both, e has zero bytes
+    HIP_CHECK(plan.Reserve(a, 1000, 0));
+    HIP_CHECK(plan.Reserve(b, 5000, 0, 1));
+    HIP_CHECK(plan.Reserve(c, 700, 1));
+    HIP_CHECK(plan.Reserve(d, 100, 2));
+    HIP_CHECK(plan.Reserve(e, 0, 2));
+    ASSERT_EQ(plan.Reserve(a, 1, 3, 2), hipErrorInvalidValue);
+
+    ASSERT_EQ(plan.UnaliasedBytes(), 1024u + 5120u + 768u + 256u + 256u);
+    ASSERT_EQ(plan.ArenaBytes(), 5120u + 1024u);
+
+    ASSERT_EQ(plan.Offset(b), 0u);
+    ASSERT_EQ(plan.Offset(a), 5120u);
+    ASSERT_EQ(plan.Offset(c), 5120u);
+    ASSERT_EQ(plan.Offset(d) % plan.alignment, 0u);
+    ASSERT_NE(plan.Offset(d), plan.Offset(e));
+
+    // Nothing to hand out before an arena is bound
+    ASSERT_EQ(plan.Pointer(a), nullptr);
+    ASSERT_EQ(plan.Run(a, [](void *, size_t &) { return hipSuccess; }), hipErrorInvalidValue);
+
+    void *d_arena;
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_arena, plan.ArenaBytes()));
+    ASSERT_EQ(plan.Bind(d_arena, plan.ArenaBytes() - 1), hipErrorInvalidValue);
+    ASSERT_EQ(plan.Bind(static_cast<char *>(d_arena) + 4, plan.ArenaBytes()), hipErrorInvalidValue);
+    HIP_CHECK(plan.Bind(d_arena, plan.ArenaBytes()));
+    ASSERT_EQ(plan.Pointer<char>(c), static_cast<char *>(d_arena) + plan.Offset(c));
+    ASSERT_NE(plan.Pointer(e), nullptr);
+
+    // Reserving another buffer invalidates the binding
+    HIP_CHECK(plan.Reserve(e, 10, 0));
+    ASSERT_EQ(plan.Pointer(a), nullptr);
+    HIP_CHECK(hipFree(d_arena));
+}
+
+TEST(HipcubTempStoragePlanTests, InvalidAlignment)
+{
+    hipcub::TempStoragePlan plan(100);
+    hipcub::TempStoragePlan::Buffer a;
+
+    ASSERT_EQ(plan.Reserve(a, 1000, 0), hipErrorInvalidValue);
+    ASSERT_EQ(plan.Query(0, a, [](void *, size_t &bytes) { bytes = 10; return hipSuccess; }), hipErrorInvalidValue);
+    ASSERT_EQ(plan.ArenaBytes(), 0u);
+
+    void *d_arena;
+    HIP_CHECK(test_common_utils::hipMallocHelper(&d_arena, 256));
+    ASSERT_EQ(plan.Bind(d_arena, 256), hipErrorInvalidValue);
+    HIP_CHECK(hipFree(d_arena));
+}
+
+TEST(HipcubTempStoragePlanTests, RandomLayouts)
+{
+    std::default_random_engine engine(rand());
+    for(size_t test = 0; test < 100; test++)
+    {
+        hipcub::TempStoragePlan plan(test % 2 ? 128 : 256);
+        const size_t num_buffers = std::uniform_int_distribution<size_t>(1, 40)(engine);
+        for(size_t i = 0; i < num_buffers; i++)
+        {
+            const unsigned int first = std::uniform_int_distribution<unsigned int>(0, 10)(engine);
+            const unsigned int last = first + std::uniform_int_distribution<unsigned int>(0, 3)(engine);
+            const size_t bytes = std::uniform_int_distribution<size_t>(0, 100000)(engine);
+            hipcub::TempStoragePlan::Buffer buffer;
+            HIP_CHECK(plan.Reserve(buffer, bytes, first, last));
+        }
+
+        const size_t arena_bytes = plan.ArenaBytes();
+        ASSERT_LE(arena_bytes, plan.UnaliasedBytes());
+        for(hipcub::TempStoragePlan::Buffer i = 0; i < num_buffers; i++)
+        {
+            const auto& x = plan.buffers[i];
+            ASSERT_EQ(x.offset % plan.alignment, 0u);
+            ASSERT_LE(x.offset + x.bytes, arena_bytes);
+            for(hipcub::TempStoragePlan::Buffer j = 0; j < i; j++)
+            {
+                const auto& y = plan.buffers[j];
+                const bool live_together = x.first_step <= y.last_step && y.first_step <= x.last_step;
+                const bool overlap = x.offset < y.offset + std::max<size_t>(y.bytes, 1)
+                    && y.offset < x.offset + std::max<size_t>(x.bytes, 1);
+                ASSERT_FALSE(live_together && overlap) << "buffers " << i << " and " << j;
+            }
+        }
+    }
+}
+
+TEST(HipcubTempStoragePlanTests, Pipeline)
+{
+    using key_type = unsigned int;
+    hipStream_t stream = 0;
+
+    for(size_t size : { 1, 1000, 100000 })
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        std::vector<key_type> input = test_utils::get_random_data<key_type>(size, 0, 1000, rand());
+        std::vector<key_type> expected = input;
+        std::sort(expected.begin(), expected.end());
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+        key_type expected_max = expected.back();
+
+        key_type *d_input;
+        key_type *d_unique;
+        int *d_num_unique;
+        key_type *d_max;
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_input, size * sizeof(key_type)));
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_unique, size * sizeof(key_type)));
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_num_unique, sizeof(int)));
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_max, sizeof(key_type)));
+        HIP_CHECK(hipMemcpy(d_input, input.data(), size * sizeof(key_type), hipMemcpyHostToDevice));
+
+        // Sort, select the unique keys from the sorted ones, reduce them
+        hipcub::TempStoragePlan plan;
+        hipcub::TempStoragePlan::Buffer sorted, sort_storage, unique_storage, max_storage;
+        auto sort_keys = [&](void *d_temp_storage, size_t &temp_storage_bytes)
+        {
+            return hipcub::DeviceRadixSort::SortKeys(
+                d_temp_storage, temp_storage_bytes,
+                d_input, plan.Pointer<key_type>(sorted), static_cast<int>(size),
+                0, 8 * sizeof(key_type), stream
+            );
+        };
+        auto select_unique = [&](void *d_temp_storage, size_t &temp_storage_bytes)
+        {
+            return hipcub::DeviceSelect::Unique(
+                d_temp_storage, temp_storage_bytes,
+                plan.Pointer<key_type>(sorted), d_unique, d_num_unique, static_cast<int>(size),
+                stream
+            );
+        };
+        auto reduce_max = [&](void *d_temp_storage, size_t &temp_storage_bytes)
+        {
+            return hipcub::DeviceReduce::Max(
+                d_temp_storage, temp_storage_bytes,
+                d_unique, d_max, static_cast<int>(size), stream
+            );
+        };
+
+        HIP_CHECK(plan.Reserve(sorted, size * sizeof(key_type), 0, 1));
+        HIP_CHECK(plan.Query(0, sort_storage, sort_keys));
+        HIP_CHECK(plan.Query(1, unique_storage, select_unique));
+        HIP_CHECK(plan.Query(2, max_storage, reduce_max));
+        ASSERT_LE(plan.ArenaBytes(), plan.UnaliasedBytes());
+
+        void *d_arena;
+        HIP_CHECK(test_common_utils::hipMallocHelper(&d_arena, plan.ArenaBytes()));
+        HIP_CHECK(plan.Bind(d_arena, plan.ArenaBytes()));
+
+        // The unique keys past the selected ones are set to 0 so that the maximum covers all items
+        HIP_CHECK(hipMemset(d_unique, 0, size * sizeof(key_type)));
+        HIP_CHECK(plan.Run(sort_storage, sort_keys));
+        HIP_CHECK(plan.Run(unique_storage, select_unique));
+        HIP_CHECK(plan.Run(max_storage, reduce_max));
+        HIP_CHECK(hipDeviceSynchronize());
+
+        int num_unique;
+        key_type result_max;
+        HIP_CHECK(hipMemcpy(&num_unique, d_num_unique, sizeof(int), hipMemcpyDeviceToHost));
+        HIP_CHECK(hipMemcpy(&result_max, d_max, sizeof(key_type), hipMemcpyDeviceToHost));
+        std::vector<key_type> result(num_unique);
+        HIP_CHECK(hipMemcpy(result.data(), d_unique, num_unique * sizeof(key_type), hipMemcpyDeviceToHost));
+
+        ASSERT_EQ(result, expected);
+        ASSERT_EQ(result_max, expected_max);
+
+        HIP_CHECK(hipFree(d_arena));
+        HIP_CHECK(hipFree(d_input));
+        HIP_CHECK(hipFree(d_unique));
+        HIP_CHECK(hipFree(d_num_unique));
+        HIP_CHECK(hipFree(d_max));
+    }
+}